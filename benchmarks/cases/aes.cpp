@@ -0,0 +1,82 @@
+/**
+ * @file aes.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Benchmarks for AES cipher (hardware-accelerated baseline)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "bench_common.hpp"
+
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char raw_key[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+
+/**
+ * @brief Registers benchmark for all key sizes, engines and several buffer sizes.
+ */
+void AllKeySizesEnginesAndSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({ "key", "engine", "blocks" });
+    benchmark->ArgsProduct({ { AES128_KEY_SIZE, AES256_KEY_SIZE },
+                             benchmark::CreateDenseRange(AES_ENGINE_AESNI, AES_ENGINE_VAES, 1),
+                             { 1, 8, 64, 256, 4096 } });
+}
+
+
+/**
+ * @brief Multi-block throughput (in-place), comparable with Kuznyechik one.
+ */
+void MultiBlockThroughput(benchmark::State& state, bool encrypt)
+{
+    BLOCK_CIPHER cipher = {};
+    if (!bench::details::InitializeEngine(state, &cipher, static_cast<size_t>(state.range(0)),
+                                          static_cast<AES_ENGINE>(state.range(1))))
+    {
+        return;
+    }
+
+    KEY key = {};
+    encrypt ? cipher.initialize_encrypt_key(raw_key, &key)
+            : cipher.initialize_decrypt_key(raw_key, &key);
+
+    const auto procedure    = encrypt ? cipher.encrypt_blocks : cipher.decrypt_blocks;
+    const auto blocks_count = static_cast<std::size_t>(state.range(2));
+
+    std::vector<unsigned char> buffer(blocks_count * AES_BLOCK_SIZE, 0x5a);
+    auto blocks = reinterpret_cast<__m128i*>(buffer.data());
+
+    const auto start = bench::details::ReadTsc();
+
+    for (auto _ : state)
+    {
+        procedure(blocks, &key, blocks, blocks_count);
+        benchmark::ClobberMemory();
+    }
+
+    const auto cycles = bench::details::ReadTsc() - start;
+    const auto bytes  = state.iterations() * buffer.size();
+
+    state.SetBytesProcessed(bytes);
+    state.counters["cycles_per_byte"] = static_cast<double>(cycles) / static_cast<double>(bytes);
+}
+
+
+void BM_AesEncryptBlocks(benchmark::State& state) { MultiBlockThroughput(state, true); }
+void BM_AesDecryptBlocks(benchmark::State& state) { MultiBlockThroughput(state, false); }
+
+}  // namespace
+
+
+BENCHMARK(BM_AesEncryptBlocks)->Apply(AllKeySizesEnginesAndSizes);
+BENCHMARK(BM_AesDecryptBlocks)->Apply(AllKeySizesEnginesAndSizes);
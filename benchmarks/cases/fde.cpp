@@ -0,0 +1,388 @@
+/**
+ * @file fde.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Full disk encryption workload: storage traffic over in-memory (or tmpfs-backed) volumes
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_MSC_VER)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+
+namespace {
+
+/**
+ * @brief Environment variable with a directory (e.g. /dev/shm) for disk files.
+ *        If it is not set, disks are kept in anonymous memory.
+ */
+constexpr char kDiskDirectoryVariable[] = "BCLIB_FDE_BENCH_DIR";
+
+/**
+ * @brief Total size of all disks of a workload, it is split between volumes.
+ */
+constexpr std::size_t kTotalDiskSize = 256 * 1024 * 1024;
+
+/**
+ * @brief Sector size of volumes.
+ */
+constexpr std::size_t kSectorSize = 4096;
+
+/**
+ * @brief Request sizes of random and sequential patterns.
+ */
+constexpr std::size_t kRandomRequestSize     = 4096;
+constexpr std::size_t kSequentialRequestSize = 1024 * 1024;
+
+/**
+ * @brief Number of latency samples reserved per thread.
+ */
+constexpr std::size_t kReservedSamples = 1 << 20;
+
+/**
+ * @brief Access patterns.
+ */
+enum Pattern
+{
+    kRandom4K     = 0, /**< Random 4 KB requests over the whole volume */
+    kSequential1M = 1  /**< Sequential 1 MB streams, each thread has its own cursor */
+};
+
+
+/**
+ * @brief A disk: encrypted sectors of a volume in memory or in a file mapping.
+ */
+class Disk
+{
+public:
+    explicit Disk(std::size_t size, std::size_t index)
+        : size_(size)
+    {
+#if !defined(_MSC_VER)
+        if (const char* directory = std::getenv(kDiskDirectoryVariable))
+        {
+            const std::string path = std::string(directory) + "/bclib-fde-bench-" + std::to_string(index) + ".img";
+            const int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+            if (file >= 0 && ftruncate(file, static_cast<off_t>(size)) == 0)
+            {
+                void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+                data_         = mapping != MAP_FAILED ? static_cast<unsigned char*>(mapping) : nullptr;
+            }
+
+            if (file >= 0)
+            {
+                close(file);
+                unlink(path.c_str());
+            }
+        }
+#else
+        static_cast<void>(index);
+#endif
+
+        if (!data_)
+        {
+            memory_.resize(size);
+            data_ = memory_.data();
+        }
+
+        //
+        // Pages are faulted in ahead, so first touches are not measured
+        //
+
+        std::memset(data_, 0x5a, size);
+    }
+
+    ~Disk()
+    {
+#if !defined(_MSC_VER)
+        if (memory_.empty())
+        {
+            munmap(data_, size_);
+        }
+#endif
+    }
+
+    Disk(const Disk&)            = delete;
+    Disk& operator=(const Disk&) = delete;
+
+    unsigned char* Data() const { return data_; }
+    std::size_t Size() const { return size_; }
+
+private:
+    std::size_t size_;
+    unsigned char* data_ = nullptr;
+    std::vector<unsigned char> memory_;
+};
+
+
+/**
+ * @brief A volume: disk and its own keys (as a dm-crypt target with xts-plain64).
+ */
+struct Volume
+{
+    Volume(const BLOCK_CIPHER* cipher, std::size_t size, std::size_t index)
+        : disk(size, index)
+    {
+        unsigned char raw_key[KUZNYECHIK_KEY_SIZE];
+        unsigned char raw_tweak_key[KUZNYECHIK_KEY_SIZE];
+
+        for (std::size_t idx = 0; idx < KUZNYECHIK_KEY_SIZE; ++idx)
+        {
+            raw_key[idx]       = static_cast<unsigned char>(idx * 7 + index);
+            raw_tweak_key[idx] = static_cast<unsigned char>(idx * 13 + index + 1);
+        }
+
+        cipher->initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+        cipher->initialize_encrypt_key(raw_tweak_key, &tweak_key);
+
+        context = SECTOR_CONTEXT{ cipher, SECTOR_MODE_XTS, SECTOR_IV_PLAIN64, kSectorSize, 1,
+                                  &encrypt_key, &decrypt_key, &tweak_key, nullptr };
+    }
+
+    Disk disk;
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    KEY tweak_key   = {};
+    SECTOR_CONTEXT context = {};
+};
+
+
+/**
+ * @brief Volumes of a workload, they are shared by all threads and kept
+ *        between runs with different numbers of threads.
+ */
+struct Volumes
+{
+    BLOCK_CIPHER cipher = {};
+    std::vector<std::unique_ptr<Volume>> volumes;
+};
+
+
+/**
+ * @brief Returns volumes for a number of volumes (creates them on first use).
+ */
+Volumes& GetVolumes(std::size_t volumes_count)
+{
+    static std::mutex lock;
+    static std::map<std::size_t, std::unique_ptr<Volumes>> workloads;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto& workload = workloads[volumes_count];
+
+    if (!workload)
+    {
+        workload = std::make_unique<Volumes>();
+
+        //
+        // Engine is selected as in production (BCLIB_KUZNYECHIK_ENGINE may override it)
+        //
+
+        kuznyechik_initialize_interface(&workload->cipher);
+
+        for (std::size_t idx = 0; idx < volumes_count; ++idx)
+        {
+            workload->volumes.push_back(std::make_unique<Volume>(&workload->cipher, kTotalDiskSize / volumes_count, idx));
+        }
+    }
+
+    return *workload;
+}
+
+
+/**
+ * @brief Latency samples (in nanoseconds) of each thread of the current run.
+ */
+std::vector<std::vector<unsigned int>>& LatencySamples()
+{
+    static std::vector<std::vector<unsigned int>> samples(std::max(1u, std::thread::hardware_concurrency()));
+    return samples;
+}
+
+
+/**
+ * @brief Fast pseudo-random generator (xorshift64), each thread has its own one.
+ */
+class Random
+{
+public:
+    explicit Random(unsigned long long seed)
+        : state_(seed * 0x9e3779b97f4a7c15ull + 1)
+    { }
+
+    unsigned long long Next()
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+
+        return state_;
+    }
+
+private:
+    unsigned long long state_;
+};
+
+
+/**
+ * @brief Returns a percentile of samples (samples are reordered).
+ */
+double Percentile(std::vector<unsigned int>& samples, double fraction)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    const auto position = samples.begin() + static_cast<std::ptrdiff_t>(fraction * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), position, samples.end());
+
+    return *position;
+}
+
+
+/**
+ * @brief Registers workloads: pattern, share of reads in percents and number
+ *        of volumes, for 1 to all hardware threads.
+ */
+void AllWorkloads(benchmark::internal::Benchmark* benchmark)
+{
+    const int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    benchmark->ArgNames({ "pattern", "reads", "volumes" });
+    benchmark->ArgsProduct({ { kRandom4K, kSequential1M }, { 100, 70, 0 }, { 1, 64 } });
+    benchmark->ThreadRange(1, threads);
+    benchmark->UseRealTime();
+}
+
+
+/**
+ * @brief Storage traffic: reads decrypt sectors of a volume into a buffer of
+ *        a thread, writes encrypt a buffer into sectors of a volume. Each
+ *        iteration is a single request.
+ */
+void BM_FdeWorkload(benchmark::State& state)
+{
+    const auto pattern       = static_cast<Pattern>(state.range(0));
+    const auto read_percent  = static_cast<unsigned long long>(state.range(1));
+    const auto volumes_count = static_cast<std::size_t>(state.range(2));
+    const auto thread_index  = static_cast<std::size_t>(state.thread_index());
+    const auto threads_count = static_cast<std::size_t>(state.threads());
+
+    const std::size_t request_size  = pattern == kRandom4K ? kRandomRequestSize : kSequentialRequestSize;
+    const std::size_t request_units = request_size / kSectorSize;
+
+    Volumes& workload = GetVolumes(volumes_count);
+
+    const std::size_t volume_size     = workload.volumes.front()->disk.Size();
+    const std::size_t volume_requests = volume_size / request_size;
+
+    std::vector<unsigned char> buffer(request_size, 0xa5);
+    std::vector<std::size_t> cursors(volumes_count);
+
+    //
+    // Sequential streams of threads start from different places of a volume
+    //
+
+    for (std::size_t volume = 0; volume < volumes_count; ++volume)
+    {
+        cursors[volume] = (thread_index * volume_requests) / threads_count;
+    }
+
+    auto& samples = LatencySamples()[thread_index];
+    samples.clear();
+    samples.reserve(kReservedSamples);
+
+    Random random(thread_index + 1);
+
+    std::size_t requests = 0;
+    std::size_t volume   = thread_index % volumes_count;
+
+    for (auto _ : state)
+    {
+        std::size_t request;
+
+        if (pattern == kRandom4K)
+        {
+            volume  = static_cast<std::size_t>(random.Next() % volumes_count);
+            request = static_cast<std::size_t>(random.Next() % volume_requests);
+        }
+        else
+        {
+            volume  = (volume + 1) % volumes_count;
+            request = cursors[volume];
+
+            cursors[volume] = (request + 1) % volume_requests;
+        }
+
+        const bool read        = random.Next() % 100 < read_percent;
+        const auto sector      = static_cast<unsigned long long>(request * request_units);
+        unsigned char* sectors = workload.volumes[volume]->disk.Data() + request * request_size;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        if (read)
+        {
+            sector_decrypt(&workload.volumes[volume]->context, sector, request_units, sectors, buffer.data());
+        }
+        else
+        {
+            sector_encrypt(&workload.volumes[volume]->context, sector, request_units, buffer.data(), sectors);
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        samples.push_back(static_cast<unsigned int>(elapsed.count()));
+
+        benchmark::DoNotOptimize(buffer.data());
+        ++requests;
+    }
+
+    const auto bytes = static_cast<double>(requests * request_size);
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(requests * request_size));
+    state.counters["per_thread"] = benchmark::Counter(bytes, benchmark::Counter::kAvgThreadsRate,
+                                                  benchmark::Counter::OneK::kIs1024);
+
+    //
+    // Timing loop ends with a barrier, so samples of all threads are complete
+    // here. Latency percentiles are computed over all requests by the first
+    // thread (counters of other threads are zero, counters are summed)
+    //
+
+    if (thread_index == 0)
+    {
+        std::vector<unsigned int> all_samples;
+
+        for (std::size_t thread = 0; thread < threads_count; ++thread)
+        {
+            all_samples.insert(all_samples.end(), LatencySamples()[thread].begin(), LatencySamples()[thread].end());
+        }
+
+        state.counters["p50_us"]  = Percentile(all_samples, 0.5) / 1000.0;
+        state.counters["p99_us"]  = Percentile(all_samples, 0.99) / 1000.0;
+        state.counters["p999_us"] = Percentile(all_samples, 0.999) / 1000.0;
+    }
+}
+
+}  // namespace
+
+
+BENCHMARK(BM_FdeWorkload)->Apply(AllWorkloads);
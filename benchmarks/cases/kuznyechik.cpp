@@ -0,0 +1,260 @@
+/**
+ * @file kuznyechik.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Benchmarks for Kuznyechik cipher
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "bench_common.hpp"
+
+#include <chrono>
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+
+/**
+ * @brief Registers benchmark for all engines.
+ */
+void AllEngines(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgName("engine");
+    benchmark->DenseRange(KUZNYECHIK_ENGINE_GENERIC, KUZNYECHIK_ENGINE_COMPACT);
+}
+
+
+/**
+ * @brief Registers benchmark for all engines and several buffer sizes.
+ */
+void AllEnginesAndSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({ "engine", "blocks" });
+    benchmark->ArgsProduct({ benchmark::CreateDenseRange(KUZNYECHIK_ENGINE_GENERIC, KUZNYECHIK_ENGINE_COMPACT, 1),
+                             { 1, 8, 64, 256, 4096 } });
+}
+
+
+/**
+ * @brief Single block latency: each block depends on the previous one,
+ *        so blocks cannot overlap in the pipeline. Tables are warm.
+ */
+void SingleBlockLatency(benchmark::State& state, bool encrypt)
+{
+    BLOCK_CIPHER cipher = {};
+    if (!bench::details::InitializeEngine(state, &cipher, static_cast<KUZNYECHIK_ENGINE>(state.range(0))))
+    {
+        return;
+    }
+
+    KEY key = {};
+    encrypt ? cipher.initialize_encrypt_key(raw_key, &key)
+            : cipher.initialize_decrypt_key(raw_key, &key);
+
+    const auto procedure = encrypt ? cipher.encrypt_block : cipher.decrypt_block;
+
+    __m128i block = _mm_set1_epi8(0x5a);
+
+    const auto start = bench::details::ReadTsc();
+
+    for (auto _ : state)
+    {
+        procedure(block, &key, &block);
+        benchmark::DoNotOptimize(block);
+    }
+
+    const auto cycles = bench::details::ReadTsc() - start;
+
+    state.SetBytesProcessed(state.iterations() * KUZNYECHIK_BLOCK_SIZE);
+    state.counters["cycles"] = benchmark::Counter(static_cast<double>(cycles), benchmark::Counter::kAvgIterations);
+}
+
+
+/**
+ * @brief Single block latency with cold tables: caches are flushed 
+ *        before each block (flushing is not measured).
+ */
+void SingleBlockCold(benchmark::State& state, bool encrypt)
+{
+    BLOCK_CIPHER cipher = {};
+    if (!bench::details::InitializeEngine(state, &cipher, static_cast<KUZNYECHIK_ENGINE>(state.range(0))))
+    {
+        return;
+    }
+
+    KEY key = {};
+    encrypt ? cipher.initialize_encrypt_key(raw_key, &key)
+            : cipher.initialize_decrypt_key(raw_key, &key);
+
+    const auto procedure = encrypt ? cipher.encrypt_block : cipher.decrypt_block;
+
+    __m128i block = _mm_set1_epi8(0x5a);
+
+    unsigned long long cycles = 0;
+
+    for (auto _ : state)
+    {
+        bench::details::EvictCaches();
+
+        const auto start       = std::chrono::high_resolution_clock::now();
+        const auto start_cycles = bench::details::ReadTsc();
+
+        procedure(block, &key, &block);
+        benchmark::DoNotOptimize(block);
+
+        cycles += bench::details::ReadTsc() - start_cycles;
+
+        const auto finish = std::chrono::high_resolution_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(finish - start).count());
+    }
+
+    state.counters["cycles"] = benchmark::Counter(static_cast<double>(cycles), benchmark::Counter::kAvgIterations);
+}
+
+
+/**
+ * @brief Multi-block throughput (in-place, warm tables).
+ */
+void MultiBlockThroughput(benchmark::State& state, bool encrypt)
+{
+    BLOCK_CIPHER cipher = {};
+    if (!bench::details::InitializeEngine(state, &cipher, static_cast<KUZNYECHIK_ENGINE>(state.range(0))))
+    {
+        return;
+    }
+
+    KEY key = {};
+    encrypt ? cipher.initialize_encrypt_key(raw_key, &key)
+            : cipher.initialize_decrypt_key(raw_key, &key);
+
+    const auto procedure    = encrypt ? cipher.encrypt_blocks : cipher.decrypt_blocks;
+    const auto blocks_count = static_cast<std::size_t>(state.range(1));
+
+    std::vector<unsigned char> buffer(blocks_count * KUZNYECHIK_BLOCK_SIZE, 0x5a);
+    auto blocks = reinterpret_cast<__m128i*>(buffer.data());
+
+    const auto start = bench::details::ReadTsc();
+
+    for (auto _ : state)
+    {
+        procedure(blocks, &key, blocks, blocks_count);
+        benchmark::ClobberMemory();
+    }
+
+    const auto cycles = bench::details::ReadTsc() - start;
+    const auto bytes  = state.iterations() * buffer.size();
+
+    state.SetBytesProcessed(bytes);
+    state.counters["cycles_per_byte"] = static_cast<double>(cycles) / static_cast<double>(bytes);
+}
+
+
+void BM_EncryptBlock(benchmark::State& state) { SingleBlockLatency(state, true); }
+void BM_DecryptBlock(benchmark::State& state) { SingleBlockLatency(state, false); }
+void BM_EncryptBlockCold(benchmark::State& state) { SingleBlockCold(state, true); }
+void BM_DecryptBlockCold(benchmark::State& state) { SingleBlockCold(state, false); }
+void BM_EncryptBlocks(benchmark::State& state) { MultiBlockThroughput(state, true); }
+void BM_DecryptBlocks(benchmark::State& state) { MultiBlockThroughput(state, false); }
+
+
+/**
+ * @brief Encryption key schedule setup.
+ */
+void BM_InitializeEncryptKey(benchmark::State& state)
+{
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+
+    for (auto _ : state)
+    {
+        cipher.initialize_encrypt_key(raw_key, &key);
+        benchmark::DoNotOptimize(key);
+    }
+}
+
+
+/**
+ * @brief Decryption key schedule setup.
+ */
+void BM_InitializeDecryptKey(benchmark::State& state)
+{
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+
+    for (auto _ : state)
+    {
+        cipher.initialize_decrypt_key(raw_key, &key);
+        benchmark::DoNotOptimize(key);
+    }
+}
+
+
+/**
+ * @brief Both key schedules setup with a single expansion.
+ */
+void BM_InitializeKeys(benchmark::State& state)
+{
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+
+    for (auto _ : state)
+    {
+        cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+        benchmark::DoNotOptimize(encrypt_key);
+        benchmark::DoNotOptimize(decrypt_key);
+    }
+}
+
+
+/**
+ * @brief Batch setup of both key schedules (time is per batch).
+ */
+void BM_InitializeKeysBatch(benchmark::State& state)
+{
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    const auto keys_count = static_cast<std::size_t>(state.range(0));
+
+    std::vector<unsigned char> raw_keys(keys_count * KUZNYECHIK_KEY_SIZE, 0x5a);
+    std::vector<KEY> encrypt_keys(keys_count);
+    std::vector<KEY> decrypt_keys(keys_count);
+
+    for (auto _ : state)
+    {
+        cipher.initialize_keys_batch(raw_keys.data(), encrypt_keys.data(), decrypt_keys.data(), keys_count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys_count);
+}
+
+}  // namespace
+
+
+BENCHMARK(BM_EncryptBlock)->Apply(AllEngines);
+BENCHMARK(BM_DecryptBlock)->Apply(AllEngines);
+BENCHMARK(BM_EncryptBlockCold)->Apply(AllEngines)->UseManualTime()->Iterations(200);
+BENCHMARK(BM_DecryptBlockCold)->Apply(AllEngines)->UseManualTime()->Iterations(200);
+BENCHMARK(BM_EncryptBlocks)->Apply(AllEnginesAndSizes);
+BENCHMARK(BM_DecryptBlocks)->Apply(AllEnginesAndSizes);
+BENCHMARK(BM_InitializeEncryptKey);
+BENCHMARK(BM_InitializeDecryptKey);
+BENCHMARK(BM_InitializeKeys);
+BENCHMARK(BM_InitializeKeysBatch)->ArgName("keys")->Arg(4)->Arg(64)->Arg(1024);
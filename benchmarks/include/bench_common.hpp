@@ -0,0 +1,31 @@
+/**
+ * @file bench_common.hpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Common header for all benchmarks
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#pragma once
+
+
+//
+// Google benchmark library
+//
+
+#include "benchmark/benchmark.h"
+
+
+//
+// bc-lib
+//
+
+#include "bclib.h"
+
+
+//
+// Helpers
+//
+
+#include "bench_utils.hpp"
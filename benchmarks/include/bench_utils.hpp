@@ -0,0 +1,113 @@
+/**
+ * @file bench_utils.hpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Some helpers for benchmarks
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#else
+#   include <x86intrin.h>
+#endif
+
+#include "bclib.h"
+
+
+namespace bench::details {
+
+/**
+ * @brief Size of a buffer that is used to evict lookup tables from caches.
+ *        Must be larger than last level cache.
+ */
+constexpr std::size_t kEvictionBufferSize = 64 * 1024 * 1024;
+
+
+/**
+ * @brief Reads CPU timestamp counter.
+ */
+inline unsigned long long ReadTsc()
+{
+    return __rdtsc();
+}
+
+
+/**
+ * @brief Evicts everything (including cipher lookup tables) from CPU caches
+ *        by writing a buffer larger than last level cache.
+ */
+inline void EvictCaches()
+{
+    static std::vector<unsigned char> buffer(kEvictionBufferSize);
+
+    for (std::size_t idx = 0; idx < buffer.size(); idx += 64)
+    {
+        buffer[idx] += 1;
+    }
+
+    benchmark::ClobberMemory();
+}
+
+
+/**
+ * @brief Checks if CPU supports an engine.
+ */
+inline bool EngineSupported(KUZNYECHIK_ENGINE engine)
+{
+    return kuznyechik_engine_supported(engine);
+}
+
+
+/**
+ * @brief Initializes cipher with an engine or skips benchmark if engine 
+ *        is not supported by CPU.
+ * 
+ * @return true if benchmark can be run
+ */
+inline bool InitializeEngine(benchmark::State& state, BLOCK_CIPHER* cipher, KUZNYECHIK_ENGINE engine)
+{
+    if (!EngineSupported(engine))
+    {
+        state.SkipWithError("Engine is not supported by CPU");
+        return false;
+    }
+
+    kuznyechik_initialize_interface_ex(cipher, engine);
+    return true;
+}
+
+
+/**
+ * @brief Checks if CPU supports an AES engine.
+ */
+inline bool EngineSupported(AES_ENGINE engine)
+{
+    return aes_engine_supported(engine);
+}
+
+
+/**
+ * @brief Initializes AES with an engine or skips benchmark if engine 
+ *        is not supported by CPU.
+ * 
+ * @return true if benchmark can be run
+ */
+inline bool InitializeEngine(benchmark::State& state, BLOCK_CIPHER* cipher, size_t key_size, AES_ENGINE engine)
+{
+    if (!EngineSupported(engine))
+    {
+        state.SkipWithError("Engine is not supported by CPU");
+        return false;
+    }
+
+    return aes_initialize_interface_ex(cipher, key_size, engine) != 0;
+}
+
+}  // namespace bench::details
@@ -17,7 +17,23 @@
 
 #include "common/utils.h"
 #include "common/interface.h"
+#include "common/key_cache.h"
+#include "common/cpu.h"
+#include "common/iov.h"
+#include "common/instrumentation.h"
 #include "ciphers/kuznyechik/kuznyechik.h"
+#include "ciphers/kuznyechik/kuznyechik_numa.h"
+#include "ciphers/magma/magma.h"
+#include "ciphers/aes/aes.h"
+#include "modes/ecb/ecb.h"
+#include "modes/xts/xts.h"
+#include "modes/ctr/ctr.h"
+#include "modes/mgm/mgm.h"
+#include "modes/cmac/cmac.h"
+#include "modes/cbc/cbc.h"
+#include "modes/cfb/cfb.h"
+#include "sector/sector.h"
+#include "bulk/bulk.h"
 
 
 #endif // !BCLIB_INCLUDED
\ No newline at end of file
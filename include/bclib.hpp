@@ -0,0 +1,322 @@
+/**
+ * @file bclib.hpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Header-only C++ front end: cipher, engine and mode are bound at compile time
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_HPP_INCLUDED
+#define BCLIB_HPP_INCLUDED
+
+
+#include "bclib.h"
+#include "ciphers/kuznyechik/kuznyechik_engines.h"
+
+#include <cstddef>
+
+#include <emmintrin.h>
+
+
+namespace bclib {
+
+//
+// Cipher tags
+//
+
+/**
+ * @brief Kuznyechik (GOST 34.12-2018), engine is a KUZNYECHIK_ENGINE value.
+ */
+struct Kuznyechik {};
+
+
+//
+// Mode tags
+//
+
+/**
+ * @brief ECB mode of operation (GOST 34.13-2018).
+ */
+struct Ecb {};
+
+
+/**
+ * @brief CTR mode of operation (GOST 34.13-2018).
+ */
+struct Ctr {};
+
+
+/**
+ * @brief XTS mode of operation (IEEE 1619).
+ */
+struct Xts {};
+
+
+/**
+ * @brief Block cipher bound to an engine at compile time. Procedures are called
+ *        directly instead of through BLOCK_CIPHER dispatch table, so compiler
+ *        sees the exact callee (and may inline it with link-time optimization).
+ * 
+ * Engine MUST be supported by CPU, check it with `Supported` once.
+ * 
+ * @tparam CipherTag Cipher tag (e.g. Kuznyechik)
+ * @tparam Engine Engine of cipher (e.g. KUZNYECHIK_ENGINE_AVX2)
+ */
+template <typename CipherTag, auto Engine>
+struct Cipher;
+
+
+/**
+ * @brief Kuznyechik bound to an engine.
+ */
+template <KUZNYECHIK_ENGINE Engine>
+struct Cipher<Kuznyechik, Engine>
+{
+    static_assert(Engine >= KUZNYECHIK_ENGINE_GENERIC && Engine <= KUZNYECHIK_ENGINE_COMPACT, "unknown Kuznyechik engine");
+
+    /**
+     * @brief Block size in bytes.
+     */
+    static constexpr std::size_t block_size = KUZNYECHIK_BLOCK_SIZE;
+
+    /**
+     * @brief Key size in bytes.
+     */
+    static constexpr std::size_t key_size = KUZNYECHIK_KEY_SIZE;
+
+    /**
+     * @brief Number of blocks processed by engine at once (the same as `interleave`
+     *        field of its dispatch table).
+     */
+    static constexpr std::size_t interleave = (Engine == KUZNYECHIK_ENGINE_AVX2)          ? KUZNYECHIK_AVX2_INTERLEAVE
+                                            : (Engine == KUZNYECHIK_ENGINE_AVX512)        ? KUZNYECHIK_AVX512_INTERLEAVE
+                                            : (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME) ? KUZNYECHIK_CONSTANT_TIME_INTERLEAVE
+                                            : (Engine == KUZNYECHIK_ENGINE_COMPACT)       ? KUZNYECHIK_COMPACT_INTERLEAVE
+                                                                                          : KUZNYECHIK_GENERIC_INTERLEAVE;
+
+    /**
+     * @brief Checks if engine is supported by CPU.
+     */
+    static bool Supported() noexcept
+    {
+        return kuznyechik_engine_supported(Engine) != 0;
+    }
+
+    /**
+     * @brief Dispatch table of the engine, which C procedures of modes are called
+     *        with (it is initialized once, on the first call).
+     */
+    static const BLOCK_CIPHER& Interface() noexcept
+    {
+        static const BLOCK_CIPHER cipher = [] {
+            BLOCK_CIPHER table = {};
+            kuznyechik_initialize_interface_ex(&table, Engine);
+            return table;
+        }();
+
+        return cipher;
+    }
+
+    static void InitializeEncryptKey(const unsigned char* key, KEY* round_keys) noexcept
+    {
+        if constexpr (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME)
+        {
+            kuznyechik_sliced_initialize_encrypt_key(key, round_keys);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_COMPACT)
+        {
+            kuznyechik_compact_initialize_encrypt_key(key, round_keys);
+        }
+        else
+        {
+            kuznyechik_initialize_encrypt_key(key, round_keys);
+        }
+    }
+
+    static void InitializeDecryptKey(const unsigned char* key, KEY* round_keys) noexcept
+    {
+        if constexpr (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME)
+        {
+            kuznyechik_sliced_initialize_decrypt_key(key, round_keys);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_COMPACT)
+        {
+            kuznyechik_compact_initialize_decrypt_key(key, round_keys);
+        }
+        else
+        {
+            kuznyechik_initialize_decrypt_key(key, round_keys);
+        }
+    }
+
+    static void EncryptBlock(const __m128i in, const KEY* round_keys, __m128i* out) noexcept
+    {
+        if constexpr (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME)
+        {
+            kuznyechik_sliced_encrypt_block(in, round_keys, out);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_COMPACT)
+        {
+            kuznyechik_compact_encrypt_block(in, round_keys, out);
+        }
+        else
+        {
+            //
+            // Single block procedures of lookup tables engines are the same
+            //
+
+            kuznyechik_encrypt_block(in, round_keys, out);
+        }
+    }
+
+    static void DecryptBlock(const __m128i in, const KEY* round_keys, __m128i* out) noexcept
+    {
+        if constexpr (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME)
+        {
+            kuznyechik_sliced_decrypt_block(in, round_keys, out);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_COMPACT)
+        {
+            kuznyechik_compact_decrypt_block(in, round_keys, out);
+        }
+        else
+        {
+            kuznyechik_decrypt_block(in, round_keys, out);
+        }
+    }
+
+    static void EncryptBlocks(const __m128i* in, const KEY* round_keys, __m128i* out, std::size_t blocks_count) noexcept
+    {
+        if constexpr (Engine == KUZNYECHIK_ENGINE_AVX2)
+        {
+            kuznyechik_avx2_encrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_AVX512)
+        {
+            kuznyechik_avx512_encrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME)
+        {
+            kuznyechik_sliced_encrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_COMPACT)
+        {
+            kuznyechik_compact_encrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else
+        {
+            kuznyechik_encrypt_blocks(in, round_keys, out, blocks_count);
+        }
+    }
+
+    static void DecryptBlocks(const __m128i* in, const KEY* round_keys, __m128i* out, std::size_t blocks_count) noexcept
+    {
+        if constexpr (Engine == KUZNYECHIK_ENGINE_AVX2)
+        {
+            kuznyechik_avx2_decrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_AVX512)
+        {
+            kuznyechik_avx512_decrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_CONSTANT_TIME)
+        {
+            kuznyechik_sliced_decrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else if constexpr (Engine == KUZNYECHIK_ENGINE_COMPACT)
+        {
+            kuznyechik_compact_decrypt_blocks(in, round_keys, out, blocks_count);
+        }
+        else
+        {
+            kuznyechik_decrypt_blocks(in, round_keys, out, blocks_count);
+        }
+    }
+};
+
+
+/**
+ * @brief Mode of operation bound to a cipher (and its engine) at compile time.
+ *        ECB calls engine procedures directly, other modes wrap C procedures
+ *        (with dispatch table of the engine), so mode logic is not duplicated.
+ * 
+ * @tparam ModeTag Mode tag (e.g. Xts)
+ * @tparam CipherType Cipher bound to an engine (e.g. Cipher<Kuznyechik, KUZNYECHIK_ENGINE_AVX2>)
+ */
+template <typename ModeTag, typename CipherType>
+struct Mode;
+
+
+/**
+ * @brief ECB mode, see `ecb_encrypt`.
+ */
+template <typename CipherType>
+struct Mode<Ecb, CipherType>
+{
+    static void Encrypt(const KEY& key, const unsigned char* in, unsigned char* out, std::size_t length) noexcept
+    {
+        CipherType::EncryptBlocks(reinterpret_cast<const __m128i*>(in), &key, reinterpret_cast<__m128i*>(out),
+                                  length / CipherType::block_size);
+    }
+
+    static void Decrypt(const KEY& key, const unsigned char* in, unsigned char* out, std::size_t length) noexcept
+    {
+        CipherType::DecryptBlocks(reinterpret_cast<const __m128i*>(in), &key, reinterpret_cast<__m128i*>(out),
+                                  length / CipherType::block_size);
+    }
+};
+
+
+/**
+ * @brief CTR mode, see `ctr_encrypt`.
+ */
+template <typename CipherType>
+struct Mode<Ctr, CipherType>
+{
+    static void Encrypt(const KEY& key, const unsigned char* iv, unsigned long long block_offset,
+                        const unsigned char* in, unsigned char* out, std::size_t length) noexcept
+    {
+        ctr_encrypt(&CipherType::Interface(), &key, iv, block_offset, in, out, length);
+    }
+
+    static void Decrypt(const KEY& key, const unsigned char* iv, unsigned long long block_offset,
+                        const unsigned char* in, unsigned char* out, std::size_t length) noexcept
+    {
+        ctr_decrypt(&CipherType::Interface(), &key, iv, block_offset, in, out, length);
+    }
+};
+
+
+/**
+ * @brief XTS mode, see `xts_encrypt_sectors`.
+ */
+template <typename CipherType>
+struct Mode<Xts, CipherType>
+{
+    /**
+     * @return True on success, false if sector size is invalid (nothing is processed)
+     */
+    static bool EncryptSectors(const KEY& data_key, const KEY& tweak_key, unsigned long long sector_number,
+                               std::size_t sector_size, std::size_t sectors_count,
+                               const unsigned char* in, unsigned char* out) noexcept
+    {
+        return xts_encrypt_sectors(&CipherType::Interface(), &data_key, &tweak_key, sector_number,
+                                   sector_size, sectors_count, in, out) != 0;
+    }
+
+    /**
+     * @return True on success, false if sector size is invalid (nothing is processed)
+     */
+    static bool DecryptSectors(const KEY& data_key, const KEY& tweak_key, unsigned long long sector_number,
+                               std::size_t sector_size, std::size_t sectors_count,
+                               const unsigned char* in, unsigned char* out) noexcept
+    {
+        return xts_decrypt_sectors(&CipherType::Interface(), &data_key, &tweak_key, sector_number,
+                                   sector_size, sectors_count, in, out) != 0;
+    }
+};
+
+}  // namespace bclib
+
+#endif  // !BCLIB_HPP_INCLUDED
@@ -0,0 +1,114 @@
+/**
+ * @file bulk.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Multi-threaded bulk encryption engine (user mode only)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_BULK_INCLUDED
+#define BCLIB_BULK_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Size of a piece of work processed by a thread at once in bytes
+ *        (it is rounded down to a multiple of block or sector size).
+ */
+#define BULK_CHUNK_SIZE (64 * 1024)
+
+
+/**
+ * @brief Modes of operation supported by bulk engine. Only modes, 
+ *        where blocks (or sectors) are independent, are supported
+ *        (CBC decryption depends only on ciphertext).
+ */
+typedef enum tagBULK_MODE
+{
+    BULK_MODE_ECB_ENCRYPT,         /**< Multi-block encryption */
+    BULK_MODE_ECB_DECRYPT,         /**< Multi-block decryption */
+    BULK_MODE_CTR,                 /**< CTR (encryption and decryption are the same) */
+    BULK_MODE_XTS_ENCRYPT,         /**< XTS encryption of consecutive sectors */
+    BULK_MODE_XTS_DECRYPT,         /**< XTS decryption of consecutive sectors */
+    BULK_MODE_CBC_DECRYPT,         /**< CBC decryption of a buffer with one block IV */
+    BULK_MODE_CBC_DECRYPT_SECTORS  /**< CBC decryption of consecutive sectors, each one with its own IV */
+} BULK_MODE;
+
+
+/**
+ * @brief Bulk processing request.
+ */
+typedef struct tagBULK_REQUEST
+{
+    BULK_MODE mode;             /**< Mode of operation */
+    const BLOCK_CIPHER* cipher; /**< Initialized 128-bit block cipher interface */
+    const KEY* key;             /**< Key schedule (for encryption in CTR mode, for decryption in CBC mode) */
+    const KEY* tweak_key;       /**< Key schedule for encryption of tweaks (XTS only) */
+    const unsigned char* iv;    /**< IV (CTR_IV_SIZE bytes for CTR, a block for CBC, a block per sector for CBC sectors) */
+    unsigned long long offset;  /**< Number of the first block (CTR) or sector (XTS) */
+    size_t sector_size;         /**< Sector size in bytes (XTS and CBC sectors only, multiple of block size, at most XTS_MAX_SECTOR_SIZE for XTS) */
+    const unsigned char* in;    /**< Input buffer (not necessarily aligned) */
+    unsigned char* out;         /**< Output buffer (not necessarily aligned, may be equal to `in`) */
+    size_t length;              /**< Length in bytes (multiple of block size for ECB and CBC, of sector size for sectors) */
+} BULK_REQUEST;
+
+
+/**
+ * @brief Bulk engine (a thread pool), opaque type.
+ */
+typedef struct tagBULK_ENGINE BULK_ENGINE;
+
+
+/**
+ * @brief Creates bulk engine.
+ * 
+ * @param threads_count Number of threads including calling one (0 means number of CPUs)
+ * @return Engine or NULL on failure
+ */
+BULK_ENGINE* bulk_create(size_t threads_count);
+
+
+/**
+ * @brief Destroys bulk engine and stops its threads.
+ * 
+ * @param engine Engine created with bulk_create
+ */
+void bulk_destroy(BULK_ENGINE* engine);
+
+
+/**
+ * @brief Gets number of threads used by an engine (including calling thread).
+ * 
+ * @param engine Engine created with bulk_create
+ * @return Number of threads
+ */
+size_t bulk_threads_count(const BULK_ENGINE* engine);
+
+
+/**
+ * @brief Processes a request. Data is split into chunks of BULK_CHUNK_SIZE
+ *        bytes, which are processed by all threads of the engine (calling 
+ *        thread participates too). Results are identical to serial processing.
+ *        Requests to a single engine are serialized.
+ * 
+ * @param engine Engine created with bulk_create
+ * @param request Request to process
+ * @return Non-zero on success, zero if sector size or length is invalid for 
+ *         the mode (nothing is processed)
+ */
+int bulk_process(BULK_ENGINE* engine, const BULK_REQUEST* request);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_BULK_INCLUDED
@@ -0,0 +1,89 @@
+/**
+ * @file aes.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief AES block cipher (FIPS 197) with AES-NI
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_AES_INCLUDED
+#define BCLIB_AES_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief AES block size in bytes.
+ */
+#define AES_BLOCK_SIZE 16
+
+
+/**
+ * @brief AES-128 key size in bytes.
+ */
+#define AES128_KEY_SIZE 16
+
+
+/**
+ * @brief AES-256 key size in bytes.
+ */
+#define AES256_KEY_SIZE 32
+
+
+/**
+ * @brief AES implementations (engines). Engines differ in multi-block
+ *        procedures only and share key schedule format.
+ */
+typedef enum tagAES_ENGINE
+{
+    AES_ENGINE_AESNI, /**< AES-NI engine (8 interleaved blocks) */
+    AES_ENGINE_VAES   /**< VAES engine with AVX-512 (4 blocks per register, 16 blocks at once) */
+} AES_ENGINE;
+
+
+/**
+ * @brief Checks if CPU supports an engine.
+ * 
+ * @param engine Engine to check.
+ * @return Non-zero if engine can be used, zero otherwise.
+ */
+int aes_engine_supported(AES_ENGINE engine);
+
+
+/**
+ * @brief Initializes block cipher interface for AES with the fastest
+ *        engine supported by CPU. Requires AES-NI.
+ * 
+ * @param cipher Block cipher interface to be initialized.
+ * @param key_size Key size: AES128_KEY_SIZE or AES256_KEY_SIZE.
+ * @return Non-zero on success, zero if key size is not supported 
+ *         or CPU doesn't support AES-NI (interface is not initialized).
+ */
+int aes_initialize_interface(BLOCK_CIPHER* cipher, size_t key_size);
+
+
+/**
+ * @brief Initializes block cipher interface for AES with a specific engine.
+ *        Note, that engine support by CPU is NOT verified (use aes_engine_supported).
+ * 
+ * @param cipher Block cipher interface to be initialized.
+ * @param key_size Key size: AES128_KEY_SIZE or AES256_KEY_SIZE.
+ * @param engine Engine to use.
+ * @return Non-zero on success, zero if key size is not supported 
+ *         (interface is not initialized).
+ */
+int aes_initialize_interface_ex(BLOCK_CIPHER* cipher, size_t key_size, AES_ENGINE engine);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_AES_INCLUDED
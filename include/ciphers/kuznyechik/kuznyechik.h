@@ -32,13 +32,80 @@ extern "C" {
 
 
 /**
- * @brief Initializes block cipher interface for Kuznyechik.
+ * @brief Kuznyechik implementations (engines). Engines differ in multi-block
+ *        procedures only and share key schedule format, hence keys are
+ *        compatible between engines.
+ * 
+ * Key schedule references lookup tables by pointer, so a KEY is valid only
+ * in the process, that derived it (and only while NUMA replica, it is bound
+ * to, exists). Zeroed key schedules fall back to static tables.
+ */
+typedef enum tagKUZNYECHIK_ENGINE
+{
+    KUZNYECHIK_ENGINE_GENERIC,       /**< SSE2 lookup tables engine */
+    KUZNYECHIK_ENGINE_AVX2,          /**< AVX2 lookup tables engine (2 blocks per register) */
+    KUZNYECHIK_ENGINE_AVX512,        /**< AVX-512 (F, BW, VBMI) and GFNI engine (4 blocks per register) */
+    KUZNYECHIK_ENGINE_CONSTANT_TIME, /**< Constant-time byte-sliced AVX2 engine (32 blocks at once), no data-dependent memory accesses */
+    KUZNYECHIK_ENGINE_COMPACT        /**< SSE2 engine with compact (about 17 KB in total) L1-resident lookup tables */
+} KUZNYECHIK_ENGINE;
+
+
+/**
+ * @brief Environment variable, that forces an engine selected by 
+ *        `kuznyechik_select_engine` (e.g. for benchmarking). Values are
+ *        `generic`, `avx2`, `avx512`, `constant-time` and `compact`.
+ *        Engines, that are not supported by CPU, are ignored.
+ */
+#define KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE "BCLIB_KUZNYECHIK_ENGINE"
+
+
+/**
+ * @brief Checks if CPU (and OS) supports an engine.
+ * 
+ * @param engine Engine to check.
+ * @return Nonzero if engine can be used.
+ */
+int kuznyechik_engine_supported(KUZNYECHIK_ENGINE engine);
+
+
+/**
+ * @brief Selects the fastest engine supported by CPU, unless another one is
+ *        forced with KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE.
+ * 
+ * @return Selected engine.
+ */
+KUZNYECHIK_ENGINE kuznyechik_select_engine(void);
+
+
+/**
+ * @brief Initializes block cipher interface for Kuznyechik with an engine
+ *        selected by `kuznyechik_select_engine`.
  * 
  * @param cipher Block cipher interface to be initialized.
  */
 void kuznyechik_initialize_interface(BLOCK_CIPHER* cipher);
 
 
+/**
+ * @brief Initializes block cipher interface for Kuznyechik with a specific engine.
+ *        Note, that engine support by CPU is NOT verified.
+ * 
+ * @param cipher Block cipher interface to be initialized.
+ * @param engine Engine to use.
+ */
+void kuznyechik_initialize_interface_ex(BLOCK_CIPHER* cipher, KUZNYECHIK_ENGINE engine);
+
+
+/**
+ * @brief Prefetches lookup tables referenced by a key schedule (and the schedule 
+ *        itself) into cache. Call it before a latency-sensitive request after
+ *        idle, so the first blocks do not pay for cache and TLB misses.
+ * 
+ * @param round_keys Key schedule (encryption or decryption one)
+ */
+void kuznyechik_warm_up(const KEY* round_keys);
+
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
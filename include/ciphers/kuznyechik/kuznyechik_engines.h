@@ -0,0 +1,108 @@
+/**
+ * @file kuznyechik_engines.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Procedures of Kuznyechik engines for static binding
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_KUZNYECHIK_ENGINES_INCLUDED
+#define BCLIB_KUZNYECHIK_ENGINES_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+//
+// These are the procedures, which `kuznyechik_initialize_interface_ex` puts 
+// into a dispatch table. They may be called directly, if engine is known at 
+// compile time (e.g. by C++ front end), but caller is responsible for checking
+// `kuznyechik_engine_supported` in this case. Key schedules are the same for
+// all engines (constant-time and compact engines compute them without large 
+// lookup tables, but the result is identical). Multi-block procedures accept 
+// unaligned memory and `in` may be equal to `out`
+//
+
+
+//
+// Number of blocks processed by multi-block procedures of engines at once 
+// (the remainder is processed by a narrower path). The same value is put
+// into `interleave` field of dispatch table
+//
+
+#define KUZNYECHIK_GENERIC_INTERLEAVE       4
+#define KUZNYECHIK_AVX2_INTERLEAVE          8
+#define KUZNYECHIK_AVX512_INTERLEAVE        8
+#define KUZNYECHIK_CONSTANT_TIME_INTERLEAVE 32
+#define KUZNYECHIK_COMPACT_INTERLEAVE       4
+
+
+//
+// Generic (SSE2) engine
+//
+
+void kuznyechik_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void kuznyechik_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void kuznyechik_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_initialize_encrypt_key(const unsigned char* key, KEY* round_keys);
+void kuznyechik_initialize_decrypt_key(const unsigned char* key, KEY* round_keys);
+void kuznyechik_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+void kuznyechik_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count);
+
+
+//
+// AVX2 engine (2 blocks per register)
+//
+
+void kuznyechik_avx2_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_avx2_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+
+
+//
+// AVX-512 and GFNI engine (4 blocks per register)
+//
+
+void kuznyechik_avx512_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_avx512_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+
+
+//
+// Constant-time byte-sliced AVX2 engine (32 blocks at once)
+//
+
+void kuznyechik_sliced_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void kuznyechik_sliced_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void kuznyechik_sliced_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_sliced_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_sliced_initialize_encrypt_key(const unsigned char* key, KEY* round_keys);
+void kuznyechik_sliced_initialize_decrypt_key(const unsigned char* key, KEY* round_keys);
+void kuznyechik_sliced_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+void kuznyechik_sliced_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count);
+
+
+//
+// Compact (L1-resident) tables engine
+//
+
+void kuznyechik_compact_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void kuznyechik_compact_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void kuznyechik_compact_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_compact_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void kuznyechik_compact_initialize_encrypt_key(const unsigned char* key, KEY* round_keys);
+void kuznyechik_compact_initialize_decrypt_key(const unsigned char* key, KEY* round_keys);
+void kuznyechik_compact_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+void kuznyechik_compact_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_KUZNYECHIK_ENGINES_INCLUDED
@@ -0,0 +1,93 @@
+/**
+ * @file kuznyechik_numa.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief NUMA node local replicas of Kuznyechik lookup tables (user mode only)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_KUZNYECHIK_NUMA_INCLUDED
+#define BCLIB_KUZNYECHIK_NUMA_INCLUDED
+
+
+#include "ciphers/kuznyechik/kuznyechik.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Maximal number of NUMA nodes with table replicas. Keys for 
+ *        nodes beyond this limit use static tables.
+ */
+#define KUZNYECHIK_NUMA_MAX_NODES 8
+
+
+/**
+ * @brief Allocates a replica of lookup tables (192 KB) on every NUMA node.
+ *        Each replica is placed into a single 2 MB huge page if the system
+ *        has free ones, otherwise transparent huge pages are requested. 
+ *        Subsequent calls do nothing.
+ * 
+ * @return Number of nodes with replicas, 0 on failure.
+ */
+unsigned int kuznyechik_numa_create_replicas(void);
+
+
+/**
+ * @brief Frees replicas. Keys bound to replicas MUST NOT be used afterwards,
+ *        unless they are rebound with kuznyechik_numa_bind_keys (which uses
+ *        static tables, when there are no replicas).
+ */
+void kuznyechik_numa_destroy_replicas(void);
+
+
+/**
+ * @brief Checks if a replica is placed into an explicitly allocated huge page.
+ * 
+ * @param node NUMA node
+ * @return Nonzero if replica exists and is backed by a huge page.
+ */
+int kuznyechik_numa_huge_pages(unsigned int node);
+
+
+/**
+ * @brief Gets NUMA node of a CPU, the calling thread is running on.
+ * 
+ * @return NUMA node (0 if it cannot be determined).
+ */
+unsigned int kuznyechik_numa_current_node(void);
+
+
+/**
+ * @brief Binds key schedules to a replica of a node. If there is no replica for 
+ *        the node, static tables are used.
+ * 
+ * @param round_keys Key schedules
+ * @param keys_count Number of key schedules
+ * @param node NUMA node
+ */
+void kuznyechik_numa_bind_keys(KEY* round_keys, size_t keys_count, unsigned int node);
+
+
+/**
+ * @brief Initializes block cipher interface for Kuznyechik, which key setup 
+ *        procedures bind key schedules to a replica of a node. Threads running
+ *        on the node should use such an interface. Note, that engine support 
+ *        by CPU is NOT verified.
+ * 
+ * @param cipher Block cipher interface to be initialized.
+ * @param engine Engine to use (constant-time and compact engines do not use replicated tables).
+ * @param node NUMA node
+ */
+void kuznyechik_numa_initialize_interface(BLOCK_CIPHER* cipher, KUZNYECHIK_ENGINE engine, unsigned int node);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_KUZNYECHIK_NUMA_INCLUDED
@@ -0,0 +1,68 @@
+/**
+ * @file magma.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Magma block cipher (GOST 34.12-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_MAGMA_INCLUDED
+#define BCLIB_MAGMA_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Magma block size in bytes.
+ */
+#define MAGMA_BLOCK_SIZE 8
+
+
+/**
+ * @brief Magma key size in bytes.
+ */
+#define MAGMA_KEY_SIZE 32
+
+
+/**
+ * @brief Magma implementations (engines). Engines differ in multi-block
+ *        procedures only and share key schedule format.
+ */
+typedef enum tagMAGMA_ENGINE
+{
+    MAGMA_ENGINE_GENERIC, /**< Portable engine (4 interleaved blocks) */
+    MAGMA_ENGINE_AVX2     /**< AVX2 engine (halves of 8 blocks per register, S-boxes with byte shuffles) */
+} MAGMA_ENGINE;
+
+
+/**
+ * @brief Initializes block cipher interface for Magma with the fastest
+ *        engine supported by CPU.
+ * 
+ * @param cipher Block cipher interface to be initialized.
+ */
+void magma_initialize_interface(BLOCK_CIPHER64* cipher);
+
+
+/**
+ * @brief Initializes block cipher interface for Magma with a specific engine.
+ *        Note, that engine support by CPU is NOT verified.
+ * 
+ * @param cipher Block cipher interface to be initialized.
+ * @param engine Engine to use.
+ */
+void magma_initialize_interface_ex(BLOCK_CIPHER64* cipher, MAGMA_ENGINE engine);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_MAGMA_INCLUDED
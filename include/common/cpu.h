@@ -0,0 +1,55 @@
+/**
+ * @file cpu.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CPU features detection for runtime engine selection
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_CPU_INCLUDED
+#define BCLIB_CPU_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief CPU features (bit flags). Extensions with wide registers are reported
+ *        only if OS saves their state on context switches.
+ */
+#define CPU_FEATURE_SSE2       0x0001u /**< SSE2 */
+#define CPU_FEATURE_SSSE3      0x0002u /**< SSSE3 */
+#define CPU_FEATURE_PCLMUL     0x0004u /**< PCLMULQDQ */
+#define CPU_FEATURE_AESNI      0x0008u /**< AES-NI */
+#define CPU_FEATURE_AVX2       0x0010u /**< AVX2 */
+#define CPU_FEATURE_AVX512F    0x0020u /**< AVX-512 Foundation */
+#define CPU_FEATURE_AVX512BW   0x0040u /**< AVX-512 Byte and Word */
+#define CPU_FEATURE_AVX512VBMI 0x0080u /**< AVX-512 Vector Byte Manipulation */
+#define CPU_FEATURE_GFNI       0x0100u /**< Galois Field New Instructions */
+#define CPU_FEATURE_VAES       0x0200u /**< Vector AES */
+
+
+/**
+ * @brief Queries CPU features. CPUID is executed once, then result is cached.
+ * 
+ * @return Combination of CPU_FEATURE_* flags.
+ */
+unsigned int cpu_features(void);
+
+
+/**
+ * @brief Checks if CPU supports all required features.
+ * 
+ * @param required Combination of CPU_FEATURE_* flags.
+ * @return Nonzero if all features are supported.
+ */
+int cpu_supports(unsigned int required);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_CPU_INCLUDED
@@ -0,0 +1,119 @@
+/**
+ * @file instrumentation.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Optional instrumentation of cipher calls (per-thread counters)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_INSTRUMENTATION_INCLUDED
+#define BCLIB_INSTRUMENTATION_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Number of latency histogram buckets. Bucket `i` counts calls,
+ *        that took [2^i, 2^(i+1)) cycles, the last one counts all longer calls.
+ */
+#define INSTRUMENTATION_HISTOGRAM_SIZE 32
+
+
+/**
+ * @brief Instrumented events.
+ */
+typedef enum tagINSTRUMENTATION_EVENT
+{
+    INSTRUMENTATION_EVENT_ENCRYPT_BLOCK,  /**< Single block encryption */
+    INSTRUMENTATION_EVENT_DECRYPT_BLOCK,  /**< Single block decryption */
+    INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS, /**< Multiple blocks encryption */
+    INSTRUMENTATION_EVENT_DECRYPT_BLOCKS, /**< Multiple blocks decryption */
+    INSTRUMENTATION_EVENT_KEY_SETUP,      /**< Round keys derivation (blocks are keys here) */
+    INSTRUMENTATION_EVENT_COUNT           /**< Number of events */
+} INSTRUMENTATION_EVENT;
+
+
+/**
+ * @brief Instrumented engines. Single block procedures and key setup, that are
+ *        shared between engines, are accounted to a generic (or AES-NI) engine.
+ */
+typedef enum tagINSTRUMENTATION_ENGINE
+{
+    INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC,       /**< Kuznyechik, lookup tables */
+    INSTRUMENTATION_ENGINE_KUZNYECHIK_AVX2,          /**< Kuznyechik, AVX2 */
+    INSTRUMENTATION_ENGINE_KUZNYECHIK_AVX512,        /**< Kuznyechik, AVX-512 */
+    INSTRUMENTATION_ENGINE_KUZNYECHIK_CONSTANT_TIME, /**< Kuznyechik, byte-sliced */
+    INSTRUMENTATION_ENGINE_KUZNYECHIK_COMPACT,       /**< Kuznyechik, compact tables */
+    INSTRUMENTATION_ENGINE_MAGMA_GENERIC,            /**< Magma, lookup tables */
+    INSTRUMENTATION_ENGINE_MAGMA_AVX2,               /**< Magma, AVX2 */
+    INSTRUMENTATION_ENGINE_AES_AESNI,                /**< AES, AES-NI */
+    INSTRUMENTATION_ENGINE_AES_VAES,                 /**< AES, VAES */
+    INSTRUMENTATION_ENGINE_COUNT                     /**< Number of engines */
+} INSTRUMENTATION_ENGINE;
+
+
+/**
+ * @brief Counters of a single (engine, event) pair.
+ */
+typedef struct tagINSTRUMENTATION_COUNTERS
+{
+    unsigned long long calls;                                     /**< Number of calls */
+    unsigned long long blocks;                                    /**< Number of processed blocks (keys) */
+    unsigned long long cycles;                                    /**< Total time stamp counter delta */
+    unsigned long long histogram[INSTRUMENTATION_HISTOGRAM_SIZE]; /**< Calls latency histogram (log2 of cycles) */
+} INSTRUMENTATION_COUNTERS;
+
+
+/**
+ * @brief All counters.
+ */
+typedef struct tagINSTRUMENTATION_STATISTICS
+{
+    INSTRUMENTATION_COUNTERS counters[INSTRUMENTATION_ENGINE_COUNT][INSTRUMENTATION_EVENT_COUNT];
+} INSTRUMENTATION_STATISTICS;
+
+
+/**
+ * @brief Checks if library is built with instrumentation 
+ *        (BCLIB_ENABLE_INSTRUMENTATION CMake option).
+ * 
+ * @return Nonzero if instrumentation is compiled in. Otherwise
+ *         all counters are always zero.
+ */
+int instrumentation_enabled(void);
+
+
+/**
+ * @brief Sums counters of all threads, that have ever called instrumented 
+ *        procedures. Counters of running threads are read atomically one
+ *        by one, hence the sum may miss calls finished during the query.
+ * 
+ * @param statistics Output statistics
+ */
+void instrumentation_query(INSTRUMENTATION_STATISTICS* statistics);
+
+
+/**
+ * @brief Reads counters of the calling thread only.
+ * 
+ * @param statistics Output statistics
+ */
+void instrumentation_query_thread(INSTRUMENTATION_STATISTICS* statistics);
+
+
+/**
+ * @brief Resets counters of all threads. May be called while other threads
+ *        use the library: their counters are not modified, current values
+ *        are subtracted from subsequent queries instead.
+ */
+void instrumentation_reset(void);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_INSTRUMENTATION_INCLUDED
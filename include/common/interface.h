@@ -13,6 +13,7 @@
 
 #include "common/utils.h"
 #include <emmintrin.h>
+#include <stddef.h>
 
 
 #ifdef __cplusplus
@@ -25,11 +26,14 @@ extern "C" {
  *        here is in expanded form, hence it is larger,
  *        than in standards and documentation.
  */
-#define MAX_KEY_SIZE 160  // Kuznyechik
+#define MAX_KEY_SIZE 240  // AES-256 (Kuznyechik needs 192: round keys and lookup table pointers)
 
 
 /**
- * @brief Generic key representation.
+ * @brief Generic key representation. Key schedule may reference data of
+ *        the process, that derived it (e.g. lookup tables), hence it is
+ *        valid in this process only: it MUST NOT be stored or passed to
+ *        another process, binary key should be expanded there again.
  */
 typedef struct tagKEY
 {
@@ -69,6 +73,40 @@ typedef struct tagKEY
                           block_type* out)
 
 
+/**
+ * @brief Multiple blocks encryption procedure. Blocks are processed
+ *        independently (ECB), so implementations are free to interleave
+ *        them internally.
+ *
+ * @param in Plaintext blocks (not necessarily aligned)
+ * @param round_keys Initialized key schedule for encryption
+ * @param out Ciphertext blocks (not necessarily aligned, may be equal to `in`)
+ * @param blocks_count Number of blocks to encrypt
+ */
+#define BCLIB_ENCRYPT_BLOCKS(block_type)          \
+    void (*encrypt_blocks)(const block_type* in,  \
+                           const KEY* round_keys, \
+                           block_type* out,       \
+                           size_t blocks_count)
+
+
+/**
+ * @brief Multiple blocks decryption procedure. Blocks are processed
+ *        independently (ECB), so implementations are free to interleave
+ *        them internally.
+ *
+ * @param in Ciphertext blocks (not necessarily aligned)
+ * @param round_keys Initialized key schedule for decryption
+ * @param out Plaintext blocks (not necessarily aligned, may be equal to `in`)
+ * @param blocks_count Number of blocks to decrypt
+ */
+#define BCLIB_DECRYPT_BLOCKS(block_type)          \
+    void (*decrypt_blocks)(const block_type* in,  \
+                           const KEY* round_keys, \
+                           block_type* out,       \
+                           size_t blocks_count)
+
+
 /**
  * @brief Encryption key schedule initialization procedure.
  *
@@ -91,6 +129,36 @@ typedef struct tagKEY
                                    KEY* round_keys)
 
 
+/**
+ * @brief Initialization of both encryption and decryption key schedules
+ *        with a single key expansion.
+ * 
+ * @param key Binary key representation
+ * @param encrypt_round_keys Key schedule for encryption to initialize
+ * @param decrypt_round_keys Key schedule for decryption to initialize
+ */
+#define BCLIB_INIT_KEYS()                             \
+    void (*initialize_keys)(const unsigned char* key, \
+                            KEY* encrypt_round_keys,  \
+                            KEY* decrypt_round_keys)
+
+
+/**
+ * @brief Initialization of key schedules for several keys at once. Independent 
+ *        key expansions are interleaved, so it is faster than a loop.
+ * 
+ * @param keys Binary keys representations (`keys_count` keys of `key_size` bytes one after another)
+ * @param encrypt_round_keys Array of `keys_count` key schedules for encryption to initialize
+ * @param decrypt_round_keys Array of `keys_count` key schedules for decryption to initialize (may be NULL)
+ * @param keys_count Number of keys
+ */
+#define BCLIB_INIT_KEYS_BATCH()                              \
+    void (*initialize_keys_batch)(const unsigned char* keys, \
+                                  KEY* encrypt_round_keys,   \
+                                  KEY* decrypt_round_keys,   \
+                                  size_t keys_count)
+
+
 /**
  * @brief Defines a block cipher dispatch table.
  * 
@@ -98,16 +166,21 @@ typedef struct tagKEY
  * dispatch tables intentionally to allow implementing algorithms with 
  * high performance for research purposes.
  */
-#define BCLIB_DEFINE_CIPHER_TABLE(name, block_type)                                               \
-    typedef struct tag##name                                                                      \
-    {                                                                                             \
-        unsigned char block_size; /**< Block size in bytes */                                     \
-        unsigned char key_size;   /**< Key size in bytes */                                       \
-                                                                                                  \
-        BCLIB_ENCRYPT_BLOCK(block_type); /**< Block encryption procedure */                       \
-        BCLIB_DECRYPT_BLOCK(block_type); /**< Block decryption procedure */                       \
-        BCLIB_INIT_ENCRYPT_KEY();        /**< Encryption key schedule initialization procedure */ \
-        BCLIB_INIT_DECRYPT_KEY();        /**< Decryption key schedule initialization procedure */ \
+#define BCLIB_DEFINE_CIPHER_TABLE(name, block_type)                                                \
+    typedef struct tag##name                                                                       \
+    {                                                                                              \
+        unsigned char block_size;         /**< Block size in bytes */                              \
+        unsigned char key_size;           /**< Key size in bytes */                                \
+        unsigned char interleave;         /**< Blocks processed at once by multi-block calls */    \
+                                                                                                   \
+        BCLIB_ENCRYPT_BLOCK(block_type);  /**< Block encryption procedure */                       \
+        BCLIB_DECRYPT_BLOCK(block_type);  /**< Block decryption procedure */                       \
+        BCLIB_ENCRYPT_BLOCKS(block_type); /**< Multiple blocks encryption procedure */             \
+        BCLIB_DECRYPT_BLOCKS(block_type); /**< Multiple blocks decryption procedure */             \
+        BCLIB_INIT_ENCRYPT_KEY();         /**< Encryption key schedule initialization procedure */ \
+        BCLIB_INIT_DECRYPT_KEY();         /**< Decryption key schedule initialization procedure */ \
+        BCLIB_INIT_KEYS();                /**< Initialization of both key schedules at once */     \
+        BCLIB_INIT_KEYS_BATCH();          /**< Batch key schedules initialization procedure */     \
     } name
 
 
@@ -116,6 +189,13 @@ typedef struct tagKEY
  */
 BCLIB_DEFINE_CIPHER_TABLE(BLOCK_CIPHER, __m128i);
 
+
+/**
+ * @brief 64-bit block cipher dispatch table (block is held in memory 
+ *        byte order, as in standards).
+ */
+BCLIB_DEFINE_CIPHER_TABLE(BLOCK_CIPHER64, unsigned long long);
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -0,0 +1,37 @@
+/**
+ * @file iov.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Scatter-gather lists
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_IOV_INCLUDED
+#define BCLIB_IOV_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Segment of a scatter-gather list. Layout matches POSIX `struct iovec`,
+ *        so an array of `struct iovec` can be passed with a pointer cast.
+ *        Segments may have arbitrary lengths (including zero) and alignment,
+ *        hence a block or a sector may straddle segment boundaries.
+ */
+typedef struct tagIOVEC
+{
+    void* iov_base; /**< Segment start */
+    size_t iov_len; /**< Segment length in bytes */
+} IOVEC;
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_IOV_INCLUDED
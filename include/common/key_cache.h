@@ -0,0 +1,142 @@
+/**
+ * @file key_cache.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Bounded thread-safe cache of expanded key schedules
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_KEY_CACHE_INCLUDED
+#define BCLIB_KEY_CACHE_INCLUDED
+
+#include "common/interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Number of entries in each cache set. Cache is set-associative:
+ *        key identifier selects a set, and the least recently used entry
+ *        of the set is evicted.
+ */
+#define KEY_CACHE_WAYS 4
+
+
+/**
+ * @brief Number of sets necessary to hold `capacity` keys.
+ */
+#define KEY_CACHE_SETS_COUNT(capacity) (((capacity) + KEY_CACHE_WAYS - 1) / KEY_CACHE_WAYS)
+
+
+/**
+ * @brief Cached key schedules.
+ */
+typedef struct tagKEY_CACHE_ENTRY
+{
+    KEY encrypt_round_keys;       /**< Key schedule for encryption */
+    KEY decrypt_round_keys;       /**< Key schedule for decryption */
+    unsigned long long key_id;    /**< Key identifier */
+    unsigned long long last_use;  /**< Value of set clock at the last access */
+    unsigned char valid;          /**< Non-zero if entry is occupied */
+} KEY_CACHE_ENTRY;
+
+
+/**
+ * @brief Cache set. Each set is protected by its own spin lock.
+ */
+typedef struct tagKEY_CACHE_SET
+{
+    KEY_CACHE_ENTRY entries[KEY_CACHE_WAYS]; /**< Entries of the set */
+    unsigned long long clock;                /**< Access counter for LRU policy */
+    volatile long lock;                      /**< Spin lock */
+} KEY_CACHE_SET;
+
+
+/**
+ * @brief Cache of expanded key schedules. Storage is provided by caller,
+ *        so the cache is usable in kernel mode too. Cached schedules are
+ *        valid in the process, that filled the cache, only (see KEY), so
+ *        storage MUST NOT be shared with other processes or persisted.
+ */
+typedef struct tagKEY_CACHE
+{
+    const BLOCK_CIPHER* cipher; /**< Cipher used to expand keys on cache misses */
+    KEY_CACHE_SET* sets;        /**< Cache sets */
+    size_t sets_count;          /**< Number of sets */
+} KEY_CACHE;
+
+
+/**
+ * @brief Initializes an empty cache.
+ * 
+ * @param cache Cache to initialize
+ * @param cipher Initialized block cipher interface (must outlive the cache)
+ * @param sets Storage for cache sets (must outlive the cache)
+ * @param sets_count Number of sets (see KEY_CACHE_SETS_COUNT), must be non-zero
+ */
+void key_cache_initialize(KEY_CACHE* cache, const BLOCK_CIPHER* cipher, KEY_CACHE_SET* sets, size_t sets_count);
+
+
+/**
+ * @brief Looks a key up in the cache and copies its schedules.
+ * 
+ * @param cache Initialized cache
+ * @param key_id Key identifier
+ * @param encrypt_round_keys Where to copy encryption key schedule (may be NULL)
+ * @param decrypt_round_keys Where to copy decryption key schedule (may be NULL)
+ * @return Non-zero if key is found, zero otherwise
+ */
+int key_cache_lookup(KEY_CACHE* cache, unsigned long long key_id, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+
+
+/**
+ * @brief Inserts (or replaces) key schedules into the cache. If the set is full,
+ *        its least recently used entry is evicted and wiped.
+ * 
+ * @param cache Initialized cache
+ * @param key_id Key identifier
+ * @param encrypt_round_keys Encryption key schedule
+ * @param decrypt_round_keys Decryption key schedule
+ */
+void key_cache_insert(KEY_CACHE* cache, unsigned long long key_id, const KEY* encrypt_round_keys, const KEY* decrypt_round_keys);
+
+
+/**
+ * @brief Gets key schedules from the cache. On cache miss the key is expanded 
+ *        using `initialize_keys` of the cipher and inserted into the cache.
+ * 
+ * @param cache Initialized cache
+ * @param key_id Key identifier
+ * @param key Binary key representation (used on cache miss only)
+ * @param encrypt_round_keys Where to copy encryption key schedule
+ * @param decrypt_round_keys Where to copy decryption key schedule
+ * @return Non-zero on cache hit, zero on cache miss
+ */
+int key_cache_get(KEY_CACHE* cache, unsigned long long key_id, const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+
+
+/**
+ * @brief Removes a key from the cache and wipes its schedules.
+ * 
+ * @param cache Initialized cache
+ * @param key_id Key identifier
+ */
+void key_cache_remove(KEY_CACHE* cache, unsigned long long key_id);
+
+
+/**
+ * @brief Removes all keys from the cache and wipes their schedules.
+ * 
+ * @param cache Initialized cache
+ */
+void key_cache_clear(KEY_CACHE* cache);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_KEY_CACHE_INCLUDED
@@ -24,12 +24,54 @@
 
 
 /**
- * @brief Force inlining specifier.
+ * @brief Force inlining specifier. It implies `inline` (GCC warns about
+ *        always_inline functions, which are not declared inline).
  */
 #if defined(_MSC_VER)
 #   define BCLIB_FORCEINLINE __forceinline
 #elif defined(__GNUC__)
-#   define BCLIB_FORCEINLINE __attribute__((always_inline))
+#   define BCLIB_FORCEINLINE __attribute__((always_inline)) inline
+#else
+#   error Unsupported target for now
+#endif 
+
+
+/**
+ * @brief Byte order reversal of 64-bit integer.
+ */
+#if defined(_MSC_VER)
+#   define BCLIB_BSWAP64(x) _byteswap_uint64(x)
+#elif defined(__GNUC__)
+#   define BCLIB_BSWAP64(x) __builtin_bswap64(x)
+#else
+#   error Unsupported target for now
+#endif 
+
+
+/**
+ * @brief Spin lock primitives over `volatile long` (0 means unlocked).
+ */
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#   define BCLIB_SPIN_TRY_LOCK(lock) (_InterlockedExchange((lock), 1) == 0)
+#   define BCLIB_SPIN_UNLOCK(lock)   _InterlockedExchange((lock), 0)
+#   define BCLIB_SPIN_PAUSE()        _mm_pause()
+#elif defined(__GNUC__)
+#   define BCLIB_SPIN_TRY_LOCK(lock) (__sync_lock_test_and_set((lock), 1) == 0)
+#   define BCLIB_SPIN_UNLOCK(lock)   __sync_lock_release(lock)
+#   define BCLIB_SPIN_PAUSE()        __builtin_ia32_pause()
+#else
+#   error Unsupported target for now
+#endif 
+
+
+/**
+ * @brief Thread local storage specifier.
+ */
+#if defined(_MSC_VER)
+#   define BCLIB_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#   define BCLIB_THREAD_LOCAL __thread
 #else
 #   error Unsupported target for now
 #endif 
@@ -0,0 +1,107 @@
+/**
+ * @file cbc.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CBC mode of operation (GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_CBC_INCLUDED
+#define BCLIB_CBC_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief IV size of a sector in bytes for sector procedures (one block).
+ */
+#define CBC_SECTOR_IV_SIZE 16
+
+
+/**
+ * @brief Encrypts a buffer in CBC mode. Chapter 5.4 of GOST 34.13-2018
+ * 
+ * IV of z blocks forms z interleaved chains: block i is chained with 
+ * block i - z. Blocks of different chains are encrypted with a single 
+ * multi-block call, with one-block IV encryption is serial.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector
+ * @param iv_size Size of IV in bytes (non-zero multiple of block size)
+ * @param in Plaintext (not necessarily aligned)
+ * @param out Ciphertext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (multiple of block size)
+ * @return Non-zero on success, zero if IV size or length is invalid (nothing is processed)
+ */
+int cbc_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Decrypts a buffer in CBC mode. Chapter 5.4 of GOST 34.13-2018
+ * 
+ * Decryption has no chain dependency, so all blocks are decrypted
+ * with multi-block calls regardless of IV size.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for decryption
+ * @param iv Initialization vector
+ * @param iv_size Size of IV in bytes (non-zero multiple of block size)
+ * @param in Ciphertext (not necessarily aligned)
+ * @param out Plaintext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (multiple of block size)
+ * @return Non-zero on success, zero if IV size or length is invalid (nothing is processed)
+ */
+int cbc_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Encrypts consecutive sectors in CBC mode, each one with its own IV
+ *        (e.g. ESSIV). 
+ * 
+ * Chains of several sectors are advanced in lockstep: one block of each
+ * sector is encrypted with a single multi-block call.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param ivs IVs of sectors, CBC_SECTOR_IV_SIZE bytes each
+ * @param sector_size Sector size in bytes (non-zero multiple of block size)
+ * @param sectors_count Number of sectors to encrypt
+ * @param in Plaintext sectors (not necessarily aligned)
+ * @param out Ciphertext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int cbc_encrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* ivs, size_t sector_size,
+                        size_t sectors_count, const unsigned char* in, unsigned char* out);
+
+
+/**
+ * @brief Decrypts consecutive sectors in CBC mode, each one with its own IV.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for decryption
+ * @param ivs IVs of sectors, CBC_SECTOR_IV_SIZE bytes each
+ * @param sector_size Sector size in bytes (non-zero multiple of block size)
+ * @param sectors_count Number of sectors to decrypt
+ * @param in Ciphertext sectors (not necessarily aligned)
+ * @param out Plaintext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int cbc_decrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* ivs, size_t sector_size,
+                        size_t sectors_count, const unsigned char* in, unsigned char* out);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_CBC_INCLUDED
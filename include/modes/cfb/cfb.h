@@ -0,0 +1,138 @@
+/**
+ * @file cfb.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CFB mode of operation (GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_CFB_INCLUDED
+#define BCLIB_CFB_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Maximal IV size in bytes for streaming procedures (four blocks).
+ */
+#define CFB_MAX_STREAM_IV_SIZE 64
+
+
+/**
+ * @brief Size of streaming context in bytes.
+ */
+#define CFB_CONTEXT_SIZE 160
+
+
+/**
+ * @brief Streaming context of CFB mode (opaque).
+ */
+typedef struct tagCFB_CONTEXT
+{
+    BCLIB_ALIGN16 unsigned char context[CFB_CONTEXT_SIZE]; /**< Opaque state */
+} CFB_CONTEXT;
+
+
+/**
+ * @brief Encrypts a buffer in CFB mode. Chapter 5.5 of GOST 34.13-2018
+ * 
+ * Segment size equals to block size. IV of z blocks forms z interleaved 
+ * chains: keystream of block i is encryption of ciphertext block i - z, 
+ * hence z blocks are encrypted with a single multi-block call.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector
+ * @param iv_size Size of IV in bytes (non-zero multiple of block size)
+ * @param in Plaintext (not necessarily aligned)
+ * @param out Ciphertext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (arbitrary, the last block is truncated)
+ * @return Non-zero on success, zero if IV size is invalid (nothing is processed)
+ */
+int cfb_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Decrypts a buffer in CFB mode. Chapter 5.5 of GOST 34.13-2018
+ * 
+ * Decryption has no chain dependency, so all blocks are processed
+ * with multi-block calls regardless of IV size.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption (CFB uses encryption only)
+ * @param iv Initialization vector
+ * @param iv_size Size of IV in bytes (non-zero multiple of block size)
+ * @param in Ciphertext (not necessarily aligned)
+ * @param out Plaintext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (arbitrary, the last block is truncated)
+ * @return Non-zero on success, zero if IV size is invalid (nothing is processed)
+ */
+int cfb_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Starts streaming encryption in CFB mode. Cipher and key must 
+ *        outlive the context.
+ * 
+ * @param context Context to initialize
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector
+ * @param iv_size Size of IV in bytes (non-zero multiple of block size, 
+ *        at most CFB_MAX_STREAM_IV_SIZE)
+ * @return Non-zero on success, zero if IV size is invalid (context is not initialized)
+ */
+int cfb_encrypt_init(CFB_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                     size_t iv_size);
+
+
+/**
+ * @brief Starts streaming decryption in CFB mode. Cipher and key must 
+ *        outlive the context.
+ * 
+ * @param context Context to initialize
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption (CFB uses encryption only)
+ * @param iv Initialization vector
+ * @param iv_size Size of IV in bytes (non-zero multiple of block size, 
+ *        at most CFB_MAX_STREAM_IV_SIZE)
+ * @return Non-zero on success, zero if IV size is invalid (context is not initialized)
+ */
+int cfb_decrypt_init(CFB_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                     size_t iv_size);
+
+
+/**
+ * @brief Encrypts (or decrypts) the next chunk of data. Output of an
+ *        incomplete block is kept in context to continue the shift register.
+ * 
+ * @param context Initialized context
+ * @param in Input data (not necessarily aligned)
+ * @param out Output data (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (arbitrary)
+ */
+void cfb_update(CFB_CONTEXT* context, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Finishes streaming and wipes context.
+ * 
+ * @param context Initialized context
+ */
+void cfb_final(CFB_CONTEXT* context);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_CFB_INCLUDED
@@ -0,0 +1,117 @@
+/**
+ * @file cmac.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief MAC generation mode (CMAC/OMAC1, GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_CMAC_INCLUDED
+#define BCLIB_CMAC_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Maximal tag size in bytes.
+ */
+#define CMAC_MAX_TAG_SIZE 16
+
+
+/**
+ * @brief Size of streaming context in bytes.
+ */
+#define CMAC_CONTEXT_SIZE 96
+
+
+/**
+ * @brief Streaming context of CMAC (opaque).
+ */
+typedef struct tagCMAC_CONTEXT
+{
+    BCLIB_ALIGN16 unsigned char context[CMAC_CONTEXT_SIZE]; /**< Opaque state */
+} CMAC_CONTEXT;
+
+
+/**
+ * @brief Computes MAC of a message. Chapter 5.6 of GOST 34.13-2018
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param in Message (not necessarily aligned)
+ * @param length Length of message in bytes (arbitrary)
+ * @param tag Buffer for tag
+ * @param tag_size Tag size in bytes (from 1 to CMAC_MAX_TAG_SIZE, tag is a prefix of the full one)
+ * @return Non-zero on success, zero if tag size is invalid (nothing is computed)
+ */
+int cmac_compute(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* in, size_t length,
+                 unsigned char* tag, size_t tag_size);
+
+
+/**
+ * @brief Computes MACs of several independent messages with the same key. 
+ *        Chapter 5.6 of GOST 34.13-2018
+ * 
+ * Chain of a single message is serial, hence chains of several messages
+ * are advanced in lockstep: one block of each message is encrypted with
+ * a single multi-block call. When a message is finished, the next one
+ * takes its place, so messages may have different lengths.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param messages Array of messages (not necessarily aligned)
+ * @param lengths Array of lengths of messages in bytes
+ * @param messages_count Number of messages
+ * @param tags Buffer for tags (tag of i-th message starts at `tags + i * tag_size`)
+ * @param tag_size Tag size in bytes (from 1 to CMAC_MAX_TAG_SIZE, tag is a prefix of the full one)
+ * @return Non-zero on success, zero if tag size is invalid (nothing is computed)
+ */
+int cmac_compute_batch(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* const* messages,
+                       const size_t* lengths, size_t messages_count, unsigned char* tags, size_t tag_size);
+
+
+/**
+ * @brief Starts streaming MAC computation. Cipher and key must outlive 
+ *        the context.
+ * 
+ * @param context Context to initialize
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ */
+void cmac_init(CMAC_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key);
+
+
+/**
+ * @brief Absorbs the next chunk of message. The last (possibly complete) 
+ *        block is kept in context until it is known not to be the final one.
+ * 
+ * @param context Initialized context
+ * @param in Chunk of message (not necessarily aligned)
+ * @param length Length of chunk in bytes (arbitrary)
+ */
+void cmac_update(CMAC_CONTEXT* context, const unsigned char* in, size_t length);
+
+
+/**
+ * @brief Finishes MAC computation and wipes context.
+ * 
+ * @param context Initialized context
+ * @param tag Buffer for tag
+ * @param tag_size Tag size in bytes (from 1 to CMAC_MAX_TAG_SIZE, tag is a prefix of the full one)
+ * @return Non-zero on success, zero if tag size is invalid (context is wiped anyway)
+ */
+int cmac_final(CMAC_CONTEXT* context, unsigned char* tag, size_t tag_size);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_CMAC_INCLUDED
@@ -0,0 +1,158 @@
+/**
+ * @file ctr.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CTR mode of operation (GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_CTR_INCLUDED
+#define BCLIB_CTR_INCLUDED
+
+
+#include "common/interface.h"
+#include "common/iov.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Initialization vector size in bytes (a half of block).
+ */
+#define CTR_IV_SIZE 8
+
+
+/**
+ * @brief Size of streaming context in bytes.
+ */
+#define CTR_CONTEXT_SIZE 64
+
+
+/**
+ * @brief Streaming context of CTR mode (opaque).
+ */
+typedef struct tagCTR_CONTEXT
+{
+    BCLIB_ALIGN16 unsigned char context[CTR_CONTEXT_SIZE]; /**< Opaque state */
+} CTR_CONTEXT;
+
+
+/**
+ * @brief Encrypts a buffer in CTR mode. Chapter 5.2 of GOST 34.13-2018
+ * 
+ * Counter block is IV || 0 (most significant byte first) incremented 
+ * by one for each block. Keystream is generated for several counters 
+ * at once with a single multi-block call.
+ * 
+ * Processing may be started from an arbitrary block, hence a slice of
+ * a large buffer can be encrypted (or decrypted) without its prefix.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector of CTR_IV_SIZE bytes
+ * @param block_offset Number of the block, which `in` starts with
+ * @param in Input data (not necessarily aligned)
+ * @param out Output data (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (arbitrary, but only the last 
+ *               piece of a message may be not a multiple of block size)
+ */
+void ctr_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                 unsigned long long block_offset, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Decrypts a buffer in CTR mode. Chapter 5.2 of GOST 34.13-2018
+ * 
+ * Decryption is the same as encryption, encryption key schedule is used.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector of CTR_IV_SIZE bytes
+ * @param block_offset Number of the block, which `in` starts with
+ * @param in Input data (not necessarily aligned)
+ * @param out Output data (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes
+ */
+void ctr_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                 unsigned long long block_offset, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Encrypts a scatter-gather list in CTR mode. Blocks may straddle segment
+ *        boundaries, only such blocks are copied.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector of CTR_IV_SIZE bytes
+ * @param block_offset Number of the block, which data starts with
+ * @param in Input segments
+ * @param in_count Number of input segments
+ * @param out Output segments (may be the same as `in` for in-place encryption)
+ * @param out_count Number of output segments
+ * @param length Length of data in bytes (arbitrary)
+ * @return Non-zero on success, zero if any list is shorter than `length` (nothing is processed)
+ */
+int ctr_encrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, unsigned long long block_offset,
+                    const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count, size_t length);
+
+
+/**
+ * @brief Decrypts a scatter-gather list in CTR mode (the same as encryption).
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector of CTR_IV_SIZE bytes
+ * @param block_offset Number of the block, which data starts with
+ * @param in Input segments
+ * @param in_count Number of input segments
+ * @param out Output segments (may be the same as `in` for in-place decryption)
+ * @param out_count Number of output segments
+ * @param length Length of data in bytes (arbitrary)
+ * @return Non-zero on success, zero if any list is shorter than `length` (nothing is processed)
+ */
+int ctr_decrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, unsigned long long block_offset,
+                    const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count, size_t length);
+
+
+/**
+ * @brief Starts streaming encryption (or decryption) in CTR mode. Cipher 
+ *        and key must outlive the context, IV is copied into it.
+ * 
+ * @param context Context to initialize
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param iv Initialization vector of CTR_IV_SIZE bytes
+ * @param block_offset Number of the block, which data starts with
+ */
+void ctr_init(CTR_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+              unsigned long long block_offset);
+
+
+/**
+ * @brief Encrypts (or decrypts) the next chunk of data.
+ * 
+ * @param context Initialized context
+ * @param in Input data (not necessarily aligned)
+ * @param out Output data (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (arbitrary)
+ */
+void ctr_update(CTR_CONTEXT* context, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Finishes streaming and wipes context.
+ * 
+ * @param context Initialized context
+ */
+void ctr_final(CTR_CONTEXT* context);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_CTR_INCLUDED
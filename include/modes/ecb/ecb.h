@@ -0,0 +1,89 @@
+/**
+ * @file ecb.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief ECB mode of operation (GOST 34.13-2018) over byte buffers
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_ECB_INCLUDED
+#define BCLIB_ECB_INCLUDED
+
+
+#include "common/interface.h"
+#include "common/iov.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Encrypts blocks in ECB mode. Chapter 5.1 of GOST 34.13-2018
+ * 
+ * Unlike block cipher procedures, that operate on `__m128i` values, works
+ * with byte buffers of arbitrary alignment, hence no aligned temporaries
+ * are necessary. A single block is encrypted with single block procedure
+ * (it has the best latency), several blocks with a multi-block one.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param in Plaintext (not necessarily aligned)
+ * @param out Ciphertext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (multiple of block size)
+ */
+void ecb_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Decrypts blocks in ECB mode. Chapter 5.1 of GOST 34.13-2018
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for decryption
+ * @param in Ciphertext (not necessarily aligned)
+ * @param out Plaintext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of data in bytes (multiple of block size)
+ */
+void ecb_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Encrypts blocks of scatter-gather list in ECB mode. Blocks may straddle 
+ *        segment boundaries, only such blocks are copied.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param in Plaintext segments
+ * @param in_count Number of plaintext segments
+ * @param out Ciphertext segments (may be the same as `in` for in-place encryption)
+ * @param out_count Number of ciphertext segments
+ * @param length Length of data in bytes (multiple of block size)
+ * @return Non-zero on success, zero if any list is shorter than `length` (nothing is processed)
+ */
+int ecb_encrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const IOVEC* in, size_t in_count,
+                    const IOVEC* out, size_t out_count, size_t length);
+
+
+/**
+ * @brief Decrypts blocks of scatter-gather list in ECB mode.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for decryption
+ * @param in Ciphertext segments
+ * @param in_count Number of ciphertext segments
+ * @param out Plaintext segments (may be the same as `in` for in-place decryption)
+ * @param out_count Number of plaintext segments
+ * @param length Length of data in bytes (multiple of block size)
+ * @return Non-zero on success, zero if any list is shorter than `length` (nothing is processed)
+ */
+int ecb_decrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const IOVEC* in, size_t in_count,
+                    const IOVEC* out, size_t out_count, size_t length);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_ECB_INCLUDED
@@ -0,0 +1,181 @@
+/**
+ * @file mgm.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief MGM authenticated encryption mode (RFC 9058)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_MGM_INCLUDED
+#define BCLIB_MGM_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Nonce size in bytes (most significant bit is ignored).
+ */
+#define MGM_NONCE_SIZE 16
+
+
+/**
+ * @brief Maximal authentication tag size in bytes.
+ */
+#define MGM_MAX_TAG_SIZE 16
+
+
+/**
+ * @brief Size of streaming context in bytes.
+ */
+#define MGM_CONTEXT_SIZE 192
+
+
+/**
+ * @brief Streaming context of MGM mode (opaque).
+ */
+typedef struct tagMGM_CONTEXT
+{
+    BCLIB_ALIGN16 unsigned char context[MGM_CONTEXT_SIZE]; /**< Opaque state */
+} MGM_CONTEXT;
+
+
+/**
+ * @brief Encrypts and authenticates a message in MGM mode. RFC 9058
+ * 
+ * Encryption counters (0 || nonce) and authentication counters (1 || nonce)
+ * of several blocks are encrypted with a single multi-block call. Products 
+ * in GF(2^128) are computed with PCLMULQDQ and accumulated without reduction, 
+ * the sum is reduced once per message.
+ * 
+ * Requires PCLMULQDQ and SSSE3 support.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param nonce Nonce of MGM_NONCE_SIZE bytes (unique for each message)
+ * @param aad Associated data, which is authenticated, but not encrypted
+ * @param aad_length Length of associated data in bytes (arbitrary)
+ * @param in Plaintext (not necessarily aligned)
+ * @param out Ciphertext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of plaintext in bytes (arbitrary)
+ * @param tag Buffer for authentication tag
+ * @param tag_size Tag size in bytes (from 1 to MGM_MAX_TAG_SIZE)
+ * @return Non-zero on success, zero if tag size is invalid (nothing is encrypted)
+ */
+int mgm_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce,
+                const unsigned char* aad, size_t aad_length, const unsigned char* in, unsigned char* out,
+                size_t length, unsigned char* tag, size_t tag_size);
+
+
+/**
+ * @brief Decrypts a message and verifies its tag in MGM mode. RFC 9058
+ * 
+ * Decryption and authentication are performed in a single pass. If tag
+ * is invalid, output is wiped.
+ * 
+ * Requires PCLMULQDQ and SSSE3 support.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption (MGM uses encryption only)
+ * @param nonce Nonce of MGM_NONCE_SIZE bytes
+ * @param aad Associated data
+ * @param aad_length Length of associated data in bytes
+ * @param in Ciphertext (not necessarily aligned)
+ * @param out Plaintext (not necessarily aligned, may be equal to `in`)
+ * @param length Length of ciphertext in bytes
+ * @param tag Authentication tag to verify
+ * @param tag_size Tag size in bytes (from 1 to MGM_MAX_TAG_SIZE)
+ * @return Non-zero if tag is valid, zero otherwise (or if tag size is invalid,
+ *         nothing is decrypted then)
+ */
+int mgm_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce,
+                const unsigned char* aad, size_t aad_length, const unsigned char* in, unsigned char* out,
+                size_t length, const unsigned char* tag, size_t tag_size);
+
+
+/**
+ * @brief Starts streaming encryption in MGM mode. Cipher and key must 
+ *        outlive the context.
+ * 
+ * Requires PCLMULQDQ and SSSE3 support.
+ * 
+ * @param context Context to initialize
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption
+ * @param nonce Nonce of MGM_NONCE_SIZE bytes (unique for each message)
+ */
+void mgm_encrypt_init(MGM_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce);
+
+
+/**
+ * @brief Starts streaming decryption in MGM mode. Cipher and key must 
+ *        outlive the context.
+ * 
+ * Requires PCLMULQDQ and SSSE3 support.
+ * 
+ * @param context Context to initialize
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param key Key schedule for encryption (MGM uses encryption only)
+ * @param nonce Nonce of MGM_NONCE_SIZE bytes
+ */
+void mgm_decrypt_init(MGM_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce);
+
+
+/**
+ * @brief Authenticates the next chunk of associated data. All associated 
+ *        data MUST be passed before the first call to `mgm_update`.
+ * 
+ * @param context Initialized context
+ * @param aad Chunk of associated data
+ * @param aad_length Length of chunk in bytes (arbitrary)
+ */
+void mgm_update_aad(MGM_CONTEXT* context, const unsigned char* aad, size_t aad_length);
+
+
+/**
+ * @brief Encrypts (or decrypts) the next chunk of message.
+ * 
+ * @param context Initialized context
+ * @param in Input data (not necessarily aligned)
+ * @param out Output data (not necessarily aligned, may be equal to `in`)
+ * @param length Length of chunk in bytes (arbitrary)
+ */
+void mgm_update(MGM_CONTEXT* context, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Finishes streaming encryption, computes the tag and wipes context.
+ * 
+ * @param context Context initialized with `mgm_encrypt_init`
+ * @param tag Buffer for authentication tag
+ * @param tag_size Tag size in bytes (from 1 to MGM_MAX_TAG_SIZE)
+ * @return Non-zero on success, zero if tag size is invalid
+ */
+int mgm_encrypt_final(MGM_CONTEXT* context, unsigned char* tag, size_t tag_size);
+
+
+/**
+ * @brief Finishes streaming decryption, verifies the tag and wipes context.
+ * 
+ * Plaintext is already released by `mgm_update`, hence it cannot be wiped
+ * here: caller MUST discard it, if tag is invalid.
+ * 
+ * @param context Context initialized with `mgm_decrypt_init`
+ * @param tag Authentication tag to verify
+ * @param tag_size Tag size in bytes (from 1 to MGM_MAX_TAG_SIZE)
+ * @return Non-zero if tag is valid, zero otherwise (or if tag size is invalid)
+ */
+int mgm_decrypt_final(MGM_CONTEXT* context, const unsigned char* tag, size_t tag_size);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_MGM_INCLUDED
@@ -0,0 +1,161 @@
+/**
+ * @file xts.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief XTS mode of operation (IEEE 1619) for sector encryption
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_XTS_INCLUDED
+#define BCLIB_XTS_INCLUDED
+
+
+#include "common/interface.h"
+#include "common/iov.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief Maximal supported sector size in bytes.
+ */
+#define XTS_MAX_SECTOR_SIZE 4096
+
+
+/**
+ * @brief IV size of a sector in bytes (one block).
+ */
+#define XTS_SECTOR_IV_SIZE 16
+
+
+/**
+ * @brief Encrypts consecutive sectors in XTS mode.
+ * 
+ * Each sector is tweaked with its number (little-endian 128-bit integer, as in 
+ * IEEE 1619 and dm-crypt's plain64), encrypted with the tweak key. All tweaks 
+ * of a sector are computed ahead, then all sector blocks are encrypted with
+ * a single multi-block call.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param data_key Key schedule for encryption of data
+ * @param tweak_key Key schedule for encryption of tweaks (must differ from data key)
+ * @param sector_number Number of the first sector
+ * @param sector_size Sector size in bytes (multiple of block size, at most XTS_MAX_SECTOR_SIZE)
+ * @param sectors_count Number of sectors to encrypt
+ * @param in Plaintext sectors (not necessarily aligned)
+ * @param out Ciphertext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int xts_encrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                        unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                        const unsigned char* in, unsigned char* out);
+
+
+/**
+ * @brief Decrypts consecutive sectors in XTS mode.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param data_key Key schedule for decryption of data
+ * @param tweak_key Key schedule for encryption of tweaks (tweaks are always encrypted)
+ * @param sector_number Number of the first sector
+ * @param sector_size Sector size in bytes (multiple of block size, at most XTS_MAX_SECTOR_SIZE)
+ * @param sectors_count Number of sectors to decrypt
+ * @param in Ciphertext sectors (not necessarily aligned)
+ * @param out Plaintext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int xts_decrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                        unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                        const unsigned char* in, unsigned char* out);
+
+
+/**
+ * @brief Encrypts consecutive sectors in XTS mode with IVs supplied by caller
+ *        (e.g. plain64be or ESSIV, as dm-crypt does). IV of a sector is encrypted
+ *        with the tweak key to get its initial tweak.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param data_key Key schedule for encryption of data
+ * @param tweak_key Key schedule for encryption of tweaks (must differ from data key)
+ * @param ivs IVs of sectors, XTS_SECTOR_IV_SIZE bytes each
+ * @param sector_size Sector size in bytes (multiple of block size, at most XTS_MAX_SECTOR_SIZE)
+ * @param sectors_count Number of sectors to encrypt
+ * @param in Plaintext sectors (not necessarily aligned)
+ * @param out Ciphertext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int xts_encrypt_sectors_ivs(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            const unsigned char* ivs, size_t sector_size, size_t sectors_count,
+                            const unsigned char* in, unsigned char* out);
+
+
+/**
+ * @brief Decrypts consecutive sectors in XTS mode with IVs supplied by caller.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param data_key Key schedule for decryption of data
+ * @param tweak_key Key schedule for encryption of tweaks (tweaks are always encrypted)
+ * @param ivs IVs of sectors, XTS_SECTOR_IV_SIZE bytes each
+ * @param sector_size Sector size in bytes (multiple of block size, at most XTS_MAX_SECTOR_SIZE)
+ * @param sectors_count Number of sectors to decrypt
+ * @param in Ciphertext sectors (not necessarily aligned)
+ * @param out Plaintext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int xts_decrypt_sectors_ivs(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            const unsigned char* ivs, size_t sector_size, size_t sectors_count,
+                            const unsigned char* in, unsigned char* out);
+
+
+/**
+ * @brief Encrypts consecutive sectors of a scatter-gather list in XTS mode. 
+ *        Sectors may straddle segment boundaries, only such sectors are copied.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param data_key Key schedule for encryption of data
+ * @param tweak_key Key schedule for encryption of tweaks (must differ from data key)
+ * @param sector_number Number of the first sector
+ * @param sector_size Sector size in bytes (multiple of block size, at most XTS_MAX_SECTOR_SIZE)
+ * @param sectors_count Number of sectors to encrypt
+ * @param in Plaintext segments
+ * @param in_count Number of plaintext segments
+ * @param out Ciphertext segments (may be the same as `in` for in-place encryption)
+ * @param out_count Number of ciphertext segments
+ * @return Non-zero on success, zero if sector size is invalid or any list is shorter 
+ *         than sectors (nothing is processed)
+ */
+int xts_encrypt_sectors_iov(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                            const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count);
+
+
+/**
+ * @brief Decrypts consecutive sectors of a scatter-gather list in XTS mode.
+ * 
+ * @param cipher Initialized 128-bit block cipher interface
+ * @param data_key Key schedule for decryption of data
+ * @param tweak_key Key schedule for encryption of tweaks (tweaks are always encrypted)
+ * @param sector_number Number of the first sector
+ * @param sector_size Sector size in bytes (multiple of block size, at most XTS_MAX_SECTOR_SIZE)
+ * @param sectors_count Number of sectors to decrypt
+ * @param in Ciphertext segments
+ * @param in_count Number of ciphertext segments
+ * @param out Plaintext segments (may be the same as `in` for in-place decryption)
+ * @param out_count Number of plaintext segments
+ * @return Non-zero on success, zero if sector size is invalid or any list is shorter 
+ *         than sectors (nothing is processed)
+ */
+int xts_decrypt_sectors_iov(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                            const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_XTS_INCLUDED
@@ -0,0 +1,123 @@
+/**
+ * @file sector.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Sector-addressed encryption with dm-crypt compatible IV generators
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_SECTOR_INCLUDED
+#define BCLIB_SECTOR_INCLUDED
+
+
+#include "common/interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+
+/**
+ * @brief IV size of a sector in bytes (one block).
+ */
+#define SECTOR_IV_SIZE 16
+
+
+/**
+ * @brief Size of a sector used for IV numbering by dm-crypt 
+ *        (unless `iv_large_sectors` is set).
+ */
+#define SECTOR_IV_UNIT_SIZE 512
+
+
+/**
+ * @brief Modes of operation for sectors.
+ */
+typedef enum tagSECTOR_MODE
+{
+    SECTOR_MODE_XTS, /**< XTS, IV is encrypted with tweak key (xts-<iv> in dm-crypt) */
+    SECTOR_MODE_CBC  /**< CBC, IV is used as is (cbc-<iv> in dm-crypt) */
+} SECTOR_MODE;
+
+
+/**
+ * @brief IV generators (compatible with dm-crypt ones). IV sector number `n` 
+ *        counts SECTOR_IV_UNIT_SIZE units or whole sectors (see `large_iv_sectors`).
+ */
+typedef enum tagSECTOR_IV
+{
+    SECTOR_IV_PLAIN64,   /**< n as 64-bit little-endian integer, zero padded */
+    SECTOR_IV_PLAIN64BE, /**< n as 64-bit big-endian integer in the last 8 bytes, zero padded */
+    SECTOR_IV_ESSIV,     /**< plain64 encrypted with a key derived from data key (salt) */
+    SECTOR_IV_BENBI      /**< Number of the first block of a sector counting from 1, 64-bit big-endian in the last 8 bytes */
+} SECTOR_IV;
+
+
+/**
+ * @brief Configuration of sector processing (an analog of dm-crypt target).
+ */
+typedef struct tagSECTOR_CONTEXT
+{
+    const BLOCK_CIPHER* cipher; /**< Initialized 128-bit block cipher interface */
+    SECTOR_MODE mode;           /**< Mode of operation */
+    SECTOR_IV iv;               /**< IV generator */
+    size_t sector_size;         /**< Sector size in bytes (multiple of SECTOR_IV_UNIT_SIZE or of block size if
+                                     `large_iv_sectors` is set, at most XTS_MAX_SECTOR_SIZE) */
+    int large_iv_sectors;       /**< Nonzero if IVs are numbered in sectors rather than in 512-byte units */
+    const KEY* encrypt_key;     /**< Key schedule for encryption of data */
+    const KEY* decrypt_key;     /**< Key schedule for decryption of data */
+    const KEY* tweak_key;       /**< Key schedule for encryption of tweaks (XTS only) */
+    const KEY* essiv_key;       /**< Key schedule for encryption of IVs (ESSIV only). As in dm-crypt it is
+                                     initialized from a hash of data key (e.g. essiv:sha256), the hash is
+                                     computed by caller */
+} SECTOR_CONTEXT;
+
+
+/**
+ * @brief Generates IVs of consecutive sectors. ESSIV encryptions of all 
+ *        IVs are performed with a single multi-block call.
+ * 
+ * @param context Sector processing configuration
+ * @param sector Number of the first sector (in sectors of `sector_size`)
+ * @param sectors_count Number of sectors
+ * @param ivs Output IVs, SECTOR_IV_SIZE bytes each
+ */
+void sector_generate_ivs(const SECTOR_CONTEXT* context, unsigned long long sector, size_t sectors_count, unsigned char* ivs);
+
+
+/**
+ * @brief Encrypts consecutive sectors. IVs are generated internally 
+ *        in batches, all sectors are processed with a single call.
+ * 
+ * @param context Sector processing configuration
+ * @param sector Number of the first sector (in sectors of `sector_size`)
+ * @param sectors_count Number of sectors
+ * @param in Plaintext sectors (not necessarily aligned)
+ * @param out Ciphertext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int sector_encrypt(const SECTOR_CONTEXT* context, unsigned long long sector, size_t sectors_count,
+                   const unsigned char* in, unsigned char* out);
+
+
+/**
+ * @brief Decrypts consecutive sectors.
+ * 
+ * @param context Sector processing configuration
+ * @param sector Number of the first sector (in sectors of `sector_size`)
+ * @param sectors_count Number of sectors
+ * @param in Ciphertext sectors (not necessarily aligned)
+ * @param out Plaintext sectors (not necessarily aligned, may be equal to `in`)
+ * @return Non-zero on success, zero if sector size is invalid (nothing is processed)
+ */
+int sector_decrypt(const SECTOR_CONTEXT* context, unsigned long long sector, size_t sectors_count,
+                   const unsigned char* in, unsigned char* out);
+
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !BCLIB_SECTOR_INCLUDED
@@ -0,0 +1,423 @@
+/**
+ * @file bulk.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Multi-threaded bulk encryption engine (user mode only)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "bulk/bulk.h"
+#include "modes/cbc/cbc.h"
+#include "modes/ctr/ctr.h"
+#include "modes/xts/xts.h"
+#include "common/utils.h"
+
+#include "bulk_threads.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define BULKP_BLOCK_SIZE 16
+
+
+/**
+ * @brief A request split into chunks.
+ */
+typedef struct tagBULKP_JOB
+{
+    const BULK_REQUEST* request; /**< Request being processed */
+    size_t chunk_size;           /**< Chunk size in bytes */
+    size_t chunks_count;         /**< Number of chunks */
+    unsigned char* chain_ivs;    /**< Last ciphertext blocks of chunks, IVs of the next ones (CBC only) */
+    volatile size_t next_chunk;  /**< Index of the next chunk to take */
+} BULKP_JOB;
+
+
+/**
+ * @brief Bulk engine (thread pool).
+ */
+struct tagBULK_ENGINE
+{
+    BULKP_THREAD* threads;         /**< Worker threads (threads_count - 1) */
+    size_t threads_count;          /**< Number of threads including calling one */
+    BULKP_MUTEX request_mutex;     /**< Serializes requests */
+    BULKP_MUTEX mutex;             /**< Protects fields below */
+    BULKP_CONDITION job_posted;    /**< Signaled when a new job is posted or on shutdown */
+    BULKP_CONDITION job_finished;  /**< Signaled when all workers finished a job */
+    BULKP_JOB* job;                /**< Current job */
+    unsigned long long generation; /**< Number of posted jobs */
+    size_t busy_workers;           /**< Number of workers processing current job */
+    int shutdown;                  /**< Non-zero if workers must exit */
+};
+
+
+/**
+ * @brief Processes a single chunk of a job.
+ */
+static void bulkp_process_chunk(const BULKP_JOB* job, size_t chunk)
+{
+    const BULK_REQUEST* request = job->request;
+
+    const size_t offset = chunk * job->chunk_size;
+    const size_t length = (request->length - offset < job->chunk_size) ? request->length - offset : job->chunk_size;
+
+    const unsigned char* in = request->in + offset;
+    unsigned char* out      = request->out + offset;
+
+    switch (request->mode)
+    {
+    case BULK_MODE_ECB_ENCRYPT:
+        request->cipher->encrypt_blocks((const __m128i*)in, request->key, (__m128i*)out, length / BULKP_BLOCK_SIZE);
+        break;
+
+    case BULK_MODE_ECB_DECRYPT:
+        request->cipher->decrypt_blocks((const __m128i*)in, request->key, (__m128i*)out, length / BULKP_BLOCK_SIZE);
+        break;
+
+    case BULK_MODE_CTR:
+        ctr_encrypt(request->cipher, request->key, request->iv, request->offset + offset / BULKP_BLOCK_SIZE, in, out, length);
+        break;
+
+    case BULK_MODE_XTS_ENCRYPT:
+        xts_encrypt_sectors(request->cipher, request->key, request->tweak_key, request->offset + offset / request->sector_size,
+                            request->sector_size, length / request->sector_size, in, out);
+        break;
+
+    case BULK_MODE_XTS_DECRYPT:
+        xts_decrypt_sectors(request->cipher, request->key, request->tweak_key, request->offset + offset / request->sector_size,
+                            request->sector_size, length / request->sector_size, in, out);
+        break;
+
+    case BULK_MODE_CBC_DECRYPT:
+        cbc_decrypt(request->cipher, request->key, chunk ? job->chain_ivs + (chunk - 1) * BULKP_BLOCK_SIZE : request->iv,
+                    BULKP_BLOCK_SIZE, in, out, length);
+        break;
+
+    case BULK_MODE_CBC_DECRYPT_SECTORS:
+        cbc_decrypt_sectors(request->cipher, request->key, request->iv + (offset / request->sector_size) * CBC_SECTOR_IV_SIZE,
+                            request->sector_size, length / request->sector_size, in, out);
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief Saves the last ciphertext block of each chunk (but the last one) for
+ *        CBC decryption: they are IVs of the next chunks and may be overwritten
+ *        by another thread in case of in-place decryption.
+ * 
+ * @return Non-zero on success, zero if memory can't be allocated
+ */
+static int bulkp_save_chain_ivs(BULKP_JOB* job)
+{
+    size_t chunk;
+
+    job->chain_ivs = (unsigned char*)malloc((job->chunks_count - 1) * BULKP_BLOCK_SIZE);
+    if (!job->chain_ivs)
+    {
+        return 0;
+    }
+
+    for (chunk = 0; chunk + 1 < job->chunks_count; ++chunk)
+    {
+        memcpy(job->chain_ivs + chunk * BULKP_BLOCK_SIZE,
+               job->request->in + (chunk + 1) * job->chunk_size - BULKP_BLOCK_SIZE, BULKP_BLOCK_SIZE);
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Checks that data of a request consists of whole blocks (or sectors),
+ *        and that sector size is acceptable for the mode.
+ */
+static int bulkp_valid_request(const BULK_REQUEST* request)
+{
+    switch (request->mode)
+    {
+    case BULK_MODE_ECB_ENCRYPT:
+    case BULK_MODE_ECB_DECRYPT:
+    case BULK_MODE_CBC_DECRYPT:
+        return !(request->length % BULKP_BLOCK_SIZE);
+
+    case BULK_MODE_CTR:
+        return 1;
+
+    case BULK_MODE_XTS_ENCRYPT:
+    case BULK_MODE_XTS_DECRYPT:
+        return request->sector_size && !(request->sector_size % BULKP_BLOCK_SIZE) &&
+               request->sector_size <= XTS_MAX_SECTOR_SIZE && !(request->length % request->sector_size);
+
+    case BULK_MODE_CBC_DECRYPT_SECTORS:
+        return request->sector_size && !(request->sector_size % BULKP_BLOCK_SIZE) &&
+               !(request->length % request->sector_size);
+
+    default:
+        return 0;
+    }
+}
+
+
+/**
+ * @brief Takes chunks of a job until there are no more left.
+ */
+static void bulkp_run_job(BULKP_JOB* job)
+{
+    size_t chunk;
+
+    while ((chunk = bulkp_atomic_increment(&job->next_chunk)) < job->chunks_count)
+    {
+        bulkp_process_chunk(job, chunk);
+    }
+}
+
+
+/**
+ * @brief Worker thread procedure.
+ */
+static BULKP_THREAD_PROCEDURE(bulkp_worker, parameter)
+{
+    BULK_ENGINE* engine = (BULK_ENGINE*)parameter;
+
+    unsigned long long generation = 0;
+    BULKP_JOB* job;
+
+    bulkp_mutex_lock(&engine->mutex);
+
+    for (;;)
+    {
+        while (!engine->shutdown && engine->generation == generation)
+        {
+            bulkp_condition_wait(&engine->job_posted, &engine->mutex);
+        }
+
+        if (engine->shutdown)
+        {
+            break;
+        }
+
+        generation = engine->generation;
+        job        = engine->job;
+
+        bulkp_mutex_unlock(&engine->mutex);
+
+        bulkp_run_job(job);
+
+        bulkp_mutex_lock(&engine->mutex);
+
+        if (--engine->busy_workers == 0)
+        {
+            bulkp_condition_broadcast(&engine->job_finished);
+        }
+    }
+
+    bulkp_mutex_unlock(&engine->mutex);
+
+    BULKP_THREAD_RETURN;
+}
+
+
+/**
+ * @brief Stops and joins first `count` worker threads.
+ */
+static void bulkp_stop_workers(BULK_ENGINE* engine, size_t count)
+{
+    size_t idx;
+
+    bulkp_mutex_lock(&engine->mutex);
+    engine->shutdown = 1;
+    bulkp_condition_broadcast(&engine->job_posted);
+    bulkp_mutex_unlock(&engine->mutex);
+
+    for (idx = 0; idx < count; ++idx)
+    {
+        bulkp_thread_join(engine->threads[idx]);
+    }
+}
+
+
+BULK_ENGINE* bulk_create(size_t threads_count)
+{
+    BULK_ENGINE* engine;
+    size_t idx;
+
+    engine = (BULK_ENGINE*)calloc(1, sizeof(BULK_ENGINE));
+    if (!engine)
+    {
+        return 0;
+    }
+
+    engine->threads_count = threads_count ? threads_count : bulkp_cpus_count();
+    engine->threads       = (BULKP_THREAD*)calloc(engine->threads_count, sizeof(BULKP_THREAD));
+
+    if (!engine->threads)
+    {
+        goto free_engine;
+    }
+
+    if (!bulkp_mutex_initialize(&engine->request_mutex))
+    {
+        goto free_engine;
+    }
+
+    if (!bulkp_mutex_initialize(&engine->mutex))
+    {
+        goto destroy_request_mutex;
+    }
+
+    if (!bulkp_condition_initialize(&engine->job_posted))
+    {
+        goto destroy_mutex;
+    }
+
+    if (!bulkp_condition_initialize(&engine->job_finished))
+    {
+        goto destroy_job_posted;
+    }
+
+    //
+    // Calling thread is a worker too, so one thread less is created
+    //
+
+    for (idx = 0; idx + 1 < engine->threads_count; ++idx)
+    {
+        if (!bulkp_thread_create(&engine->threads[idx], bulkp_worker, engine))
+        {
+            bulkp_stop_workers(engine, idx);
+            bulk_destroy(engine);
+
+            return 0;
+        }
+    }
+
+    return engine;
+
+destroy_job_posted:
+    bulkp_condition_destroy(&engine->job_posted);
+
+destroy_mutex:
+    bulkp_mutex_destroy(&engine->mutex);
+
+destroy_request_mutex:
+    bulkp_mutex_destroy(&engine->request_mutex);
+
+free_engine:
+    free(engine->threads);
+    free(engine);
+
+    return 0;
+}
+
+
+void bulk_destroy(BULK_ENGINE* engine)
+{
+    if (!engine)
+    {
+        return;
+    }
+
+    if (!engine->shutdown)
+    {
+        bulkp_stop_workers(engine, engine->threads_count - 1);
+    }
+
+    bulkp_condition_destroy(&engine->job_finished);
+    bulkp_condition_destroy(&engine->job_posted);
+    bulkp_mutex_destroy(&engine->mutex);
+    bulkp_mutex_destroy(&engine->request_mutex);
+
+    free(engine->threads);
+    free(engine);
+}
+
+
+size_t bulk_threads_count(const BULK_ENGINE* engine)
+{
+    return engine->threads_count;
+}
+
+
+int bulk_process(BULK_ENGINE* engine, const BULK_REQUEST* request)
+{
+    BULKP_JOB job;
+
+    //
+    // Chunks must contain whole blocks (or sectors), otherwise
+    // results would differ from serial processing
+    //
+
+    const size_t unit = (request->mode == BULK_MODE_XTS_ENCRYPT || request->mode == BULK_MODE_XTS_DECRYPT ||
+                         request->mode == BULK_MODE_CBC_DECRYPT_SECTORS)
+                            ? request->sector_size
+                            : BULKP_BLOCK_SIZE;
+
+    if (!bulkp_valid_request(request))
+    {
+        return 0;
+    }
+
+    job.request      = request;
+    job.chunk_size   = (BULK_CHUNK_SIZE > unit) ? (BULK_CHUNK_SIZE / unit) * unit : unit;
+    job.chunks_count = (request->length + job.chunk_size - 1) / job.chunk_size;
+    job.chain_ivs    = 0;
+    job.next_chunk   = 0;
+
+    if (request->mode == BULK_MODE_CBC_DECRYPT && job.chunks_count > 1 &&
+        (engine->threads_count < 2 || !bulkp_save_chain_ivs(&job)))
+    {
+        //
+        // Without saved IVs (single thread or no memory)
+        // the whole buffer is decrypted as a single chunk
+        //
+
+        job.chunk_size   = request->length;
+        job.chunks_count = 1;
+    }
+
+    bulkp_mutex_lock(&engine->request_mutex);
+
+    if (job.chunks_count < 2 || engine->threads_count < 2)
+    {
+        //
+        // Nothing to split: waking threads up is more expensive
+        //
+
+        bulkp_run_job(&job);
+    }
+    else
+    {
+        bulkp_mutex_lock(&engine->mutex);
+        engine->job          = &job;
+        engine->busy_workers = engine->threads_count - 1;
+        ++engine->generation;
+        bulkp_condition_broadcast(&engine->job_posted);
+        bulkp_mutex_unlock(&engine->mutex);
+
+        bulkp_run_job(&job);
+
+        bulkp_mutex_lock(&engine->mutex);
+
+        while (engine->busy_workers)
+        {
+            bulkp_condition_wait(&engine->job_finished, &engine->mutex);
+        }
+
+        bulkp_mutex_unlock(&engine->mutex);
+    }
+
+    bulkp_mutex_unlock(&engine->request_mutex);
+
+    free(job.chain_ivs);
+
+    return 1;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file bulk_threads.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Minimal threading shim over Win32 and pthreads
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_BULK_THREADS_INCLUDED
+#define BCLIB_BULK_THREADS_INCLUDED
+
+
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <unistd.h>
+#endif
+
+
+#if defined(_WIN32)
+
+typedef HANDLE BULKP_THREAD;
+typedef CRITICAL_SECTION BULKP_MUTEX;
+typedef CONDITION_VARIABLE BULKP_CONDITION;
+
+#define BULKP_THREAD_PROCEDURE(name, parameter) DWORD WINAPI name(LPVOID parameter)
+#define BULKP_THREAD_RETURN                     return 0
+
+#define bulkp_mutex_initialize(mutex)                      (InitializeCriticalSection(mutex), 1)
+#define bulkp_mutex_destroy(mutex)                         DeleteCriticalSection(mutex)
+#define bulkp_mutex_lock(mutex)                            EnterCriticalSection(mutex)
+#define bulkp_mutex_unlock(mutex)                          LeaveCriticalSection(mutex)
+#define bulkp_condition_initialize(condition)              (InitializeConditionVariable(condition), 1)
+#define bulkp_condition_destroy(condition)                 ((void)(condition))
+#define bulkp_condition_wait(condition, mutex)             SleepConditionVariableCS(condition, mutex, INFINITE)
+#define bulkp_condition_broadcast(condition)               WakeAllConditionVariable(condition)
+#define bulkp_thread_create(thread, procedure, parameter)  ((*(thread) = CreateThread(0, 0, procedure, parameter, 0, 0)) != 0)
+#define bulkp_thread_join(thread)                          (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
+#define bulkp_atomic_increment(value)                      ((size_t)InterlockedIncrementSizeT(value) - 1)
+
+/**
+ * @brief Gets number of logical CPUs.
+ */
+static size_t bulkp_cpus_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors;
+}
+
+#else
+
+typedef pthread_t BULKP_THREAD;
+typedef pthread_mutex_t BULKP_MUTEX;
+typedef pthread_cond_t BULKP_CONDITION;
+
+#define BULKP_THREAD_PROCEDURE(name, parameter) void* name(void* parameter)
+#define BULKP_THREAD_RETURN                     return 0
+
+#define bulkp_mutex_initialize(mutex)                      (pthread_mutex_init(mutex, 0) == 0)
+#define bulkp_mutex_destroy(mutex)                         pthread_mutex_destroy(mutex)
+#define bulkp_mutex_lock(mutex)                            pthread_mutex_lock(mutex)
+#define bulkp_mutex_unlock(mutex)                          pthread_mutex_unlock(mutex)
+#define bulkp_condition_initialize(condition)              (pthread_cond_init(condition, 0) == 0)
+#define bulkp_condition_destroy(condition)                 pthread_cond_destroy(condition)
+#define bulkp_condition_wait(condition, mutex)             pthread_cond_wait(condition, mutex)
+#define bulkp_condition_broadcast(condition)               pthread_cond_broadcast(condition)
+#define bulkp_thread_create(thread, procedure, parameter)  (pthread_create(thread, 0, procedure, parameter) == 0)
+#define bulkp_thread_join(thread)                          pthread_join(thread, 0)
+#define bulkp_atomic_increment(value)                      __sync_fetch_and_add(value, 1)
+
+/**
+ * @brief Gets number of logical CPUs.
+ */
+static size_t bulkp_cpus_count(void)
+{
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+}
+
+#endif
+
+#endif  // !BCLIB_BULK_THREADS_INCLUDED
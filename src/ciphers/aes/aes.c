@@ -0,0 +1,352 @@
+/**
+ * @file aes.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief AES block cipher (FIPS 197) with AES-NI
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/aes/aes.h"
+#include "common/utils.h"
+#include "common/cpu.h"
+
+#include "aes_internal.h"
+#include "instrumentation_internal.h"
+
+#include <string.h>
+
+#include <wmmintrin.h>
+
+
+/**
+ * @brief Number of blocks processed simultaneously (AESENC has latency 
+ *        of several cycles, but a throughput of one per cycle).
+ */
+#define AESP_INTERLEAVE 8
+
+
+/**
+ * @brief Step of key expansion: prefix xor of 32-bit words of previous 
+ *        round key and mixing in of AESKEYGENASSIST result.
+ */
+BCLIB_FORCEINLINE static __m128i aesp_expand_step(__m128i key, __m128i assist)
+{
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 8));
+
+    return _mm_xor_si128(key, assist);
+}
+
+
+/**
+ * @brief Round key of AES-128 (rcon must be an immediate).
+ */
+#define AESP_EXPAND128(keys, idx, rcon) \
+    keys[idx] = aesp_expand_step(keys[(idx) - 1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(keys[(idx) - 1], rcon), 0xff))
+
+
+/**
+ * @brief Pair of round keys of AES-256 (rcon must be an immediate).
+ */
+#define AESP_EXPAND256(keys, idx, rcon)                                                                                             \
+    keys[idx]       = aesp_expand_step(keys[(idx) - 2], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(keys[(idx) - 1], rcon), 0xff)); \
+    keys[(idx) + 1] = aesp_expand_step(keys[(idx) - 1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(keys[idx], 0), 0xaa))
+
+
+static void aesp_expand_key128(const unsigned char* key, __m128i* keys)
+{
+    keys[0] = _mm_loadu_si128((const __m128i*)key);
+
+    AESP_EXPAND128(keys, 1, 0x01);
+    AESP_EXPAND128(keys, 2, 0x02);
+    AESP_EXPAND128(keys, 3, 0x04);
+    AESP_EXPAND128(keys, 4, 0x08);
+    AESP_EXPAND128(keys, 5, 0x10);
+    AESP_EXPAND128(keys, 6, 0x20);
+    AESP_EXPAND128(keys, 7, 0x40);
+    AESP_EXPAND128(keys, 8, 0x80);
+    AESP_EXPAND128(keys, 9, 0x1b);
+    AESP_EXPAND128(keys, 10, 0x36);
+}
+
+
+static void aesp_expand_key256(const unsigned char* key, __m128i* keys)
+{
+    keys[0] = _mm_loadu_si128((const __m128i*)key);
+    keys[1] = _mm_loadu_si128((const __m128i*)(key + 16));
+
+    AESP_EXPAND256(keys, 2, 0x01);
+    AESP_EXPAND256(keys, 4, 0x02);
+    AESP_EXPAND256(keys, 6, 0x04);
+    AESP_EXPAND256(keys, 8, 0x08);
+    AESP_EXPAND256(keys, 10, 0x10);
+    AESP_EXPAND256(keys, 12, 0x20);
+
+    //
+    // The last round key is the first one of a pair
+    //
+
+    keys[14] = aesp_expand_step(keys[12], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(keys[13], 0x40), 0xff));
+}
+
+
+/**
+ * @brief Prepares decryption key schedule for AESDEC (Equivalent Inverse Cipher).
+ */
+static void aesp_derive_decrypt_key(const __m128i* encrypt_keys, __m128i* decrypt_keys, size_t rounds)
+{
+    size_t idx;
+
+    decrypt_keys[0]      = encrypt_keys[rounds];
+    decrypt_keys[rounds] = encrypt_keys[0];
+
+    for (idx = 1; idx < rounds; ++idx)
+    {
+        decrypt_keys[idx] = _mm_aesimc_si128(encrypt_keys[rounds - idx]);
+    }
+}
+
+
+BCLIB_FORCEINLINE static void aesp_encrypt_blocks(const __m128i* in, const __m128i* keys, __m128i* out, size_t blocks_count, size_t rounds)
+{
+    __m128i blocks[AESP_INTERLEAVE];
+
+    size_t round;
+    size_t idx;
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        blocks[idx] = _mm_xor_si128(_mm_loadu_si128(in + idx), keys[0]);
+    }
+
+    for (round = 1; round < rounds; ++round)
+    {
+        for (idx = 0; idx < blocks_count; ++idx)
+        {
+            blocks[idx] = _mm_aesenc_si128(blocks[idx], keys[round]);
+        }
+    }
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        _mm_storeu_si128(out + idx, _mm_aesenclast_si128(blocks[idx], keys[rounds]));
+    }
+}
+
+
+BCLIB_FORCEINLINE static void aesp_decrypt_blocks(const __m128i* in, const __m128i* keys, __m128i* out, size_t blocks_count, size_t rounds)
+{
+    __m128i blocks[AESP_INTERLEAVE];
+
+    size_t round;
+    size_t idx;
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        blocks[idx] = _mm_xor_si128(_mm_loadu_si128(in + idx), keys[0]);
+    }
+
+    for (round = 1; round < rounds; ++round)
+    {
+        for (idx = 0; idx < blocks_count; ++idx)
+        {
+            blocks[idx] = _mm_aesdec_si128(blocks[idx], keys[round]);
+        }
+    }
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        _mm_storeu_si128(out + idx, _mm_aesdeclast_si128(blocks[idx], keys[rounds]));
+    }
+}
+
+
+/**
+ * @brief Defines AES-NI engine procedures for a key size. Full batches are
+ *        processed with a constant number of blocks, so they are unrolled.
+ */
+#define AESP_DEFINE_ENGINE(bits)                                                                                                \
+    void aes##bits##_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)                                       \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, ENCRYPT_BLOCK, 1);                                                                     \
+                                                                                                                                \
+        aesp_encrypt_blocks(&in, (const __m128i*)round_keys->key, out, 1, AES##bits##_ROUNDS);                                  \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)                                       \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, DECRYPT_BLOCK, 1);                                                                     \
+                                                                                                                                \
+        aesp_decrypt_blocks(&in, (const __m128i*)round_keys->key, out, 1, AES##bits##_ROUNDS);                                  \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)                \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, ENCRYPT_BLOCKS, blocks_count);                                                         \
+                                                                                                                                \
+        for (; blocks_count >= AESP_INTERLEAVE; blocks_count -= AESP_INTERLEAVE, in += AESP_INTERLEAVE, out += AESP_INTERLEAVE) \
+        {                                                                                                                       \
+            aesp_encrypt_blocks(in, (const __m128i*)round_keys->key, out, AESP_INTERLEAVE, AES##bits##_ROUNDS);                 \
+        }                                                                                                                       \
+                                                                                                                                \
+        aesp_encrypt_blocks(in, (const __m128i*)round_keys->key, out, blocks_count, AES##bits##_ROUNDS);                        \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)                \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, DECRYPT_BLOCKS, blocks_count);                                                         \
+                                                                                                                                \
+        for (; blocks_count >= AESP_INTERLEAVE; blocks_count -= AESP_INTERLEAVE, in += AESP_INTERLEAVE, out += AESP_INTERLEAVE) \
+        {                                                                                                                       \
+            aesp_decrypt_blocks(in, (const __m128i*)round_keys->key, out, AESP_INTERLEAVE, AES##bits##_ROUNDS);                 \
+        }                                                                                                                       \
+                                                                                                                                \
+        aesp_decrypt_blocks(in, (const __m128i*)round_keys->key, out, blocks_count, AES##bits##_ROUNDS);                        \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_initialize_encrypt_key(const unsigned char* key, KEY* round_keys)                                          \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, KEY_SETUP, 1);                                                                         \
+                                                                                                                                \
+        aesp_expand_key##bits(key, (__m128i*)round_keys->key);                                                                  \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_initialize_decrypt_key(const unsigned char* key, KEY* round_keys)                                          \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, KEY_SETUP, 1);                                                                         \
+                                                                                                                                \
+        AES_INTERNAL_KEY encrypt_key;                                                                                           \
+                                                                                                                                \
+        aesp_expand_key##bits(key, encrypt_key.key);                                                                            \
+        aesp_derive_decrypt_key(encrypt_key.key, (__m128i*)round_keys->key, AES##bits##_ROUNDS);                                \
+                                                                                                                                \
+        memset(&encrypt_key, 0, sizeof(encrypt_key));                                                                           \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys)                \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, KEY_SETUP, 1);                                                                         \
+                                                                                                                                \
+        aesp_expand_key##bits(key, (__m128i*)encrypt_round_keys->key);                                                          \
+        aesp_derive_decrypt_key((const __m128i*)encrypt_round_keys->key, (__m128i*)decrypt_round_keys->key,                     \
+                                AES##bits##_ROUNDS);                                                                            \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }                                                                                                                           \
+                                                                                                                                \
+    void aes##bits##_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys,         \
+                                           size_t keys_count)                                                                   \
+    {                                                                                                                           \
+        INSTRUMENTATION_BEGIN(AES_AESNI, KEY_SETUP, keys_count);                                                                \
+                                                                                                                                \
+        size_t idx;                                                                                                             \
+                                                                                                                                \
+        for (idx = 0; idx < keys_count; ++idx)                                                                                  \
+        {                                                                                                                       \
+            aesp_expand_key##bits(keys + idx * AES##bits##_KEY_SIZE, (__m128i*)encrypt_round_keys[idx].key);                    \
+                                                                                                                                \
+            if (decrypt_round_keys)                                                                                             \
+            {                                                                                                                   \
+                aesp_derive_decrypt_key((const __m128i*)encrypt_round_keys[idx].key, (__m128i*)decrypt_round_keys[idx].key,     \
+                                        AES##bits##_ROUNDS);                                                                    \
+            }                                                                                                                   \
+        }                                                                                                                       \
+                                                                                                                                \
+        INSTRUMENTATION_END();                                                                                                  \
+    }
+
+
+AESP_DEFINE_ENGINE(128)
+AESP_DEFINE_ENGINE(256)
+
+
+int aes_engine_supported(AES_ENGINE engine)
+{
+    switch (engine)
+    {
+    case AES_ENGINE_VAES:
+        return cpu_supports(CPU_FEATURE_AESNI | CPU_FEATURE_AVX512F | CPU_FEATURE_VAES);
+
+    default:
+        return cpu_supports(CPU_FEATURE_AESNI);
+    }
+}
+
+
+int aes_initialize_interface(BLOCK_CIPHER* cipher, size_t key_size)
+{
+    if (!aes_engine_supported(AES_ENGINE_AESNI))
+    {
+        return 0;
+    }
+
+    return aes_initialize_interface_ex(cipher, key_size, aes_engine_supported(AES_ENGINE_VAES) ? AES_ENGINE_VAES
+                                                                                               : AES_ENGINE_AESNI);
+}
+
+
+int aes_initialize_interface_ex(BLOCK_CIPHER* cipher, size_t key_size, AES_ENGINE engine)
+{
+    if (key_size != AES128_KEY_SIZE && key_size != AES256_KEY_SIZE)
+    {
+        return 0;
+    }
+
+    cipher->block_size = AES_BLOCK_SIZE;
+    cipher->interleave = (engine == AES_ENGINE_VAES) ? AESP_VAES_BLOCKS : AESP_INTERLEAVE;
+
+    if (key_size == AES128_KEY_SIZE)
+    {
+        cipher->key_size = AES128_KEY_SIZE;
+
+        cipher->encrypt_block          = aes128_encrypt_block;
+        cipher->decrypt_block          = aes128_decrypt_block;
+        cipher->encrypt_blocks         = aes128_encrypt_blocks;
+        cipher->decrypt_blocks         = aes128_decrypt_blocks;
+        cipher->initialize_encrypt_key = aes128_initialize_encrypt_key;
+        cipher->initialize_decrypt_key = aes128_initialize_decrypt_key;
+        cipher->initialize_keys        = aes128_initialize_keys;
+        cipher->initialize_keys_batch  = aes128_initialize_keys_batch;
+
+        if (engine == AES_ENGINE_VAES)
+        {
+            cipher->encrypt_blocks = aes128_vaes_encrypt_blocks;
+            cipher->decrypt_blocks = aes128_vaes_decrypt_blocks;
+        }
+    }
+    else
+    {
+        cipher->key_size = AES256_KEY_SIZE;
+
+        cipher->encrypt_block          = aes256_encrypt_block;
+        cipher->decrypt_block          = aes256_decrypt_block;
+        cipher->encrypt_blocks         = aes256_encrypt_blocks;
+        cipher->decrypt_blocks         = aes256_decrypt_blocks;
+        cipher->initialize_encrypt_key = aes256_initialize_encrypt_key;
+        cipher->initialize_decrypt_key = aes256_initialize_decrypt_key;
+        cipher->initialize_keys        = aes256_initialize_keys;
+        cipher->initialize_keys_batch  = aes256_initialize_keys_batch;
+
+        if (engine == AES_ENGINE_VAES)
+        {
+            cipher->encrypt_blocks = aes256_vaes_encrypt_blocks;
+            cipher->decrypt_blocks = aes256_vaes_decrypt_blocks;
+        }
+    }
+
+    return 1;
+}
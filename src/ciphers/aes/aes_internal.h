@@ -0,0 +1,95 @@
+/**
+ * @file aes_internal.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief AES internals shared between engines
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_AES_INTERNAL_INCLUDED
+#define BCLIB_AES_INTERNAL_INCLUDED
+
+
+#include "ciphers/aes/aes.h"
+#include "common/utils.h"
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Number of rounds of AES-128.
+ */
+#define AES128_ROUNDS 10
+
+
+/**
+ * @brief Number of rounds of AES-256.
+ */
+#define AES256_ROUNDS 14
+
+
+/**
+ * @brief Number of registers processed simultaneously by VAES engine.
+ */
+#define AESP_VAES_REGISTERS 4
+
+
+/**
+ * @brief Number of blocks processed simultaneously by VAES engine (4 blocks per register).
+ */
+#define AESP_VAES_BLOCKS (4 * AESP_VAES_REGISTERS)
+
+
+/**
+ * @brief Internal AES key structure. Decryption key schedule is prepared 
+ *        for AESDEC (reversed, InvMixColumns applied to inner round keys).
+ */
+typedef struct tagAES_INTERNAL_KEY
+{
+    __m128i key[AES256_ROUNDS + 1];
+} AES_INTERNAL_KEY;
+
+
+//
+// Check if generic key can hold a key for AES
+//
+
+BCLIB_STATIC_ASSERT(sizeof(AES_INTERNAL_KEY) <= MAX_KEY_SIZE,
+                    maximum_key_size_is_less_than_necessary_for_aes);
+
+
+//
+// AES-NI engine
+//
+
+void aes128_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void aes128_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void aes128_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes128_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes128_initialize_encrypt_key(const unsigned char* key, KEY* round_keys);
+void aes128_initialize_decrypt_key(const unsigned char* key, KEY* round_keys);
+void aes128_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+void aes128_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count);
+
+void aes256_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void aes256_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out);
+void aes256_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes256_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes256_initialize_encrypt_key(const unsigned char* key, KEY* round_keys);
+void aes256_initialize_decrypt_key(const unsigned char* key, KEY* round_keys);
+void aes256_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+void aes256_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count);
+
+
+//
+// VAES engine (4 blocks per register)
+//
+
+void aes128_vaes_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes128_vaes_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes256_vaes_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+void aes256_vaes_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+
+
+#endif  // !BCLIB_AES_INTERNAL_INCLUDED
@@ -0,0 +1,115 @@
+/**
+ * @file aes_vaes.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief AES block cipher (VAES engine)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/aes/aes.h"
+#include "common/utils.h"
+
+#include "aes_internal.h"
+#include "instrumentation_internal.h"
+
+#include <immintrin.h>
+
+
+/**
+ * @brief Processes full batches, returns number of processed blocks. 
+ *        The rest is processed by AES-NI engine.
+ */
+BCLIB_FORCEINLINE static size_t aesp_vaes_process(const __m128i* in, const KEY* round_keys, __m128i* out,
+                                                  size_t blocks_count, size_t rounds, int decrypt)
+{
+    const __m128i* keys = (const __m128i*)round_keys->key;
+
+    __m512i wide_keys[AES256_ROUNDS + 1];
+    __m512i blocks[AESP_VAES_REGISTERS];
+
+    size_t processed = 0;
+    size_t round;
+    size_t idx;
+
+    if (blocks_count < AESP_VAES_BLOCKS)
+    {
+        return 0;
+    }
+
+    for (round = 0; round <= rounds; ++round)
+    {
+        wide_keys[round] = _mm512_broadcast_i32x4(keys[round]);
+    }
+
+    for (; blocks_count - processed >= AESP_VAES_BLOCKS; processed += AESP_VAES_BLOCKS)
+    {
+        for (idx = 0; idx < AESP_VAES_REGISTERS; ++idx)
+        {
+            blocks[idx] = _mm512_xor_si512(_mm512_loadu_si512((const void*)(in + processed + 4 * idx)), wide_keys[0]);
+        }
+
+        for (round = 1; round < rounds; ++round)
+        {
+            for (idx = 0; idx < AESP_VAES_REGISTERS; ++idx)
+            {
+                blocks[idx] = decrypt ? _mm512_aesdec_epi128(blocks[idx], wide_keys[round])
+                                      : _mm512_aesenc_epi128(blocks[idx], wide_keys[round]);
+            }
+        }
+
+        for (idx = 0; idx < AESP_VAES_REGISTERS; ++idx)
+        {
+            _mm512_storeu_si512((void*)(out + processed + 4 * idx),
+                                decrypt ? _mm512_aesdeclast_epi128(blocks[idx], wide_keys[rounds])
+                                        : _mm512_aesenclast_epi128(blocks[idx], wide_keys[rounds]));
+        }
+    }
+
+    return processed;
+}
+
+
+void aes128_vaes_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(AES_VAES, ENCRYPT_BLOCKS, blocks_count);
+
+    const size_t processed = aesp_vaes_process(in, round_keys, out, blocks_count, AES128_ROUNDS, 0);
+    aes128_encrypt_blocks(in + processed, round_keys, out + processed, blocks_count - processed);
+
+    INSTRUMENTATION_END();
+}
+
+
+void aes128_vaes_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(AES_VAES, DECRYPT_BLOCKS, blocks_count);
+
+    const size_t processed = aesp_vaes_process(in, round_keys, out, blocks_count, AES128_ROUNDS, 1);
+    aes128_decrypt_blocks(in + processed, round_keys, out + processed, blocks_count - processed);
+
+    INSTRUMENTATION_END();
+}
+
+
+void aes256_vaes_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(AES_VAES, ENCRYPT_BLOCKS, blocks_count);
+
+    const size_t processed = aesp_vaes_process(in, round_keys, out, blocks_count, AES256_ROUNDS, 0);
+    aes256_encrypt_blocks(in + processed, round_keys, out + processed, blocks_count - processed);
+
+    INSTRUMENTATION_END();
+}
+
+
+void aes256_vaes_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(AES_VAES, DECRYPT_BLOCKS, blocks_count);
+
+    const size_t processed = aesp_vaes_process(in, round_keys, out, blocks_count, AES256_ROUNDS, 1);
+    aes256_decrypt_blocks(in + processed, round_keys, out + processed, blocks_count - processed);
+
+    INSTRUMENTATION_END();
+}
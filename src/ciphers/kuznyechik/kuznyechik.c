@@ -10,284 +10,195 @@
 
 #include "ciphers/kuznyechik/kuznyechik.h"
 #include "common/utils.h"
-#include "galoislib.h"
+#include "common/cpu.h"
+
+#include "kuznyechik_internal.h"
+#include "instrumentation_internal.h"
+
+#if !defined(BCLIB_KERNEL_MODE_BUILD)
+#   include <stdlib.h>
+#   include <string.h>
+#endif  // !BCLIB_KERNEL_MODE_BUILD
 
 #include <mmintrin.h>
 #include <emmintrin.h>
 
 
 /**
- * @brief Number of rounds in cipher.
+ * @brief Preparation for lookup tables usage (tables are copied to
+ *        a local variable, so they are not reloaded after stores)
  */
-#define KUZNYECHIK_ROUNDS 10
+#define KUZNYECHIKP_XOR_LOOKUP_INIT(tables)                                                         \
+    const KUZNYECHIK_TABLES kuznyechikp_tables = (tables);                                          \
+    __m128i kuznyechikp_temporary1;                                                                 \
+    __m128i kuznyechikp_temporary2;                                                                 \
+    __m128i kuznyechikp_lookup_mask = _mm_setr_epi8(0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, \
+                                                    0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff)
 
 
 /**
- * @brief 64 bit type (defined here intentionally to
- *        be able not to include any of stdlib headers.
+ * @brief Internal lookup table accessor
  */
-typedef unsigned long long uint64_t;
-
-
-//
-// Just to be sure if we a going well :)
-//
-
-BCLIB_STATIC_ASSERT(sizeof(uint64_t) == 8, wrong_64_bit_type);
+#define KUZNYECHIKP_XOR_LOOKUP(table, a)                                                                    \
+    kuznyechikp_temporary1 = _mm_and_si128(kuznyechikp_lookup_mask, a);                                     \
+    kuznyechikp_temporary2 = _mm_andnot_si128(kuznyechikp_lookup_mask, a);                                  \
+                                                                                                            \
+    kuznyechikp_temporary1 = _mm_srli_epi16(kuznyechikp_temporary1, 4);                                     \
+    kuznyechikp_temporary2 = _mm_slli_epi16(kuznyechikp_temporary2, 4);                                     \
+                                                                                                            \
+    a = _mm_load_si128((const void*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 0)));                \
+                                                                                                            \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 0) + 0x1000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 1) + 0x2000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 1) + 0x3000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 2) + 0x4000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 2) + 0x5000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 3) + 0x6000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 3) + 0x7000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 4) + 0x8000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 4) + 0x9000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 5) + 0xa000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 5) + 0xb000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 6) + 0xc000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 6) + 0xd000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 7) + 0xe000)); \
+    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 7) + 0xf000));
 
 
 /**
- * @brief Internal Kuznyechik key structure.
+ * @brief Number of blocks processed simultaneously by multi-block procedures.
  */
-typedef struct tagINTERNAL_KEY
-{
-    __m128i key[KUZNYECHIK_ROUNDS];
-} INTERNAL_KEY;
-
-
-//
-// Check if generic key can hold a key for Kuznyechik
-//
+#define KUZNYECHIKP_INTERLEAVE 4
 
-BCLIB_STATIC_ASSERT(sizeof(INTERNAL_KEY) <= MAX_KEY_SIZE,
-                    maximum_key_size_is_less_than_necessary);
+BCLIB_STATIC_ASSERT(KUZNYECHIKP_INTERLEAVE == KUZNYECHIK_GENERIC_INTERLEAVE, kuznyechik_generic_interleave_mismatch);
 
 
 /**
- * @brief SBox. Chapter 4.1.1 of GOST 34.12-2018
+ * @brief Preparation for interleaved lookup tables usage
  */
-static const unsigned char kuznyechikp_sbox[256] = {
-    0xfc, 0xee, 0xdd, 0x11, 0xcf, 0x6e, 0x31, 0x16, 0xfb, 0xc4, 0xfa, 0xda, 0x23, 0xc5, 0x04, 0x4d,
-    0xe9, 0x77, 0xf0, 0xdb, 0x93, 0x2e, 0x99, 0xba, 0x17, 0x36, 0xf1, 0xbb, 0x14, 0xcd, 0x5f, 0xc1,
-    0xf9, 0x18, 0x65, 0x5a, 0xe2, 0x5c, 0xef, 0x21, 0x81, 0x1c, 0x3c, 0x42, 0x8b, 0x01, 0x8e, 0x4f,
-    0x05, 0x84, 0x02, 0xae, 0xe3, 0x6a, 0x8f, 0xa0, 0x06, 0x0b, 0xed, 0x98, 0x7f, 0xd4, 0xd3, 0x1f,
-    0xeb, 0x34, 0x2c, 0x51, 0xea, 0xc8, 0x48, 0xab, 0xf2, 0x2a, 0x68, 0xa2, 0xfd, 0x3a, 0xce, 0xcc,
-    0xb5, 0x70, 0x0e, 0x56, 0x08, 0x0c, 0x76, 0x12, 0xbf, 0x72, 0x13, 0x47, 0x9c, 0xb7, 0x5d, 0x87,
-    0x15, 0xa1, 0x96, 0x29, 0x10, 0x7b, 0x9a, 0xc7, 0xf3, 0x91, 0x78, 0x6f, 0x9d, 0x9e, 0xb2, 0xb1,
-    0x32, 0x75, 0x19, 0x3d, 0xff, 0x35, 0x8a, 0x7e, 0x6d, 0x54, 0xc6, 0x80, 0xc3, 0xbd, 0x0d, 0x57,
-    0xdf, 0xf5, 0x24, 0xa9, 0x3e, 0xa8, 0x43, 0xc9, 0xd7, 0x79, 0xd6, 0xf6, 0x7c, 0x22, 0xb9, 0x03,
-    0xe0, 0x0f, 0xec, 0xde, 0x7a, 0x94, 0xb0, 0xbc, 0xdc, 0xe8, 0x28, 0x50, 0x4e, 0x33, 0x0a, 0x4a,
-    0xa7, 0x97, 0x60, 0x73, 0x1e, 0x00, 0x62, 0x44, 0x1a, 0xb8, 0x38, 0x82, 0x64, 0x9f, 0x26, 0x41,
-    0xad, 0x45, 0x46, 0x92, 0x27, 0x5e, 0x55, 0x2f, 0x8c, 0xa3, 0xa5, 0x7d, 0x69, 0xd5, 0x95, 0x3b,
-    0x07, 0x58, 0xb3, 0x40, 0x86, 0xac, 0x1d, 0xf7, 0x30, 0x37, 0x6b, 0xe4, 0x88, 0xd9, 0xe7, 0x89,
-    0xe1, 0x1b, 0x83, 0x49, 0x4c, 0x3f, 0xf8, 0xfe, 0x8d, 0x53, 0xaa, 0x90, 0xca, 0xd8, 0x85, 0x61,
-    0x20, 0x71, 0x67, 0xa4, 0x2d, 0x2b, 0x09, 0x5b, 0xcb, 0x9b, 0x25, 0xd0, 0xbe, 0xe5, 0x6c, 0x52,
-    0x59, 0xa6, 0x74, 0xd2, 0xe6, 0xf4, 0xb4, 0xc0, 0xd1, 0x66, 0xaf, 0xc2, 0x39, 0x4b, 0x63, 0xb6
-};
+#define KUZNYECHIKP_XOR_LOOKUP4_INIT(tables)                                                         \
+    const KUZNYECHIK_TABLES kuznyechikp_tables = (tables);                                           \
+    __m128i kuznyechikp_lookup_mask = _mm_setr_epi8(0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff,  \
+                                                    0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff); \
+    __m128i kuznyechikp_odd0;                                                                        \
+    __m128i kuznyechikp_odd1;                                                                        \
+    __m128i kuznyechikp_odd2;                                                                        \
+    __m128i kuznyechikp_odd3;                                                                        \
+    __m128i kuznyechikp_even0;                                                                       \
+    __m128i kuznyechikp_even1;                                                                       \
+    __m128i kuznyechikp_even2;                                                                       \
+    __m128i kuznyechikp_even3
 
 
 /**
- * @brief Inverse of SBox. Chapter 4.1.1 of GOST 34.12-2018
+ * @brief Computes lookup table offsets for odd and even bytes of a block
  */
-static const unsigned char kuznyechikp_sbox_inverse[256] = {
-    0xa5, 0x2d, 0x32, 0x8f, 0x0e, 0x30, 0x38, 0xc0, 0x54, 0xe6, 0x9e, 0x39, 0x55, 0x7e, 0x52, 0x91,
-    0x64, 0x03, 0x57, 0x5a, 0x1c, 0x60, 0x07, 0x18, 0x21, 0x72, 0xa8, 0xd1, 0x29, 0xc6, 0xa4, 0x3f,
-    0xe0, 0x27, 0x8d, 0x0c, 0x82, 0xea, 0xae, 0xb4, 0x9a, 0x63, 0x49, 0xe5, 0x42, 0xe4, 0x15, 0xb7,
-    0xc8, 0x06, 0x70, 0x9d, 0x41, 0x75, 0x19, 0xc9, 0xaa, 0xfc, 0x4d, 0xbf, 0x2a, 0x73, 0x84, 0xd5,
-    0xc3, 0xaf, 0x2b, 0x86, 0xa7, 0xb1, 0xb2, 0x5b, 0x46, 0xd3, 0x9f, 0xfd, 0xd4, 0x0f, 0x9c, 0x2f,
-    0x9b, 0x43, 0xef, 0xd9, 0x79, 0xb6, 0x53, 0x7f, 0xc1, 0xf0, 0x23, 0xe7, 0x25, 0x5e, 0xb5, 0x1e,
-    0xa2, 0xdf, 0xa6, 0xfe, 0xac, 0x22, 0xf9, 0xe2, 0x4a, 0xbc, 0x35, 0xca, 0xee, 0x78, 0x05, 0x6b,
-    0x51, 0xe1, 0x59, 0xa3, 0xf2, 0x71, 0x56, 0x11, 0x6a, 0x89, 0x94, 0x65, 0x8c, 0xbb, 0x77, 0x3c,
-    0x7b, 0x28, 0xab, 0xd2, 0x31, 0xde, 0xc4, 0x5f, 0xcc, 0xcf, 0x76, 0x2c, 0xb8, 0xd8, 0x2e, 0x36,
-    0xdb, 0x69, 0xb3, 0x14, 0x95, 0xbe, 0x62, 0xa1, 0x3b, 0x16, 0x66, 0xe9, 0x5c, 0x6c, 0x6d, 0xad,
-    0x37, 0x61, 0x4b, 0xb9, 0xe3, 0xba, 0xf1, 0xa0, 0x85, 0x83, 0xda, 0x47, 0xc5, 0xb0, 0x33, 0xfa,
-    0x96, 0x6f, 0x6e, 0xc2, 0xf6, 0x50, 0xff, 0x5d, 0xa9, 0x8e, 0x17, 0x1b, 0x97, 0x7d, 0xec, 0x58,
-    0xf7, 0x1f, 0xfb, 0x7c, 0x09, 0x0d, 0x7a, 0x67, 0x45, 0x87, 0xdc, 0xe8, 0x4f, 0x1d, 0x4e, 0x04,
-    0xeb, 0xf8, 0xf3, 0x3e, 0x3d, 0xbd, 0x8a, 0x88, 0xdd, 0xcd, 0x0b, 0x13, 0x98, 0x02, 0x93, 0x80,
-    0x90, 0xd0, 0x24, 0x34, 0xcb, 0xed, 0xf4, 0xce, 0x99, 0x10, 0x44, 0x40, 0x92, 0x3a, 0x01, 0x26,
-    0x12, 0x1a, 0x48, 0x68, 0xf5, 0x81, 0x8b, 0xc7, 0xd6, 0x20, 0x0a, 0x08, 0x00, 0x4c, 0xd7, 0x74
-};
+#define KUZNYECHIKP_LOOKUP_OFFSETS(a, odd, even)                         \
+    odd  = _mm_srli_epi16(_mm_and_si128(kuznyechikp_lookup_mask, a), 4); \
+    even = _mm_slli_epi16(_mm_andnot_si128(kuznyechikp_lookup_mask, a), 4)
 
 
 /**
- * @brief Linear transformation vector. Chapter 4.1.1 of GOST 34.12-2018
+ * @brief Reads a single lookup table entry
  */
-static const unsigned char kuznyechikp_linear_vector[16] = {
-    0x94, 0x20, 0x85, 0x10, 0xc2, 0xc0, 0x01, 0xfb, 0x01, 0xc0, 0xc2, 0x10, 0x85, 0x20, 0x94, 0x01
-};
+#define KUZNYECHIKP_LOOKUP_ENTRY(table, offsets, word, base) \
+    (*(const __m128i*)(table + _mm_extract_epi16(offsets, word) + (base)))
 
 
 /**
- * @brief Lookup table for computing LS trnsformation. Chapter 4.2 of GOST 34.12-2018
+ * @brief Processes a pair of bytes (one 16-bit word) of 4 interleaved blocks
  */
-BCLIB_ALIGN16 static unsigned char kuznyechikp_ls_lookup_table[16 * 256 * 16];
+#define KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, word)                                            \
+    a0 = _mm_xor_si128(a0, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even0, word, 0x2000 * word));         \
+    a1 = _mm_xor_si128(a1, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even1, word, 0x2000 * word));         \
+    a2 = _mm_xor_si128(a2, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even2, word, 0x2000 * word));         \
+    a3 = _mm_xor_si128(a3, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even3, word, 0x2000 * word));         \
+                                                                                                             \
+    a0 = _mm_xor_si128(a0, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd0, word, 0x2000 * word + 0x1000)); \
+    a1 = _mm_xor_si128(a1, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd1, word, 0x2000 * word + 0x1000)); \
+    a2 = _mm_xor_si128(a2, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd2, word, 0x2000 * word + 0x1000)); \
+    a3 = _mm_xor_si128(a3, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd3, word, 0x2000 * word + 0x1000))
 
 
 /**
- * @brief Lookup table for computing inverse L transformation. Chapter 4.2 of GOST 34.12-2018
+ * @brief Internal lookup table accessor for 4 interleaved blocks. Table loads
+ *        of independent blocks are mixed to hide their latency.
  */
-BCLIB_ALIGN16 static unsigned char kuznyechikp_linear_inverse_lookup_table[16 * 256 * 16];
+#define KUZNYECHIKP_XOR_LOOKUP4(table, a0, a1, a2, a3)                                    \
+    KUZNYECHIKP_LOOKUP_OFFSETS(a0, kuznyechikp_odd0, kuznyechikp_even0);                  \
+    KUZNYECHIKP_LOOKUP_OFFSETS(a1, kuznyechikp_odd1, kuznyechikp_even1);                  \
+    KUZNYECHIKP_LOOKUP_OFFSETS(a2, kuznyechikp_odd2, kuznyechikp_even2);                  \
+    KUZNYECHIKP_LOOKUP_OFFSETS(a3, kuznyechikp_odd3, kuznyechikp_even3);                  \
+                                                                                          \
+    a0 = KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even0, 0, 0);                        \
+    a1 = KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even1, 0, 0);                        \
+    a2 = KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even2, 0, 0);                        \
+    a3 = KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_even3, 0, 0);                        \
+                                                                                          \
+    a0 = _mm_xor_si128(a0, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd0, 0, 0x1000)); \
+    a1 = _mm_xor_si128(a1, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd1, 0, 0x1000)); \
+    a2 = _mm_xor_si128(a2, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd2, 0, 0x1000)); \
+    a3 = _mm_xor_si128(a3, KUZNYECHIKP_LOOKUP_ENTRY(table, kuznyechikp_odd3, 0, 0x1000)); \
+                                                                                          \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 1);                               \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 2);                               \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 3);                               \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 4);                               \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 5);                               \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 6);                               \
+    KUZNYECHIKP_XOR_LOOKUP4_WORD(table, a0, a1, a2, a3, 7)
 
 
 /**
- * @brief Lookup table for computing inverse of LS transformation. Chapter 4.2 of GOST 34.12-2018
- */
-BCLIB_ALIGN16 static unsigned char kuznyechikp_ls_inverse_lookup_table[16 * 256 * 16];
-
-
-/**
- * @brief Implementation of linear transformation.Chapter 4.1.2 of GOST 34.12-2018
+ * @brief X transformation.Chapter 4.2 of GOST 34.12-2018
  */
-static void kuznyechikp_linear_transform(unsigned char* inout)
-{
-    unsigned char temporary;
-    int idx1;
-    int idx2;
-
-    for (idx1 = 16; idx1; --idx1)
-    {
-        temporary = inout[15];
-
-        for (idx2 = 14; idx2 >= 0; --idx2)
-        {
-            inout[idx2 + 1] = inout[idx2];
-            temporary ^= gf8_multiply(inout[idx2], kuznyechikp_linear_vector[idx2]);
-        }
-
-        inout[0] = temporary;
-    }
-}
+#define KUZNYECHIKP_X(a, k) a = _mm_xor_si128(a, k)
 
 
 /**
- * @brief Implementation of linear transformation inverse.Chapter 4.1.2 of GOST 34.12-2018
+ * @brief LS transformation.Chapter 4.2 of GOST 34.12-2018
  */
-BCLIB_FORCEINLINE static void kuznyechikp_linear_transform_inverse(unsigned char* inout)
-{
-    unsigned char temporary;
-    int idx1;
-    int idx2;
-
-    for (idx1 = 16; idx1 > 0; --idx1)
-    {
-        temporary = inout[0];
-
-        for (idx2 = 0; idx2 < 15; ++idx2)
-        {
-            inout[idx2] = inout[idx2 + 1];
-            temporary ^= gf8_multiply(inout[idx2], kuznyechikp_linear_vector[idx2]);
-        }
-
-        inout[15] = temporary;
-    }
-}
+#define KUZNYECHIKP_LS(a) KUZNYECHIKP_XOR_LOOKUP(kuznyechikp_tables.ls, a)
 
 
 /**
- * @brief Initializes lookup tables for internal transformations.
+ * @brief Inverse of LS transformation.Chapter 4.2 of GOST 34.12-2018
  */
-BCLIB_FORCEINLINE static void kuznyechikp_initialize_tables()
-{
-    static char initialized = 0;
-
-    if (initialized)
-    {
-        return;
-    }
-
-    initialized = 1;
-
-    unsigned int idx1;
-    unsigned int idx2;
-    unsigned int table_offset = 0;
-
-    unsigned char* table_pointer;
-
-    for (idx1 = 0; idx1 < 16; ++idx1)
-    {
-        for (idx2 = 0; idx2 < 256; ++idx2)
-        {
-            //
-            // LS transformation (substitution and linear transformation)
-            //
-
-            table_pointer       = kuznyechikp_ls_lookup_table + table_offset;
-            table_pointer[idx1] = kuznyechikp_sbox[idx2];
-            kuznyechikp_linear_transform(table_pointer);
-
-            //
-            // Inverse of LS transformation
-            //
-
-            table_pointer       = kuznyechikp_ls_inverse_lookup_table + table_offset;
-            table_pointer[idx1] = kuznyechikp_sbox_inverse[idx2];
-            kuznyechikp_linear_transform_inverse(table_pointer);
-
-            //
-            // Inverse of linear transformation
-            //
-
-            table_pointer       = kuznyechikp_linear_inverse_lookup_table + table_offset;
-            table_pointer[idx1] = (unsigned char)idx2;
-            kuznyechikp_linear_transform_inverse(table_pointer);
-
-            table_offset += 16;
-        }
-    }
-}
+#define KUZNYECHIKP_ILS(a) KUZNYECHIKP_XOR_LOOKUP(kuznyechikp_tables.ls_inverse, a)
 
 
 /**
- * @brief Preparation for lookup tables usage
- */
-#define KUZNYECHIKP_XOR_LOOKUP_INIT()                                                               \
-    __m128i kuznyechikp_temporary1;                                                                 \
-    __m128i kuznyechikp_temporary2;                                                                 \
-    __m128i kuznyechikp_lookup_mask = _mm_setr_epi8(0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, \
-                                                    0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff)
-
-
-/**
- * @brief Internal lookup table accessor
+ * @brief Inverse of L transformation.Chapter 4.2 of GOST 34.12-2018
  */
-#define KUZNYECHIKP_XOR_LOOKUP(table, a)                                                                    \
-    kuznyechikp_temporary1 = _mm_and_si128(kuznyechikp_lookup_mask, a);                                     \
-    kuznyechikp_temporary2 = _mm_andnot_si128(kuznyechikp_lookup_mask, a);                                  \
-                                                                                                            \
-    kuznyechikp_temporary1 = _mm_srli_epi16(kuznyechikp_temporary1, 4);                                     \
-    kuznyechikp_temporary2 = _mm_slli_epi16(kuznyechikp_temporary2, 4);                                     \
-                                                                                                            \
-    a = _mm_load_si128((const void*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 0)));                \
-                                                                                                            \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 0) + 0x1000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 1) + 0x2000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 1) + 0x3000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 2) + 0x4000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 2) + 0x5000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 3) + 0x6000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 3) + 0x7000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 4) + 0x8000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 4) + 0x9000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 5) + 0xa000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 5) + 0xb000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 6) + 0xc000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 6) + 0xd000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary2, 7) + 0xe000)); \
-    a = _mm_xor_si128(a, *(const __m128i*)(table + _mm_extract_epi16(kuznyechikp_temporary1, 7) + 0xf000));
+#define KUZNYECHIKP_IL(a) KUZNYECHIKP_XOR_LOOKUP(kuznyechikp_tables.linear_inverse, a)
 
 
 /**
- * @brief X transformation.Chapter 4.2 of GOST 34.12-2018
+ * @brief X transformation for 4 interleaved blocks
  */
-#define KUZNYECHIKP_X(a, k) a = _mm_xor_si128(a, k)
+#define KUZNYECHIKP_X4(a0, a1, a2, a3, k) \
+    KUZNYECHIKP_X(a0, k);                 \
+    KUZNYECHIKP_X(a1, k);                 \
+    KUZNYECHIKP_X(a2, k);                 \
+    KUZNYECHIKP_X(a3, k)
 
 
 /**
- * @brief LS transformation.Chapter 4.2 of GOST 34.12-2018
+ * @brief LS transformation for 4 interleaved blocks
  */
-#define KUZNYECHIKP_LS(a) KUZNYECHIKP_XOR_LOOKUP(kuznyechikp_ls_lookup_table, a)
+#define KUZNYECHIKP_LS4(a0, a1, a2, a3) KUZNYECHIKP_XOR_LOOKUP4(kuznyechikp_tables.ls, a0, a1, a2, a3)
 
 
 /**
- * @brief Inverse of LS transformation.Chapter 4.2 of GOST 34.12-2018
+ * @brief Inverse of LS transformation for 4 interleaved blocks
  */
-#define KUZNYECHIKP_ILS(a) KUZNYECHIKP_XOR_LOOKUP(kuznyechikp_ls_inverse_lookup_table, a)
+#define KUZNYECHIKP_ILS4(a0, a1, a2, a3) KUZNYECHIKP_XOR_LOOKUP4(kuznyechikp_tables.ls_inverse, a0, a1, a2, a3)
 
 
 /**
- * @brief Inverse of L transformation.Chapter 4.2 of GOST 34.12-2018
+ * @brief Inverse of L transformation for 4 interleaved blocks
  */
-#define KUZNYECHIKP_IL(a) KUZNYECHIKP_XOR_LOOKUP(kuznyechikp_linear_inverse_lookup_table, a)
+#define KUZNYECHIKP_IL4(a0, a1, a2, a3) KUZNYECHIKP_XOR_LOOKUP4(kuznyechikp_tables.linear_inverse, a0, a1, a2, a3)
 
 
 /**
@@ -315,17 +226,26 @@ BCLIB_FORCEINLINE static void kuznyechikp_initialize_tables()
     }
 
 
-static void kuznyechik_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
+const KUZNYECHIK_TABLES kuznyechikp_static_tables = {
+    kuznyechikp_ls_lookup_table,
+    kuznyechikp_linear_inverse_lookup_table,
+    kuznyechikp_ls_inverse_lookup_table
+};
+
+
+void kuznyechik_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
 {
-    KUZNYECHIKP_XOR_LOOKUP_INIT();
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, ENCRYPT_BLOCK, 1);
+
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    KUZNYECHIKP_XOR_LOOKUP_INIT(KUZNYECHIKP_KEY_TABLES(internal_keys));
 
     //
     // Chapter 4.4.1 of GOST 34.12-2018
     // E(a) = X[K10] LS X[K9] ... LS X[K2] LS X[K1](a)
     //
 
-    __m128i temporary                 = in;
-    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    __m128i temporary = in;
 
     KUZNYECHIKP_X(temporary, internal_keys->key[0]);
     KUZNYECHIKP_LS(temporary);
@@ -348,20 +268,24 @@ static void kuznyechik_encrypt_block(const __m128i in, const KEY* round_keys, __
     KUZNYECHIKP_X(temporary, internal_keys->key[9]);
 
     *out = temporary;
+
+    INSTRUMENTATION_END();
 }
 
 
-static void kuznyechik_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
+void kuznyechik_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
 {
-    KUZNYECHIKP_XOR_LOOKUP_INIT();
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, DECRYPT_BLOCK, 1);
+
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    KUZNYECHIKP_XOR_LOOKUP_INIT(KUZNYECHIKP_KEY_TABLES(internal_keys));
 
     //
     // Chapter 4.4.2 of GOST 34.12-2018
     // D(a) = X[K1] ILS X[K2] ... ILS X[K9] ILS X[K10](a)
     //
 
-    __m128i temporary                 = in;
-    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    __m128i temporary = in;
 
     KUZNYECHIKP_IL(temporary);
     KUZNYECHIKP_X(temporary, internal_keys->key[9]);
@@ -385,102 +309,614 @@ static void kuznyechik_decrypt_block(const __m128i in, const KEY* round_keys, __
     KUZNYECHIKP_X(temporary, internal_keys->key[0]);
 
     *out = temporary;
+
+    INSTRUMENTATION_END();
 }
 
 
-void kuznyechik_initialize_encrypt_key(const unsigned char* key, KEY* round_keys)
+/**
+ * @brief Encrypts 4 blocks with interleaved rounds.
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_encrypt_blocks4(const __m128i* in, const INTERNAL_KEY* internal_keys, __m128i* out)
+{
+    KUZNYECHIKP_XOR_LOOKUP4_INIT(KUZNYECHIKP_KEY_TABLES(internal_keys));
+
+    unsigned int round;
+
+    __m128i a0 = _mm_loadu_si128(in + 0);
+    __m128i a1 = _mm_loadu_si128(in + 1);
+    __m128i a2 = _mm_loadu_si128(in + 2);
+    __m128i a3 = _mm_loadu_si128(in + 3);
+
+    for (round = 0; round < KUZNYECHIK_ROUNDS - 1; ++round)
+    {
+        KUZNYECHIKP_X4(a0, a1, a2, a3, internal_keys->key[round]);
+        KUZNYECHIKP_LS4(a0, a1, a2, a3);
+    }
+
+    KUZNYECHIKP_X4(a0, a1, a2, a3, internal_keys->key[KUZNYECHIK_ROUNDS - 1]);
+
+    _mm_storeu_si128(out + 0, a0);
+    _mm_storeu_si128(out + 1, a1);
+    _mm_storeu_si128(out + 2, a2);
+    _mm_storeu_si128(out + 3, a3);
+}
+
+
+/**
+ * @brief Decrypts 4 blocks with interleaved rounds.
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_decrypt_blocks4(const __m128i* in, const INTERNAL_KEY* internal_keys, __m128i* out)
+{
+    KUZNYECHIKP_XOR_LOOKUP4_INIT(KUZNYECHIKP_KEY_TABLES(internal_keys));
+
+    unsigned int round;
+
+    __m128i a0 = _mm_loadu_si128(in + 0);
+    __m128i a1 = _mm_loadu_si128(in + 1);
+    __m128i a2 = _mm_loadu_si128(in + 2);
+    __m128i a3 = _mm_loadu_si128(in + 3);
+
+    KUZNYECHIKP_IL4(a0, a1, a2, a3);
+
+    for (round = KUZNYECHIK_ROUNDS - 1; round > 1; --round)
+    {
+        KUZNYECHIKP_X4(a0, a1, a2, a3, internal_keys->key[round]);
+        KUZNYECHIKP_ILS4(a0, a1, a2, a3);
+    }
+
+    KUZNYECHIKP_X4(a0, a1, a2, a3, internal_keys->key[1]);
+
+    KUZNYECHIKP_IS(a0);
+    KUZNYECHIKP_IS(a1);
+    KUZNYECHIKP_IS(a2);
+    KUZNYECHIKP_IS(a3);
+
+    KUZNYECHIKP_X4(a0, a1, a2, a3, internal_keys->key[0]);
+
+    _mm_storeu_si128(out + 0, a0);
+    _mm_storeu_si128(out + 1, a1);
+    _mm_storeu_si128(out + 2, a2);
+    _mm_storeu_si128(out + 3, a3);
+}
+
+
+void kuznyechik_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
 {
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, ENCRYPT_BLOCKS, blocks_count);
+
     //
-    // Chapter 4.3 of GOST 34.12-2018
+    // Interleave independent blocks to hide table lookups latency,
+    // the tail is processed block by block
     //
 
-    INTERNAL_KEY* internal_keys = (INTERNAL_KEY*)round_keys;
+    __m128i temporary;
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+
+    for (; blocks_count >= KUZNYECHIKP_INTERLEAVE; blocks_count -= KUZNYECHIKP_INTERLEAVE)
+    {
+        kuznyechikp_encrypt_blocks4(in, internal_keys, out);
+
+        in += KUZNYECHIKP_INTERLEAVE;
+        out += KUZNYECHIKP_INTERLEAVE;
+    }
+
+    for (; blocks_count; --blocks_count)
+    {
+        kuznyechik_encrypt_block(_mm_loadu_si128(in++), round_keys, &temporary);
+        _mm_storeu_si128(out++, temporary);
+    }
+
+    INSTRUMENTATION_END();
+}
 
-    unsigned int idx1;
-    unsigned int idx2;
-    uint64_t x[4];
-    uint64_t z[2];
-    unsigned char temporary[16];
 
-    x[0] = ((uint64_t*)key)[0];
-    x[1] = ((uint64_t*)key)[1];
-    x[2] = ((uint64_t*)key)[2];
-    x[3] = ((uint64_t*)key)[3];
+void kuznyechik_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, DECRYPT_BLOCKS, blocks_count);
+
+    //
+    // Interleave independent blocks to hide table lookups latency,
+    // the tail is processed block by block
+    //
+
+    __m128i temporary;
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
 
-    ((uint64_t*)&internal_keys->key[0])[0] = x[0];
-    ((uint64_t*)&internal_keys->key[0])[1] = x[1];
-    ((uint64_t*)&internal_keys->key[1])[0] = x[2];
-    ((uint64_t*)&internal_keys->key[1])[1] = x[3];
+    for (; blocks_count >= KUZNYECHIKP_INTERLEAVE; blocks_count -= KUZNYECHIKP_INTERLEAVE)
+    {
+        kuznyechikp_decrypt_blocks4(in, internal_keys, out);
+
+        in += KUZNYECHIKP_INTERLEAVE;
+        out += KUZNYECHIKP_INTERLEAVE;
+    }
 
-    for (idx1 = 1; idx1 <= 32; ++idx1)
+    for (; blocks_count; --blocks_count)
     {
-        ((uint64_t*)temporary)[0] = 0;
-        ((uint64_t*)temporary)[1] = 0;
+        kuznyechik_decrypt_block(_mm_loadu_si128(in++), round_keys, &temporary);
+        _mm_storeu_si128(out++, temporary);
+    }
+
+    INSTRUMENTATION_END();
+}
 
-        temporary[15] = (unsigned char)idx1;
-        kuznyechikp_linear_transform(temporary);
 
-        z[0] = x[0] ^ ((uint64_t*)temporary)[0];
-        z[1] = x[1] ^ ((uint64_t*)temporary)[1];
+/**
+ * @brief Expands a key into encryption key schedule. Chapter 4.3 of GOST 34.12-2018.
+ *        Iteration constants are precomputed and each of 32 Feistel steps
+ *        uses LS lookup table.
+ * 
+ * @param key Binary key representation
+ * @param internal_keys Encryption key schedule
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_expand_key(const unsigned char* key, INTERNAL_KEY* internal_keys)
+{
+    KUZNYECHIKP_XOR_LOOKUP_INIT(kuznyechikp_static_tables);
+
+    unsigned int idx;
+    __m128i temporary;
+
+    const __m128i* constants = (const __m128i*)kuznyechikp_iteration_constants;
+
+    __m128i x0 = _mm_loadu_si128((const __m128i*)key);
+    __m128i x1 = _mm_loadu_si128((const __m128i*)key + 1);
+
+    internal_keys->key[0] = x0;
+    internal_keys->key[1] = x1;
+    internal_keys->tables = kuznyechikp_static_tables;
+
+    for (idx = 0; idx < 32; ++idx)
+    {
+        //
+        // F[C](x0, x1) = (LSX[C](x0) ^ x1, x0)
+        //
 
-        for (idx2 = 0; idx2 < 16; ++idx2)
+        temporary = _mm_xor_si128(x0, constants[idx]);
+        KUZNYECHIKP_LS(temporary);
+
+        temporary = _mm_xor_si128(temporary, x1);
+        x1        = x0;
+        x0        = temporary;
+
+        if ((idx & 7) == 7)
         {
-            ((unsigned char*)z)[idx2] = kuznyechikp_sbox[((unsigned char*)z)[idx2]];
+            internal_keys->key[((idx + 1) >> 2)]     = x0;
+            internal_keys->key[((idx + 1) >> 2) + 1] = x1;
         }
+    }
+}
+
+
+/**
+ * @brief Derives decryption key schedule from encryption one: inverse of L
+ *        is applied to keys 1..9 to be able to use ILS lookup table.
+ * 
+ * @param encrypt_keys Encryption key schedule
+ * @param decrypt_keys Decryption key schedule (may be equal to encrypt_keys)
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_derive_decrypt_key(const INTERNAL_KEY* encrypt_keys, INTERNAL_KEY* decrypt_keys)
+{
+    KUZNYECHIKP_XOR_LOOKUP_INIT(KUZNYECHIKP_KEY_TABLES(encrypt_keys));
+
+    unsigned int idx;
+    __m128i temporary;
 
-        kuznyechikp_linear_transform((unsigned char*)z);
+    decrypt_keys->key[0] = encrypt_keys->key[0];
+    decrypt_keys->tables = encrypt_keys->tables;
 
-        z[0] ^= x[2];
-        z[1] ^= x[3];
+    for (idx = 1; idx < KUZNYECHIK_ROUNDS; ++idx)
+    {
+        temporary = encrypt_keys->key[idx];
+        KUZNYECHIKP_IL(temporary);
 
-        x[2] = x[0];
-        x[3] = x[1];
+        decrypt_keys->key[idx] = temporary;
+    }
+}
 
-        x[0] = z[0];
-        x[1] = z[1];
 
-        if ((idx1 & 7) == 0)
+/**
+ * @brief Expands 4 keys into encryption key schedules simultaneously.
+ *        Key schedules are independent, so lookups are interleaved.
+ * 
+ * @param keys 4 binary key representations (one after another)
+ * @param internal_keys 4 encryption key schedules
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_expand_keys4(const unsigned char* keys, INTERNAL_KEY* internal_keys)
+{
+    KUZNYECHIKP_XOR_LOOKUP4_INIT(kuznyechikp_static_tables);
+
+    unsigned int idx;
+    __m128i t0, t1, t2, t3;
+
+    const __m128i* constants = (const __m128i*)kuznyechikp_iteration_constants;
+    const __m128i* raw_keys  = (const __m128i*)keys;
+
+    __m128i x00 = _mm_loadu_si128(raw_keys + 0);
+    __m128i x01 = _mm_loadu_si128(raw_keys + 1);
+    __m128i x10 = _mm_loadu_si128(raw_keys + 2);
+    __m128i x11 = _mm_loadu_si128(raw_keys + 3);
+    __m128i x20 = _mm_loadu_si128(raw_keys + 4);
+    __m128i x21 = _mm_loadu_si128(raw_keys + 5);
+    __m128i x30 = _mm_loadu_si128(raw_keys + 6);
+    __m128i x31 = _mm_loadu_si128(raw_keys + 7);
+
+    internal_keys[0].key[0] = x00;
+    internal_keys[0].key[1] = x01;
+    internal_keys[1].key[0] = x10;
+    internal_keys[1].key[1] = x11;
+    internal_keys[2].key[0] = x20;
+    internal_keys[2].key[1] = x21;
+    internal_keys[3].key[0] = x30;
+    internal_keys[3].key[1] = x31;
+
+    internal_keys[0].tables = kuznyechikp_static_tables;
+    internal_keys[1].tables = kuznyechikp_static_tables;
+    internal_keys[2].tables = kuznyechikp_static_tables;
+    internal_keys[3].tables = kuznyechikp_static_tables;
+
+    for (idx = 0; idx < 32; ++idx)
+    {
+        t0 = _mm_xor_si128(x00, constants[idx]);
+        t1 = _mm_xor_si128(x10, constants[idx]);
+        t2 = _mm_xor_si128(x20, constants[idx]);
+        t3 = _mm_xor_si128(x30, constants[idx]);
+
+        KUZNYECHIKP_LS4(t0, t1, t2, t3);
+
+        x01 = _mm_xor_si128(t0, x01);
+        x11 = _mm_xor_si128(t1, x11);
+        x21 = _mm_xor_si128(t2, x21);
+        x31 = _mm_xor_si128(t3, x31);
+
+        //
+        // Swap halves (x0, x1) -> (x1, x0) in each schedule
+        //
+
+        t0 = x00, x00 = x01, x01 = t0;
+        t1 = x10, x10 = x11, x11 = t1;
+        t2 = x20, x20 = x21, x21 = t2;
+        t3 = x30, x30 = x31, x31 = t3;
+
+        if ((idx & 7) == 7)
         {
-            ((uint64_t*)&internal_keys->key[(idx1 >> 2)])[0]     = x[0];
-            ((uint64_t*)&internal_keys->key[(idx1 >> 2)])[1]     = x[1];
-            ((uint64_t*)&internal_keys->key[(idx1 >> 2) + 1])[0] = x[2];
-            ((uint64_t*)&internal_keys->key[(idx1 >> 2) + 1])[1] = x[3];
+            internal_keys[0].key[((idx + 1) >> 2)]     = x00;
+            internal_keys[0].key[((idx + 1) >> 2) + 1] = x01;
+            internal_keys[1].key[((idx + 1) >> 2)]     = x10;
+            internal_keys[1].key[((idx + 1) >> 2) + 1] = x11;
+            internal_keys[2].key[((idx + 1) >> 2)]     = x20;
+            internal_keys[2].key[((idx + 1) >> 2) + 1] = x21;
+            internal_keys[3].key[((idx + 1) >> 2)]     = x30;
+            internal_keys[3].key[((idx + 1) >> 2) + 1] = x31;
         }
     }
 }
 
 
+/**
+ * @brief Derives 4 decryption key schedules from encryption ones simultaneously.
+ * 
+ * @param encrypt_keys 4 encryption key schedules
+ * @param decrypt_keys 4 decryption key schedules
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_derive_decrypt_keys4(const INTERNAL_KEY* encrypt_keys, INTERNAL_KEY* decrypt_keys)
+{
+    KUZNYECHIKP_XOR_LOOKUP4_INIT(KUZNYECHIKP_KEY_TABLES(encrypt_keys));
+
+    unsigned int idx;
+    __m128i t0, t1, t2, t3;
+
+    decrypt_keys[0].key[0] = encrypt_keys[0].key[0];
+    decrypt_keys[1].key[0] = encrypt_keys[1].key[0];
+    decrypt_keys[2].key[0] = encrypt_keys[2].key[0];
+    decrypt_keys[3].key[0] = encrypt_keys[3].key[0];
+
+    decrypt_keys[0].tables = encrypt_keys[0].tables;
+    decrypt_keys[1].tables = encrypt_keys[1].tables;
+    decrypt_keys[2].tables = encrypt_keys[2].tables;
+    decrypt_keys[3].tables = encrypt_keys[3].tables;
+
+    for (idx = 1; idx < KUZNYECHIK_ROUNDS; ++idx)
+    {
+        t0 = encrypt_keys[0].key[idx];
+        t1 = encrypt_keys[1].key[idx];
+        t2 = encrypt_keys[2].key[idx];
+        t3 = encrypt_keys[3].key[idx];
+
+        KUZNYECHIKP_IL4(t0, t1, t2, t3);
+
+        decrypt_keys[0].key[idx] = t0;
+        decrypt_keys[1].key[idx] = t1;
+        decrypt_keys[2].key[idx] = t2;
+        decrypt_keys[3].key[idx] = t3;
+    }
+}
+
+
+void kuznyechik_initialize_encrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, KEY_SETUP, 1);
+
+    kuznyechikp_expand_key(key, (INTERNAL_KEY*)round_keys);
+
+    INSTRUMENTATION_END();
+}
+
+
 void kuznyechik_initialize_decrypt_key(const unsigned char* key, KEY* round_keys)
 {
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, KEY_SETUP, 1);
+
+    INTERNAL_KEY* internal_keys = (INTERNAL_KEY*)round_keys;
+
+    kuznyechikp_expand_key(key, internal_keys);
+    kuznyechikp_derive_decrypt_key(internal_keys, internal_keys);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, KEY_SETUP, 1);
+
+    kuznyechikp_expand_key(key, (INTERNAL_KEY*)encrypt_round_keys);
+    kuznyechikp_derive_decrypt_key((const INTERNAL_KEY*)encrypt_round_keys, (INTERNAL_KEY*)decrypt_round_keys);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_GENERIC, KEY_SETUP, keys_count);
+
+    BCLIB_ALIGN16 INTERNAL_KEY encrypt_keys[KUZNYECHIKP_INTERLEAVE];
+    BCLIB_ALIGN16 INTERNAL_KEY decrypt_keys[KUZNYECHIKP_INTERLEAVE];
+
+    unsigned int idx;
+
     //
-    // Chapter 4.3 of GOST 34.12-2018
+    // KEY is larger than INTERNAL_KEY, hence schedules are
+    // expanded into a local array and then copied
     //
 
-    unsigned int idx;
-    INTERNAL_KEY* internal_keys = (INTERNAL_KEY*)round_keys;
+    for (; keys_count >= KUZNYECHIKP_INTERLEAVE; keys_count -= KUZNYECHIKP_INTERLEAVE)
+    {
+        kuznyechikp_expand_keys4(keys, encrypt_keys);
 
-    kuznyechik_initialize_encrypt_key(key, round_keys);
+        if (decrypt_round_keys)
+        {
+            kuznyechikp_derive_decrypt_keys4(encrypt_keys, decrypt_keys);
+        }
 
-    for (idx = 1; idx < KUZNYECHIK_ROUNDS; ++idx)
+        for (idx = 0; idx < KUZNYECHIKP_INTERLEAVE; ++idx)
+        {
+            *(INTERNAL_KEY*)(encrypt_round_keys++) = encrypt_keys[idx];
+
+            if (decrypt_round_keys)
+            {
+                *(INTERNAL_KEY*)(decrypt_round_keys++) = decrypt_keys[idx];
+            }
+        }
+
+        keys += KUZNYECHIKP_INTERLEAVE * KUZNYECHIK_KEY_SIZE;
+    }
+
+    for (; keys_count; --keys_count)
     {
-        kuznyechikp_linear_transform_inverse((unsigned char*)&internal_keys->key[idx]);
+        kuznyechikp_expand_key(keys, (INTERNAL_KEY*)encrypt_round_keys);
+
+        if (decrypt_round_keys)
+        {
+            kuznyechikp_derive_decrypt_key((const INTERNAL_KEY*)encrypt_round_keys, (INTERNAL_KEY*)decrypt_round_keys++);
+        }
+
+        encrypt_round_keys++;
+        keys += KUZNYECHIK_KEY_SIZE;
     }
+
+    INSTRUMENTATION_END();
 }
 
 
-void kuznyechik_initialize_interface(BLOCK_CIPHER* cipher)
+/**
+ * @brief Reads an engine forced by environment variable.
+ * 
+ * @param engine Forced engine (is not modified if there is no one)
+ * @return Nonzero if engine is forced.
+ */
+static int kuznyechikp_forced_engine(KUZNYECHIK_ENGINE* engine)
+{
+#if !defined(BCLIB_KERNEL_MODE_BUILD)
+    static const struct
+    {
+        const char* name;
+        KUZNYECHIK_ENGINE engine;
+    } engines[] = {
+        { "generic", KUZNYECHIK_ENGINE_GENERIC },
+        { "avx2", KUZNYECHIK_ENGINE_AVX2 },
+        { "avx512", KUZNYECHIK_ENGINE_AVX512 },
+        { "constant-time", KUZNYECHIK_ENGINE_CONSTANT_TIME },
+        { "compact", KUZNYECHIK_ENGINE_COMPACT }
+    };
+
+    const char* value = getenv(KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE);
+    size_t idx;
+
+    if (!value)
+    {
+        return 0;
+    }
+
+    for (idx = 0; idx < sizeof(engines) / sizeof(*engines); ++idx)
+    {
+        if (strcmp(value, engines[idx].name) == 0)
+        {
+            *engine = engines[idx].engine;
+            return 1;
+        }
+    }
+#else
+    (void)engine;
+#endif  // !BCLIB_KERNEL_MODE_BUILD
+
+    return 0;
+}
+
+
+int kuznyechik_engine_supported(KUZNYECHIK_ENGINE engine)
+{
+    switch (engine)
+    {
+    case KUZNYECHIK_ENGINE_AVX2:
+    case KUZNYECHIK_ENGINE_CONSTANT_TIME:
+        return cpu_supports(CPU_FEATURE_AVX2);
+
+    case KUZNYECHIK_ENGINE_AVX512:
+        return cpu_supports(CPU_FEATURE_AVX512F | CPU_FEATURE_AVX512BW | CPU_FEATURE_AVX512VBMI | CPU_FEATURE_GFNI);
+
+    default:
+        return cpu_supports(CPU_FEATURE_SSE2);
+    }
+}
+
+
+KUZNYECHIK_ENGINE kuznyechik_select_engine(void)
+{
+    KUZNYECHIK_ENGINE engine;
+
+    if (kuznyechikp_forced_engine(&engine) && kuznyechik_engine_supported(engine))
+    {
+        return engine;
+    }
+
+    //
+    // Constant-time and compact engines are slower for bulk data,
+    // so they are used only if requested explicitly
+    //
+
+    if (kuznyechik_engine_supported(KUZNYECHIK_ENGINE_AVX512))
+    {
+        return KUZNYECHIK_ENGINE_AVX512;
+    }
+
+    if (kuznyechik_engine_supported(KUZNYECHIK_ENGINE_AVX2))
+    {
+        return KUZNYECHIK_ENGINE_AVX2;
+    }
+
+    return KUZNYECHIK_ENGINE_GENERIC;
+}
+
+
+void kuznyechik_warm_up(const KEY* round_keys)
 {
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    const KUZNYECHIK_TABLES tables    = KUZNYECHIKP_KEY_TABLES(internal_keys);
+
+    size_t offset;
+
     //
-    // Perform initialization first
+    // Every cache line of tables is touched, hence TLB entries
+    // are loaded as well
     //
 
-    kuznyechikp_initialize_tables();
+    for (offset = 0; offset < KUZNYECHIKP_TABLE_SIZE; offset += 64)
+    {
+        _mm_prefetch((const char*)tables.ls + offset, _MM_HINT_T0);
+        _mm_prefetch((const char*)tables.linear_inverse + offset, _MM_HINT_T0);
+        _mm_prefetch((const char*)tables.ls_inverse + offset, _MM_HINT_T0);
+    }
+
+    for (offset = 0; offset < sizeof(kuznyechikp_sbox_inverse); offset += 64)
+    {
+        _mm_prefetch((const char*)kuznyechikp_sbox_inverse + offset, _MM_HINT_T0);
+    }
+
+    for (offset = 0; offset < sizeof(INTERNAL_KEY); offset += 64)
+    {
+        _mm_prefetch((const char*)internal_keys + offset, _MM_HINT_T0);
+    }
+}
+
+
+void kuznyechik_initialize_interface(BLOCK_CIPHER* cipher)
+{
+    kuznyechik_initialize_interface_ex(cipher, kuznyechik_select_engine());
+}
 
+
+void kuznyechik_initialize_interface_ex(BLOCK_CIPHER* cipher, KUZNYECHIK_ENGINE engine)
+{
     cipher->block_size = KUZNYECHIK_BLOCK_SIZE;
     cipher->key_size   = KUZNYECHIK_KEY_SIZE;
+    cipher->interleave = KUZNYECHIK_GENERIC_INTERLEAVE;
 
     cipher->encrypt_block          = kuznyechik_encrypt_block;
     cipher->decrypt_block          = kuznyechik_decrypt_block;
+    cipher->encrypt_blocks         = kuznyechik_encrypt_blocks;
+    cipher->decrypt_blocks         = kuznyechik_decrypt_blocks;
     cipher->initialize_encrypt_key = kuznyechik_initialize_encrypt_key;
     cipher->initialize_decrypt_key = kuznyechik_initialize_decrypt_key;
+    cipher->initialize_keys        = kuznyechik_initialize_keys;
+    cipher->initialize_keys_batch  = kuznyechik_initialize_keys_batch;
+
+    //
+    // Single block procedures are the same for all engines:
+    // latency of lookup tables is the best one here
+    //
+
+    switch (engine)
+    {
+    case KUZNYECHIK_ENGINE_AVX2:
+        cipher->interleave     = KUZNYECHIK_AVX2_INTERLEAVE;
+        cipher->encrypt_blocks = kuznyechik_avx2_encrypt_blocks;
+        cipher->decrypt_blocks = kuznyechik_avx2_decrypt_blocks;
+        break;
+
+    case KUZNYECHIK_ENGINE_AVX512:
+        cipher->interleave     = KUZNYECHIK_AVX512_INTERLEAVE;
+        cipher->encrypt_blocks = kuznyechik_avx512_encrypt_blocks;
+        cipher->decrypt_blocks = kuznyechik_avx512_decrypt_blocks;
+        break;
+
+    case KUZNYECHIK_ENGINE_CONSTANT_TIME:
+
+        //
+        // Single block and key setup procedures are replaced here too, 
+        // otherwise lookup tables would be indexed by secret data
+        //
+
+        cipher->interleave             = KUZNYECHIK_CONSTANT_TIME_INTERLEAVE;
+        cipher->encrypt_block          = kuznyechik_sliced_encrypt_block;
+        cipher->decrypt_block          = kuznyechik_sliced_decrypt_block;
+        cipher->encrypt_blocks         = kuznyechik_sliced_encrypt_blocks;
+        cipher->decrypt_blocks         = kuznyechik_sliced_decrypt_blocks;
+        cipher->initialize_encrypt_key = kuznyechik_sliced_initialize_encrypt_key;
+        cipher->initialize_decrypt_key = kuznyechik_sliced_initialize_decrypt_key;
+        cipher->initialize_keys        = kuznyechik_sliced_initialize_keys;
+        cipher->initialize_keys_batch  = kuznyechik_sliced_initialize_keys_batch;
+        break;
+
+    case KUZNYECHIK_ENGINE_COMPACT:
+
+        //
+        // The same as above: single block and key setup procedures
+        // must not touch large tables too
+        //
+
+        cipher->interleave             = KUZNYECHIK_COMPACT_INTERLEAVE;
+        cipher->encrypt_block          = kuznyechik_compact_encrypt_block;
+        cipher->decrypt_block          = kuznyechik_compact_decrypt_block;
+        cipher->encrypt_blocks         = kuznyechik_compact_encrypt_blocks;
+        cipher->decrypt_blocks         = kuznyechik_compact_decrypt_blocks;
+        cipher->initialize_encrypt_key = kuznyechik_compact_initialize_encrypt_key;
+        cipher->initialize_decrypt_key = kuznyechik_compact_initialize_decrypt_key;
+        cipher->initialize_keys        = kuznyechik_compact_initialize_keys;
+        cipher->initialize_keys_batch  = kuznyechik_compact_initialize_keys_batch;
+        break;
+
+    default:
+        break;
+    }
 }
@@ -0,0 +1,251 @@
+/**
+ * @file kuznyechik_avx2.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Kuznyechik block cipher (AVX2 engine)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/kuznyechik/kuznyechik.h"
+#include "common/utils.h"
+
+#include "kuznyechik_internal.h"
+#include "instrumentation_internal.h"
+
+#include <immintrin.h>
+
+
+//
+// This engine is still table-based: each round does 16 pairs of 128-bit
+// lookups per register (one entry for each of its 2 blocks), L is not
+// vectorized. Only offsets computation and X transformation use 256-bit
+// registers, so the gain over generic engine is modest (10-20% on 256 block
+// buffers). Gathers are not used: a 16-byte entry needs two 64-bit lanes,
+// which is not cheaper than two ordinary loads
+//
+
+
+/**
+ * @brief Number of registers processed simultaneously.
+ */
+#define KUZNYECHIKP_AVX2_REGISTERS 4
+
+
+/**
+ * @brief Number of blocks processed simultaneously (2 blocks per register).
+ */
+#define KUZNYECHIKP_AVX2_BLOCKS (2 * KUZNYECHIKP_AVX2_REGISTERS)
+
+BCLIB_STATIC_ASSERT(KUZNYECHIKP_AVX2_BLOCKS == KUZNYECHIK_AVX2_INTERLEAVE, kuznyechik_avx2_interleave_mismatch);
+
+
+/**
+ * @brief Lookup table offsets of all bytes of 2 blocks held in a register.
+ */
+typedef struct tagKUZNYECHIKP_AVX2_OFFSETS
+{
+    BCLIB_ALIGN16 unsigned short odd[16];  /**< Offsets of odd bytes (first block, then second one) */
+    BCLIB_ALIGN16 unsigned short even[16]; /**< Offsets of even bytes (first block, then second one) */
+} KUZNYECHIKP_AVX2_OFFSETS;
+
+
+/**
+ * @brief Computes lookup table offsets of all bytes in a register with a few 
+ *        vector instructions (unlike 16 extractions per block in generic engine)
+ */
+#define KUZNYECHIKP_AVX2_OFFSETS(a, offsets)                                                                    \
+    _mm256_storeu_si256((__m256i*)(offsets).odd, _mm256_srli_epi16(_mm256_and_si256(lookup_mask, a), 4));      \
+    _mm256_storeu_si256((__m256i*)(offsets).even, _mm256_slli_epi16(_mm256_andnot_si256(lookup_mask, a), 4))
+
+
+/**
+ * @brief Reads lookup table entries for a byte of both blocks of a register
+ */
+#define KUZNYECHIKP_AVX2_ENTRY(table, offsets, word, base)                                                  \
+    _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_load_si128(                                        \
+                                (const __m128i*)(table + (offsets)[word] + (base)))),                      \
+                            _mm_load_si128((const __m128i*)(table + (offsets)[(word) + 8] + (base))), 1)
+
+
+/**
+ * @brief Internal lookup table accessor for all registers
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx2_xor_lookup(const unsigned char* table, __m256i* a)
+{
+    const __m256i lookup_mask = _mm256_set1_epi16((short)0xff00);
+
+    KUZNYECHIKP_AVX2_OFFSETS offsets[KUZNYECHIKP_AVX2_REGISTERS];
+    unsigned int word;
+    unsigned int base;
+
+    KUZNYECHIKP_AVX2_OFFSETS(a[0], offsets[0]);
+    KUZNYECHIKP_AVX2_OFFSETS(a[1], offsets[1]);
+    KUZNYECHIKP_AVX2_OFFSETS(a[2], offsets[2]);
+    KUZNYECHIKP_AVX2_OFFSETS(a[3], offsets[3]);
+
+    a[0] = KUZNYECHIKP_AVX2_ENTRY(table, offsets[0].even, 0, 0);
+    a[1] = KUZNYECHIKP_AVX2_ENTRY(table, offsets[1].even, 0, 0);
+    a[2] = KUZNYECHIKP_AVX2_ENTRY(table, offsets[2].even, 0, 0);
+    a[3] = KUZNYECHIKP_AVX2_ENTRY(table, offsets[3].even, 0, 0);
+
+    for (word = 0; word < 8; ++word)
+    {
+        base = 0x2000 * word;
+
+        if (word)
+        {
+            a[0] = _mm256_xor_si256(a[0], KUZNYECHIKP_AVX2_ENTRY(table, offsets[0].even, word, base));
+            a[1] = _mm256_xor_si256(a[1], KUZNYECHIKP_AVX2_ENTRY(table, offsets[1].even, word, base));
+            a[2] = _mm256_xor_si256(a[2], KUZNYECHIKP_AVX2_ENTRY(table, offsets[2].even, word, base));
+            a[3] = _mm256_xor_si256(a[3], KUZNYECHIKP_AVX2_ENTRY(table, offsets[3].even, word, base));
+        }
+
+        a[0] = _mm256_xor_si256(a[0], KUZNYECHIKP_AVX2_ENTRY(table, offsets[0].odd, word, base + 0x1000));
+        a[1] = _mm256_xor_si256(a[1], KUZNYECHIKP_AVX2_ENTRY(table, offsets[1].odd, word, base + 0x1000));
+        a[2] = _mm256_xor_si256(a[2], KUZNYECHIKP_AVX2_ENTRY(table, offsets[2].odd, word, base + 0x1000));
+        a[3] = _mm256_xor_si256(a[3], KUZNYECHIKP_AVX2_ENTRY(table, offsets[3].odd, word, base + 0x1000));
+    }
+}
+
+
+/**
+ * @brief X transformation for all registers
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx2_x(__m256i* a, const __m128i* k)
+{
+    const __m256i key = _mm256_broadcastsi128_si256(_mm_load_si128(k));
+
+    a[0] = _mm256_xor_si256(a[0], key);
+    a[1] = _mm256_xor_si256(a[1], key);
+    a[2] = _mm256_xor_si256(a[2], key);
+    a[3] = _mm256_xor_si256(a[3], key);
+}
+
+
+/**
+ * @brief Loads blocks into registers (2 consequent blocks per register)
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx2_load(const __m128i* in, __m256i* a)
+{
+    a[0] = _mm256_loadu_si256((const __m256i*)in + 0);
+    a[1] = _mm256_loadu_si256((const __m256i*)in + 1);
+    a[2] = _mm256_loadu_si256((const __m256i*)in + 2);
+    a[3] = _mm256_loadu_si256((const __m256i*)in + 3);
+}
+
+
+/**
+ * @brief Stores registers into blocks
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx2_store(const __m256i* a, __m128i* out)
+{
+    _mm256_storeu_si256((__m256i*)out + 0, a[0]);
+    _mm256_storeu_si256((__m256i*)out + 1, a[1]);
+    _mm256_storeu_si256((__m256i*)out + 2, a[2]);
+    _mm256_storeu_si256((__m256i*)out + 3, a[3]);
+}
+
+
+void kuznyechik_avx2_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_AVX2, ENCRYPT_BLOCKS, blocks_count);
+
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    const KUZNYECHIK_TABLES tables    = KUZNYECHIKP_KEY_TABLES(internal_keys);
+
+    __m256i a[KUZNYECHIKP_AVX2_REGISTERS];
+    unsigned int round;
+
+    for (; blocks_count >= KUZNYECHIKP_AVX2_BLOCKS; blocks_count -= KUZNYECHIKP_AVX2_BLOCKS)
+    {
+        //
+        // Chapter 4.4.1 of GOST 34.12-2018
+        // E(a) = X[K10] LS X[K9] ... LS X[K2] LS X[K1](a)
+        //
+
+        kuznyechikp_avx2_load(in, a);
+
+        for (round = 0; round < KUZNYECHIK_ROUNDS - 1; ++round)
+        {
+            kuznyechikp_avx2_x(a, &internal_keys->key[round]);
+            kuznyechikp_avx2_xor_lookup(tables.ls, a);
+        }
+
+        kuznyechikp_avx2_x(a, &internal_keys->key[KUZNYECHIK_ROUNDS - 1]);
+
+        kuznyechikp_avx2_store(a, out);
+
+        in += KUZNYECHIKP_AVX2_BLOCKS;
+        out += KUZNYECHIKP_AVX2_BLOCKS;
+    }
+
+    //
+    // The rest of blocks is processed by generic engine
+    //
+
+    kuznyechik_encrypt_blocks(in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_avx2_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_AVX2, DECRYPT_BLOCKS, blocks_count);
+
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+    const KUZNYECHIK_TABLES tables    = KUZNYECHIKP_KEY_TABLES(internal_keys);
+
+    BCLIB_ALIGN16 unsigned char bytes[KUZNYECHIKP_AVX2_BLOCKS * KUZNYECHIK_BLOCK_SIZE];
+    __m256i a[KUZNYECHIKP_AVX2_REGISTERS];
+    unsigned int round;
+    unsigned int idx;
+
+    for (; blocks_count >= KUZNYECHIKP_AVX2_BLOCKS; blocks_count -= KUZNYECHIKP_AVX2_BLOCKS)
+    {
+        //
+        // Chapter 4.4.2 of GOST 34.12-2018
+        // D(a) = X[K1] ILS X[K2] ... ILS X[K9] ILS X[K10](a)
+        //
+
+        kuznyechikp_avx2_load(in, a);
+        kuznyechikp_avx2_xor_lookup(tables.linear_inverse, a);
+
+        for (round = KUZNYECHIK_ROUNDS - 1; round > 1; --round)
+        {
+            kuznyechikp_avx2_x(a, &internal_keys->key[round]);
+            kuznyechikp_avx2_xor_lookup(tables.ls_inverse, a);
+        }
+
+        kuznyechikp_avx2_x(a, &internal_keys->key[1]);
+
+        //
+        // Inverse of S transformation is performed in local buffer, so
+        // caller's memory is written only once
+        //
+
+        kuznyechikp_avx2_store(a, (__m128i*)bytes);
+
+        for (idx = 0; idx < KUZNYECHIKP_AVX2_BLOCKS * KUZNYECHIK_BLOCK_SIZE; ++idx)
+        {
+            bytes[idx] = kuznyechikp_sbox_inverse[bytes[idx]];
+        }
+
+        kuznyechikp_avx2_load((const __m128i*)bytes, a);
+        kuznyechikp_avx2_x(a, &internal_keys->key[0]);
+        kuznyechikp_avx2_store(a, out);
+
+        in += KUZNYECHIKP_AVX2_BLOCKS;
+        out += KUZNYECHIKP_AVX2_BLOCKS;
+    }
+
+    //
+    // The rest of blocks is processed by generic engine
+    //
+
+    kuznyechik_decrypt_blocks(in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
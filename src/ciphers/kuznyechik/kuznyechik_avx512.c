@@ -0,0 +1,391 @@
+/**
+ * @file kuznyechik_avx512.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Kuznyechik block cipher (AVX-512 and GFNI engine)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/kuznyechik/kuznyechik.h"
+#include "common/utils.h"
+
+#include "kuznyechik_internal.h"
+#include "instrumentation_internal.h"
+
+#include <immintrin.h>
+
+
+//
+// GFNI instructions multiply in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1 (AES polynomial),
+// while Kuznyechik uses x^8 + x^7 + x^6 + x + 1. Fields are isomorphic, hence the whole
+// cipher is evaluated in AES representation: data and keys are converted with a single 
+// affine instruction, S-boxes and linear transformation matrices are precomputed for
+// this representation. Isomorphism maps x to 0x30 (a root of Kuznyechik polynomial 
+// in AES field).
+//
+
+
+/**
+ * @brief Number of registers processed simultaneously.
+ */
+#define KUZNYECHIKP_AVX512_REGISTERS 2
+
+
+/**
+ * @brief Number of blocks in a register.
+ */
+#define KUZNYECHIKP_AVX512_REGISTER_BLOCKS 4
+
+BCLIB_STATIC_ASSERT(KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS == KUZNYECHIK_AVX512_INTERLEAVE,
+                    kuznyechik_avx512_interleave_mismatch);
+
+
+/**
+ * @brief Isomorphism from Kuznyechik field to AES field (GF2P8AFFINEQB matrix).
+ */
+#define KUZNYECHIKP_AVX512_TO_AES_FIELD 0x5d0ce430cee6bcd0ull
+
+
+/**
+ * @brief Isomorphism from AES field to Kuznyechik field (GF2P8AFFINEQB matrix).
+ */
+#define KUZNYECHIKP_AVX512_FROM_AES_FIELD 0xc9248c8eb6be7c4aull
+
+
+/**
+ * @brief SBox in AES field representation.
+ */
+static const unsigned char kuznyechikp_avx512_sbox[256] = {
+    0xc0, 0x39, 0xd0, 0xa9, 0x25, 0x3a, 0xec, 0xa2, 0x5b, 0x45, 0x24, 0x53, 0x9c, 0x09, 0x85, 0x81,
+    0x95, 0x66, 0xa5, 0xe3, 0x77, 0x90, 0x0a, 0x79, 0x94, 0xa1, 0x58, 0x1d, 0xef, 0x9f, 0xf3, 0xf8,
+    0x9b, 0x80, 0xbb, 0x5a, 0x5d, 0x37, 0x2a, 0x68, 0xd6, 0x63, 0x6d, 0x38, 0x11, 0x6c, 0x20, 0x44,
+    0xad, 0xc8, 0xee, 0x35, 0x70, 0x74, 0xb3, 0xbc, 0x4c, 0xfd, 0xf9, 0x57, 0x15, 0x2d, 0xed, 0xf5,
+    0x2f, 0x46, 0x0b, 0xfc, 0xc7, 0x4b, 0x8e, 0xa4, 0x96, 0x01, 0x73, 0x4a, 0x14, 0x3b, 0x1a, 0x88,
+    0xc3, 0xbd, 0x36, 0x86, 0xa6, 0x6b, 0x04, 0x97, 0x19, 0x17, 0x49, 0x0e, 0xaf, 0x1f, 0x3f, 0x7c,
+    0x0d, 0xf2, 0xeb, 0x87, 0xda, 0xa7, 0xd3, 0xf1, 0x59, 0xb2, 0x52, 0x1e, 0xb6, 0x9a, 0xac, 0x7e,
+    0xb5, 0x60, 0xf4, 0x06, 0xfe, 0x8b, 0xcd, 0x54, 0xe0, 0xa0, 0x51, 0x75, 0x27, 0x10, 0x23, 0x5f,
+    0xff, 0x05, 0xcb, 0xb1, 0x7d, 0x48, 0x71, 0x8d, 0x2c, 0xab, 0xd5, 0x3c, 0x2b, 0xb4, 0x6f, 0x32,
+    0xc6, 0xc1, 0x93, 0x6a, 0x8c, 0x30, 0xa3, 0xcf, 0xde, 0x7b, 0x8f, 0xe2, 0x82, 0xd8, 0x5e, 0x07,
+    0x65, 0x55, 0x41, 0x26, 0x83, 0x76, 0x42, 0xce, 0xd9, 0x21, 0xe5, 0x33, 0x22, 0xdb, 0xc9, 0x72,
+    0xdc, 0xb9, 0x13, 0x84, 0xd2, 0x4f, 0x9e, 0x89, 0xc5, 0xe7, 0x43, 0xcc, 0xae, 0x28, 0x0c, 0x78,
+    0xf7, 0xd7, 0x4e, 0x12, 0x1b, 0xca, 0x08, 0x6e, 0x56, 0x7f, 0x02, 0xaa, 0x50, 0x61, 0xf0, 0xb7,
+    0x34, 0x5c, 0x1c, 0xba, 0x67, 0xb8, 0x8a, 0xa8, 0x99, 0xbf, 0x4d, 0xd1, 0x40, 0x69, 0xc2, 0xe9,
+    0x03, 0x31, 0xe1, 0x98, 0x2e, 0xdf, 0xd4, 0x0f, 0x3e, 0x7a, 0x3d, 0xfb, 0x64, 0xbe, 0x00, 0xdd,
+    0xe8, 0x16, 0xe6, 0xfa, 0x9d, 0x92, 0x47, 0x62, 0xea, 0xe4, 0xc4, 0xf6, 0x29, 0x18, 0xb0, 0x91
+};
+
+
+/**
+ * @brief Inverse of SBox in AES field representation.
+ */
+static const unsigned char kuznyechikp_avx512_sbox_inverse[256] = {
+    0xee, 0x49, 0xca, 0xe0, 0x56, 0x81, 0x73, 0x9f, 0xc6, 0x0d, 0x16, 0x42, 0xbe, 0x60, 0x5b, 0xe7,
+    0x7d, 0x2c, 0xc3, 0xb2, 0x4c, 0x3c, 0xf1, 0x59, 0xfd, 0x58, 0x4e, 0xc4, 0xd2, 0x1b, 0x6b, 0x5d,
+    0x2e, 0xa9, 0xac, 0x7e, 0x0a, 0x04, 0xa3, 0x7c, 0xbd, 0xfc, 0x26, 0x8c, 0x88, 0x3d, 0xe4, 0x40,
+    0x95, 0xe1, 0x8f, 0xab, 0xd0, 0x33, 0x52, 0x25, 0x2b, 0x01, 0x05, 0x4d, 0x8b, 0xea, 0xe8, 0x5e,
+    0xdc, 0xa2, 0xa6, 0xba, 0x2f, 0x09, 0x41, 0xf6, 0x85, 0x5a, 0x4b, 0x45, 0x38, 0xda, 0xc2, 0xb5,
+    0xcc, 0x7a, 0x6a, 0x0b, 0x77, 0xa1, 0xc8, 0x3b, 0x1a, 0x68, 0x23, 0x08, 0xd1, 0x24, 0x9e, 0x7f,
+    0x71, 0xcd, 0xf7, 0x29, 0xec, 0xa0, 0x11, 0xd4, 0x27, 0xdd, 0x93, 0x55, 0x2d, 0x2a, 0xc7, 0x8e,
+    0x34, 0x86, 0xaf, 0x4a, 0x35, 0x7b, 0xa5, 0x14, 0xbf, 0x17, 0xe9, 0x99, 0x5f, 0x84, 0x6f, 0xc9,
+    0x21, 0x0f, 0x9c, 0xa4, 0xb3, 0x0e, 0x53, 0x63, 0x4f, 0xb7, 0xd6, 0x75, 0x94, 0x87, 0x46, 0x9a,
+    0x15, 0xff, 0xf5, 0x92, 0x18, 0x10, 0x48, 0x57, 0xe3, 0xd8, 0x6d, 0x20, 0x0c, 0xf4, 0xb6, 0x1d,
+    0x79, 0x19, 0x07, 0x96, 0x47, 0x12, 0x54, 0x65, 0xd7, 0x03, 0xcb, 0x89, 0x6e, 0x30, 0xbc, 0x5c,
+    0xfe, 0x83, 0x69, 0x36, 0x8d, 0x70, 0x6c, 0xcf, 0xd5, 0xb1, 0xd3, 0x22, 0x37, 0x51, 0xed, 0xd9,
+    0x00, 0x91, 0xde, 0x50, 0xfa, 0xb8, 0x90, 0x44, 0x31, 0xae, 0xc5, 0x82, 0xbb, 0x76, 0xa7, 0x97,
+    0x02, 0xdb, 0xb4, 0x66, 0xe6, 0x8a, 0x28, 0xc1, 0x9d, 0xa8, 0x64, 0xad, 0xb0, 0xef, 0x98, 0xe5,
+    0x78, 0xe2, 0x9b, 0x13, 0xf9, 0xaa, 0xf2, 0xb9, 0xf0, 0xdf, 0xf8, 0x62, 0x06, 0x3e, 0x32, 0x1c,
+    0xce, 0x67, 0x61, 0x1e, 0x72, 0x3f, 0xfb, 0xc0, 0x1f, 0x3a, 0xf3, 0xeb, 0x43, 0x39, 0x74, 0x80
+};
+
+
+/**
+ * @brief Columns of linear transformation matrix in AES field representation.
+ */
+static const unsigned char kuznyechikp_avx512_linear[16][16] = {
+    { 0x54, 0xcd, 0xa8, 0x57, 0x20, 0xfd, 0xe6, 0x73, 0x02, 0x59, 0x2a, 0x74, 0xc9, 0xad, 0x83, 0x4a },
+    { 0x6e, 0x6c, 0x12, 0x94, 0xd4, 0x57, 0xfe, 0x6a, 0xe7, 0xff, 0x28, 0x4b, 0x7f, 0x6f, 0x49, 0x6c },
+    { 0x67, 0x06, 0xb2, 0xc9, 0xbb, 0x09, 0xe9, 0xa1, 0xb2, 0x02, 0x45, 0x68, 0x88, 0x66, 0x67, 0x82 },
+    { 0x44, 0xeb, 0x10, 0x24, 0x22, 0x24, 0x8f, 0xaa, 0xbe, 0x79, 0x8a, 0xa5, 0xda, 0x22, 0x7a, 0xc9 },
+    { 0x0c, 0x3d, 0x8a, 0xed, 0x6c, 0x37, 0x47, 0x33, 0x23, 0xd1, 0xaa, 0x7f, 0xd5, 0x7b, 0x59, 0x71 },
+    { 0xe0, 0xe6, 0x84, 0xc8, 0x4f, 0x75, 0x49, 0x78, 0xd1, 0xf9, 0x34, 0xd9, 0x4a, 0xc2, 0x56, 0x41 },
+    { 0xd4, 0xa6, 0xed, 0xcf, 0x30, 0x8d, 0x36, 0xe5, 0xfa, 0x39, 0xbd, 0x44, 0x80, 0x1f, 0xcc, 0x01 },
+    { 0xd5, 0x19, 0x0e, 0xba, 0xef, 0xcd, 0x6b, 0x45, 0xe7, 0xa3, 0x13, 0xc9, 0x8d, 0x2d, 0x9c, 0x86 },
+    { 0x63, 0x40, 0x99, 0xdf, 0xd1, 0xa9, 0xfe, 0xff, 0x52, 0x53, 0x83, 0x38, 0x72, 0xa5, 0x0b, 0x01 },
+    { 0x44, 0xae, 0xe8, 0xce, 0xff, 0x2c, 0x4f, 0x8d, 0xfd, 0x0b, 0x79, 0xf7, 0xf1, 0xdf, 0x26, 0x41 },
+    { 0xa3, 0x02, 0xa5, 0xa3, 0x36, 0x3d, 0x6f, 0xe3, 0x0f, 0x15, 0x4f, 0x09, 0xae, 0xa4, 0xd1, 0x71 },
+    { 0xca, 0x49, 0xbb, 0xe7, 0x01, 0x2f, 0x43, 0x50, 0x01, 0xd5, 0xf0, 0x3c, 0x3c, 0xb9, 0x89, 0xc9 },
+    { 0x4e, 0xb3, 0x28, 0x46, 0xaf, 0x14, 0x4c, 0xff, 0xd9, 0x6e, 0x06, 0x05, 0x4c, 0x9d, 0xc2, 0x82 },
+    { 0xe0, 0xc2, 0xa5, 0xbe, 0xad, 0x30, 0x92, 0x0f, 0xe0, 0x12, 0xe6, 0xe6, 0xb7, 0xe6, 0x81, 0x6c },
+    { 0x90, 0x88, 0x1c, 0x7e, 0x91, 0x70, 0x8e, 0xcd, 0xd7, 0x05, 0xa8, 0xa6, 0x25, 0xae, 0xee, 0x4a },
+    { 0xcd, 0xa8, 0x57, 0x20, 0xfd, 0xe6, 0x73, 0x02, 0x59, 0x2a, 0x74, 0xc9, 0xad, 0x83, 0x4a, 0x01 }
+};
+
+
+/**
+ * @brief Columns of inverse linear transformation matrix in AES field representation.
+ */
+static const unsigned char kuznyechikp_avx512_linear_inverse[16][16] = {
+    { 0x01, 0x4a, 0x83, 0xad, 0xc9, 0x74, 0x2a, 0x59, 0x02, 0x73, 0xe6, 0xfd, 0x20, 0x57, 0xa8, 0xcd },
+    { 0x4a, 0xee, 0xae, 0x25, 0xa6, 0xa8, 0x05, 0xd7, 0xcd, 0x8e, 0x70, 0x91, 0x7e, 0x1c, 0x88, 0x90 },
+    { 0x6c, 0x81, 0xe6, 0xb7, 0xe6, 0xe6, 0x12, 0xe0, 0x0f, 0x92, 0x30, 0xad, 0xbe, 0xa5, 0xc2, 0xe0 },
+    { 0x82, 0xc2, 0x9d, 0x4c, 0x05, 0x06, 0x6e, 0xd9, 0xff, 0x4c, 0x14, 0xaf, 0x46, 0x28, 0xb3, 0x4e },
+    { 0xc9, 0x89, 0xb9, 0x3c, 0x3c, 0xf0, 0xd5, 0x01, 0x50, 0x43, 0x2f, 0x01, 0xe7, 0xbb, 0x49, 0xca },
+    { 0x71, 0xd1, 0xa4, 0xae, 0x09, 0x4f, 0x15, 0x0f, 0xe3, 0x6f, 0x3d, 0x36, 0xa3, 0xa5, 0x02, 0xa3 },
+    { 0x41, 0x26, 0xdf, 0xf1, 0xf7, 0x79, 0x0b, 0xfd, 0x8d, 0x4f, 0x2c, 0xff, 0xce, 0xe8, 0xae, 0x44 },
+    { 0x01, 0x0b, 0xa5, 0x72, 0x38, 0x83, 0x53, 0x52, 0xff, 0xfe, 0xa9, 0xd1, 0xdf, 0x99, 0x40, 0x63 },
+    { 0x86, 0x9c, 0x2d, 0x8d, 0xc9, 0x13, 0xa3, 0xe7, 0x45, 0x6b, 0xcd, 0xef, 0xba, 0x0e, 0x19, 0xd5 },
+    { 0x01, 0xcc, 0x1f, 0x80, 0x44, 0xbd, 0x39, 0xfa, 0xe5, 0x36, 0x8d, 0x30, 0xcf, 0xed, 0xa6, 0xd4 },
+    { 0x41, 0x56, 0xc2, 0x4a, 0xd9, 0x34, 0xf9, 0xd1, 0x78, 0x49, 0x75, 0x4f, 0xc8, 0x84, 0xe6, 0xe0 },
+    { 0x71, 0x59, 0x7b, 0xd5, 0x7f, 0xaa, 0xd1, 0x23, 0x33, 0x47, 0x37, 0x6c, 0xed, 0x8a, 0x3d, 0x0c },
+    { 0xc9, 0x7a, 0x22, 0xda, 0xa5, 0x8a, 0x79, 0xbe, 0xaa, 0x8f, 0x24, 0x22, 0x24, 0x10, 0xeb, 0x44 },
+    { 0x82, 0x67, 0x66, 0x88, 0x68, 0x45, 0x02, 0xb2, 0xa1, 0xe9, 0x09, 0xbb, 0xc9, 0xb2, 0x06, 0x67 },
+    { 0x6c, 0x49, 0x6f, 0x7f, 0x4b, 0x28, 0xff, 0xe7, 0x6a, 0xfe, 0x57, 0xd4, 0x94, 0x12, 0x6c, 0x6e },
+    { 0x4a, 0x83, 0xad, 0xc9, 0x74, 0x2a, 0x59, 0x02, 0x73, 0xe6, 0xfd, 0x20, 0x57, 0xa8, 0xcd, 0x54 }
+};
+
+
+/**
+ * @brief Engine state: tables and round keys loaded into registers.
+ */
+typedef struct tagKUZNYECHIKP_AVX512_CONTEXT
+{
+    __m512i sbox[4];                       /**< SBox (4 parts of 64 bytes) */
+    __m512i linear[16];                    /**< Columns of linear transformation matrix */
+    __m512i round_keys[KUZNYECHIK_ROUNDS]; /**< Round keys in AES field representation */
+} KUZNYECHIKP_AVX512_CONTEXT;
+
+
+/**
+ * @brief Converts bytes of a register from Kuznyechik field to AES field.
+ */
+#define KUZNYECHIKP_AVX512_TO_AES(a) \
+    _mm512_gf2p8affine_epi64_epi8(a, _mm512_set1_epi64((long long)KUZNYECHIKP_AVX512_TO_AES_FIELD), 0)
+
+
+/**
+ * @brief Converts bytes of a register from AES field to Kuznyechik field.
+ */
+#define KUZNYECHIKP_AVX512_FROM_AES(a) \
+    _mm512_gf2p8affine_epi64_epi8(a, _mm512_set1_epi64((long long)KUZNYECHIKP_AVX512_FROM_AES_FIELD), 0)
+
+
+/**
+ * @brief Loads tables and converts round keys.
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx512_initialize_context(const unsigned char* sbox, const unsigned char (*linear)[16],
+                                                                     const INTERNAL_KEY* internal_keys, KUZNYECHIKP_AVX512_CONTEXT* context)
+{
+    unsigned int idx;
+
+    for (idx = 0; idx < 4; ++idx)
+    {
+        context->sbox[idx] = _mm512_loadu_si512(sbox + 64 * idx);
+    }
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        context->linear[idx] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)linear[idx]));
+    }
+
+    for (idx = 0; idx < KUZNYECHIK_ROUNDS; ++idx)
+    {
+        context->round_keys[idx] = KUZNYECHIKP_AVX512_TO_AES(_mm512_broadcast_i32x4(internal_keys->key[idx]));
+    }
+}
+
+
+/**
+ * @brief S transformation (or its inverse). 7 low bits of each byte select 
+ *        one of 128 table entries, the highest bit selects one of table halves.
+ */
+BCLIB_FORCEINLINE static __m512i kuznyechikp_avx512_s(__m512i a, const KUZNYECHIKP_AVX512_CONTEXT* context)
+{
+    const __m512i low  = _mm512_permutex2var_epi8(context->sbox[0], a, context->sbox[1]);
+    const __m512i high = _mm512_permutex2var_epi8(context->sbox[2], a, context->sbox[3]);
+
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(a), low, high);
+}
+
+
+/**
+ * @brief L transformation (or its inverse) as a matrix-vector product: 
+ *        each byte of a block is broadcast and multiplied by matrix column.
+ */
+BCLIB_FORCEINLINE static __m512i kuznyechikp_avx512_l(__m512i a, const KUZNYECHIKP_AVX512_CONTEXT* context)
+{
+    __m512i result = _mm512_gf2p8mul_epi8(_mm512_shuffle_epi8(a, _mm512_setzero_si512()), context->linear[0]);
+    unsigned int idx;
+
+    for (idx = 1; idx < 16; ++idx)
+    {
+        result = _mm512_xor_si512(result, _mm512_gf2p8mul_epi8(_mm512_shuffle_epi8(a, _mm512_set1_epi8((char)idx)),
+                                                               context->linear[idx]));
+    }
+
+    return result;
+}
+
+
+/**
+ * @brief Encrypts `registers` registers of blocks (all blocks in AES field representation).
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx512_encrypt(__m512i* a, unsigned int registers, const KUZNYECHIKP_AVX512_CONTEXT* context)
+{
+    unsigned int round;
+    unsigned int idx;
+
+    //
+    // Chapter 4.4.1 of GOST 34.12-2018
+    // E(a) = X[K10] LS X[K9] ... LS X[K2] LS X[K1](a)
+    //
+
+    for (round = 0; round < KUZNYECHIK_ROUNDS - 1; ++round)
+    {
+        for (idx = 0; idx < registers; ++idx)
+        {
+            a[idx] = _mm512_xor_si512(a[idx], context->round_keys[round]);
+            a[idx] = kuznyechikp_avx512_s(a[idx], context);
+            a[idx] = kuznyechikp_avx512_l(a[idx], context);
+        }
+    }
+
+    for (idx = 0; idx < registers; ++idx)
+    {
+        a[idx] = _mm512_xor_si512(a[idx], context->round_keys[KUZNYECHIK_ROUNDS - 1]);
+    }
+}
+
+
+/**
+ * @brief Decrypts `registers` registers of blocks (all blocks in AES field representation).
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_avx512_decrypt(__m512i* a, unsigned int registers, const KUZNYECHIKP_AVX512_CONTEXT* context)
+{
+    unsigned int round;
+    unsigned int idx;
+
+    //
+    // Chapter 4.4.2 of GOST 34.12-2018
+    // D(a) = X[K1] ILS X[K2] ... ILS X[K9] ILS X[K10](a)
+    //
+    // Decryption key schedule contains inverse of L applied to round keys
+    // (as generic engine requires), hence the first inverse of L is applied
+    // to data before the key addition.
+    //
+
+    for (idx = 0; idx < registers; ++idx)
+    {
+        a[idx] = kuznyechikp_avx512_l(a[idx], context);
+    }
+
+    for (round = KUZNYECHIK_ROUNDS - 1; round > 1; --round)
+    {
+        for (idx = 0; idx < registers; ++idx)
+        {
+            a[idx] = _mm512_xor_si512(a[idx], context->round_keys[round]);
+            a[idx] = kuznyechikp_avx512_s(a[idx], context);
+            a[idx] = kuznyechikp_avx512_l(a[idx], context);
+        }
+    }
+
+    for (idx = 0; idx < registers; ++idx)
+    {
+        a[idx] = _mm512_xor_si512(a[idx], context->round_keys[1]);
+        a[idx] = kuznyechikp_avx512_s(a[idx], context);
+        a[idx] = _mm512_xor_si512(a[idx], context->round_keys[0]);
+    }
+}
+
+
+void kuznyechik_avx512_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_AVX512, ENCRYPT_BLOCKS, blocks_count);
+
+    KUZNYECHIKP_AVX512_CONTEXT context;
+    __m512i a[KUZNYECHIKP_AVX512_REGISTERS];
+
+    kuznyechikp_avx512_initialize_context(kuznyechikp_avx512_sbox, kuznyechikp_avx512_linear,
+                                          (const INTERNAL_KEY*)round_keys, &context);
+
+    for (; blocks_count >= KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+         blocks_count -= KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS)
+    {
+        a[0] = KUZNYECHIKP_AVX512_TO_AES(_mm512_loadu_si512(in));
+        a[1] = KUZNYECHIKP_AVX512_TO_AES(_mm512_loadu_si512(in + KUZNYECHIKP_AVX512_REGISTER_BLOCKS));
+
+        kuznyechikp_avx512_encrypt(a, 2, &context);
+
+        _mm512_storeu_si512(out, KUZNYECHIKP_AVX512_FROM_AES(a[0]));
+        _mm512_storeu_si512(out + KUZNYECHIKP_AVX512_REGISTER_BLOCKS, KUZNYECHIKP_AVX512_FROM_AES(a[1]));
+
+        in += KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+        out += KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+    }
+
+    if (blocks_count >= KUZNYECHIKP_AVX512_REGISTER_BLOCKS)
+    {
+        a[0] = KUZNYECHIKP_AVX512_TO_AES(_mm512_loadu_si512(in));
+        kuznyechikp_avx512_encrypt(a, 1, &context);
+        _mm512_storeu_si512(out, KUZNYECHIKP_AVX512_FROM_AES(a[0]));
+
+        in += KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+        out += KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+        blocks_count -= KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+    }
+
+    //
+    // The rest of blocks is processed by generic engine
+    //
+
+    kuznyechik_encrypt_blocks(in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_avx512_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_AVX512, DECRYPT_BLOCKS, blocks_count);
+
+    KUZNYECHIKP_AVX512_CONTEXT context;
+    __m512i a[KUZNYECHIKP_AVX512_REGISTERS];
+
+    kuznyechikp_avx512_initialize_context(kuznyechikp_avx512_sbox_inverse, kuznyechikp_avx512_linear_inverse,
+                                          (const INTERNAL_KEY*)round_keys, &context);
+
+    for (; blocks_count >= KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+         blocks_count -= KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS)
+    {
+        a[0] = KUZNYECHIKP_AVX512_TO_AES(_mm512_loadu_si512(in));
+        a[1] = KUZNYECHIKP_AVX512_TO_AES(_mm512_loadu_si512(in + KUZNYECHIKP_AVX512_REGISTER_BLOCKS));
+
+        kuznyechikp_avx512_decrypt(a, 2, &context);
+
+        _mm512_storeu_si512(out, KUZNYECHIKP_AVX512_FROM_AES(a[0]));
+        _mm512_storeu_si512(out + KUZNYECHIKP_AVX512_REGISTER_BLOCKS, KUZNYECHIKP_AVX512_FROM_AES(a[1]));
+
+        in += KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+        out += KUZNYECHIKP_AVX512_REGISTERS * KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+    }
+
+    if (blocks_count >= KUZNYECHIKP_AVX512_REGISTER_BLOCKS)
+    {
+        a[0] = KUZNYECHIKP_AVX512_TO_AES(_mm512_loadu_si512(in));
+        kuznyechikp_avx512_decrypt(a, 1, &context);
+        _mm512_storeu_si512(out, KUZNYECHIKP_AVX512_FROM_AES(a[0]));
+
+        in += KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+        out += KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+        blocks_count -= KUZNYECHIKP_AVX512_REGISTER_BLOCKS;
+    }
+
+    //
+    // The rest of blocks is processed by generic engine
+    //
+
+    kuznyechik_decrypt_blocks(in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
@@ -0,0 +1,426 @@
+/**
+ * @file kuznyechik_compact.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Kuznyechik block cipher (compact L1-resident lookup tables engine)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/kuznyechik/kuznyechik.h"
+#include "common/utils.h"
+
+#include "kuznyechik_internal.h"
+#include "instrumentation_internal.h"
+
+#include <emmintrin.h>
+
+
+//
+// Generic engine uses 16x256x16 tables (64 KB each, 128 KB for decryption).
+// Here S-box is applied bytewise with 256 byte tables, and L is evaluated 
+// as a sum of images of nibbles: 16 positions x 2 nibbles x 16 values x 16 
+// bytes = 8 KB per direction. Encryption and decryption together touch less 
+// than 17 KB, so the tables stay in L1 cache. Price is 32 lookups per round 
+// instead of 16. Key setup uses the same tables (and 512 bytes of iteration
+// constants), so large tables are never touched by this engine.
+//
+
+
+/**
+ * @brief Offset of a byte position within compact table.
+ */
+#define KUZNYECHIKP_COMPACT_POSITION_SIZE (32 * 16)
+
+
+/**
+ * @brief Offset of high nibbles images within a byte position.
+ */
+#define KUZNYECHIKP_COMPACT_HIGH_OFFSET (16 * 16)
+
+
+/**
+ * @brief Number of blocks processed simultaneously by multi-block procedures.
+ */
+#define KUZNYECHIKP_COMPACT_INTERLEAVE 4
+
+BCLIB_STATIC_ASSERT(KUZNYECHIKP_COMPACT_INTERLEAVE == KUZNYECHIK_COMPACT_INTERLEAVE, kuznyechik_compact_interleave_mismatch);
+
+
+/**
+ * @brief Performs optional substitution and then linear transformation 
+ *        using compact nibble-split table. Several blocks are processed
+ *        in an interleaved manner to hide lookups latency.
+ * 
+ * @param table Compact lookup table (L or inverse of L)
+ * @param sbox Substitution table or NULL if substitution is not applied
+ * @param a Blocks to transform (in-place)
+ * @param count Number of blocks (up to KUZNYECHIKP_COMPACT_INTERLEAVE)
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_compact_transform(const unsigned char* table, const unsigned char* sbox, __m128i* a, unsigned int count)
+{
+    BCLIB_ALIGN16 unsigned char bytes[KUZNYECHIKP_COMPACT_INTERLEAVE][16];
+
+    __m128i low_result[KUZNYECHIKP_COMPACT_INTERLEAVE];
+    __m128i high_result[KUZNYECHIKP_COMPACT_INTERLEAVE];
+
+    unsigned int idx;
+    unsigned int block;
+    unsigned int value;
+
+    for (block = 0; block < count; ++block)
+    {
+        _mm_store_si128((__m128i*)bytes[block], a[block]);
+
+        low_result[block]  = _mm_setzero_si128();
+        high_result[block] = _mm_setzero_si128();
+    }
+
+    //
+    // Images of low and high nibbles are accumulated separately
+    // to shorten dependency chains
+    //
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        for (block = 0; block < count; ++block)
+        {
+            value = sbox ? sbox[bytes[block][idx]] : bytes[block][idx];
+
+            low_result[block]  = _mm_xor_si128(low_result[block], _mm_load_si128((const __m128i*)(table + ((value & 0x0f) << 4))));
+            high_result[block] = _mm_xor_si128(high_result[block], _mm_load_si128((const __m128i*)(table + KUZNYECHIKP_COMPACT_HIGH_OFFSET + (value & 0xf0))));
+        }
+
+        table += KUZNYECHIKP_COMPACT_POSITION_SIZE;
+    }
+
+    for (block = 0; block < count; ++block)
+    {
+        a[block] = _mm_xor_si128(low_result[block], high_result[block]);
+    }
+}
+
+
+/**
+ * @brief Applies inverse of substitution bytewise.
+ * 
+ * @param a Block to transform
+ * @return Transformed block
+ */
+BCLIB_FORCEINLINE static __m128i kuznyechikp_compact_substitute_inverse(__m128i a)
+{
+    BCLIB_ALIGN16 unsigned char bytes[16];
+
+    unsigned int idx;
+
+    _mm_store_si128((__m128i*)bytes, a);
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        bytes[idx] = kuznyechikp_sbox_inverse[bytes[idx]];
+    }
+
+    return _mm_load_si128((const __m128i*)bytes);
+}
+
+
+/**
+ * @brief Encrypts several blocks in-place (the same sequence as generic engine).
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_compact_encrypt(__m128i* a, const INTERNAL_KEY* internal_keys, unsigned int count)
+{
+    unsigned int round;
+    unsigned int block;
+
+    for (block = 0; block < count; ++block)
+    {
+        a[block] = _mm_xor_si128(a[block], internal_keys->key[0]);
+    }
+
+    for (round = 1; round < KUZNYECHIK_ROUNDS; ++round)
+    {
+        kuznyechikp_compact_transform(kuznyechikp_compact_linear_table, kuznyechikp_sbox, a, count);
+
+        for (block = 0; block < count; ++block)
+        {
+            a[block] = _mm_xor_si128(a[block], internal_keys->key[round]);
+        }
+    }
+}
+
+
+/**
+ * @brief Decrypts several blocks in-place. Decryption key schedule has inverse  
+ *        of L applied to keys 1..9, so the sequence is the same as in generic engine.
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_compact_decrypt(__m128i* a, const INTERNAL_KEY* internal_keys, unsigned int count)
+{
+    unsigned int round;
+    unsigned int block;
+
+    kuznyechikp_compact_transform(kuznyechikp_compact_linear_inverse_table, 0, a, count);
+
+    for (round = KUZNYECHIK_ROUNDS - 1; round > 1; --round)
+    {
+        for (block = 0; block < count; ++block)
+        {
+            a[block] = _mm_xor_si128(a[block], internal_keys->key[round]);
+        }
+
+        kuznyechikp_compact_transform(kuznyechikp_compact_linear_inverse_table, kuznyechikp_sbox_inverse, a, count);
+    }
+
+    for (block = 0; block < count; ++block)
+    {
+        a[block] = _mm_xor_si128(a[block], internal_keys->key[1]);
+        a[block] = kuznyechikp_compact_substitute_inverse(a[block]);
+        a[block] = _mm_xor_si128(a[block], internal_keys->key[0]);
+    }
+}
+
+
+/**
+ * @brief Expands up to KUZNYECHIKP_COMPACT_INTERLEAVE keys into encryption key 
+ *        schedules simultaneously. Chapter 4.3 of GOST 34.12-2018. LS of Feistel
+ *        steps is evaluated with compact table, so large tables are not touched.
+ * 
+ * @param keys Binary key representations (one after another)
+ * @param round_keys Encryption key schedules
+ * @param count Number of keys (up to KUZNYECHIKP_COMPACT_INTERLEAVE)
+ */
+static void kuznyechikp_compact_expand_keys(const unsigned char* keys, KEY* round_keys, unsigned int count)
+{
+    const __m128i* constants = (const __m128i*)kuznyechikp_iteration_constants;
+    const __m128i* raw_keys  = (const __m128i*)keys;
+
+    __m128i x0[KUZNYECHIKP_COMPACT_INTERLEAVE];
+    __m128i x1[KUZNYECHIKP_COMPACT_INTERLEAVE];
+    __m128i t[KUZNYECHIKP_COMPACT_INTERLEAVE];
+
+    INTERNAL_KEY* internal_keys;
+    unsigned int step;
+    unsigned int block;
+
+    for (block = 0; block < count; ++block)
+    {
+        internal_keys = (INTERNAL_KEY*)(round_keys + block);
+
+        x0[block] = _mm_loadu_si128(raw_keys + 2 * block);
+        x1[block] = _mm_loadu_si128(raw_keys + 2 * block + 1);
+
+        internal_keys->key[0] = x0[block];
+        internal_keys->key[1] = x1[block];
+        internal_keys->tables = kuznyechikp_static_tables;
+    }
+
+    for (step = 0; step < 32; ++step)
+    {
+        //
+        // F[C](x0, x1) = (LSX[C](x0) ^ x1, x0)
+        //
+
+        for (block = 0; block < count; ++block)
+        {
+            t[block] = _mm_xor_si128(x0[block], constants[step]);
+        }
+
+        kuznyechikp_compact_transform(kuznyechikp_compact_linear_table, kuznyechikp_sbox, t, count);
+
+        for (block = 0; block < count; ++block)
+        {
+            x1[block] = _mm_xor_si128(t[block], x1[block]);
+            t[block]  = x0[block];
+            x0[block] = x1[block];
+            x1[block] = t[block];
+
+            if ((step & 7) == 7)
+            {
+                ((INTERNAL_KEY*)(round_keys + block))->key[(step + 1) >> 2]       = x0[block];
+                ((INTERNAL_KEY*)(round_keys + block))->key[((step + 1) >> 2) + 1] = x1[block];
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Derives decryption key schedule from encryption one: inverse of L
+ *        is applied to keys 1..9 with compact table.
+ * 
+ * @param encrypt_round_keys Encryption key schedule
+ * @param decrypt_round_keys Decryption key schedule (may be equal to encrypt_round_keys)
+ */
+static void kuznyechikp_compact_derive_decrypt_key(const KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    const INTERNAL_KEY* encrypt_keys = (const INTERNAL_KEY*)encrypt_round_keys;
+    INTERNAL_KEY* decrypt_keys       = (INTERNAL_KEY*)decrypt_round_keys;
+
+    __m128i a[KUZNYECHIKP_COMPACT_INTERLEAVE];
+
+    unsigned int round;
+    unsigned int count;
+    unsigned int block;
+
+    decrypt_keys->key[0] = encrypt_keys->key[0];
+    decrypt_keys->tables = encrypt_keys->tables;
+
+    for (round = 1; round < KUZNYECHIK_ROUNDS; round += count)
+    {
+        count = (KUZNYECHIK_ROUNDS - round < KUZNYECHIKP_COMPACT_INTERLEAVE) ? KUZNYECHIK_ROUNDS - round : KUZNYECHIKP_COMPACT_INTERLEAVE;
+
+        for (block = 0; block < count; ++block)
+        {
+            a[block] = encrypt_keys->key[round + block];
+        }
+
+        kuznyechikp_compact_transform(kuznyechikp_compact_linear_inverse_table, 0, a, count);
+
+        for (block = 0; block < count; ++block)
+        {
+            decrypt_keys->key[round + block] = a[block];
+        }
+    }
+}
+
+
+/**
+ * @brief Processes blocks with interleaving.
+ */
+#define KUZNYECHIKP_COMPACT_PROCESS(procedure, in, round_keys, out, blocks_count)                                  \
+    {                                                                                                              \
+        __m128i kuznyechikp_blocks[KUZNYECHIKP_COMPACT_INTERLEAVE];                                                \
+        const INTERNAL_KEY* kuznyechikp_keys = (const INTERNAL_KEY*)(round_keys);                                  \
+        unsigned int kuznyechikp_block;                                                                            \
+                                                                                                                   \
+        for (; (blocks_count) >= KUZNYECHIKP_COMPACT_INTERLEAVE; (blocks_count) -= KUZNYECHIKP_COMPACT_INTERLEAVE) \
+        {                                                                                                          \
+            for (kuznyechikp_block = 0; kuznyechikp_block < KUZNYECHIKP_COMPACT_INTERLEAVE; ++kuznyechikp_block)   \
+            {                                                                                                      \
+                kuznyechikp_blocks[kuznyechikp_block] = _mm_loadu_si128(in++);                                     \
+            }                                                                                                      \
+                                                                                                                   \
+            procedure(kuznyechikp_blocks, kuznyechikp_keys, KUZNYECHIKP_COMPACT_INTERLEAVE);                       \
+                                                                                                                   \
+            for (kuznyechikp_block = 0; kuznyechikp_block < KUZNYECHIKP_COMPACT_INTERLEAVE; ++kuznyechikp_block)   \
+            {                                                                                                      \
+                _mm_storeu_si128(out++, kuznyechikp_blocks[kuznyechikp_block]);                                    \
+            }                                                                                                      \
+        }                                                                                                          \
+                                                                                                                   \
+        while ((blocks_count)--)                                                                                   \
+        {                                                                                                          \
+            kuznyechikp_blocks[0] = _mm_loadu_si128(in++);                                                         \
+            procedure(kuznyechikp_blocks, kuznyechikp_keys, 1);                                                    \
+            _mm_storeu_si128(out++, kuznyechikp_blocks[0]);                                                        \
+        }                                                                                                          \
+    }
+
+
+void kuznyechik_compact_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, ENCRYPT_BLOCK, 1);
+
+    __m128i temporary = in;
+    kuznyechikp_compact_encrypt(&temporary, (const INTERNAL_KEY*)round_keys, 1);
+
+    *out = temporary;
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, DECRYPT_BLOCK, 1);
+
+    __m128i temporary = in;
+    kuznyechikp_compact_decrypt(&temporary, (const INTERNAL_KEY*)round_keys, 1);
+
+    *out = temporary;
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, ENCRYPT_BLOCKS, blocks_count);
+
+    KUZNYECHIKP_COMPACT_PROCESS(kuznyechikp_compact_encrypt, in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, DECRYPT_BLOCKS, blocks_count);
+
+    KUZNYECHIKP_COMPACT_PROCESS(kuznyechikp_compact_decrypt, in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_initialize_encrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, KEY_SETUP, 1);
+
+    kuznyechikp_compact_expand_keys(key, round_keys, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_initialize_decrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, KEY_SETUP, 1);
+
+    kuznyechikp_compact_expand_keys(key, round_keys, 1);
+    kuznyechikp_compact_derive_decrypt_key(round_keys, round_keys);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, KEY_SETUP, 1);
+
+    kuznyechikp_compact_expand_keys(key, encrypt_round_keys, 1);
+    kuznyechikp_compact_derive_decrypt_key(encrypt_round_keys, decrypt_round_keys);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_compact_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_COMPACT, KEY_SETUP, keys_count);
+
+    unsigned int count;
+    unsigned int idx;
+
+    for (; keys_count; keys_count -= count)
+    {
+        count = keys_count < KUZNYECHIKP_COMPACT_INTERLEAVE ? (unsigned int)keys_count : KUZNYECHIKP_COMPACT_INTERLEAVE;
+
+        kuznyechikp_compact_expand_keys(keys, encrypt_round_keys, count);
+
+        if (decrypt_round_keys)
+        {
+            for (idx = 0; idx < count; ++idx)
+            {
+                kuznyechikp_compact_derive_decrypt_key(encrypt_round_keys + idx, decrypt_round_keys + idx);
+            }
+
+            decrypt_round_keys += count;
+        }
+
+        encrypt_round_keys += count;
+        keys += count * KUZNYECHIK_KEY_SIZE;
+    }
+
+    INSTRUMENTATION_END();
+}
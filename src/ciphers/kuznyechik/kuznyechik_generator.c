@@ -0,0 +1,199 @@
+/**
+ * @file kuznyechik_generator.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Build-time generator of Kuznyechik lookup tables
+ * @date 2023-07-07
+ * 
+ * Produces a C source file with read-only lookup tables, so the
+ * library does not need any lazy (and racy) runtime initialization.
+ * Usage: bc-lib-kuznyechik-generator <output file>
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "kuznyechik_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+/**
+ * @brief Lookup table for LS transformation.
+ */
+static unsigned char kuznyechikp_ls_table[KUZNYECHIKP_TABLE_SIZE];
+
+
+/**
+ * @brief Lookup table for inverse of L transformation.
+ */
+static unsigned char kuznyechikp_linear_inverse_table[KUZNYECHIKP_TABLE_SIZE];
+
+
+/**
+ * @brief Lookup table for inverse of LS transformation.
+ */
+static unsigned char kuznyechikp_ls_inverse_table[KUZNYECHIKP_TABLE_SIZE];
+
+
+/**
+ * @brief Nibble-split lookup table for L transformation (compact engine).
+ */
+static unsigned char kuznyechikp_compact_table[KUZNYECHIKP_COMPACT_TABLE_SIZE];
+
+
+/**
+ * @brief Nibble-split lookup table for inverse of L transformation (compact engine).
+ */
+static unsigned char kuznyechikp_compact_inverse_table[KUZNYECHIKP_COMPACT_TABLE_SIZE];
+
+
+/**
+ * @brief Iteration constants C_i of key schedule.
+ */
+static unsigned char kuznyechikp_constants[KUZNYECHIKP_ITERATION_CONSTANTS_SIZE];
+
+
+/**
+ * @brief Computes all lookup tables.
+ */
+static void kuznyechikp_compute_tables(void)
+{
+    unsigned int idx1;
+    unsigned int idx2;
+    unsigned int table_offset = 0;
+
+    unsigned char* table_pointer;
+
+    for (idx1 = 0; idx1 < 16; ++idx1)
+    {
+        for (idx2 = 0; idx2 < 256; ++idx2)
+        {
+            //
+            // LS transformation (substitution and linear transformation)
+            //
+
+            table_pointer       = kuznyechikp_ls_table + table_offset;
+            table_pointer[idx1] = kuznyechikp_sbox[idx2];
+            kuznyechikp_linear_transform(table_pointer);
+
+            //
+            // Inverse of LS transformation
+            //
+
+            table_pointer       = kuznyechikp_ls_inverse_table + table_offset;
+            table_pointer[idx1] = kuznyechikp_sbox_inverse[idx2];
+            kuznyechikp_linear_transform_inverse(table_pointer);
+
+            //
+            // Inverse of linear transformation
+            //
+
+            table_pointer       = kuznyechikp_linear_inverse_table + table_offset;
+            table_pointer[idx1] = (unsigned char)idx2;
+            kuznyechikp_linear_transform_inverse(table_pointer);
+
+            table_offset += 16;
+        }
+    }
+
+    //
+    // Compact tables: L is linear, hence L(x) is a sum of images of
+    // each nibble of each byte taken separately
+    //
+
+    table_offset = 0;
+
+    for (idx1 = 0; idx1 < 16; ++idx1)
+    {
+        for (idx2 = 0; idx2 < 32; ++idx2)
+        {
+            table_pointer       = kuznyechikp_compact_table + table_offset;
+            table_pointer[idx1] = (unsigned char)(idx2 < 16 ? idx2 : (idx2 - 16) << 4);
+            kuznyechikp_linear_transform(table_pointer);
+
+            table_pointer       = kuznyechikp_compact_inverse_table + table_offset;
+            table_pointer[idx1] = (unsigned char)(idx2 < 16 ? idx2 : (idx2 - 16) << 4);
+            kuznyechikp_linear_transform_inverse(table_pointer);
+
+            table_offset += 16;
+        }
+    }
+
+    //
+    // Iteration constants: C_i = L(Vec128(i)), chapter 4.3 of GOST 34.12-2018
+    //
+
+    for (idx1 = 0; idx1 < 32; ++idx1)
+    {
+        table_pointer     = kuznyechikp_constants + idx1 * 16;
+        table_pointer[15] = (unsigned char)(idx1 + 1);
+        kuznyechikp_linear_transform(table_pointer);
+    }
+}
+
+
+/**
+ * @brief Writes a table definition into output file.
+ * 
+ * @param output Output file
+ * @param name Name of the table
+ * @param table Table contents
+ * @param size Size of the table in bytes
+ */
+static void kuznyechikp_write_table(FILE* output, const char* name, const unsigned char* table, size_t size)
+{
+    size_t idx;
+
+    fprintf(output, "BCLIB_ALIGN16 const unsigned char %s[%u] = {\n", name, (unsigned int)size);
+
+    for (idx = 0; idx < size; ++idx)
+    {
+        fprintf(output, "%s0x%02x%s", (idx % 16) ? " " : "    ", table[idx],
+                (idx + 1 == size) ? "\n" : ((idx % 16 == 15) ? ",\n" : ","));
+    }
+
+    fprintf(output, "};\n\n\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    FILE* output;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <output file>\n", argv[0]);
+        return 1;
+    }
+
+    kuznyechikp_compute_tables();
+
+    output = fopen(argv[1], "w");
+    if (!output)
+    {
+        fprintf(stderr, "Cannot open '%s' for writing\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(output, "/**\n"
+                    " * @file kuznyechik_tables.c\n"
+                    " * @brief Kuznyechik lookup tables (generated by kuznyechik_generator.c, do not edit)\n"
+                    " */\n\n\n"
+                    "#include \"kuznyechik_internal.h\"\n\n\n");
+
+    kuznyechikp_write_table(output, "kuznyechikp_ls_lookup_table", kuznyechikp_ls_table, KUZNYECHIKP_TABLE_SIZE);
+    kuznyechikp_write_table(output, "kuznyechikp_linear_inverse_lookup_table", kuznyechikp_linear_inverse_table, KUZNYECHIKP_TABLE_SIZE);
+    kuznyechikp_write_table(output, "kuznyechikp_ls_inverse_lookup_table", kuznyechikp_ls_inverse_table, KUZNYECHIKP_TABLE_SIZE);
+    kuznyechikp_write_table(output, "kuznyechikp_compact_linear_table", kuznyechikp_compact_table, KUZNYECHIKP_COMPACT_TABLE_SIZE);
+    kuznyechikp_write_table(output, "kuznyechikp_compact_linear_inverse_table", kuznyechikp_compact_inverse_table, KUZNYECHIKP_COMPACT_TABLE_SIZE);
+    kuznyechikp_write_table(output, "kuznyechikp_iteration_constants", kuznyechikp_constants, KUZNYECHIKP_ITERATION_CONSTANTS_SIZE);
+
+    if (fclose(output) != 0)
+    {
+        fprintf(stderr, "Cannot write '%s'\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
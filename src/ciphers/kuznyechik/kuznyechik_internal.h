@@ -0,0 +1,163 @@
+/**
+ * @file kuznyechik_internal.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Kuznyechik internals shared between engines
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_KUZNYECHIK_INTERNAL_INCLUDED
+#define BCLIB_KUZNYECHIK_INTERNAL_INCLUDED
+
+
+#include "ciphers/kuznyechik/kuznyechik.h"
+#include "ciphers/kuznyechik/kuznyechik_engines.h"
+#include "common/utils.h"
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Number of rounds in cipher.
+ */
+#define KUZNYECHIK_ROUNDS 10
+
+
+/**
+ * @brief Lookup tables used by generic and AVX2 engines. Key setup 
+ *        references the static ones, but a key may be bound to a NUMA 
+ *        node local replica (see kuznyechik_numa.h).
+ */
+typedef struct tagKUZNYECHIK_TABLES
+{
+    const unsigned char* ls;             /**< LS transformation */
+    const unsigned char* linear_inverse; /**< Inverse of L transformation */
+    const unsigned char* ls_inverse;     /**< Inverse of LS transformation */
+} KUZNYECHIK_TABLES;
+
+
+/**
+ * @brief Internal Kuznyechik key structure.
+ */
+typedef struct tagINTERNAL_KEY
+{
+    __m128i key[KUZNYECHIK_ROUNDS];
+    KUZNYECHIK_TABLES tables;
+} INTERNAL_KEY;
+
+
+//
+// Check if generic key can hold a key for Kuznyechik
+//
+
+BCLIB_STATIC_ASSERT(sizeof(INTERNAL_KEY) <= MAX_KEY_SIZE,
+                    maximum_key_size_is_less_than_necessary);
+
+
+/**
+ * @brief SBox. Chapter 4.1.1 of GOST 34.12-2018
+ */
+extern const unsigned char kuznyechikp_sbox[256];
+
+
+/**
+ * @brief Inverse of SBox. Chapter 4.1.1 of GOST 34.12-2018
+ */
+extern const unsigned char kuznyechikp_sbox_inverse[256];
+
+
+/**
+ * @brief Lookup table for computing LS trnsformation. Chapter 4.2 of GOST 34.12-2018.
+ *        Generated at build time by kuznyechik_generator.c.
+ */
+extern const unsigned char kuznyechikp_ls_lookup_table[16 * 256 * 16];
+
+
+/**
+ * @brief Lookup table for computing inverse L transformation. Chapter 4.2 of GOST 34.12-2018.
+ *        Generated at build time by kuznyechik_generator.c.
+ */
+extern const unsigned char kuznyechikp_linear_inverse_lookup_table[16 * 256 * 16];
+
+
+/**
+ * @brief Lookup table for computing inverse of LS transformation. Chapter 4.2 of GOST 34.12-2018.
+ *        Generated at build time by kuznyechik_generator.c.
+ */
+extern const unsigned char kuznyechikp_ls_inverse_lookup_table[16 * 256 * 16];
+
+
+/**
+ * @brief Size of each of lookup tables above in bytes.
+ */
+#define KUZNYECHIKP_TABLE_SIZE (16 * 256 * 16)
+
+
+/**
+ * @brief Static lookup tables (referenced by keys after setup).
+ */
+extern const KUZNYECHIK_TABLES kuznyechikp_static_tables;
+
+
+/**
+ * @brief Gets lookup tables referenced by a key schedule. Zeroed key schedules
+ *        (e.g. zero-initialized or wiped ones) use static tables.
+ */
+#define KUZNYECHIKP_KEY_TABLES(internal_keys) \
+    ((internal_keys)->tables.ls ? (internal_keys)->tables : kuznyechikp_static_tables)
+
+
+/**
+ * @brief Size of nibble-split lookup tables of compact engine in bytes.
+ */
+#define KUZNYECHIKP_COMPACT_TABLE_SIZE (16 * 32 * 16)
+
+
+/**
+ * @brief Nibble-split lookup table for L transformation: for each byte position
+ *        16 images of low nibbles followed by 16 images of high nibbles.
+ *        Generated at build time by kuznyechik_generator.c.
+ */
+extern const unsigned char kuznyechikp_compact_linear_table[KUZNYECHIKP_COMPACT_TABLE_SIZE];
+
+
+/**
+ * @brief Nibble-split lookup table for inverse of L transformation (same layout).
+ *        Generated at build time by kuznyechik_generator.c.
+ */
+extern const unsigned char kuznyechikp_compact_linear_inverse_table[KUZNYECHIKP_COMPACT_TABLE_SIZE];
+
+
+/**
+ * @brief Size of key schedule iteration constants table in bytes.
+ */
+#define KUZNYECHIKP_ITERATION_CONSTANTS_SIZE (32 * 16)
+
+
+/**
+ * @brief Iteration constants C_1, ..., C_32 of key schedule. Chapter 4.3 of GOST 34.12-2018.
+ *        Generated at build time by kuznyechik_generator.c.
+ */
+extern const unsigned char kuznyechikp_iteration_constants[KUZNYECHIKP_ITERATION_CONSTANTS_SIZE];
+
+
+/**
+ * @brief Implementation of linear transformation.
+ *        Chapter 4.1.2 of GOST 34.12-2018
+ *
+ * @param inout Pointer to data to be transformed (16 bytes)
+ */
+void kuznyechikp_linear_transform(unsigned char* inout);
+
+
+/**
+ * @brief Implementation of inverse of linear transformation.
+ *        Chapter 4.1.2 of GOST 34.12-2018
+ *
+ * @param inout Pointer to data to be transformed (16 bytes)
+ */
+void kuznyechikp_linear_transform_inverse(unsigned char* inout);
+
+
+#endif  // !BCLIB_KUZNYECHIK_INTERNAL_INCLUDED
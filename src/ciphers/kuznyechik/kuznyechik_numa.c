@@ -0,0 +1,490 @@
+/**
+ * @file kuznyechik_numa.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief NUMA node local replicas of Kuznyechik lookup tables (user mode only)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/kuznyechik/kuznyechik_numa.h"
+#include "common/utils.h"
+
+#include "kuznyechik_internal.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <stdio.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#endif
+
+
+/**
+ * @brief Size of a replica: all tables one after another.
+ */
+#define KUZNYECHIKP_REPLICA_SIZE (3 * KUZNYECHIKP_TABLE_SIZE)
+
+
+/**
+ * @brief Size of a huge page, replica fits into a single one.
+ */
+#define KUZNYECHIKP_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+
+#if !defined(_WIN32)
+
+/**
+ * @brief Huge page size selector for mmap (2 MB).
+ */
+#   if !defined(MAP_HUGE_2MB)
+#       define MAP_HUGE_2MB (21 << 26)
+#   endif
+
+/**
+ * @brief Memory policy for mbind: allocate on a node if possible, fall back 
+ *        to other nodes otherwise (binding would kill the process with SIGBUS, 
+ *        if there are no free huge pages on the node).
+ */
+#   define KUZNYECHIKP_MPOL_PREFERRED 1
+
+#endif  // !_WIN32
+
+
+/**
+ * @brief Replica of lookup tables on a NUMA node.
+ */
+typedef struct tagKUZNYECHIKP_REPLICA
+{
+    unsigned char* memory;    /**< Allocated memory (null if there is no replica) */
+    size_t size;              /**< Size of allocated memory */
+    int huge_pages;           /**< Memory is an explicitly allocated huge page */
+    KUZNYECHIK_TABLES tables; /**< Tables inside of memory */
+} KUZNYECHIKP_REPLICA;
+
+
+/**
+ * @brief Replicas and lock for their creation and destruction.
+ */
+static KUZNYECHIKP_REPLICA kuznyechikp_replicas[KUZNYECHIK_NUMA_MAX_NODES];
+static unsigned int kuznyechikp_replicas_count = 0;
+static volatile long kuznyechikp_replicas_lock = 0;
+
+
+/**
+ * @brief Acquires replicas lock.
+ */
+static void kuznyechikp_numa_lock(void)
+{
+    while (!BCLIB_SPIN_TRY_LOCK(&kuznyechikp_replicas_lock))
+    {
+        while (kuznyechikp_replicas_lock)
+        {
+            BCLIB_SPIN_PAUSE();
+        }
+    }
+}
+
+
+/**
+ * @brief Releases replicas lock.
+ */
+static void kuznyechikp_numa_unlock(void)
+{
+    BCLIB_SPIN_UNLOCK(&kuznyechikp_replicas_lock);
+}
+
+
+#if defined(_WIN32)
+
+/**
+ * @brief Checks if a node exists.
+ */
+static int kuznyechikp_numa_node_exists(unsigned int node)
+{
+    ULONG highest_node = 0;
+    ULONGLONG mask     = 0;
+
+    if (!GetNumaHighestNodeNumber(&highest_node))
+    {
+        return node == 0;
+    }
+
+    return node <= highest_node && GetNumaNodeProcessorMask((UCHAR)node, &mask) && mask;
+}
+
+
+/**
+ * @brief Allocates memory for a replica on a node.
+ */
+static void kuznyechikp_numa_allocate(unsigned int node, KUZNYECHIKP_REPLICA* replica)
+{
+    const SIZE_T large_page_size = GetLargePageMinimum();
+
+    //
+    // Large pages require SeLockMemoryPrivilege
+    //
+
+    if (large_page_size && large_page_size <= KUZNYECHIKP_HUGE_PAGE_SIZE)
+    {
+        replica->memory = (unsigned char*)VirtualAllocExNuma(GetCurrentProcess(), 0, KUZNYECHIKP_HUGE_PAGE_SIZE,
+                                                             MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+
+        if (replica->memory)
+        {
+            replica->size       = KUZNYECHIKP_HUGE_PAGE_SIZE;
+            replica->huge_pages = 1;
+            return;
+        }
+    }
+
+    replica->memory = (unsigned char*)VirtualAllocExNuma(GetCurrentProcess(), 0, KUZNYECHIKP_REPLICA_SIZE,
+                                                         MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+    replica->size   = KUZNYECHIKP_REPLICA_SIZE;
+}
+
+
+/**
+ * @brief Makes replica read-only (large pages cannot be protected, it is ignored).
+ */
+static void kuznyechikp_numa_protect(KUZNYECHIKP_REPLICA* replica)
+{
+    DWORD protection;
+    VirtualProtect(replica->memory, replica->size, PAGE_READONLY, &protection);
+}
+
+
+/**
+ * @brief Frees memory of a replica.
+ */
+static void kuznyechikp_numa_free(KUZNYECHIKP_REPLICA* replica)
+{
+    VirtualFree(replica->memory, 0, MEM_RELEASE);
+}
+
+
+unsigned int kuznyechik_numa_current_node(void)
+{
+    PROCESSOR_NUMBER processor;
+    USHORT node = 0;
+
+    GetCurrentProcessorNumberEx(&processor);
+
+    return GetNumaProcessorNodeEx(&processor, &node) ? node : 0;
+}
+
+#else  // !_WIN32
+
+/**
+ * @brief Checks if a node exists.
+ */
+static int kuznyechikp_numa_node_exists(unsigned int node)
+{
+    char path[64];
+
+    //
+    // Non-NUMA systems may have no nodes in sysfs at all
+    //
+
+    if (access("/sys/devices/system/node", F_OK) != 0)
+    {
+        return node == 0;
+    }
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u", node);
+    return access(path, F_OK) == 0;
+}
+
+
+/**
+ * @brief Allocates memory for a replica on a node. Memory policy is set before 
+ *        the first touch, hence pages are allocated on the node.
+ */
+static void kuznyechikp_numa_allocate(unsigned int node, KUZNYECHIKP_REPLICA* replica)
+{
+    unsigned long node_mask = 1ul << node;
+    unsigned char* memory;
+    size_t head;
+
+    memory = (unsigned char*)mmap(0, KUZNYECHIKP_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+
+    if (memory != MAP_FAILED)
+    {
+        replica->size       = KUZNYECHIKP_HUGE_PAGE_SIZE;
+        replica->huge_pages = 1;
+    }
+    else
+    {
+        //
+        // No free huge pages: a 2 MB aligned region is carved out of a larger
+        // one, so the kernel is able to back it with a transparent huge page
+        //
+
+        memory = (unsigned char*)mmap(0, 2 * KUZNYECHIKP_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (memory == MAP_FAILED)
+        {
+            return;
+        }
+
+        head = (KUZNYECHIKP_HUGE_PAGE_SIZE - ((size_t)memory & (KUZNYECHIKP_HUGE_PAGE_SIZE - 1))) & (KUZNYECHIKP_HUGE_PAGE_SIZE - 1);
+
+        if (head)
+        {
+            munmap(memory, head);
+        }
+
+        munmap(memory + head + KUZNYECHIKP_HUGE_PAGE_SIZE, KUZNYECHIKP_HUGE_PAGE_SIZE - head);
+
+        memory       += head;
+        replica->size = KUZNYECHIKP_HUGE_PAGE_SIZE;
+
+#if defined(MADV_HUGEPAGE)
+        madvise(memory, KUZNYECHIKP_HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+#endif
+    }
+
+    //
+    // Failure is not fatal: pages are allocated on the node of
+    // the calling thread then
+    //
+
+    syscall(SYS_mbind, memory, replica->size, KUZNYECHIKP_MPOL_PREFERRED, &node_mask, sizeof(node_mask) * 8, 0);
+
+    replica->memory = memory;
+}
+
+
+/**
+ * @brief Makes replica read-only.
+ */
+static void kuznyechikp_numa_protect(KUZNYECHIKP_REPLICA* replica)
+{
+    mprotect(replica->memory, replica->size, PROT_READ);
+}
+
+
+/**
+ * @brief Frees memory of a replica.
+ */
+static void kuznyechikp_numa_free(KUZNYECHIKP_REPLICA* replica)
+{
+    munmap(replica->memory, replica->size);
+}
+
+
+unsigned int kuznyechik_numa_current_node(void)
+{
+    unsigned int cpu  = 0;
+    unsigned int node = 0;
+
+    return syscall(SYS_getcpu, &cpu, &node, 0) == 0 ? node : 0;
+}
+
+#endif  // _WIN32
+
+
+unsigned int kuznyechik_numa_create_replicas(void)
+{
+    KUZNYECHIKP_REPLICA* replica;
+    unsigned int node;
+
+    kuznyechikp_numa_lock();
+
+    if (kuznyechikp_replicas_count)
+    {
+        kuznyechikp_numa_unlock();
+        return kuznyechikp_replicas_count;
+    }
+
+    for (node = 0; node < KUZNYECHIK_NUMA_MAX_NODES; ++node)
+    {
+        if (!kuznyechikp_numa_node_exists(node))
+        {
+            continue;
+        }
+
+        replica = kuznyechikp_replicas + node;
+        kuznyechikp_numa_allocate(node, replica);
+
+        if (!replica->memory)
+        {
+            continue;
+        }
+
+        memcpy(replica->memory, kuznyechikp_static_tables.ls, KUZNYECHIKP_TABLE_SIZE);
+        memcpy(replica->memory + KUZNYECHIKP_TABLE_SIZE, kuznyechikp_static_tables.linear_inverse, KUZNYECHIKP_TABLE_SIZE);
+        memcpy(replica->memory + 2 * KUZNYECHIKP_TABLE_SIZE, kuznyechikp_static_tables.ls_inverse, KUZNYECHIKP_TABLE_SIZE);
+
+        kuznyechikp_numa_protect(replica);
+
+        replica->tables.ls             = replica->memory;
+        replica->tables.linear_inverse = replica->memory + KUZNYECHIKP_TABLE_SIZE;
+        replica->tables.ls_inverse     = replica->memory + 2 * KUZNYECHIKP_TABLE_SIZE;
+
+        ++kuznyechikp_replicas_count;
+    }
+
+    kuznyechikp_numa_unlock();
+
+    return kuznyechikp_replicas_count;
+}
+
+
+void kuznyechik_numa_destroy_replicas(void)
+{
+    unsigned int node;
+
+    kuznyechikp_numa_lock();
+
+    for (node = 0; node < KUZNYECHIK_NUMA_MAX_NODES; ++node)
+    {
+        if (kuznyechikp_replicas[node].memory)
+        {
+            kuznyechikp_numa_free(kuznyechikp_replicas + node);
+        }
+    }
+
+    memset(kuznyechikp_replicas, 0, sizeof(kuznyechikp_replicas));
+    kuznyechikp_replicas_count = 0;
+
+    kuznyechikp_numa_unlock();
+}
+
+
+int kuznyechik_numa_huge_pages(unsigned int node)
+{
+    return node < KUZNYECHIK_NUMA_MAX_NODES && kuznyechikp_replicas[node].memory && kuznyechikp_replicas[node].huge_pages;
+}
+
+
+void kuznyechik_numa_bind_keys(KEY* round_keys, size_t keys_count, unsigned int node)
+{
+    const KUZNYECHIK_TABLES* tables = &kuznyechikp_static_tables;
+
+    if (node < KUZNYECHIK_NUMA_MAX_NODES && kuznyechikp_replicas[node].memory)
+    {
+        tables = &kuznyechikp_replicas[node].tables;
+    }
+
+    for (; keys_count; --keys_count, ++round_keys)
+    {
+        ((INTERNAL_KEY*)round_keys)->tables = *tables;
+    }
+}
+
+
+/**
+ * @brief Key setup procedures, that bind key schedules to a node.
+ */
+typedef struct tagKUZNYECHIKP_NUMA_KEY_SETUP
+{
+    BCLIB_INIT_ENCRYPT_KEY();
+    BCLIB_INIT_DECRYPT_KEY();
+    BCLIB_INIT_KEYS();
+    BCLIB_INIT_KEYS_BATCH();
+} KUZNYECHIKP_NUMA_KEY_SETUP;
+
+
+/**
+ * @brief Defines key setup procedures for a node (procedures have no context,
+ *        so a node is a part of their names).
+ */
+#define KUZNYECHIKP_DEFINE_NUMA_NODE(node)                                                                                       \
+    static void kuznyechikp_numa_initialize_encrypt_key##node(const unsigned char* key, KEY* round_keys)                         \
+    {                                                                                                                            \
+        kuznyechik_initialize_encrypt_key(key, round_keys);                                                                      \
+        kuznyechik_numa_bind_keys(round_keys, 1, node);                                                                          \
+    }                                                                                                                            \
+                                                                                                                                 \
+    static void kuznyechikp_numa_initialize_decrypt_key##node(const unsigned char* key, KEY* round_keys)                         \
+    {                                                                                                                            \
+        kuznyechik_initialize_decrypt_key(key, round_keys);                                                                      \
+        kuznyechik_numa_bind_keys(round_keys, 1, node);                                                                          \
+    }                                                                                                                            \
+                                                                                                                                 \
+    static void kuznyechikp_numa_initialize_keys##node(const unsigned char* key, KEY* encrypt_round_keys,                        \
+                                                       KEY* decrypt_round_keys)                                                  \
+    {                                                                                                                            \
+        kuznyechik_initialize_keys(key, encrypt_round_keys, decrypt_round_keys);                                                 \
+        kuznyechik_numa_bind_keys(encrypt_round_keys, 1, node);                                                                  \
+        kuznyechik_numa_bind_keys(decrypt_round_keys, 1, node);                                                                  \
+    }                                                                                                                            \
+                                                                                                                                 \
+    static void kuznyechikp_numa_initialize_keys_batch##node(const unsigned char* keys, KEY* encrypt_round_keys,                 \
+                                                             KEY* decrypt_round_keys, size_t keys_count)                         \
+    {                                                                                                                            \
+        kuznyechik_initialize_keys_batch(keys, encrypt_round_keys, decrypt_round_keys, keys_count);                              \
+        kuznyechik_numa_bind_keys(encrypt_round_keys, keys_count, node);                                                         \
+                                                                                                                                 \
+        if (decrypt_round_keys)                                                                                                  \
+        {                                                                                                                        \
+            kuznyechik_numa_bind_keys(decrypt_round_keys, keys_count, node);                                                     \
+        }                                                                                                                        \
+    }
+
+
+/**
+ * @brief Key setup procedures of a node for the table below.
+ */
+#define KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(node)                                                               \
+    {                                                                                                        \
+        kuznyechikp_numa_initialize_encrypt_key##node, kuznyechikp_numa_initialize_decrypt_key##node,        \
+        kuznyechikp_numa_initialize_keys##node, kuznyechikp_numa_initialize_keys_batch##node                 \
+    }
+
+
+//
+// Procedures below are defined for each supported node
+//
+
+BCLIB_STATIC_ASSERT(KUZNYECHIK_NUMA_MAX_NODES == 8, numa_key_setup_procedures_mismatch);
+
+
+KUZNYECHIKP_DEFINE_NUMA_NODE(0)
+KUZNYECHIKP_DEFINE_NUMA_NODE(1)
+KUZNYECHIKP_DEFINE_NUMA_NODE(2)
+KUZNYECHIKP_DEFINE_NUMA_NODE(3)
+KUZNYECHIKP_DEFINE_NUMA_NODE(4)
+KUZNYECHIKP_DEFINE_NUMA_NODE(5)
+KUZNYECHIKP_DEFINE_NUMA_NODE(6)
+KUZNYECHIKP_DEFINE_NUMA_NODE(7)
+
+
+static const KUZNYECHIKP_NUMA_KEY_SETUP kuznyechikp_numa_key_setup[KUZNYECHIK_NUMA_MAX_NODES] = {
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(0),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(1),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(2),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(3),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(4),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(5),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(6),
+    KUZNYECHIKP_NUMA_KEY_SETUP_ENTRY(7)
+};
+
+
+void kuznyechik_numa_initialize_interface(BLOCK_CIPHER* cipher, KUZNYECHIK_ENGINE engine, unsigned int node)
+{
+    const KUZNYECHIKP_NUMA_KEY_SETUP* key_setup;
+
+    kuznyechik_initialize_interface_ex(cipher, engine);
+
+    if (node >= KUZNYECHIK_NUMA_MAX_NODES)
+    {
+        return;
+    }
+
+    key_setup = kuznyechikp_numa_key_setup + node;
+
+    cipher->initialize_encrypt_key = key_setup->initialize_encrypt_key;
+    cipher->initialize_decrypt_key = key_setup->initialize_decrypt_key;
+    cipher->initialize_keys        = key_setup->initialize_keys;
+    cipher->initialize_keys_batch  = key_setup->initialize_keys_batch;
+}
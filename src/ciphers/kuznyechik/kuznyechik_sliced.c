@@ -0,0 +1,617 @@
+/**
+ * @file kuznyechik_sliced.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Kuznyechik block cipher (constant-time byte-sliced AVX2 engine)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/kuznyechik/kuznyechik.h"
+#include "common/utils.h"
+
+#include "kuznyechik_internal.h"
+#include "instrumentation_internal.h"
+
+#include <immintrin.h>
+
+
+//
+// Blocks are transposed, so that i-th register holds i-th bytes of all 32 blocks
+// (16 blocks per 128-bit lane). In this layout:
+// - S-box is evaluated with in-register shuffles only (no memory accesses depending 
+//   on data);
+// - L is evaluated as 16 steps of LFSR R (chapter 4.1.2 of GOST 34.12-2018), where
+//   bytes of a block are just registers, and multiplication by a constant in GF(2^8)
+//   is a pair of in-register nibble lookups.
+// Hence no memory access depends on secret data, and no large table is touched.
+//
+// True bit-slicing is not used here: Kuznyechik S-box has no known compact boolean 
+// circuit, while byte-slicing preserves constant-time property with much fewer 
+// instructions.
+//
+
+
+/**
+ * @brief Number of blocks processed simultaneously.
+ */
+#define KUZNYECHIKP_SLICED_BLOCKS 32
+
+BCLIB_STATIC_ASSERT(KUZNYECHIKP_SLICED_BLOCKS == KUZNYECHIK_CONSTANT_TIME_INTERLEAVE, kuznyechik_sliced_interleave_mismatch);
+
+
+/**
+ * @brief Number of distinct non-trivial coefficients of linear transformation.
+ */
+#define KUZNYECHIKP_SLICED_COEFFICIENTS 7
+
+
+/**
+ * @brief Products of linear transformation coefficients (0x94, 0x20, 0x85, 0x10,
+ *        0xc2, 0xc0, 0xfb) and all low nibbles.
+ */
+static const unsigned char kuznyechikp_sliced_multiply_low[KUZNYECHIKP_SLICED_COEFFICIENTS][16] = {
+    { 0x00, 0x94, 0xeb, 0x7f, 0x15, 0x81, 0xfe, 0x6a, 0x2a, 0xbe, 0xc1, 0x55, 0x3f, 0xab, 0xd4, 0x40 },
+    { 0x00, 0x20, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xe0, 0xc3, 0xe3, 0x83, 0xa3, 0x43, 0x63, 0x03, 0x23 },
+    { 0x00, 0x85, 0xc9, 0x4c, 0x51, 0xd4, 0x98, 0x1d, 0xa2, 0x27, 0x6b, 0xee, 0xf3, 0x76, 0x3a, 0xbf },
+    { 0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0, 0xf0 },
+    { 0x00, 0xc2, 0x47, 0x85, 0x8e, 0x4c, 0xc9, 0x0b, 0xdf, 0x1d, 0x98, 0x5a, 0x51, 0x93, 0x16, 0xd4 },
+    { 0x00, 0xc0, 0x43, 0x83, 0x86, 0x46, 0xc5, 0x05, 0xcf, 0x0f, 0x8c, 0x4c, 0x49, 0x89, 0x0a, 0xca },
+    { 0x00, 0xfb, 0x35, 0xce, 0x6a, 0x91, 0x5f, 0xa4, 0xd4, 0x2f, 0xe1, 0x1a, 0xbe, 0x45, 0x8b, 0x70 }
+};
+
+
+/**
+ * @brief Products of linear transformation coefficients (0x94, 0x20, 0x85, 0x10,
+ *        0xc2, 0xc0, 0xfb) and all high nibbles.
+ */
+static const unsigned char kuznyechikp_sliced_multiply_high[KUZNYECHIKP_SLICED_COEFFICIENTS][16] = {
+    { 0x00, 0x54, 0xa8, 0xfc, 0x93, 0xc7, 0x3b, 0x6f, 0xe5, 0xb1, 0x4d, 0x19, 0x76, 0x22, 0xde, 0x8a },
+    { 0x00, 0x45, 0x8a, 0xcf, 0xd7, 0x92, 0x5d, 0x18, 0x6d, 0x28, 0xe7, 0xa2, 0xba, 0xff, 0x30, 0x75 },
+    { 0x00, 0x87, 0xcd, 0x4a, 0x59, 0xde, 0x94, 0x13, 0xb2, 0x35, 0x7f, 0xf8, 0xeb, 0x6c, 0x26, 0xa1 },
+    { 0x00, 0xc3, 0x45, 0x86, 0x8a, 0x49, 0xcf, 0x0c, 0xd7, 0x14, 0x92, 0x51, 0x5d, 0x9e, 0x18, 0xdb },
+    { 0x00, 0x7d, 0xfa, 0x87, 0x37, 0x4a, 0xcd, 0xb0, 0x6e, 0x13, 0x94, 0xe9, 0x59, 0x24, 0xa3, 0xde },
+    { 0x00, 0x5d, 0xba, 0xe7, 0xb7, 0xea, 0x0d, 0x50, 0xad, 0xf0, 0x17, 0x4a, 0x1a, 0x47, 0xa0, 0xfd },
+    { 0x00, 0x6b, 0xd6, 0xbd, 0x6f, 0x04, 0xb9, 0xd2, 0xde, 0xb5, 0x08, 0x63, 0xb1, 0xda, 0x67, 0x0c }
+};
+
+
+/**
+ * @brief Accessor to a byte of state during LFSR steps.
+ */
+#define KUZNYECHIKP_SLICED_BYTE(a, offset, idx) a[((idx) + (offset)) & 15]
+
+
+/**
+ * @brief Transposes 16x16 byte matrices in both lanes of registers. Each stage
+ *        rotates left bits of concatenated (row, column) index by one, hence
+ *        4 identical stages perform transposition.
+ */
+static void kuznyechikp_sliced_transpose(__m256i* a)
+{
+    __m256i temporary[16];
+    unsigned int stage;
+    unsigned int idx;
+
+    for (stage = 0; stage < 4; ++stage)
+    {
+        for (idx = 0; idx < 8; ++idx)
+        {
+            temporary[2 * idx]     = _mm256_unpacklo_epi8(a[idx], a[idx + 8]);
+            temporary[2 * idx + 1] = _mm256_unpackhi_epi8(a[idx], a[idx + 8]);
+        }
+
+        for (idx = 0; idx < 16; ++idx)
+        {
+            a[idx] = temporary[idx];
+        }
+    }
+}
+
+
+/**
+ * @brief Loads blocks and transposes them.
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_sliced_load(const __m128i* in, __m256i* a)
+{
+    unsigned int idx;
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        a[idx] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(in + idx)),
+                                         _mm_loadu_si128(in + idx + 16), 1);
+    }
+
+    kuznyechikp_sliced_transpose(a);
+}
+
+
+/**
+ * @brief Transposes blocks back and stores them.
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_sliced_store(__m256i* a, __m128i* out)
+{
+    unsigned int idx;
+
+    kuznyechikp_sliced_transpose(a);
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        _mm_storeu_si128(out + idx, _mm256_castsi256_si128(a[idx]));
+        _mm_storeu_si128(out + idx + 16, _mm256_extracti128_si256(a[idx], 1));
+    }
+}
+
+
+/**
+ * @brief X transformation (key bytes are broadcast, no lookups).
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_sliced_x(__m256i* a, const __m128i* k)
+{
+    const unsigned char* key = (const unsigned char*)k;
+    unsigned int idx;
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        a[idx] = _mm256_xor_si256(a[idx], _mm256_set1_epi8((char)key[idx]));
+    }
+}
+
+
+/**
+ * @brief S transformation (or its inverse). Each of 16 rows of the table is 
+ *        applied to all bytes, and bytes from another rows are zeroed by 
+ *        setting the highest bit of shuffle index (saturated addition).
+ */
+static void kuznyechikp_sliced_s(__m256i* a, const unsigned char* sbox)
+{
+    const __m256i bias = _mm256_set1_epi8(0x70);
+    const __m256i step = _mm256_set1_epi8(0x10);
+
+    __m256i row;
+    __m256i index;
+    __m256i result;
+    unsigned int idx;
+    unsigned int row_idx;
+
+    for (idx = 0; idx < 16; ++idx)
+    {
+        index  = a[idx];
+        result = _mm256_setzero_si256();
+
+        for (row_idx = 0; row_idx < 16; ++row_idx)
+        {
+            row    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(sbox + 16 * row_idx)));
+            result = _mm256_or_si256(result, _mm256_shuffle_epi8(row, _mm256_adds_epu8(index, bias)));
+            index  = _mm256_sub_epi8(index, step);
+        }
+
+        a[idx] = result;
+    }
+}
+
+
+/**
+ * @brief Multiplication of all bytes by a linear transformation coefficient.
+ */
+BCLIB_FORCEINLINE static __m256i kuznyechikp_sliced_multiply(__m256i x, unsigned int coefficient)
+{
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+
+    const __m256i low  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kuznyechikp_sliced_multiply_low[coefficient]));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kuznyechikp_sliced_multiply_high[coefficient]));
+
+    return _mm256_xor_si256(_mm256_shuffle_epi8(low, _mm256_and_si256(x, nibble_mask)),
+                            _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble_mask)));
+}
+
+
+/**
+ * @brief L transformation: 16 steps of R. Coefficients are symmetric, hence
+ *        symmetric bytes are added before multiplication.
+ */
+static void kuznyechikp_sliced_l(__m256i* a)
+{
+    unsigned int offset = 0;
+    unsigned int step;
+    __m256i t;
+
+    for (step = 0; step < 16; ++step)
+    {
+        //
+        // R(a15, ..., a0) = l(a15, ..., a0) || a15 || ... || a1 in terms of standard, 
+        // here a[0] is the most significant byte
+        //
+
+        t = _mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 15),
+                             _mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 6), KUZNYECHIKP_SLICED_BYTE(a, offset, 8)));
+
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 0), KUZNYECHIKP_SLICED_BYTE(a, offset, 14)), 0));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 1), KUZNYECHIKP_SLICED_BYTE(a, offset, 13)), 1));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 2), KUZNYECHIKP_SLICED_BYTE(a, offset, 12)), 2));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 3), KUZNYECHIKP_SLICED_BYTE(a, offset, 11)), 3));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 4), KUZNYECHIKP_SLICED_BYTE(a, offset, 10)), 4));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 5), KUZNYECHIKP_SLICED_BYTE(a, offset, 9)), 5));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(KUZNYECHIKP_SLICED_BYTE(a, offset, 7), 6));
+
+        //
+        // Shift is performed by offset change only
+        //
+
+        offset    = (offset - 1) & 15;
+        a[offset] = t;
+    }
+}
+
+
+/**
+ * @brief Inverse of L transformation: 16 steps of inverse of R.
+ */
+static void kuznyechikp_sliced_l_inverse(__m256i* a)
+{
+    unsigned int offset = 0;
+    unsigned int step;
+    __m256i t;
+
+    for (step = 0; step < 16; ++step)
+    {
+        t = _mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 0),
+                             _mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 7), KUZNYECHIKP_SLICED_BYTE(a, offset, 9)));
+
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 1), KUZNYECHIKP_SLICED_BYTE(a, offset, 15)), 0));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 2), KUZNYECHIKP_SLICED_BYTE(a, offset, 14)), 1));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 3), KUZNYECHIKP_SLICED_BYTE(a, offset, 13)), 2));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 4), KUZNYECHIKP_SLICED_BYTE(a, offset, 12)), 3));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 5), KUZNYECHIKP_SLICED_BYTE(a, offset, 11)), 4));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(_mm256_xor_si256(KUZNYECHIKP_SLICED_BYTE(a, offset, 6), KUZNYECHIKP_SLICED_BYTE(a, offset, 10)), 5));
+        t = _mm256_xor_si256(t, kuznyechikp_sliced_multiply(KUZNYECHIKP_SLICED_BYTE(a, offset, 8), 6));
+
+        a[offset] = t;
+        offset    = (offset + 1) & 15;
+    }
+}
+
+
+/**
+ * @brief Encrypts KUZNYECHIKP_SLICED_BLOCKS blocks.
+ */
+static void kuznyechikp_sliced_encrypt(const __m128i* in, const INTERNAL_KEY* internal_keys, __m128i* out)
+{
+    __m256i a[16];
+    unsigned int round;
+
+    //
+    // Chapter 4.4.1 of GOST 34.12-2018
+    // E(a) = X[K10] LS X[K9] ... LS X[K2] LS X[K1](a)
+    //
+
+    kuznyechikp_sliced_load(in, a);
+
+    for (round = 0; round < KUZNYECHIK_ROUNDS - 1; ++round)
+    {
+        kuznyechikp_sliced_x(a, &internal_keys->key[round]);
+        kuznyechikp_sliced_s(a, kuznyechikp_sbox);
+        kuznyechikp_sliced_l(a);
+    }
+
+    kuznyechikp_sliced_x(a, &internal_keys->key[KUZNYECHIK_ROUNDS - 1]);
+
+    kuznyechikp_sliced_store(a, out);
+}
+
+
+/**
+ * @brief Decrypts KUZNYECHIKP_SLICED_BLOCKS blocks.
+ */
+static void kuznyechikp_sliced_decrypt(const __m128i* in, const INTERNAL_KEY* internal_keys, __m128i* out)
+{
+    __m256i a[16];
+    unsigned int round;
+
+    //
+    // Chapter 4.4.2 of GOST 34.12-2018
+    // D(a) = X[K1] ILS X[K2] ... ILS X[K9] ILS X[K10](a)
+    // (inverse of L is already applied to decryption round keys)
+    //
+
+    kuznyechikp_sliced_load(in, a);
+    kuznyechikp_sliced_l_inverse(a);
+
+    for (round = KUZNYECHIK_ROUNDS - 1; round > 1; --round)
+    {
+        kuznyechikp_sliced_x(a, &internal_keys->key[round]);
+        kuznyechikp_sliced_s(a, kuznyechikp_sbox_inverse);
+        kuznyechikp_sliced_l_inverse(a);
+    }
+
+    kuznyechikp_sliced_x(a, &internal_keys->key[1]);
+    kuznyechikp_sliced_s(a, kuznyechikp_sbox_inverse);
+    kuznyechikp_sliced_x(a, &internal_keys->key[0]);
+
+    kuznyechikp_sliced_store(a, out);
+}
+
+
+/**
+ * @brief Expands up to KUZNYECHIKP_SLICED_BLOCKS keys into encryption key schedules
+ *        simultaneously. Chapter 4.3 of GOST 34.12-2018. Halves of all schedules 
+ *        are kept transposed, so each of 32 Feistel steps is a single sliced LSX.
+ * 
+ * @param keys Binary key representations (one after another)
+ * @param round_keys Encryption key schedules
+ * @param keys_count Number of keys (up to KUZNYECHIKP_SLICED_BLOCKS)
+ */
+static void kuznyechikp_sliced_expand_keys(const unsigned char* keys, KEY* round_keys, size_t keys_count)
+{
+    const __m128i* constants = (const __m128i*)kuznyechikp_iteration_constants;
+
+    BCLIB_ALIGN16 __m128i buffer[KUZNYECHIKP_SLICED_BLOCKS];
+    __m256i x0[16];
+    __m256i x1[16];
+    __m256i t[16];
+
+    INTERNAL_KEY* internal_keys;
+    unsigned int step;
+    unsigned int idx;
+    size_t key_idx;
+
+    for (idx = 0; idx < KUZNYECHIKP_SLICED_BLOCKS; ++idx)
+    {
+        buffer[idx] = idx < keys_count ? _mm_loadu_si128((const __m128i*)(keys + idx * KUZNYECHIK_KEY_SIZE)) : _mm_setzero_si128();
+    }
+
+    kuznyechikp_sliced_load(buffer, x0);
+
+    for (idx = 0; idx < KUZNYECHIKP_SLICED_BLOCKS; ++idx)
+    {
+        buffer[idx] = idx < keys_count ? _mm_loadu_si128((const __m128i*)(keys + idx * KUZNYECHIK_KEY_SIZE) + 1) : _mm_setzero_si128();
+    }
+
+    kuznyechikp_sliced_load(buffer, x1);
+
+    for (key_idx = 0; key_idx < keys_count; ++key_idx)
+    {
+        internal_keys = (INTERNAL_KEY*)(round_keys + key_idx);
+
+        internal_keys->key[0] = _mm_loadu_si128((const __m128i*)(keys + key_idx * KUZNYECHIK_KEY_SIZE));
+        internal_keys->key[1] = _mm_loadu_si128((const __m128i*)(keys + key_idx * KUZNYECHIK_KEY_SIZE) + 1);
+        internal_keys->tables = kuznyechikp_static_tables;
+    }
+
+    for (step = 0; step < 32; ++step)
+    {
+        //
+        // F[C](x0, x1) = (LSX[C](x0) ^ x1, x0)
+        //
+
+        for (idx = 0; idx < 16; ++idx)
+        {
+            t[idx] = x0[idx];
+        }
+
+        kuznyechikp_sliced_x(t, constants + step);
+        kuznyechikp_sliced_s(t, kuznyechikp_sbox);
+        kuznyechikp_sliced_l(t);
+
+        for (idx = 0; idx < 16; ++idx)
+        {
+            t[idx]  = _mm256_xor_si256(t[idx], x1[idx]);
+            x1[idx] = x0[idx];
+            x0[idx] = t[idx];
+        }
+
+        if ((step & 7) != 7)
+        {
+            continue;
+        }
+
+        //
+        // Store transposes in-place, hence copies are stored
+        //
+
+        kuznyechikp_sliced_store(t, buffer);
+
+        for (key_idx = 0; key_idx < keys_count; ++key_idx)
+        {
+            ((INTERNAL_KEY*)(round_keys + key_idx))->key[(step + 1) >> 2] = buffer[key_idx];
+        }
+
+        for (idx = 0; idx < 16; ++idx)
+        {
+            t[idx] = x1[idx];
+        }
+
+        kuznyechikp_sliced_store(t, buffer);
+
+        for (key_idx = 0; key_idx < keys_count; ++key_idx)
+        {
+            ((INTERNAL_KEY*)(round_keys + key_idx))->key[((step + 1) >> 2) + 1] = buffer[key_idx];
+        }
+    }
+}
+
+
+/**
+ * @brief Derives decryption key schedules from encryption ones: inverse of L is
+ *        applied to keys 1..9 of all schedules, KUZNYECHIKP_SLICED_BLOCKS at once.
+ * 
+ * @param encrypt_round_keys Encryption key schedules
+ * @param decrypt_round_keys Decryption key schedules (may be equal to encrypt_round_keys)
+ * @param keys_count Number of schedules
+ */
+static void kuznyechikp_sliced_derive_decrypt_keys(const KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count)
+{
+    const size_t total = keys_count * (KUZNYECHIK_ROUNDS - 1);
+
+    BCLIB_ALIGN16 __m128i buffer[KUZNYECHIKP_SLICED_BLOCKS];
+    __m256i a[16];
+
+    size_t first;
+    size_t idx;
+
+    for (idx = 0; idx < keys_count; ++idx)
+    {
+        ((INTERNAL_KEY*)(decrypt_round_keys + idx))->key[0] = ((const INTERNAL_KEY*)(encrypt_round_keys + idx))->key[0];
+        ((INTERNAL_KEY*)(decrypt_round_keys + idx))->tables = ((const INTERNAL_KEY*)(encrypt_round_keys + idx))->tables;
+    }
+
+    //
+    // Round keys of all schedules are enumerated as a flat sequence and
+    // transformed in batches (a batch is read completely before it is written)
+    //
+
+    for (first = 0; first < total; first += KUZNYECHIKP_SLICED_BLOCKS)
+    {
+        for (idx = 0; idx < KUZNYECHIKP_SLICED_BLOCKS; ++idx)
+        {
+            buffer[idx] = (first + idx < total) 
+                              ? ((const INTERNAL_KEY*)(encrypt_round_keys + (first + idx) / (KUZNYECHIK_ROUNDS - 1)))->key[1 + (first + idx) % (KUZNYECHIK_ROUNDS - 1)]
+                              : _mm_setzero_si128();
+        }
+
+        kuznyechikp_sliced_load(buffer, a);
+        kuznyechikp_sliced_l_inverse(a);
+        kuznyechikp_sliced_store(a, buffer);
+
+        for (idx = 0; idx < KUZNYECHIKP_SLICED_BLOCKS && first + idx < total; ++idx)
+        {
+            ((INTERNAL_KEY*)(decrypt_round_keys + (first + idx) / (KUZNYECHIK_ROUNDS - 1)))->key[1 + (first + idx) % (KUZNYECHIK_ROUNDS - 1)] = buffer[idx];
+        }
+    }
+}
+
+
+/**
+ * @brief Processes blocks in batches, the last incomplete batch is padded 
+ *        (all batches take the same time regardless of data).
+ */
+BCLIB_FORCEINLINE static void kuznyechikp_sliced_process(void (*process)(const __m128i*, const INTERNAL_KEY*, __m128i*),
+                                                         const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    const INTERNAL_KEY* internal_keys = (const INTERNAL_KEY*)round_keys;
+
+    BCLIB_ALIGN16 __m128i buffer[KUZNYECHIKP_SLICED_BLOCKS];
+    size_t idx;
+
+    for (; blocks_count >= KUZNYECHIKP_SLICED_BLOCKS; blocks_count -= KUZNYECHIKP_SLICED_BLOCKS)
+    {
+        process(in, internal_keys, out);
+
+        in += KUZNYECHIKP_SLICED_BLOCKS;
+        out += KUZNYECHIKP_SLICED_BLOCKS;
+    }
+
+    if (blocks_count)
+    {
+        for (idx = 0; idx < KUZNYECHIKP_SLICED_BLOCKS; ++idx)
+        {
+            buffer[idx] = idx < blocks_count ? _mm_loadu_si128(in + idx) : _mm_setzero_si128();
+        }
+
+        process(buffer, internal_keys, buffer);
+
+        for (idx = 0; idx < blocks_count; ++idx)
+        {
+            _mm_storeu_si128(out + idx, buffer[idx]);
+        }
+    }
+}
+
+
+void kuznyechik_sliced_encrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, ENCRYPT_BLOCK, 1);
+
+    kuznyechikp_sliced_process(kuznyechikp_sliced_encrypt, &in, round_keys, out, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_decrypt_block(const __m128i in, const KEY* round_keys, __m128i* out)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, DECRYPT_BLOCK, 1);
+
+    kuznyechikp_sliced_process(kuznyechikp_sliced_decrypt, &in, round_keys, out, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_encrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, ENCRYPT_BLOCKS, blocks_count);
+
+    kuznyechikp_sliced_process(kuznyechikp_sliced_encrypt, in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_decrypt_blocks(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, DECRYPT_BLOCKS, blocks_count);
+
+    kuznyechikp_sliced_process(kuznyechikp_sliced_decrypt, in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_initialize_encrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, KEY_SETUP, 1);
+
+    kuznyechikp_sliced_expand_keys(key, round_keys, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_initialize_decrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, KEY_SETUP, 1);
+
+    kuznyechikp_sliced_expand_keys(key, round_keys, 1);
+    kuznyechikp_sliced_derive_decrypt_keys(round_keys, round_keys, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, KEY_SETUP, 1);
+
+    kuznyechikp_sliced_expand_keys(key, encrypt_round_keys, 1);
+    kuznyechikp_sliced_derive_decrypt_keys(encrypt_round_keys, decrypt_round_keys, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void kuznyechik_sliced_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count)
+{
+    INSTRUMENTATION_BEGIN(KUZNYECHIK_CONSTANT_TIME, KEY_SETUP, keys_count);
+
+    size_t count;
+
+    for (; keys_count; keys_count -= count)
+    {
+        count = keys_count < KUZNYECHIKP_SLICED_BLOCKS ? keys_count : KUZNYECHIKP_SLICED_BLOCKS;
+
+        kuznyechikp_sliced_expand_keys(keys, encrypt_round_keys, count);
+
+        if (decrypt_round_keys)
+        {
+            kuznyechikp_sliced_derive_decrypt_keys(encrypt_round_keys, decrypt_round_keys, count);
+            decrypt_round_keys += count;
+        }
+
+        encrypt_round_keys += count;
+        keys += count * KUZNYECHIK_KEY_SIZE;
+    }
+
+    INSTRUMENTATION_END();
+}
@@ -0,0 +1,263 @@
+/**
+ * @file magma.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Magma block cipher (GOST 34.12-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/magma/magma.h"
+#include "common/utils.h"
+#include "common/cpu.h"
+
+#include "magma_internal.h"
+#include "instrumentation_internal.h"
+
+#include <string.h>
+
+
+/**
+ * @brief Number of blocks processed simultaneously by generic engine.
+ */
+#define MAGMAP_INTERLEAVE 4
+
+
+const unsigned char magmap_pi[8][16] = {
+    { 12, 4, 6, 2, 10, 5, 11, 9, 14, 8, 13, 7, 0, 3, 15, 1 },
+    { 6, 8, 2, 3, 9, 10, 5, 12, 1, 14, 4, 7, 11, 13, 0, 15 },
+    { 11, 3, 5, 8, 2, 15, 10, 13, 14, 1, 7, 4, 12, 9, 6, 0 },
+    { 12, 8, 2, 1, 13, 4, 15, 6, 7, 0, 10, 5, 3, 14, 9, 11 },
+    { 7, 15, 5, 10, 8, 1, 6, 13, 0, 9, 3, 14, 11, 4, 2, 12 },
+    { 5, 13, 15, 6, 9, 2, 12, 10, 11, 7, 8, 1, 4, 3, 14, 0 },
+    { 8, 14, 2, 5, 6, 9, 1, 12, 15, 4, 11, 0, 13, 10, 3, 7 },
+    { 1, 7, 14, 13, 0, 5, 8, 3, 4, 15, 10, 6, 9, 12, 11, 2 }
+};
+
+
+/**
+ * @brief Transformation g[k]. Chapter 5.2 of GOST 34.12-2018
+ */
+BCLIB_FORCEINLINE static unsigned int magmap_g(unsigned int a, unsigned int k)
+{
+    unsigned int x = a + k;
+
+    x = (unsigned int)magmap_pi[0][x & 0xf] |
+        ((unsigned int)magmap_pi[1][(x >> 4) & 0xf] << 4) |
+        ((unsigned int)magmap_pi[2][(x >> 8) & 0xf] << 8) |
+        ((unsigned int)magmap_pi[3][(x >> 12) & 0xf] << 12) |
+        ((unsigned int)magmap_pi[4][(x >> 16) & 0xf] << 16) |
+        ((unsigned int)magmap_pi[5][(x >> 20) & 0xf] << 20) |
+        ((unsigned int)magmap_pi[6][(x >> 24) & 0xf] << 24) |
+        ((unsigned int)magmap_pi[7][x >> 28] << 28);
+
+    return (x << 11) | (x >> 21);
+}
+
+
+/**
+ * @brief Processes several blocks with round keys in order of use. 
+ *        Chapter 6 of GOST 34.12-2018
+ * 
+ * Halves are updated in-place, so their roles are exchanged after each
+ * round. The last round does not swap halves, hence output is (right, left).
+ */
+static void magmap_process_blocks(const unsigned long long* in, const unsigned int* keys, unsigned long long* out, size_t blocks_count)
+{
+    unsigned int left[MAGMAP_INTERLEAVE];
+    unsigned int right[MAGMAP_INTERLEAVE];
+    unsigned long long block;
+
+    size_t round;
+    size_t idx;
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        block       = BCLIB_BSWAP64(in[idx]);
+        left[idx]   = (unsigned int)(block >> 32);
+        right[idx]  = (unsigned int)block;
+    }
+
+    for (round = 0; round < MAGMA_ROUNDS; round += 2)
+    {
+        for (idx = 0; idx < blocks_count; ++idx)
+        {
+            left[idx] ^= magmap_g(right[idx], keys[round]);
+            right[idx] ^= magmap_g(left[idx], keys[round + 1]);
+        }
+    }
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        out[idx] = BCLIB_BSWAP64(((unsigned long long)right[idx] << 32) | left[idx]);
+    }
+}
+
+
+void magma_encrypt_block(const unsigned long long in, const KEY* round_keys, unsigned long long* out)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, ENCRYPT_BLOCK, 1);
+
+    magmap_process_blocks(&in, (const unsigned int*)round_keys->key, out, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_decrypt_block(const unsigned long long in, const KEY* round_keys, unsigned long long* out)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, DECRYPT_BLOCK, 1);
+
+    magmap_process_blocks(&in, (const unsigned int*)round_keys->key, out, 1);
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_encrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, ENCRYPT_BLOCKS, blocks_count);
+
+    size_t count;
+
+    for (; blocks_count; blocks_count -= count, in += count, out += count)
+    {
+        count = blocks_count < MAGMAP_INTERLEAVE ? blocks_count : MAGMAP_INTERLEAVE;
+        magmap_process_blocks(in, (const unsigned int*)round_keys->key, out, count);
+    }
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_decrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, DECRYPT_BLOCKS, blocks_count);
+
+    magma_encrypt_blocks(in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_initialize_encrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, KEY_SETUP, 1);
+
+    MAGMA_INTERNAL_KEY* internal_key = (MAGMA_INTERNAL_KEY*)round_keys->key;
+    size_t idx;
+
+    //
+    // Chapter 5.3 of GOST 34.12-2018: K_1..K_8 three times, 
+    // then K_8..K_1 (keys are big-endian words)
+    //
+
+    for (idx = 0; idx < 8; ++idx)
+    {
+        internal_key->key[idx] = ((unsigned int)key[4 * idx] << 24) | ((unsigned int)key[4 * idx + 1] << 16) |
+                                 ((unsigned int)key[4 * idx + 2] << 8) | (unsigned int)key[4 * idx + 3];
+    }
+
+    for (idx = 8; idx < MAGMA_ROUNDS; ++idx)
+    {
+        internal_key->key[idx] = (idx < 24) ? internal_key->key[idx % 8] : internal_key->key[7 - idx % 8];
+    }
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_initialize_decrypt_key(const unsigned char* key, KEY* round_keys)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, KEY_SETUP, 1);
+
+    KEY encrypt_round_keys;
+    magma_initialize_keys(key, &encrypt_round_keys, round_keys);
+
+    memset(&encrypt_round_keys, 0, sizeof(encrypt_round_keys));
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, KEY_SETUP, 1);
+
+    const MAGMA_INTERNAL_KEY* encrypt_key = (const MAGMA_INTERNAL_KEY*)encrypt_round_keys->key;
+    MAGMA_INTERNAL_KEY* decrypt_key       = (MAGMA_INTERNAL_KEY*)decrypt_round_keys->key;
+
+    size_t idx;
+
+    magma_initialize_encrypt_key(key, encrypt_round_keys);
+
+    for (idx = 0; idx < MAGMA_ROUNDS; ++idx)
+    {
+        decrypt_key->key[idx] = encrypt_key->key[MAGMA_ROUNDS - 1 - idx];
+    }
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_GENERIC, KEY_SETUP, keys_count);
+
+    size_t idx;
+
+    //
+    // Key schedule is trivial, there is nothing to interleave
+    //
+
+    for (idx = 0; idx < keys_count; ++idx)
+    {
+        if (decrypt_round_keys)
+        {
+            magma_initialize_keys(keys + idx * MAGMA_KEY_SIZE, encrypt_round_keys + idx, decrypt_round_keys + idx);
+        }
+        else
+        {
+            magma_initialize_encrypt_key(keys + idx * MAGMA_KEY_SIZE, encrypt_round_keys + idx);
+        }
+    }
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_initialize_interface(BLOCK_CIPHER64* cipher)
+{
+    magma_initialize_interface_ex(cipher, cpu_supports(CPU_FEATURE_AVX2) ? MAGMA_ENGINE_AVX2
+                                                                         : MAGMA_ENGINE_GENERIC);
+}
+
+
+void magma_initialize_interface_ex(BLOCK_CIPHER64* cipher, MAGMA_ENGINE engine)
+{
+    cipher->block_size = MAGMA_BLOCK_SIZE;
+    cipher->key_size   = MAGMA_KEY_SIZE;
+    cipher->interleave = MAGMAP_INTERLEAVE;
+
+    cipher->encrypt_block          = magma_encrypt_block;
+    cipher->decrypt_block          = magma_decrypt_block;
+    cipher->encrypt_blocks         = magma_encrypt_blocks;
+    cipher->decrypt_blocks         = magma_decrypt_blocks;
+    cipher->initialize_encrypt_key = magma_initialize_encrypt_key;
+    cipher->initialize_decrypt_key = magma_initialize_decrypt_key;
+    cipher->initialize_keys        = magma_initialize_keys;
+    cipher->initialize_keys_batch  = magma_initialize_keys_batch;
+
+    switch (engine)
+    {
+    case MAGMA_ENGINE_AVX2:
+        cipher->interleave     = MAGMAP_AVX2_BLOCKS;
+        cipher->encrypt_blocks = magma_avx2_encrypt_blocks;
+        cipher->decrypt_blocks = magma_avx2_decrypt_blocks;
+        break;
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,156 @@
+/**
+ * @file magma_avx2.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Magma block cipher (AVX2 engine)
+ * @date 2023-07-07
+ * 
+ * Left and right halves of 8 blocks are held in two registers (one 
+ * 32-bit lane per block). Substitutions of all nibbles are performed 
+ * with byte shuffles: each byte of a half is substituted with two 
+ * 16-entry tables (for its low and high nibbles), tables differ for 
+ * each byte position, so results are masked.
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "ciphers/magma/magma.h"
+#include "common/utils.h"
+
+#include "magma_internal.h"
+#include "instrumentation_internal.h"
+
+#include <string.h>
+
+#include <immintrin.h>
+
+
+/**
+ * @brief Substitution tables and masks.
+ */
+typedef struct tagMAGMAP_AVX2_TABLES
+{
+    __m256i low[4];      /**< pi_{2j} for byte j */
+    __m256i high[4];     /**< pi_{2j+1} for byte j shifted to high nibble */
+    __m256i byte[4];     /**< Masks of byte j of each lane */
+    __m256i nibble_mask; /**< 0x0f in each byte */
+} MAGMAP_AVX2_TABLES;
+
+
+BCLIB_FORCEINLINE static void magmap_avx2_load_tables(MAGMAP_AVX2_TABLES* tables)
+{
+    size_t idx;
+
+    for (idx = 0; idx < 4; ++idx)
+    {
+        tables->low[idx]  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)magmap_pi[2 * idx]));
+        tables->high[idx] = _mm256_slli_epi16(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)magmap_pi[2 * idx + 1])), 4);
+        tables->byte[idx] = _mm256_set1_epi32((int)(0xffu << (8 * idx)));
+    }
+
+    tables->nibble_mask = _mm256_set1_epi8(0x0f);
+}
+
+
+/**
+ * @brief Transformation g[k] of 8 halves. Chapter 5.2 of GOST 34.12-2018
+ */
+BCLIB_FORCEINLINE static __m256i magmap_avx2_g(const MAGMAP_AVX2_TABLES* tables, __m256i a, unsigned int k)
+{
+    const __m256i x    = _mm256_add_epi32(a, _mm256_set1_epi32((int)k));
+    const __m256i low  = _mm256_and_si256(x, tables->nibble_mask);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi32(x, 4), tables->nibble_mask);
+
+    __m256i result;
+
+    result = _mm256_and_si256(_mm256_or_si256(_mm256_shuffle_epi8(tables->low[0], low), _mm256_shuffle_epi8(tables->high[0], high)), tables->byte[0]);
+    result = _mm256_or_si256(result, _mm256_and_si256(_mm256_or_si256(_mm256_shuffle_epi8(tables->low[1], low), _mm256_shuffle_epi8(tables->high[1], high)), tables->byte[1]));
+    result = _mm256_or_si256(result, _mm256_and_si256(_mm256_or_si256(_mm256_shuffle_epi8(tables->low[2], low), _mm256_shuffle_epi8(tables->high[2], high)), tables->byte[2]));
+    result = _mm256_or_si256(result, _mm256_and_si256(_mm256_or_si256(_mm256_shuffle_epi8(tables->low[3], low), _mm256_shuffle_epi8(tables->high[3], high)), tables->byte[3]));
+
+    return _mm256_or_si256(_mm256_slli_epi32(result, 11), _mm256_srli_epi32(result, 21));
+}
+
+
+/**
+ * @brief Processes 8 blocks with round keys in order of use.
+ */
+static void magmap_avx2_process(const MAGMAP_AVX2_TABLES* tables, const unsigned long long* in, const unsigned int* keys, unsigned long long* out)
+{
+    //
+    // Byte order of each 32-bit half is reversed, so a half becomes an integer
+    //
+
+    const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                          12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    const __m256i first  = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)in), bswap);
+    const __m256i second = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(in + 4)), bswap);
+
+    //
+    // Lanes hold blocks 0, 1, 4, 5, 2, 3, 6, 7, the order is
+    // restored with unpacking at the end
+    //
+
+    __m256i left  = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(first), _mm256_castsi256_ps(second), 0x88));
+    __m256i right = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(first), _mm256_castsi256_ps(second), 0xdd));
+
+    size_t round;
+
+    for (round = 0; round < MAGMA_ROUNDS; round += 2)
+    {
+        left  = _mm256_xor_si256(left, magmap_avx2_g(tables, right, keys[round]));
+        right = _mm256_xor_si256(right, magmap_avx2_g(tables, left, keys[round + 1]));
+    }
+
+    //
+    // The last round does not swap halves, so output is (right, left)
+    //
+
+    _mm256_storeu_si256((__m256i*)out, _mm256_shuffle_epi8(_mm256_unpacklo_epi32(right, left), bswap));
+    _mm256_storeu_si256((__m256i*)(out + 4), _mm256_shuffle_epi8(_mm256_unpackhi_epi32(right, left), bswap));
+}
+
+
+void magma_avx2_encrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_AVX2, ENCRYPT_BLOCKS, blocks_count);
+
+    unsigned long long tail[MAGMAP_AVX2_BLOCKS];
+    MAGMAP_AVX2_TABLES tables;
+
+    const unsigned int* keys = (const unsigned int*)round_keys->key;
+
+    magmap_avx2_load_tables(&tables);
+
+    for (; blocks_count >= MAGMAP_AVX2_BLOCKS; blocks_count -= MAGMAP_AVX2_BLOCKS)
+    {
+        magmap_avx2_process(&tables, in, keys, out);
+
+        in += MAGMAP_AVX2_BLOCKS;
+        out += MAGMAP_AVX2_BLOCKS;
+    }
+
+    if (blocks_count)
+    {
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, in, blocks_count * sizeof(*in));
+
+        magmap_avx2_process(&tables, tail, keys, tail);
+
+        memcpy(out, tail, blocks_count * sizeof(*out));
+        memset(tail, 0, sizeof(tail));
+    }
+
+    INSTRUMENTATION_END();
+}
+
+
+void magma_avx2_decrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count)
+{
+    INSTRUMENTATION_BEGIN(MAGMA_AVX2, DECRYPT_BLOCKS, blocks_count);
+
+    magma_avx2_encrypt_blocks(in, round_keys, out, blocks_count);
+
+    INSTRUMENTATION_END();
+}
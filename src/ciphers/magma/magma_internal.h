@@ -0,0 +1,76 @@
+/**
+ * @file magma_internal.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Magma internals shared between engines
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_MAGMA_INTERNAL_INCLUDED
+#define BCLIB_MAGMA_INTERNAL_INCLUDED
+
+
+#include "ciphers/magma/magma.h"
+#include "common/utils.h"
+
+
+/**
+ * @brief Number of rounds in cipher.
+ */
+#define MAGMA_ROUNDS 32
+
+
+/**
+ * @brief Number of blocks processed simultaneously by AVX2 engine (one per 32-bit lane).
+ */
+#define MAGMAP_AVX2_BLOCKS 8
+
+
+/**
+ * @brief Internal Magma key structure: round keys in order of use
+ *        (reversed for decryption, so both directions are the same).
+ */
+typedef struct tagMAGMA_INTERNAL_KEY
+{
+    unsigned int key[MAGMA_ROUNDS];
+} MAGMA_INTERNAL_KEY;
+
+
+//
+// Check if generic key can hold a key for Magma
+//
+
+BCLIB_STATIC_ASSERT(sizeof(MAGMA_INTERNAL_KEY) <= MAX_KEY_SIZE,
+                    maximum_key_size_is_less_than_necessary_for_magma);
+
+
+/**
+ * @brief Substitutions pi_0, ..., pi_7. Chapter 5.1.1 of GOST 34.12-2018
+ */
+extern const unsigned char magmap_pi[8][16];
+
+
+//
+// Generic engine
+//
+
+void magma_encrypt_block(const unsigned long long in, const KEY* round_keys, unsigned long long* out);
+void magma_decrypt_block(const unsigned long long in, const KEY* round_keys, unsigned long long* out);
+void magma_encrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count);
+void magma_decrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count);
+void magma_initialize_encrypt_key(const unsigned char* key, KEY* round_keys);
+void magma_initialize_decrypt_key(const unsigned char* key, KEY* round_keys);
+void magma_initialize_keys(const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys);
+void magma_initialize_keys_batch(const unsigned char* keys, KEY* encrypt_round_keys, KEY* decrypt_round_keys, size_t keys_count);
+
+
+//
+// AVX2 engine (halves of 8 blocks per register)
+//
+
+void magma_avx2_encrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count);
+void magma_avx2_decrypt_blocks(const unsigned long long* in, const KEY* round_keys, unsigned long long* out, size_t blocks_count);
+
+
+#endif  // !BCLIB_MAGMA_INTERNAL_INCLUDED
@@ -0,0 +1,150 @@
+/**
+ * @file cpu.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CPU features detection for runtime engine selection
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "common/cpu.h"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#   include <immintrin.h>
+#elif defined(__GNUC__)
+#   include <cpuid.h>
+#else
+#   error Unsupported compiler
+#endif
+
+
+/**
+ * @brief Marks cached features as initialized (CPU may have no features at all).
+ */
+#define CPUP_INITIALIZED 0x80000000u
+
+
+/**
+ * @brief XCR0 bits: SSE and AVX (YMM) states.
+ */
+#define CPUP_XCR0_AVX 0x06u
+
+
+/**
+ * @brief XCR0 bits: SSE, AVX, opmask and ZMM states.
+ */
+#define CPUP_XCR0_AVX512 0xe6u
+
+
+/**
+ * @brief Cached features. Concurrent initialization is benign: all
+ *        threads compute the same value.
+ */
+static volatile unsigned int cpup_features = 0;
+
+
+static void cpup_cpuid(unsigned int leaf, unsigned int subleaf, unsigned int registers[4])
+{
+#if defined(_MSC_VER)
+    __cpuidex((int*)registers, (int)leaf, (int)subleaf);
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+
+static unsigned long long cpup_xgetbv(void)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax;
+    unsigned int edx;
+
+    //
+    // Inline assembly does not require -mxsave for the whole file
+    //
+
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+
+static unsigned int cpup_detect(void)
+{
+    unsigned int registers[4] = { 0 };
+    unsigned int features     = 0;
+    unsigned int max_leaf;
+    unsigned long long xcr0   = 0;
+
+    cpup_cpuid(0, 0, registers);
+    max_leaf = registers[0];
+
+    if (max_leaf < 1)
+    {
+        return features;
+    }
+
+    cpup_cpuid(1, 0, registers);
+
+    features |= (registers[3] & (1u << 26)) ? CPU_FEATURE_SSE2 : 0;
+    features |= (registers[2] & (1u << 9)) ? CPU_FEATURE_SSSE3 : 0;
+    features |= (registers[2] & (1u << 1)) ? CPU_FEATURE_PCLMUL : 0;
+    features |= (registers[2] & (1u << 25)) ? CPU_FEATURE_AESNI : 0;
+
+    //
+    // OSXSAVE is required to check, which register states OS preserves
+    //
+
+    if (registers[2] & (1u << 27))
+    {
+        xcr0 = cpup_xgetbv();
+    }
+
+    if (max_leaf < 7)
+    {
+        return features;
+    }
+
+    cpup_cpuid(7, 0, registers);
+
+    features |= (registers[2] & (1u << 8)) ? CPU_FEATURE_GFNI : 0;
+
+    if ((xcr0 & CPUP_XCR0_AVX) == CPUP_XCR0_AVX)
+    {
+        features |= (registers[1] & (1u << 5)) ? CPU_FEATURE_AVX2 : 0;
+        features |= (registers[2] & (1u << 9)) ? CPU_FEATURE_VAES : 0;
+    }
+
+    if ((xcr0 & CPUP_XCR0_AVX512) == CPUP_XCR0_AVX512)
+    {
+        features |= (registers[1] & (1u << 16)) ? CPU_FEATURE_AVX512F : 0;
+        features |= (registers[1] & (1u << 30)) ? CPU_FEATURE_AVX512BW : 0;
+        features |= (registers[2] & (1u << 1)) ? CPU_FEATURE_AVX512VBMI : 0;
+    }
+
+    return features;
+}
+
+
+unsigned int cpu_features(void)
+{
+    unsigned int features = cpup_features;
+
+    if (!(features & CPUP_INITIALIZED))
+    {
+        features      = cpup_detect() | CPUP_INITIALIZED;
+        cpup_features = features;
+    }
+
+    return features & ~CPUP_INITIALIZED;
+}
+
+
+int cpu_supports(unsigned int required)
+{
+    return (cpu_features() & required) == required;
+}
@@ -0,0 +1,421 @@
+/**
+ * @file instrumentation.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Optional instrumentation of cipher calls (per-thread counters)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include <string.h>
+
+#include "common/instrumentation.h"
+#include "instrumentation_internal.h"
+
+
+#if defined(BCLIB_INSTRUMENTATION)
+
+#include <stdlib.h>
+
+#include "common/utils.h"
+
+#if defined(_WIN32)
+#   include <windows.h>
+#   include <intrin.h>
+#else
+#   include <pthread.h>
+#   include <x86intrin.h>
+#endif
+
+#if defined(BCLIB_INSTRUMENTATION_USDT)
+#   include <sys/sdt.h>
+#endif
+
+
+//
+// Counters are written by their thread only, other threads read
+// them with atomic loads (a plain load and store on x86-64)
+//
+
+#if defined(_MSC_VER)
+#   define INSTRUMENTATIONP_LOAD(value)        ((unsigned long long)__iso_volatile_load64((const volatile __int64*)&(value)))
+#   define INSTRUMENTATIONP_STORE(value, data) __iso_volatile_store64((volatile __int64*)&(value), (__int64)(data))
+#else
+#   define INSTRUMENTATIONP_LOAD(value)        __atomic_load_n(&(value), __ATOMIC_RELAXED)
+#   define INSTRUMENTATIONP_STORE(value, data) __atomic_store_n(&(value), (data), __ATOMIC_RELAXED)
+#endif
+
+
+/**
+ * @brief Number of counters in statistics.
+ */
+#define INSTRUMENTATIONP_COUNTERS_COUNT (sizeof(INSTRUMENTATION_STATISTICS) / sizeof(unsigned long long))
+
+
+/**
+ * @brief Counters of a single thread. Blocks of running threads are linked 
+ *        into a list, so they can be summed up by a query.
+ */
+typedef struct tagINSTRUMENTATIONP_THREAD
+{
+    INSTRUMENTATION_STATISTICS statistics;       /**< Counters (written by the thread only) */
+    INSTRUMENTATION_STATISTICS baseline;         /**< Counters at the last reset (protected by lock) */
+    unsigned int depth;                          /**< Depth of nested instrumented calls */
+    struct tagINSTRUMENTATIONP_THREAD* previous; /**< Previous running thread */
+    struct tagINSTRUMENTATIONP_THREAD* next;     /**< Next running thread */
+} INSTRUMENTATIONP_THREAD;
+
+
+/**
+ * @brief Counters of the calling thread.
+ */
+static BCLIB_THREAD_LOCAL INSTRUMENTATIONP_THREAD* instrumentationp_thread = 0;
+
+
+/**
+ * @brief Running threads and accumulated counters of finished ones.
+ *        Protected by a spin lock.
+ */
+static INSTRUMENTATIONP_THREAD* instrumentationp_threads = 0;
+static INSTRUMENTATION_STATISTICS instrumentationp_retired;
+static volatile long instrumentationp_lock               = 0;
+
+
+//
+// Thread exit notification: counters of a finished thread are 
+// moved to retired ones, hence short-living threads (e.g. of 
+// bulk API) do not leak memory
+//
+
+#if defined(_WIN32)
+static DWORD instrumentationp_key         = FLS_OUT_OF_INDEXES;
+static volatile long instrumentationp_ready = 0;
+#else
+static pthread_key_t instrumentationp_key;
+static pthread_once_t instrumentationp_once = PTHREAD_ONCE_INIT;
+#endif
+
+
+/**
+ * @brief Acquires registry lock.
+ */
+static void instrumentationp_acquire(void)
+{
+    while (!BCLIB_SPIN_TRY_LOCK(&instrumentationp_lock))
+    {
+        while (instrumentationp_lock)
+        {
+            BCLIB_SPIN_PAUSE();
+        }
+    }
+}
+
+
+/**
+ * @brief Releases registry lock.
+ */
+static void instrumentationp_release(void)
+{
+    BCLIB_SPIN_UNLOCK(&instrumentationp_lock);
+}
+
+
+/**
+ * @brief Adds counters of a thread since the last reset to accumulator.
+ *        Must be called under registry lock.
+ */
+static void instrumentationp_accumulate(INSTRUMENTATION_STATISTICS* accumulator, const INSTRUMENTATIONP_THREAD* thread)
+{
+    const unsigned long long* source   = (const unsigned long long*)&thread->statistics;
+    const unsigned long long* baseline = (const unsigned long long*)&thread->baseline;
+    unsigned long long* destination    = (unsigned long long*)accumulator;
+
+    size_t idx;
+
+    for (idx = 0; idx < INSTRUMENTATIONP_COUNTERS_COUNT; ++idx)
+    {
+        destination[idx] += INSTRUMENTATIONP_LOAD(source[idx]) - baseline[idx];
+    }
+}
+
+
+/**
+ * @brief Adds a value to a counter of the calling thread.
+ */
+BCLIB_FORCEINLINE static void instrumentationp_add(unsigned long long* counter, unsigned long long value)
+{
+    INSTRUMENTATIONP_STORE(*counter, *counter + value);
+}
+
+
+/**
+ * @brief Unlinks counters of a finished thread.
+ */
+#if defined(_WIN32)
+static VOID WINAPI instrumentationp_retire(PVOID context)
+#else
+static void instrumentationp_retire(void* context)
+#endif
+{
+    INSTRUMENTATIONP_THREAD* thread = (INSTRUMENTATIONP_THREAD*)context;
+
+    if (!thread)
+    {
+        return;
+    }
+
+    instrumentationp_acquire();
+
+    instrumentationp_accumulate(&instrumentationp_retired, thread);
+
+    if (thread->previous)
+    {
+        thread->previous->next = thread->next;
+    }
+    else
+    {
+        instrumentationp_threads = thread->next;
+    }
+
+    if (thread->next)
+    {
+        thread->next->previous = thread->previous;
+    }
+
+    instrumentationp_release();
+
+    instrumentationp_thread = 0;
+    free(thread);
+}
+
+
+#if !defined(_WIN32)
+/**
+ * @brief Creates thread exit notification key.
+ */
+static void instrumentationp_create_key(void)
+{
+    pthread_key_create(&instrumentationp_key, instrumentationp_retire);
+}
+#endif
+
+
+/**
+ * @brief Registers thread exit notification for counters.
+ * 
+ * @return Nonzero on success.
+ */
+static int instrumentationp_register(INSTRUMENTATIONP_THREAD* thread)
+{
+#if defined(_WIN32)
+    if (!instrumentationp_ready)
+    {
+        instrumentationp_acquire();
+
+        if (!instrumentationp_ready)
+        {
+            instrumentationp_key   = FlsAlloc(instrumentationp_retire);
+            instrumentationp_ready = 1;
+        }
+
+        instrumentationp_release();
+    }
+
+    return instrumentationp_key != FLS_OUT_OF_INDEXES && FlsSetValue(instrumentationp_key, thread);
+#else
+    pthread_once(&instrumentationp_once, instrumentationp_create_key);
+    return pthread_setspecific(instrumentationp_key, thread) == 0;
+#endif
+}
+
+
+/**
+ * @brief Gets counters of the calling thread, allocates them on the first call.
+ * 
+ * @return Counters or null if memory is exhausted.
+ */
+static INSTRUMENTATIONP_THREAD* instrumentationp_current(void)
+{
+    INSTRUMENTATIONP_THREAD* thread = instrumentationp_thread;
+
+    if (thread)
+    {
+        return thread;
+    }
+
+    thread = (INSTRUMENTATIONP_THREAD*)calloc(1, sizeof(INSTRUMENTATIONP_THREAD));
+    if (!thread)
+    {
+        return 0;
+    }
+
+    if (!instrumentationp_register(thread))
+    {
+        free(thread);
+        return 0;
+    }
+
+    instrumentationp_acquire();
+
+    thread->next = instrumentationp_threads;
+    if (instrumentationp_threads)
+    {
+        instrumentationp_threads->previous = thread;
+    }
+
+    instrumentationp_threads = thread;
+
+    instrumentationp_release();
+
+    return instrumentationp_thread = thread;
+}
+
+
+/**
+ * @brief Finds histogram bucket of a latency (floor of log2).
+ */
+BCLIB_FORCEINLINE static unsigned int instrumentationp_bucket(unsigned long long cycles)
+{
+    unsigned int bucket = 0;
+
+    while ((cycles >>= 1) && bucket < INSTRUMENTATION_HISTOGRAM_SIZE - 1)
+    {
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+
+unsigned long long instrumentation_enter(void)
+{
+    INSTRUMENTATIONP_THREAD* thread = instrumentationp_current();
+
+    if (thread)
+    {
+        ++thread->depth;
+    }
+
+    return __rdtsc();
+}
+
+
+void instrumentation_leave(const INSTRUMENTATION_SCOPE* scope)
+{
+    const unsigned long long cycles = __rdtsc() - scope->start;
+    INSTRUMENTATIONP_THREAD* thread = instrumentationp_thread;
+    INSTRUMENTATION_COUNTERS* counters;
+
+    if (!thread || --thread->depth)
+    {
+        return;
+    }
+
+    counters = &thread->statistics.counters[scope->engine][scope->event];
+
+    instrumentationp_add(&counters->calls, 1);
+    instrumentationp_add(&counters->blocks, scope->blocks);
+    instrumentationp_add(&counters->cycles, cycles);
+    instrumentationp_add(&counters->histogram[instrumentationp_bucket(cycles)], 1);
+
+#if defined(BCLIB_INSTRUMENTATION_USDT)
+    STAP_PROBE4(bclib, cipher_call, (int)scope->engine, (int)scope->event, scope->blocks, cycles);
+#endif
+}
+
+
+int instrumentation_enabled(void)
+{
+    return 1;
+}
+
+
+void instrumentation_query(INSTRUMENTATION_STATISTICS* statistics)
+{
+    const INSTRUMENTATIONP_THREAD* thread;
+
+    instrumentationp_acquire();
+
+    *statistics = instrumentationp_retired;
+
+    for (thread = instrumentationp_threads; thread; thread = thread->next)
+    {
+        instrumentationp_accumulate(statistics, thread);
+    }
+
+    instrumentationp_release();
+}
+
+
+void instrumentation_query_thread(INSTRUMENTATION_STATISTICS* statistics)
+{
+    const INSTRUMENTATIONP_THREAD* thread = instrumentationp_thread;
+
+    memset(statistics, 0, sizeof(INSTRUMENTATION_STATISTICS));
+
+    if (thread)
+    {
+        instrumentationp_acquire();
+        instrumentationp_accumulate(statistics, thread);
+        instrumentationp_release();
+    }
+}
+
+
+void instrumentation_reset(void)
+{
+    INSTRUMENTATIONP_THREAD* thread;
+
+    const unsigned long long* source;
+    unsigned long long* baseline;
+    size_t idx;
+
+    instrumentationp_acquire();
+
+    memset(&instrumentationp_retired, 0, sizeof(INSTRUMENTATION_STATISTICS));
+
+    //
+    // Counters of running threads are not modified (it would race
+    // with their updates), current values become a baseline instead
+    //
+
+    for (thread = instrumentationp_threads; thread; thread = thread->next)
+    {
+        source   = (const unsigned long long*)&thread->statistics;
+        baseline = (unsigned long long*)&thread->baseline;
+
+        for (idx = 0; idx < INSTRUMENTATIONP_COUNTERS_COUNT; ++idx)
+        {
+            baseline[idx] = INSTRUMENTATIONP_LOAD(source[idx]);
+        }
+    }
+
+    instrumentationp_release();
+}
+
+#else  // !BCLIB_INSTRUMENTATION
+
+int instrumentation_enabled(void)
+{
+    return 0;
+}
+
+
+void instrumentation_query(INSTRUMENTATION_STATISTICS* statistics)
+{
+    memset(statistics, 0, sizeof(INSTRUMENTATION_STATISTICS));
+}
+
+
+void instrumentation_query_thread(INSTRUMENTATION_STATISTICS* statistics)
+{
+    memset(statistics, 0, sizeof(INSTRUMENTATION_STATISTICS));
+}
+
+
+void instrumentation_reset(void)
+{
+}
+
+#endif  // BCLIB_INSTRUMENTATION
@@ -0,0 +1,80 @@
+/**
+ * @file instrumentation_internal.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Instrumentation hooks for cipher entry points
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_INSTRUMENTATION_INTERNAL_INCLUDED
+#define BCLIB_INSTRUMENTATION_INTERNAL_INCLUDED
+
+
+#include "common/instrumentation.h"
+
+
+#if defined(BCLIB_INSTRUMENTATION)
+
+#include <stddef.h>
+
+
+/**
+ * @brief Instrumented call in progress.
+ */
+typedef struct tagINSTRUMENTATION_SCOPE
+{
+    INSTRUMENTATION_ENGINE engine; /**< Engine */
+    INSTRUMENTATION_EVENT event;   /**< Event */
+    size_t blocks;                 /**< Number of blocks (keys) being processed */
+    unsigned long long start;      /**< Time stamp counter value at the beginning */
+} INSTRUMENTATION_SCOPE;
+
+
+/**
+ * @brief Enters instrumented procedure.
+ * 
+ * @return Time stamp counter value.
+ */
+unsigned long long instrumentation_enter(void);
+
+
+/**
+ * @brief Leaves instrumented procedure. Only the outermost call is recorded,
+ *        so engines, that process tails with another engine, are not 
+ *        accounted twice.
+ * 
+ * @param scope Call being finished
+ */
+void instrumentation_leave(const INSTRUMENTATION_SCOPE* scope);
+
+
+/**
+ * @brief Marks beginning of an instrumented procedure. Must be placed
+ *        before any statement, because it declares a variable.
+ * 
+ * @param engine Engine name without INSTRUMENTATION_ENGINE_ prefix
+ * @param event Event name without INSTRUMENTATION_EVENT_ prefix
+ * @param blocks Number of blocks (keys) being processed
+ */
+#define INSTRUMENTATION_BEGIN(engine, event, blocks)                                \
+    const INSTRUMENTATION_SCOPE instrumentationp_scope = {                          \
+        INSTRUMENTATION_ENGINE_##engine, INSTRUMENTATION_EVENT_##event, (blocks),   \
+        instrumentation_enter()                                                     \
+    }
+
+
+/**
+ * @brief Marks end of an instrumented procedure.
+ */
+#define INSTRUMENTATION_END() \
+    instrumentation_leave(&instrumentationp_scope)
+
+#else  // !BCLIB_INSTRUMENTATION
+
+#define INSTRUMENTATION_BEGIN(engine, event, blocks)
+#define INSTRUMENTATION_END()
+
+#endif  // BCLIB_INSTRUMENTATION
+
+#endif  // !BCLIB_INSTRUMENTATION_INTERNAL_INCLUDED
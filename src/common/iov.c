@@ -0,0 +1,222 @@
+/**
+ * @file iov.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Scatter-gather lists traversal shared between modes
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "common/iov.h"
+#include "common/utils.h"
+
+#include "iov_internal.h"
+
+#include <string.h>
+
+
+/**
+ * @brief Position in a scatter-gather list.
+ */
+typedef struct tagIOVP_CURSOR
+{
+    const IOVEC* segments; /**< Segments */
+    size_t count;          /**< Number of segments */
+    size_t index;          /**< Current segment */
+    size_t offset;         /**< Offset in current segment */
+} IOVP_CURSOR;
+
+
+/**
+ * @brief Moves cursor from exhausted (or empty) segments to the next non-empty one.
+ */
+static void iovp_cursor_normalize(IOVP_CURSOR* cursor)
+{
+    while (cursor->index < cursor->count && cursor->offset == cursor->segments[cursor->index].iov_len)
+    {
+        ++cursor->index;
+        cursor->offset = 0;
+    }
+}
+
+
+static void iovp_cursor_initialize(IOVP_CURSOR* cursor, const IOVEC* segments, size_t count)
+{
+    cursor->segments = segments;
+    cursor->count    = count;
+    cursor->index    = 0;
+    cursor->offset   = 0;
+
+    iovp_cursor_normalize(cursor);
+}
+
+
+/**
+ * @brief Number of bytes available contiguously at cursor.
+ */
+BCLIB_FORCEINLINE static size_t iovp_cursor_contiguous(const IOVP_CURSOR* cursor)
+{
+    return cursor->index < cursor->count ? cursor->segments[cursor->index].iov_len - cursor->offset : 0;
+}
+
+
+BCLIB_FORCEINLINE static unsigned char* iovp_cursor_pointer(const IOVP_CURSOR* cursor)
+{
+    return (unsigned char*)cursor->segments[cursor->index].iov_base + cursor->offset;
+}
+
+
+/**
+ * @brief Advances cursor within the current segment.
+ */
+BCLIB_FORCEINLINE static void iovp_cursor_advance(IOVP_CURSOR* cursor, size_t length)
+{
+    cursor->offset += length;
+    iovp_cursor_normalize(cursor);
+}
+
+
+/**
+ * @brief Copies data from several segments to a buffer.
+ */
+static void iovp_cursor_gather(IOVP_CURSOR* cursor, unsigned char* buffer, size_t length)
+{
+    size_t piece;
+
+    while (length && cursor->index < cursor->count)
+    {
+        piece = iovp_cursor_contiguous(cursor);
+        piece = piece < length ? piece : length;
+
+        memcpy(buffer, iovp_cursor_pointer(cursor), piece);
+        iovp_cursor_advance(cursor, piece);
+
+        buffer += piece;
+        length -= piece;
+    }
+}
+
+
+/**
+ * @brief Copies data from a buffer to several segments.
+ */
+static void iovp_cursor_scatter(IOVP_CURSOR* cursor, const unsigned char* buffer, size_t length)
+{
+    size_t piece;
+
+    while (length && cursor->index < cursor->count)
+    {
+        piece = iovp_cursor_contiguous(cursor);
+        piece = piece < length ? piece : length;
+
+        memcpy(iovp_cursor_pointer(cursor), buffer, piece);
+        iovp_cursor_advance(cursor, piece);
+
+        buffer += piece;
+        length -= piece;
+    }
+}
+
+
+/**
+ * @brief Wipes memory (volatile prevents optimizing the stores out).
+ */
+static void iovp_wipe(void* memory, size_t size)
+{
+    volatile unsigned char* bytes = (volatile unsigned char*)memory;
+
+    while (size--)
+    {
+        *bytes++ = 0;
+    }
+}
+
+
+/**
+ * @brief Total length of segments in bytes.
+ */
+static size_t iovp_total_length(const IOVEC* segments, size_t count)
+{
+    size_t total = 0;
+
+    while (count--)
+    {
+        total += segments++->iov_len;
+    }
+
+    return total;
+}
+
+
+int iov_process(const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count,
+                size_t unit_size, size_t length, IOV_PROCESS process, void* context)
+{
+    BCLIB_ALIGN16 unsigned char bounce[IOV_MAX_UNIT_SIZE];
+
+    IOVP_CURSOR in_cursor;
+    IOVP_CURSOR out_cursor;
+
+    size_t bounced = 0;
+    size_t run;
+    size_t available;
+
+    if (iovp_total_length(in, in_count) < length || iovp_total_length(out, out_count) < length)
+    {
+        return 0;
+    }
+
+    iovp_cursor_initialize(&in_cursor, in, in_count);
+    iovp_cursor_initialize(&out_cursor, out, out_count);
+
+    while (length)
+    {
+        run       = iovp_cursor_contiguous(&in_cursor);
+        available = iovp_cursor_contiguous(&out_cursor);
+
+        run = run < available ? run : available;
+        run = run < length ? run : length;
+
+        //
+        // Only whole units are processed in place, unless 
+        // the rest of data is contiguous
+        //
+
+        if (run < length)
+        {
+            run -= run % unit_size;
+        }
+
+        if (run)
+        {
+            process(context, iovp_cursor_pointer(&in_cursor), iovp_cursor_pointer(&out_cursor), run);
+
+            iovp_cursor_advance(&in_cursor, run);
+            iovp_cursor_advance(&out_cursor, run);
+
+            length -= run;
+            continue;
+        }
+
+        //
+        // Unit straddles segment boundary: input is gathered before
+        // output is scattered, so in-place processing is safe
+        //
+
+        run = unit_size < length ? unit_size : length;
+
+        iovp_cursor_gather(&in_cursor, bounce, run);
+        process(context, bounce, bounce, run);
+        iovp_cursor_scatter(&out_cursor, bounce, run);
+
+        bounced = bounced > run ? bounced : run;
+        length -= run;
+    }
+
+    if (bounced)
+    {
+        iovp_wipe(bounce, bounced);
+    }
+
+    return 1;
+}
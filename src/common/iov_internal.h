@@ -0,0 +1,55 @@
+/**
+ * @file iov_internal.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Scatter-gather lists traversal shared between modes
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BCLIB_IOV_INTERNAL_INCLUDED
+#define BCLIB_IOV_INTERNAL_INCLUDED
+
+
+#include "common/iov.h"
+
+
+/**
+ * @brief Maximal size of a unit (block or sector) in bytes.
+ */
+#define IOV_MAX_UNIT_SIZE 4096
+
+
+/**
+ * @brief Processes contiguous data. Called sequentially, so context may 
+ *        track a position in the stream (counter, sector number, etc.).
+ *
+ * @param context Mode specific context
+ * @param in Input data
+ * @param out Output data (may be equal to `in`)
+ * @param length Length in bytes (multiple of unit size, except for the last piece)
+ */
+typedef void (*IOV_PROCESS)(void* context, const unsigned char* in, unsigned char* out, size_t length);
+
+
+/**
+ * @brief Walks input and output scatter-gather lists simultaneously. Units, that
+ *        are contiguous in both lists, are processed in place with as few calls 
+ *        as possible. Only units, that straddle segment boundaries, are copied to 
+ *        a bounce buffer.
+ *
+ * @param in Input segments
+ * @param in_count Number of input segments
+ * @param out Output segments (may be the same as input ones)
+ * @param out_count Number of output segments
+ * @param unit_size Size of indivisible unit in bytes (at most IOV_MAX_UNIT_SIZE)
+ * @param length Total length in bytes
+ * @param process Procedure for contiguous data
+ * @param context Context for `process`
+ * @return Non-zero on success, zero if any list is shorter than `length` (nothing is processed)
+ */
+int iov_process(const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count,
+                size_t unit_size, size_t length, IOV_PROCESS process, void* context);
+
+
+#endif  // !BCLIB_IOV_INTERNAL_INCLUDED
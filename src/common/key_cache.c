@@ -0,0 +1,223 @@
+/**
+ * @file key_cache.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Bounded thread-safe cache of expanded key schedules
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "common/key_cache.h"
+#include "common/utils.h"
+
+
+/**
+ * @brief Wipes memory (volatile prevents optimizing the stores out).
+ * 
+ * @param memory Memory to wipe
+ * @param size Size of memory in bytes
+ */
+static void key_cachep_wipe(void* memory, size_t size)
+{
+    volatile unsigned char* bytes = (volatile unsigned char*)memory;
+
+    while (size--)
+    {
+        *bytes++ = 0;
+    }
+}
+
+
+/**
+ * @brief Selects a set for a key identifier (Fibonacci hashing).
+ * 
+ * @param cache Initialized cache
+ * @param key_id Key identifier
+ * @return Cache set
+ */
+BCLIB_FORCEINLINE static KEY_CACHE_SET* key_cachep_select_set(KEY_CACHE* cache, unsigned long long key_id)
+{
+    const unsigned long long hash = (key_id * 0x9e3779b97f4a7c15ull) >> 32;
+    return cache->sets + (size_t)(hash % cache->sets_count);
+}
+
+
+/**
+ * @brief Acquires spin lock of a set.
+ */
+BCLIB_FORCEINLINE static void key_cachep_lock(KEY_CACHE_SET* set)
+{
+    while (!BCLIB_SPIN_TRY_LOCK(&set->lock))
+    {
+        while (set->lock)
+        {
+            BCLIB_SPIN_PAUSE();
+        }
+    }
+}
+
+
+/**
+ * @brief Releases spin lock of a set.
+ */
+BCLIB_FORCEINLINE static void key_cachep_unlock(KEY_CACHE_SET* set)
+{
+    BCLIB_SPIN_UNLOCK(&set->lock);
+}
+
+
+/**
+ * @brief Finds an entry in a locked set.
+ * 
+ * @param set Locked cache set
+ * @param key_id Key identifier
+ * @return Entry or NULL if key is not present
+ */
+BCLIB_FORCEINLINE static KEY_CACHE_ENTRY* key_cachep_find(KEY_CACHE_SET* set, unsigned long long key_id)
+{
+    unsigned int idx;
+
+    for (idx = 0; idx < KEY_CACHE_WAYS; ++idx)
+    {
+        if (set->entries[idx].valid && set->entries[idx].key_id == key_id)
+        {
+            return set->entries + idx;
+        }
+    }
+
+    return 0;
+}
+
+
+void key_cache_initialize(KEY_CACHE* cache, const BLOCK_CIPHER* cipher, KEY_CACHE_SET* sets, size_t sets_count)
+{
+    size_t idx;
+
+    cache->cipher     = cipher;
+    cache->sets       = sets;
+    cache->sets_count = sets_count;
+
+    for (idx = 0; idx < sets_count; ++idx)
+    {
+        key_cachep_wipe(sets + idx, sizeof(KEY_CACHE_SET));
+    }
+}
+
+
+int key_cache_lookup(KEY_CACHE* cache, unsigned long long key_id, KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    KEY_CACHE_SET* set = key_cachep_select_set(cache, key_id);
+    KEY_CACHE_ENTRY* entry;
+
+    key_cachep_lock(set);
+
+    entry = key_cachep_find(set, key_id);
+
+    if (entry)
+    {
+        entry->last_use = ++set->clock;
+
+        if (encrypt_round_keys)
+        {
+            *encrypt_round_keys = entry->encrypt_round_keys;
+        }
+
+        if (decrypt_round_keys)
+        {
+            *decrypt_round_keys = entry->decrypt_round_keys;
+        }
+    }
+
+    key_cachep_unlock(set);
+
+    return entry != 0;
+}
+
+
+void key_cache_insert(KEY_CACHE* cache, unsigned long long key_id, const KEY* encrypt_round_keys, const KEY* decrypt_round_keys)
+{
+    KEY_CACHE_SET* set = key_cachep_select_set(cache, key_id);
+    KEY_CACHE_ENTRY* entry;
+
+    unsigned int idx;
+
+    key_cachep_lock(set);
+
+    entry = key_cachep_find(set, key_id);
+
+    if (!entry)
+    {
+        //
+        // Free entry if any, least recently used one otherwise
+        //
+
+        entry = set->entries;
+
+        for (idx = 0; idx < KEY_CACHE_WAYS && entry->valid; ++idx)
+        {
+            if (!set->entries[idx].valid || set->entries[idx].last_use < entry->last_use)
+            {
+                entry = set->entries + idx;
+            }
+        }
+    }
+
+    entry->encrypt_round_keys = *encrypt_round_keys;
+    entry->decrypt_round_keys = *decrypt_round_keys;
+    entry->key_id             = key_id;
+    entry->last_use           = ++set->clock;
+    entry->valid              = 1;
+
+    key_cachep_unlock(set);
+}
+
+
+int key_cache_get(KEY_CACHE* cache, unsigned long long key_id, const unsigned char* key, KEY* encrypt_round_keys, KEY* decrypt_round_keys)
+{
+    if (key_cache_lookup(cache, key_id, encrypt_round_keys, decrypt_round_keys))
+    {
+        return 1;
+    }
+
+    //
+    // Key is expanded outside of the lock: concurrent misses on
+    // the same key may expand it twice, but never block each other
+    //
+
+    cache->cipher->initialize_keys(key, encrypt_round_keys, decrypt_round_keys);
+    key_cache_insert(cache, key_id, encrypt_round_keys, decrypt_round_keys);
+
+    return 0;
+}
+
+
+void key_cache_remove(KEY_CACHE* cache, unsigned long long key_id)
+{
+    KEY_CACHE_SET* set = key_cachep_select_set(cache, key_id);
+    KEY_CACHE_ENTRY* entry;
+
+    key_cachep_lock(set);
+
+    entry = key_cachep_find(set, key_id);
+
+    if (entry)
+    {
+        key_cachep_wipe(entry, sizeof(KEY_CACHE_ENTRY));
+    }
+
+    key_cachep_unlock(set);
+}
+
+
+void key_cache_clear(KEY_CACHE* cache)
+{
+    size_t idx;
+
+    for (idx = 0; idx < cache->sets_count; ++idx)
+    {
+        key_cachep_lock(cache->sets + idx);
+        key_cachep_wipe(cache->sets[idx].entries, sizeof(cache->sets[idx].entries));
+        key_cachep_unlock(cache->sets + idx);
+    }
+}
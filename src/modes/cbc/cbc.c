@@ -0,0 +1,206 @@
+/**
+ * @file cbc.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CBC mode of operation (GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/cbc/cbc.h"
+#include "common/utils.h"
+
+#include <string.h>
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define CBCP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Maximal number of blocks processed with a single call.
+ */
+#define CBCP_BATCH 16
+
+
+/**
+ * @brief Checks that a size is a non-zero multiple of block size.
+ */
+#define CBCP_VALID_SIZE(size) ((size) && !((size) % CBCP_BLOCK_SIZE))
+
+
+int cbc_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 __m128i blocks[CBCP_BATCH];
+
+    const size_t chains_count = iv_size / CBCP_BLOCK_SIZE;
+    const size_t batch        = chains_count < CBCP_BATCH ? chains_count : CBCP_BATCH;
+    const size_t blocks_count = length / CBCP_BLOCK_SIZE;
+
+    const __m128i* in_blocks = (const __m128i*)in;
+    __m128i* out_blocks      = (__m128i*)out;
+
+    size_t block;
+    size_t count;
+    size_t idx;
+
+    if (!CBCP_VALID_SIZE(iv_size) || length % CBCP_BLOCK_SIZE)
+    {
+        return 0;
+    }
+
+    //
+    // Blocks [i, i + z) depend on blocks [i - z, i) only, which
+    // are already encrypted (or are blocks of IV)
+    //
+
+    for (block = 0; block < blocks_count; block += count)
+    {
+        count = (blocks_count - block < batch) ? blocks_count - block : batch;
+
+        for (idx = 0; idx < count; ++idx)
+        {
+            blocks[idx] = _mm_xor_si128(_mm_loadu_si128(in_blocks + block + idx),
+                                        (block + idx < chains_count) ? _mm_loadu_si128((const __m128i*)iv + block + idx)
+                                                                     : _mm_loadu_si128(out_blocks + block + idx - chains_count));
+        }
+
+        cipher->encrypt_blocks(blocks, key, out_blocks + block, count);
+    }
+
+    memset(blocks, 0, sizeof(blocks));
+
+    return 1;
+}
+
+
+int cbc_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 __m128i blocks[CBCP_BATCH];
+
+    const size_t chains_count = iv_size / CBCP_BLOCK_SIZE;
+    const size_t blocks_count = length / CBCP_BLOCK_SIZE;
+
+    const __m128i* in_blocks = (const __m128i*)in;
+    __m128i* out_blocks      = (__m128i*)out;
+
+    size_t block = blocks_count;
+    size_t count;
+    size_t idx;
+
+    if (!CBCP_VALID_SIZE(iv_size) || length % CBCP_BLOCK_SIZE)
+    {
+        return 0;
+    }
+
+    //
+    // Batches are processed from the end of buffer and blocks of a batch
+    // are stored in reverse order, so ciphertext blocks needed for 
+    // chaining are not overwritten yet in case of in-place decryption
+    //
+
+    while (block)
+    {
+        count  = block < CBCP_BATCH ? block : CBCP_BATCH;
+        block -= count;
+
+        cipher->decrypt_blocks(in_blocks + block, key, blocks, count);
+
+        for (idx = count; idx--;)
+        {
+            _mm_storeu_si128(out_blocks + block + idx,
+                             _mm_xor_si128(blocks[idx], (block + idx < chains_count) ? _mm_loadu_si128((const __m128i*)iv + block + idx)
+                                                                                     : _mm_loadu_si128(in_blocks + block + idx - chains_count)));
+        }
+    }
+
+    memset(blocks, 0, sizeof(blocks));
+
+    return 1;
+}
+
+
+int cbc_encrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* ivs, size_t sector_size,
+                        size_t sectors_count, const unsigned char* in, unsigned char* out)
+{
+    BCLIB_ALIGN16 __m128i states[CBCP_BATCH];
+
+    const size_t sector_blocks = sector_size / CBCP_BLOCK_SIZE;
+    const __m128i* in_blocks   = (const __m128i*)in;
+    __m128i* out_blocks        = (__m128i*)out;
+
+    size_t batch;
+    size_t block;
+    size_t idx;
+
+    if (!CBCP_VALID_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    while (sectors_count)
+    {
+        batch = sectors_count < CBCP_BATCH ? sectors_count : CBCP_BATCH;
+
+        for (idx = 0; idx < batch; ++idx)
+        {
+            states[idx] = _mm_loadu_si128((const __m128i*)(ivs + idx * CBC_SECTOR_IV_SIZE));
+        }
+
+        //
+        // One block of each sector is encrypted with a single call,
+        // so latencies of the chains are overlapped
+        //
+
+        for (block = 0; block < sector_blocks; ++block)
+        {
+            for (idx = 0; idx < batch; ++idx)
+            {
+                states[idx] = _mm_xor_si128(states[idx], _mm_loadu_si128(in_blocks + idx * sector_blocks + block));
+            }
+
+            cipher->encrypt_blocks(states, key, states, batch);
+
+            for (idx = 0; idx < batch; ++idx)
+            {
+                _mm_storeu_si128(out_blocks + idx * sector_blocks + block, states[idx]);
+            }
+        }
+
+        ivs += batch * CBC_SECTOR_IV_SIZE;
+        in_blocks += batch * sector_blocks;
+        out_blocks += batch * sector_blocks;
+        sectors_count -= batch;
+    }
+
+    memset(states, 0, sizeof(states));
+
+    return 1;
+}
+
+
+int cbc_decrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* ivs, size_t sector_size,
+                        size_t sectors_count, const unsigned char* in, unsigned char* out)
+{
+    size_t idx;
+
+    if (!CBCP_VALID_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    for (idx = 0; idx < sectors_count; ++idx)
+    {
+        cbc_decrypt(cipher, key, ivs + idx * CBC_SECTOR_IV_SIZE, CBC_SECTOR_IV_SIZE,
+                    in + idx * sector_size, out + idx * sector_size, sector_size);
+    }
+
+    return 1;
+}
@@ -0,0 +1,335 @@
+/**
+ * @file cfb.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CFB mode of operation (GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/cfb/cfb.h"
+#include "common/utils.h"
+
+#include <string.h>
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define CFBP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Maximal number of blocks processed with a single call.
+ */
+#define CFBP_BATCH 16
+
+
+/**
+ * @brief Checks that IV size is a non-zero multiple of block size.
+ */
+#define CFBP_VALID_IV_SIZE(iv_size) ((iv_size) && !((iv_size) % CFBP_BLOCK_SIZE))
+
+
+/**
+ * @brief Maximal number of blocks in shift register of streaming state.
+ */
+#define CFBP_MAX_REGISTER_BLOCKS (CFB_MAX_STREAM_IV_SIZE / CFBP_BLOCK_SIZE)
+
+
+/**
+ * @brief Streaming state (stored in CFB_CONTEXT).
+ */
+typedef struct tagCFBP_STREAM
+{
+    const BLOCK_CIPHER* cipher;                             /**< Cipher interface */
+    const KEY* key;                                         /**< Key schedule for encryption */
+    __m128i shift_register[CFBP_MAX_REGISTER_BLOCKS];       /**< The last ciphertext blocks (oldest first) */
+    BCLIB_ALIGN16 unsigned char keystream[CFBP_BLOCK_SIZE]; /**< Keystream of the current block */
+    BCLIB_ALIGN16 unsigned char pending[CFBP_BLOCK_SIZE];   /**< Ciphertext of the current block */
+    size_t register_blocks;                                 /**< Number of blocks in shift register */
+    size_t keystream_used;                                  /**< Used bytes of keystream */
+    int decrypt;                                            /**< Non-zero for decryption */
+} CFBP_STREAM;
+
+
+//
+// Check if context can hold streaming state
+//
+
+BCLIB_STATIC_ASSERT(sizeof(CFBP_STREAM) <= CFB_CONTEXT_SIZE, cfb_context_size_is_less_than_necessary);
+
+
+/**
+ * @brief XORs a block (possibly truncated) with keystream.
+ */
+BCLIB_FORCEINLINE static void cfbp_xor_block(__m128i keystream, const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 unsigned char block[CFBP_BLOCK_SIZE];
+    size_t idx;
+
+    if (length >= CFBP_BLOCK_SIZE)
+    {
+        _mm_storeu_si128((__m128i*)out, _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), keystream));
+        return;
+    }
+
+    _mm_store_si128((__m128i*)block, keystream);
+
+    for (idx = 0; idx < length; ++idx)
+    {
+        out[idx] = in[idx] ^ block[idx];
+    }
+
+    memset(block, 0, sizeof(block));
+}
+
+
+/**
+ * @brief Shifts the register of streaming state by several blocks and appends
+ *        new ciphertext blocks to its end.
+ */
+static void cfbp_shift(CFBP_STREAM* stream, const __m128i* blocks, size_t blocks_count)
+{
+    const size_t kept = stream->register_blocks - blocks_count;
+
+    memmove(stream->shift_register, stream->shift_register + blocks_count, kept * sizeof(__m128i));
+    memcpy(stream->shift_register + kept, blocks, blocks_count * sizeof(__m128i));
+}
+
+
+/**
+ * @brief Initializes streaming state.
+ */
+static void cfbp_stream_initialize(CFB_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key,
+                                   const unsigned char* iv, size_t iv_size, int decrypt)
+{
+    CFBP_STREAM* stream = (CFBP_STREAM*)context->context;
+
+    stream->cipher          = cipher;
+    stream->key             = key;
+    stream->register_blocks = iv_size / CFBP_BLOCK_SIZE;
+    stream->keystream_used  = CFBP_BLOCK_SIZE;
+    stream->decrypt         = decrypt;
+
+    memcpy(stream->shift_register, iv, iv_size);
+}
+
+
+int cfb_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 __m128i blocks[CFBP_BATCH];
+
+    const size_t chains_count = iv_size / CFBP_BLOCK_SIZE;
+    const size_t batch        = chains_count < CFBP_BATCH ? chains_count : CFBP_BATCH;
+    const size_t blocks_count = (length + CFBP_BLOCK_SIZE - 1) / CFBP_BLOCK_SIZE;
+
+    size_t block;
+    size_t count;
+    size_t idx;
+
+    if (!CFBP_VALID_IV_SIZE(iv_size))
+    {
+        return 0;
+    }
+
+    //
+    // Keystream of blocks [i, i + z) is encryption of ciphertext
+    // blocks [i - z, i), which are already computed (or are blocks of IV)
+    //
+
+    for (block = 0; block < blocks_count; block += count)
+    {
+        count = (blocks_count - block < batch) ? blocks_count - block : batch;
+
+        for (idx = 0; idx < count; ++idx)
+        {
+            blocks[idx] = (block + idx < chains_count) ? _mm_loadu_si128((const __m128i*)iv + block + idx)
+                                                       : _mm_loadu_si128((const __m128i*)out + block + idx - chains_count);
+        }
+
+        cipher->encrypt_blocks(blocks, key, blocks, count);
+
+        for (idx = 0; idx < count; ++idx)
+        {
+            cfbp_xor_block(blocks[idx], in + (block + idx) * CFBP_BLOCK_SIZE, out + (block + idx) * CFBP_BLOCK_SIZE,
+                           length - (block + idx) * CFBP_BLOCK_SIZE);
+        }
+    }
+
+    memset(blocks, 0, sizeof(blocks));
+
+    return 1;
+}
+
+
+int cfb_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, size_t iv_size,
+                const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 __m128i blocks[CFBP_BATCH];
+
+    const size_t chains_count = iv_size / CFBP_BLOCK_SIZE;
+
+    size_t block = (length + CFBP_BLOCK_SIZE - 1) / CFBP_BLOCK_SIZE;
+    size_t count;
+    size_t idx;
+
+    if (!CFBP_VALID_IV_SIZE(iv_size))
+    {
+        return 0;
+    }
+
+    //
+    // Batches are processed from the end of buffer, so ciphertext
+    // blocks needed for keystream are not overwritten yet in case
+    // of in-place decryption
+    //
+
+    while (block)
+    {
+        count  = block < CFBP_BATCH ? block : CFBP_BATCH;
+        block -= count;
+
+        for (idx = 0; idx < count; ++idx)
+        {
+            blocks[idx] = (block + idx < chains_count) ? _mm_loadu_si128((const __m128i*)iv + block + idx)
+                                                       : _mm_loadu_si128((const __m128i*)in + block + idx - chains_count);
+        }
+
+        cipher->encrypt_blocks(blocks, key, blocks, count);
+
+        for (idx = count; idx--;)
+        {
+            cfbp_xor_block(blocks[idx], in + (block + idx) * CFBP_BLOCK_SIZE, out + (block + idx) * CFBP_BLOCK_SIZE,
+                           length - (block + idx) * CFBP_BLOCK_SIZE);
+        }
+    }
+
+    memset(blocks, 0, sizeof(blocks));
+
+    return 1;
+}
+
+
+int cfb_encrypt_init(CFB_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                     size_t iv_size)
+{
+    if (!CFBP_VALID_IV_SIZE(iv_size) || iv_size > CFB_MAX_STREAM_IV_SIZE)
+    {
+        return 0;
+    }
+
+    cfbp_stream_initialize(context, cipher, key, iv, iv_size, 0);
+
+    return 1;
+}
+
+
+int cfb_decrypt_init(CFB_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                     size_t iv_size)
+{
+    if (!CFBP_VALID_IV_SIZE(iv_size) || iv_size > CFB_MAX_STREAM_IV_SIZE)
+    {
+        return 0;
+    }
+
+    cfbp_stream_initialize(context, cipher, key, iv, iv_size, 1);
+
+    return 1;
+}
+
+
+void cfb_update(CFB_CONTEXT* context, const unsigned char* in, unsigned char* out, size_t length)
+{
+    CFBP_STREAM* stream = (CFBP_STREAM*)context->context;
+    BCLIB_ALIGN16 __m128i blocks[CFBP_MAX_REGISTER_BLOCKS];
+
+    size_t whole_length;
+    size_t shifted;
+    unsigned char data;
+
+    if (stream->keystream_used < CFBP_BLOCK_SIZE)
+    {
+        //
+        // Rest of the current block, it gets into register when completed
+        //
+
+        for (; length && stream->keystream_used < CFBP_BLOCK_SIZE; --length)
+        {
+            data   = *in++;
+            *out++ = data ^ stream->keystream[stream->keystream_used];
+
+            stream->pending[stream->keystream_used] = stream->decrypt ? data : data ^ stream->keystream[stream->keystream_used];
+            ++stream->keystream_used;
+        }
+
+        if (stream->keystream_used < CFBP_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        blocks[0] = _mm_load_si128((const __m128i*)stream->pending);
+        cfbp_shift(stream, blocks, 1);
+    }
+
+    whole_length = length - length % CFBP_BLOCK_SIZE;
+
+    if (whole_length)
+    {
+        shifted = whole_length / CFBP_BLOCK_SIZE;
+        shifted = shifted < stream->register_blocks ? shifted : stream->register_blocks;
+
+        //
+        // Register continues with the last ciphertext blocks of the run,
+        // they are saved in advance in case of in-place decryption
+        //
+
+        if (stream->decrypt)
+        {
+            memcpy(blocks, in + whole_length - shifted * CFBP_BLOCK_SIZE, shifted * CFBP_BLOCK_SIZE);
+            cfb_decrypt(stream->cipher, stream->key, (const unsigned char*)stream->shift_register,
+                        stream->register_blocks * CFBP_BLOCK_SIZE, in, out, whole_length);
+        }
+        else
+        {
+            cfb_encrypt(stream->cipher, stream->key, (const unsigned char*)stream->shift_register,
+                        stream->register_blocks * CFBP_BLOCK_SIZE, in, out, whole_length);
+            memcpy(blocks, out + whole_length - shifted * CFBP_BLOCK_SIZE, shifted * CFBP_BLOCK_SIZE);
+        }
+
+        cfbp_shift(stream, blocks, shifted);
+
+        in += whole_length;
+        out += whole_length;
+        length -= whole_length;
+    }
+
+    if (length)
+    {
+        //
+        // Keystream and output of an incomplete block are kept for the next chunk
+        //
+
+        stream->cipher->encrypt_blocks(stream->shift_register, stream->key, (__m128i*)stream->keystream, 1);
+
+        for (stream->keystream_used = 0; stream->keystream_used < length; ++stream->keystream_used)
+        {
+            data                        = in[stream->keystream_used];
+            out[stream->keystream_used] = data ^ stream->keystream[stream->keystream_used];
+
+            stream->pending[stream->keystream_used] = stream->decrypt ? data : out[stream->keystream_used];
+        }
+    }
+
+    memset(blocks, 0, sizeof(blocks));
+}
+
+
+void cfb_final(CFB_CONTEXT* context)
+{
+    memset(context, 0, sizeof(CFB_CONTEXT));
+}
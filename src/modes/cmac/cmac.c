@@ -0,0 +1,303 @@
+/**
+ * @file cmac.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief MAC generation mode (CMAC/OMAC1, GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/cmac/cmac.h"
+#include "common/utils.h"
+
+#include <string.h>
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define CMACP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Maximal number of chains advanced at once.
+ */
+#define CMACP_LANES 16
+
+
+/**
+ * @brief Checks tag size (tag is a prefix of the final state).
+ */
+#define CMACP_VALID_TAG_SIZE(tag_size) ((tag_size) > 0 && (tag_size) <= CMAC_MAX_TAG_SIZE)
+
+
+/**
+ * @brief State of a chain.
+ */
+typedef struct tagCMACP_LANE
+{
+    const unsigned char* message; /**< Current block of message */
+    size_t length;                /**< Remaining length of message */
+    size_t index;                 /**< Index of message */
+} CMACP_LANE;
+
+
+/**
+ * @brief Streaming state (stored in CMAC_CONTEXT).
+ */
+typedef struct tagCMACP_STREAM
+{
+    const BLOCK_CIPHER* cipher;                          /**< Cipher interface */
+    const KEY* key;                                      /**< Key schedule for encryption */
+    __m128i k1;                                          /**< Additional key for complete final block */
+    __m128i k2;                                          /**< Additional key for padded final block */
+    __m128i state;                                       /**< Current state of chain */
+    BCLIB_ALIGN16 unsigned char block[CMACP_BLOCK_SIZE]; /**< The last block absorbed */
+    size_t length;                                       /**< Length of the last block */
+} CMACP_STREAM;
+
+
+//
+// Check if context can hold streaming state
+//
+
+BCLIB_STATIC_ASSERT(sizeof(CMACP_STREAM) <= CMAC_CONTEXT_SIZE, cmac_context_size_is_less_than_necessary);
+
+
+/**
+ * @brief Multiplication by x modulo x^128 + x^7 + x^2 + x + 1 (shift
+ *        of a block in GOST byte order).
+ */
+static __m128i cmacp_double(__m128i block)
+{
+    BCLIB_ALIGN16 unsigned long long halves[2];
+
+    unsigned long long high;
+    unsigned long long low;
+
+    _mm_store_si128((__m128i*)halves, block);
+
+    high = BCLIB_BSWAP64(halves[0]);
+    low  = BCLIB_BSWAP64(halves[1]);
+
+    return _mm_set_epi64x((long long)BCLIB_BSWAP64((low << 1) ^ ((high >> 63) ? 0x87 : 0)),
+                          (long long)BCLIB_BSWAP64((high << 1) | (low >> 63)));
+}
+
+
+/**
+ * @brief Loads the next block of a message (the last one is padded and 
+ *        masked with an additional key).
+ */
+BCLIB_FORCEINLINE static __m128i cmacp_next_block(CMACP_LANE* lane, __m128i k1, __m128i k2)
+{
+    BCLIB_ALIGN16 unsigned char block[CMACP_BLOCK_SIZE];
+    __m128i result;
+
+    if (lane->length > CMACP_BLOCK_SIZE)
+    {
+        result = _mm_loadu_si128((const __m128i*)lane->message);
+
+        lane->message += CMACP_BLOCK_SIZE;
+        lane->length -= CMACP_BLOCK_SIZE;
+
+        return result;
+    }
+
+    if (lane->length == CMACP_BLOCK_SIZE)
+    {
+        result = _mm_xor_si128(_mm_loadu_si128((const __m128i*)lane->message), k1);
+    }
+    else
+    {
+        //
+        // Procedure 3 of padding: 1 || 0...0
+        //
+
+        memset(block, 0, sizeof(block));
+        memcpy(block, lane->message, lane->length);
+        block[lane->length] = 0x80;
+
+        result = _mm_xor_si128(_mm_load_si128((const __m128i*)block), k2);
+    }
+
+    lane->length = 0;
+    return result;
+}
+
+
+int cmac_compute(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* in, size_t length,
+                 unsigned char* tag, size_t tag_size)
+{
+    return cmac_compute_batch(cipher, key, &in, &length, 1, tag, tag_size);
+}
+
+
+int cmac_compute_batch(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* const* messages,
+                       const size_t* lengths, size_t messages_count, unsigned char* tags, size_t tag_size)
+{
+    BCLIB_ALIGN16 __m128i states[CMACP_LANES];
+    BCLIB_ALIGN16 __m128i k1;
+    BCLIB_ALIGN16 __m128i k2;
+
+    CMACP_LANE lanes[CMACP_LANES];
+
+    size_t lanes_count = 0;
+    size_t next        = 0;
+    size_t idx;
+
+    if (!CMACP_VALID_TAG_SIZE(tag_size))
+    {
+        return 0;
+    }
+
+    //
+    // Chapter 5.4.1 of GOST 34.13-2018: R = E(0), K1 = R << 1, K2 = K1 << 1
+    //
+
+    k1 = _mm_setzero_si128();
+    cipher->encrypt_blocks(&k1, key, &k1, 1);
+
+    k1 = cmacp_double(k1);
+    k2 = cmacp_double(k1);
+
+    while (lanes_count || next < messages_count)
+    {
+        //
+        // Occupy free lanes with the next messages
+        //
+
+        while (lanes_count < CMACP_LANES && next < messages_count)
+        {
+            lanes[lanes_count].message = messages[next];
+            lanes[lanes_count].length  = lengths[next];
+            lanes[lanes_count].index   = next;
+            states[lanes_count]        = _mm_setzero_si128();
+
+            ++lanes_count;
+            ++next;
+        }
+
+        for (idx = 0; idx < lanes_count; ++idx)
+        {
+            states[idx] = _mm_xor_si128(states[idx], cmacp_next_block(lanes + idx, k1, k2));
+        }
+
+        cipher->encrypt_blocks(states, key, states, lanes_count);
+
+        //
+        // Emit tags of finished messages, the last lane takes place of a finished one
+        //
+
+        for (idx = 0; idx < lanes_count;)
+        {
+            if (lanes[idx].length)
+            {
+                ++idx;
+                continue;
+            }
+
+            memcpy(tags + lanes[idx].index * tag_size, states + idx, tag_size);
+
+            --lanes_count;
+            lanes[idx]  = lanes[lanes_count];
+            states[idx] = states[lanes_count];
+        }
+    }
+
+    memset(states, 0, sizeof(states));
+    memset(&k1, 0, sizeof(k1));
+    memset(&k2, 0, sizeof(k2));
+
+    return 1;
+}
+
+
+void cmac_init(CMAC_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key)
+{
+    CMACP_STREAM* stream = (CMACP_STREAM*)context->context;
+
+    stream->cipher = cipher;
+    stream->key    = key;
+    stream->state  = _mm_setzero_si128();
+    stream->length = 0;
+
+    stream->k1 = _mm_setzero_si128();
+    cipher->encrypt_block(stream->k1, key, &stream->k1);
+
+    stream->k1 = cmacp_double(stream->k1);
+    stream->k2 = cmacp_double(stream->k1);
+}
+
+
+void cmac_update(CMAC_CONTEXT* context, const unsigned char* in, size_t length)
+{
+    CMACP_STREAM* stream = (CMACP_STREAM*)context->context;
+    size_t fill;
+
+    if (!length)
+    {
+        return;
+    }
+
+    if (stream->length)
+    {
+        fill = CMACP_BLOCK_SIZE - stream->length;
+        fill = fill < length ? fill : length;
+
+        memcpy(stream->block + stream->length, in, fill);
+
+        stream->length += fill;
+        in += fill;
+        length -= fill;
+
+        if (!length)
+        {
+            return;
+        }
+
+        //
+        // More data follows, hence the kept block is not the final one
+        //
+
+        stream->state = _mm_xor_si128(stream->state, _mm_load_si128((const __m128i*)stream->block));
+        stream->cipher->encrypt_block(stream->state, stream->key, &stream->state);
+    }
+
+    for (; length > CMACP_BLOCK_SIZE; in += CMACP_BLOCK_SIZE, length -= CMACP_BLOCK_SIZE)
+    {
+        stream->state = _mm_xor_si128(stream->state, _mm_loadu_si128((const __m128i*)in));
+        stream->cipher->encrypt_block(stream->state, stream->key, &stream->state);
+    }
+
+    memcpy(stream->block, in, length);
+    stream->length = length;
+}
+
+
+int cmac_final(CMAC_CONTEXT* context, unsigned char* tag, size_t tag_size)
+{
+    CMACP_STREAM* stream = (CMACP_STREAM*)context->context;
+    CMACP_LANE lane;
+
+    const int valid = CMACP_VALID_TAG_SIZE(tag_size);
+
+    if (valid)
+    {
+        lane.message = stream->block;
+        lane.length  = stream->length;
+        lane.index   = 0;
+
+        stream->state = _mm_xor_si128(stream->state, cmacp_next_block(&lane, stream->k1, stream->k2));
+        stream->cipher->encrypt_block(stream->state, stream->key, &stream->state);
+
+        memcpy(tag, &stream->state, tag_size);
+    }
+
+    memset(context, 0, sizeof(CMAC_CONTEXT));
+
+    return valid;
+}
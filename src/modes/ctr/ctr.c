@@ -0,0 +1,222 @@
+/**
+ * @file ctr.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief CTR mode of operation (GOST 34.13-2018)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/ctr/ctr.h"
+#include "common/utils.h"
+
+#include "iov_internal.h"
+
+#include <string.h>
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define CTRP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Number of keystream blocks generated at once.
+ */
+#define CTRP_BATCH 16
+
+
+/**
+ * @brief Context for scatter-gather processing.
+ */
+typedef struct tagCTRP_CONTEXT
+{
+    const BLOCK_CIPHER* cipher;      /**< Cipher interface */
+    const KEY* key;                  /**< Key schedule for encryption */
+    const unsigned char* iv;         /**< Initialization vector */
+    unsigned long long block_offset; /**< Number of the next block */
+} CTRP_CONTEXT;
+
+
+/**
+ * @brief Streaming state (stored in CTR_CONTEXT).
+ */
+typedef struct tagCTRP_STREAM
+{
+    const BLOCK_CIPHER* cipher;                             /**< Cipher interface */
+    const KEY* key;                                         /**< Key schedule for encryption */
+    unsigned char iv[CTR_IV_SIZE];                          /**< Initialization vector */
+    unsigned long long block_offset;                        /**< Number of the next block */
+    BCLIB_ALIGN16 unsigned char keystream[CTRP_BLOCK_SIZE]; /**< Keystream of the current block */
+    size_t keystream_used;                                  /**< Used bytes of keystream */
+} CTRP_STREAM;
+
+
+//
+// Check if context can hold streaming state
+//
+
+BCLIB_STATIC_ASSERT(sizeof(CTRP_STREAM) <= CTR_CONTEXT_SIZE, ctr_context_size_is_less_than_necessary);
+
+
+static void ctrp_process_contiguous(void* context, const unsigned char* in, unsigned char* out, size_t length)
+{
+    CTRP_CONTEXT* ctr_context = (CTRP_CONTEXT*)context;
+
+    ctr_encrypt(ctr_context->cipher, ctr_context->key, ctr_context->iv, ctr_context->block_offset, in, out, length);
+    ctr_context->block_offset += length / CTRP_BLOCK_SIZE;
+}
+
+
+void ctr_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                 unsigned long long block_offset, const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 __m128i keystream[CTRP_BATCH];
+
+    unsigned long long counter_high = BCLIB_BSWAP64(*(const unsigned long long*)iv);
+    unsigned long long counter_low  = block_offset;
+
+    size_t blocks_count;
+    size_t idx;
+
+    const unsigned char* tail;
+
+    while (length)
+    {
+        blocks_count = (length + CTRP_BLOCK_SIZE - 1) / CTRP_BLOCK_SIZE;
+        blocks_count = blocks_count < CTRP_BATCH ? blocks_count : CTRP_BATCH;
+
+        //
+        // Chapter 5.2.2 of GOST 34.13-2018
+        // Counters are big-endian 128-bit integers: IV || 0 + i
+        //
+
+        for (idx = 0; idx < blocks_count; ++idx)
+        {
+            keystream[idx] = _mm_set_epi64x((long long)BCLIB_BSWAP64(counter_low), (long long)BCLIB_BSWAP64(counter_high));
+
+            if (!++counter_low)
+            {
+                ++counter_high;
+            }
+        }
+
+        cipher->encrypt_blocks(keystream, key, keystream, blocks_count);
+
+        //
+        // Whole blocks are xored as vectors, the last (incomplete) 
+        // block of the message is processed byte by byte
+        //
+
+        for (idx = 0; idx < blocks_count && length >= CTRP_BLOCK_SIZE; ++idx)
+        {
+            _mm_storeu_si128((__m128i*)out, _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), keystream[idx]));
+
+            in += CTRP_BLOCK_SIZE;
+            out += CTRP_BLOCK_SIZE;
+            length -= CTRP_BLOCK_SIZE;
+        }
+
+        if (idx < blocks_count)
+        {
+            tail = (const unsigned char*)&keystream[idx];
+
+            for (idx = 0; idx < length; ++idx)
+            {
+                out[idx] = in[idx] ^ tail[idx];
+            }
+
+            length = 0;
+        }
+    }
+}
+
+
+void ctr_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+                 unsigned long long block_offset, const unsigned char* in, unsigned char* out, size_t length)
+{
+    ctr_encrypt(cipher, key, iv, block_offset, in, out, length);
+}
+
+
+int ctr_encrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, unsigned long long block_offset,
+                    const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count, size_t length)
+{
+    CTRP_CONTEXT context = { cipher, key, iv, block_offset };
+    return iov_process(in, in_count, out, out_count, CTRP_BLOCK_SIZE, length, ctrp_process_contiguous, &context);
+}
+
+
+int ctr_decrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv, unsigned long long block_offset,
+                    const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count, size_t length)
+{
+    return ctr_encrypt_iov(cipher, key, iv, block_offset, in, in_count, out, out_count, length);
+}
+
+
+void ctr_init(CTR_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* iv,
+              unsigned long long block_offset)
+{
+    CTRP_STREAM* stream = (CTRP_STREAM*)context->context;
+
+    stream->cipher         = cipher;
+    stream->key            = key;
+    stream->block_offset   = block_offset;
+    stream->keystream_used = CTRP_BLOCK_SIZE;
+
+    memcpy(stream->iv, iv, CTR_IV_SIZE);
+}
+
+
+void ctr_update(CTR_CONTEXT* context, const unsigned char* in, unsigned char* out, size_t length)
+{
+    CTRP_STREAM* stream = (CTRP_STREAM*)context->context;
+    size_t whole_length;
+
+    //
+    // Rest of keystream of the current block is used first
+    //
+
+    for (; length && stream->keystream_used < CTRP_BLOCK_SIZE; --length)
+    {
+        *out++ = *in++ ^ stream->keystream[stream->keystream_used++];
+    }
+
+    whole_length = length - length % CTRP_BLOCK_SIZE;
+
+    if (whole_length)
+    {
+        ctr_encrypt(stream->cipher, stream->key, stream->iv, stream->block_offset, in, out, whole_length);
+
+        stream->block_offset += whole_length / CTRP_BLOCK_SIZE;
+
+        in += whole_length;
+        out += whole_length;
+        length -= whole_length;
+    }
+
+    if (length)
+    {
+        //
+        // Keystream of an incomplete block is kept for the next chunk
+        //
+
+        memset(stream->keystream, 0, CTRP_BLOCK_SIZE);
+        ctr_encrypt(stream->cipher, stream->key, stream->iv, stream->block_offset++, stream->keystream, stream->keystream, CTRP_BLOCK_SIZE);
+
+        for (stream->keystream_used = 0; stream->keystream_used < length; ++stream->keystream_used)
+        {
+            out[stream->keystream_used] = in[stream->keystream_used] ^ stream->keystream[stream->keystream_used];
+        }
+    }
+}
+
+
+void ctr_final(CTR_CONTEXT* context)
+{
+    memset(context, 0, sizeof(CTR_CONTEXT));
+}
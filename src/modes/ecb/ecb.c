@@ -0,0 +1,97 @@
+/**
+ * @file ecb.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief ECB mode of operation (GOST 34.13-2018) over byte buffers
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/ecb/ecb.h"
+#include "common/utils.h"
+
+#include "iov_internal.h"
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define ECBP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Context for scatter-gather processing.
+ */
+typedef struct tagECBP_CONTEXT
+{
+    const BLOCK_CIPHER* cipher; /**< Cipher interface */
+    const KEY* key;             /**< Key schedule */
+    int decrypt;                /**< Nonzero for decryption */
+} ECBP_CONTEXT;
+
+
+static void ecbp_process(const BLOCK_CIPHER* cipher, const KEY* key, int decrypt,
+                         const unsigned char* in, unsigned char* out, size_t length)
+{
+    const size_t blocks_count = length / ECBP_BLOCK_SIZE;
+    __m128i block;
+
+    if (blocks_count == 1)
+    {
+        //
+        // Single block procedures take the block by value 
+        // and store it to an aligned location
+        //
+
+        decrypt ? cipher->decrypt_block(_mm_loadu_si128((const __m128i*)in), key, &block)
+                : cipher->encrypt_block(_mm_loadu_si128((const __m128i*)in), key, &block);
+
+        _mm_storeu_si128((__m128i*)out, block);
+        return;
+    }
+
+    //
+    // Multi-block procedures accept unaligned and overlapping (equal) buffers
+    //
+
+    decrypt ? cipher->decrypt_blocks((const __m128i*)in, key, (__m128i*)out, blocks_count)
+            : cipher->encrypt_blocks((const __m128i*)in, key, (__m128i*)out, blocks_count);
+}
+
+
+static void ecbp_process_contiguous(void* context, const unsigned char* in, unsigned char* out, size_t length)
+{
+    const ECBP_CONTEXT* ecb_context = (const ECBP_CONTEXT*)context;
+    ecbp_process(ecb_context->cipher, ecb_context->key, ecb_context->decrypt, in, out, length);
+}
+
+
+void ecb_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* in, unsigned char* out, size_t length)
+{
+    ecbp_process(cipher, key, 0, in, out, length);
+}
+
+
+void ecb_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* in, unsigned char* out, size_t length)
+{
+    ecbp_process(cipher, key, 1, in, out, length);
+}
+
+
+int ecb_encrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const IOVEC* in, size_t in_count,
+                    const IOVEC* out, size_t out_count, size_t length)
+{
+    ECBP_CONTEXT context = { cipher, key, 0 };
+    return iov_process(in, in_count, out, out_count, ECBP_BLOCK_SIZE, length, ecbp_process_contiguous, &context);
+}
+
+
+int ecb_decrypt_iov(const BLOCK_CIPHER* cipher, const KEY* key, const IOVEC* in, size_t in_count,
+                    const IOVEC* out, size_t out_count, size_t length)
+{
+    ECBP_CONTEXT context = { cipher, key, 1 };
+    return iov_process(in, in_count, out, out_count, ECBP_BLOCK_SIZE, length, ecbp_process_contiguous, &context);
+}
@@ -0,0 +1,617 @@
+/**
+ * @file mgm.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief MGM authenticated encryption mode (RFC 9058)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/mgm/mgm.h"
+#include "common/utils.h"
+
+#include <string.h>
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define MGMP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Number of blocks of each counter chain encrypted at once.
+ */
+#define MGMP_BATCH 16
+
+
+/**
+ * @brief Authentication state: counters and unreduced sum of products.
+ */
+typedef struct tagMGMP_STATE
+{
+    const BLOCK_CIPHER* cipher;     /**< Cipher interface */
+    const KEY* key;                 /**< Key schedule for encryption */
+    unsigned long long y_high;      /**< Left half of encryption counter */
+    unsigned long long y_low;       /**< Right half of encryption counter */
+    unsigned long long z_high;      /**< Left half of authentication counter */
+    unsigned long long z_low;       /**< Right half of authentication counter */
+    __m128i sum_low;                /**< Bits 0..127 of sum */
+    __m128i sum_middle;             /**< Bits 64..191 of sum */
+    __m128i sum_high;               /**< Bits 128..255 of sum */
+} MGMP_STATE;
+
+
+/**
+ * @brief Streaming state (stored in MGM_CONTEXT).
+ */
+typedef struct tagMGMP_STREAM
+{
+    MGMP_STATE state;                                   /**< Authentication state */
+    __m128i keystream;                                  /**< Keystream of the current block */
+    __m128i h;                                          /**< H_i of the current block */
+    BCLIB_ALIGN16 unsigned char block[MGMP_BLOCK_SIZE]; /**< Incomplete block of associated data or ciphertext */
+    size_t buffered;                                    /**< Length of incomplete block */
+    size_t aad_length;                                  /**< Total length of associated data */
+    size_t length;                                      /**< Total length of message */
+    int decrypt;                                        /**< Non-zero for decryption */
+    int aad_finished;                                   /**< Non-zero when message processing is started */
+} MGMP_STREAM;
+
+
+//
+// Check if context can hold streaming state
+//
+
+BCLIB_STATIC_ASSERT(sizeof(MGMP_STREAM) <= MGM_CONTEXT_SIZE, mgm_context_size_is_less_than_necessary);
+
+
+/**
+ * @brief Conversion of a block between byte order of GOST (most significant
+ *        byte first) and a little-endian 128-bit integer.
+ */
+#define MGMP_BSWAP(block) \
+    _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15))
+
+
+/**
+ * @brief Counter block from its halves (in GOST byte order).
+ */
+#define MGMP_COUNTER(high, low) \
+    _mm_set_epi64x((long long)BCLIB_BSWAP64(low), (long long)BCLIB_BSWAP64(high))
+
+
+/**
+ * @brief Adds a product of h and data (both are integers) to the sum. 
+ *        Reduction is postponed until the end of a message.
+ */
+BCLIB_FORCEINLINE static void mgmp_multiply_accumulate(MGMP_STATE* state, __m128i h, __m128i data)
+{
+    state->sum_low    = _mm_xor_si128(state->sum_low, _mm_clmulepi64_si128(h, data, 0x00));
+    state->sum_high   = _mm_xor_si128(state->sum_high, _mm_clmulepi64_si128(h, data, 0x11));
+    state->sum_middle = _mm_xor_si128(state->sum_middle, _mm_clmulepi64_si128(h, data, 0x01));
+    state->sum_middle = _mm_xor_si128(state->sum_middle, _mm_clmulepi64_si128(h, data, 0x10));
+}
+
+
+/**
+ * @brief Reduces the sum modulo x^128 + x^7 + x^2 + x + 1.
+ */
+static __m128i mgmp_reduce(const MGMP_STATE* state)
+{
+    const __m128i polynomial = _mm_set_epi64x(0, 0x87);
+
+    const __m128i low  = _mm_xor_si128(state->sum_low, _mm_slli_si128(state->sum_middle, 8));
+    const __m128i high = _mm_xor_si128(state->sum_high, _mm_srli_si128(state->sum_middle, 8));
+
+    //
+    // x^128 = x^7 + x^2 + x + 1, hence high * x^128 = high * 0x87.
+    // Product of the upper half of high is 71 bits long, its bits 
+    // above 128 are folded once again
+    //
+
+    const __m128i folded_high = _mm_clmulepi64_si128(high, polynomial, 0x01);
+    const __m128i folded_low  = _mm_clmulepi64_si128(high, polynomial, 0x00);
+
+    return _mm_xor_si128(_mm_xor_si128(low, folded_low),
+                         _mm_xor_si128(_mm_slli_si128(folded_high, 8),
+                                       _mm_clmulepi64_si128(_mm_srli_si128(folded_high, 8), polynomial, 0x00)));
+}
+
+
+/**
+ * @brief Generates initial counters Y_1 = E(0 || nonce) and Z_1 = E(1 || nonce).
+ */
+static void mgmp_initialize(MGMP_STATE* state, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce)
+{
+    BCLIB_ALIGN16 unsigned char counters[2 * MGMP_BLOCK_SIZE];
+
+    memcpy(counters, nonce, MGMP_BLOCK_SIZE);
+    memcpy(counters + MGMP_BLOCK_SIZE, nonce, MGMP_BLOCK_SIZE);
+
+    counters[0] &= 0x7f;
+    counters[MGMP_BLOCK_SIZE] |= 0x80;
+
+    cipher->encrypt_blocks((const __m128i*)counters, key, (__m128i*)counters, 2);
+
+    state->cipher     = cipher;
+    state->key        = key;
+    state->y_high     = BCLIB_BSWAP64(*(const unsigned long long*)counters);
+    state->y_low      = BCLIB_BSWAP64(*(const unsigned long long*)(counters + 8));
+    state->z_high     = BCLIB_BSWAP64(*(const unsigned long long*)(counters + MGMP_BLOCK_SIZE));
+    state->z_low      = BCLIB_BSWAP64(*(const unsigned long long*)(counters + MGMP_BLOCK_SIZE + 8));
+    state->sum_low    = _mm_setzero_si128();
+    state->sum_middle = _mm_setzero_si128();
+    state->sum_high   = _mm_setzero_si128();
+
+    memset(counters, 0, sizeof(counters));
+}
+
+
+/**
+ * @brief Generates next authentication counters (incr_l), they are encrypted by caller.
+ */
+BCLIB_FORCEINLINE static void mgmp_next_z(MGMP_STATE* state, __m128i* blocks, size_t blocks_count)
+{
+    size_t idx;
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        blocks[idx] = MGMP_COUNTER(state->z_high++, state->z_low);
+    }
+}
+
+
+/**
+ * @brief Generates next encryption counters (incr_r), they are encrypted by caller.
+ */
+BCLIB_FORCEINLINE static void mgmp_next_y(MGMP_STATE* state, __m128i* blocks, size_t blocks_count)
+{
+    size_t idx;
+
+    for (idx = 0; idx < blocks_count; ++idx)
+    {
+        blocks[idx] = MGMP_COUNTER(state->y_high, state->y_low++);
+    }
+}
+
+
+/**
+ * @brief Loads the last incomplete block padded with zeros.
+ */
+BCLIB_FORCEINLINE static __m128i mgmp_load_partial(const unsigned char* data, size_t length)
+{
+    BCLIB_ALIGN16 unsigned char block[MGMP_BLOCK_SIZE] = { 0 };
+
+    memcpy(block, data, length);
+    return _mm_load_si128((const __m128i*)block);
+}
+
+
+/**
+ * @brief Authenticates associated data.
+ */
+static void mgmp_authenticate_aad(MGMP_STATE* state, const unsigned char* aad, size_t aad_length)
+{
+    BCLIB_ALIGN16 __m128i h[MGMP_BATCH];
+
+    size_t blocks_count;
+    size_t idx;
+
+    while (aad_length)
+    {
+        blocks_count = (aad_length + MGMP_BLOCK_SIZE - 1) / MGMP_BLOCK_SIZE;
+        blocks_count = blocks_count < MGMP_BATCH ? blocks_count : MGMP_BATCH;
+
+        mgmp_next_z(state, h, blocks_count);
+        state->cipher->encrypt_blocks(h, state->key, h, blocks_count);
+
+        for (idx = 0; idx < blocks_count && aad_length >= MGMP_BLOCK_SIZE; ++idx)
+        {
+            mgmp_multiply_accumulate(state, MGMP_BSWAP(h[idx]), MGMP_BSWAP(_mm_loadu_si128((const __m128i*)aad)));
+
+            aad += MGMP_BLOCK_SIZE;
+            aad_length -= MGMP_BLOCK_SIZE;
+        }
+
+        if (idx < blocks_count)
+        {
+            mgmp_multiply_accumulate(state, MGMP_BSWAP(h[idx]), MGMP_BSWAP(mgmp_load_partial(aad, aad_length)));
+            aad_length = 0;
+        }
+    }
+}
+
+
+/**
+ * @brief Encrypts or decrypts data and authenticates ciphertext.
+ */
+static void mgmp_process(MGMP_STATE* state, int decrypt, const unsigned char* in, unsigned char* out, size_t length)
+{
+    BCLIB_ALIGN16 __m128i blocks[2 * MGMP_BATCH];
+    BCLIB_ALIGN16 unsigned char tail[MGMP_BLOCK_SIZE];
+
+    size_t blocks_count;
+    size_t idx;
+
+    __m128i* h;
+    __m128i data;
+    __m128i ciphertext;
+
+    while (length)
+    {
+        blocks_count = (length + MGMP_BLOCK_SIZE - 1) / MGMP_BLOCK_SIZE;
+        blocks_count = blocks_count < MGMP_BATCH ? blocks_count : MGMP_BATCH;
+
+        //
+        // Both counter chains are encrypted with a single call:
+        // keystream is followed by H_i
+        //
+
+        h = blocks + blocks_count;
+
+        mgmp_next_y(state, blocks, blocks_count);
+        mgmp_next_z(state, h, blocks_count);
+
+        state->cipher->encrypt_blocks(blocks, state->key, blocks, 2 * blocks_count);
+
+        for (idx = 0; idx < blocks_count && length >= MGMP_BLOCK_SIZE; ++idx)
+        {
+            data = _mm_loadu_si128((const __m128i*)in);
+            _mm_storeu_si128((__m128i*)out, _mm_xor_si128(data, blocks[idx]));
+
+            ciphertext = decrypt ? data : _mm_xor_si128(data, blocks[idx]);
+            mgmp_multiply_accumulate(state, MGMP_BSWAP(h[idx]), MGMP_BSWAP(ciphertext));
+
+            in += MGMP_BLOCK_SIZE;
+            out += MGMP_BLOCK_SIZE;
+            length -= MGMP_BLOCK_SIZE;
+        }
+
+        if (idx < blocks_count)
+        {
+            //
+            // The last incomplete block: keystream is truncated,
+            // ciphertext is padded with zeros for authentication
+            //
+
+            data = mgmp_load_partial(in, length);
+
+            _mm_store_si128((__m128i*)tail, _mm_xor_si128(data, blocks[idx]));
+            memset(tail + length, 0, MGMP_BLOCK_SIZE - length);
+            memcpy(out, tail, length);
+
+            ciphertext = decrypt ? data : _mm_load_si128((const __m128i*)tail);
+            mgmp_multiply_accumulate(state, MGMP_BSWAP(h[idx]), MGMP_BSWAP(ciphertext));
+
+            length = 0;
+        }
+    }
+
+    memset(blocks, 0, sizeof(blocks));
+    memset(tail, 0, sizeof(tail));
+}
+
+
+/**
+ * @brief Authenticates lengths and computes the tag.
+ */
+static void mgmp_finalize(MGMP_STATE* state, size_t aad_length, size_t length, unsigned char* tag, size_t tag_size)
+{
+    BCLIB_ALIGN16 __m128i block;
+
+    //
+    // len(A) || len(C) in bits
+    //
+
+    mgmp_next_z(state, &block, 1);
+    state->cipher->encrypt_blocks(&block, state->key, &block, 1);
+
+    mgmp_multiply_accumulate(state, MGMP_BSWAP(block), _mm_set_epi64x((long long)aad_length * 8, (long long)length * 8));
+
+    block = MGMP_BSWAP(mgmp_reduce(state));
+    state->cipher->encrypt_blocks(&block, state->key, &block, 1);
+
+    memcpy(tag, &block, tag_size);
+    memset(&block, 0, sizeof(block));
+}
+
+
+/**
+ * @brief Compares tags in constant time.
+ */
+static int mgmp_compare_tags(const unsigned char* expected_tag, const unsigned char* tag, size_t tag_size)
+{
+    unsigned char difference = 0;
+    size_t idx;
+
+    for (idx = 0; idx < tag_size; ++idx)
+    {
+        difference |= expected_tag[idx] ^ tag[idx];
+    }
+
+    return !difference;
+}
+
+
+/**
+ * @brief Authenticates the last incomplete block of associated data, 
+ *        if streaming of message has not started yet.
+ */
+static void mgmp_finish_aad(MGMP_STREAM* stream)
+{
+    if (stream->aad_finished)
+    {
+        return;
+    }
+
+    mgmp_authenticate_aad(&stream->state, stream->block, stream->buffered);
+
+    stream->buffered     = 0;
+    stream->aad_finished = 1;
+}
+
+
+/**
+ * @brief Initializes streaming state.
+ */
+static void mgmp_stream_initialize(MGM_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key,
+                                   const unsigned char* nonce, int decrypt)
+{
+    MGMP_STREAM* stream = (MGMP_STREAM*)context->context;
+
+    mgmp_initialize(&stream->state, cipher, key, nonce);
+
+    stream->buffered     = 0;
+    stream->aad_length   = 0;
+    stream->length       = 0;
+    stream->decrypt      = decrypt;
+    stream->aad_finished = 0;
+}
+
+
+/**
+ * @brief Checks tag size: empty tag would accept any message, longer
+ *        tags do not fit into a block.
+ */
+#define MGMP_VALID_TAG_SIZE(tag_size) ((tag_size) > 0 && (tag_size) <= MGM_MAX_TAG_SIZE)
+
+
+/**
+ * @brief Authenticates the last (zero padded) incomplete block of ciphertext 
+ *        and computes the tag.
+ */
+static void mgmp_stream_finalize(MGMP_STREAM* stream, unsigned char* tag, size_t tag_size)
+{
+    mgmp_finish_aad(stream);
+
+    if (stream->buffered)
+    {
+        memset(stream->block + stream->buffered, 0, MGMP_BLOCK_SIZE - stream->buffered);
+        mgmp_multiply_accumulate(&stream->state, MGMP_BSWAP(stream->h),
+                                 MGMP_BSWAP(_mm_load_si128((const __m128i*)stream->block)));
+    }
+
+    mgmp_finalize(&stream->state, stream->aad_length, stream->length, tag, tag_size);
+}
+
+
+int mgm_encrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce,
+                const unsigned char* aad, size_t aad_length, const unsigned char* in, unsigned char* out,
+                size_t length, unsigned char* tag, size_t tag_size)
+{
+    MGMP_STATE state;
+
+    if (!MGMP_VALID_TAG_SIZE(tag_size))
+    {
+        return 0;
+    }
+
+    mgmp_initialize(&state, cipher, key, nonce);
+    mgmp_authenticate_aad(&state, aad, aad_length);
+    mgmp_process(&state, 0, in, out, length);
+    mgmp_finalize(&state, aad_length, length, tag, tag_size);
+
+    return 1;
+}
+
+
+int mgm_decrypt(const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce,
+                const unsigned char* aad, size_t aad_length, const unsigned char* in, unsigned char* out,
+                size_t length, const unsigned char* tag, size_t tag_size)
+{
+    unsigned char expected_tag[MGM_MAX_TAG_SIZE];
+
+    MGMP_STATE state;
+    int valid;
+
+    if (!MGMP_VALID_TAG_SIZE(tag_size))
+    {
+        return 0;
+    }
+
+    mgmp_initialize(&state, cipher, key, nonce);
+    mgmp_authenticate_aad(&state, aad, aad_length);
+    mgmp_process(&state, 1, in, out, length);
+    mgmp_finalize(&state, aad_length, length, expected_tag, tag_size);
+
+    valid = mgmp_compare_tags(expected_tag, tag, tag_size);
+
+    if (!valid)
+    {
+        memset(out, 0, length);
+    }
+
+    memset(expected_tag, 0, sizeof(expected_tag));
+
+    return valid;
+}
+
+
+void mgm_encrypt_init(MGM_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce)
+{
+    mgmp_stream_initialize(context, cipher, key, nonce, 0);
+}
+
+
+void mgm_decrypt_init(MGM_CONTEXT* context, const BLOCK_CIPHER* cipher, const KEY* key, const unsigned char* nonce)
+{
+    mgmp_stream_initialize(context, cipher, key, nonce, 1);
+}
+
+
+void mgm_update_aad(MGM_CONTEXT* context, const unsigned char* aad, size_t aad_length)
+{
+    MGMP_STREAM* stream = (MGMP_STREAM*)context->context;
+    size_t fill;
+    size_t whole_length;
+
+    stream->aad_length += aad_length;
+
+    if (stream->buffered)
+    {
+        fill = MGMP_BLOCK_SIZE - stream->buffered;
+        fill = fill < aad_length ? fill : aad_length;
+
+        memcpy(stream->block + stream->buffered, aad, fill);
+
+        stream->buffered += fill;
+        aad += fill;
+        aad_length -= fill;
+
+        if (stream->buffered < MGMP_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        mgmp_authenticate_aad(&stream->state, stream->block, MGMP_BLOCK_SIZE);
+        stream->buffered = 0;
+    }
+
+    whole_length = aad_length - aad_length % MGMP_BLOCK_SIZE;
+    mgmp_authenticate_aad(&stream->state, aad, whole_length);
+
+    //
+    // Incomplete block is kept, because it is padded only if it is the last one
+    //
+
+    memcpy(stream->block, aad + whole_length, aad_length - whole_length);
+    stream->buffered = aad_length - whole_length;
+}
+
+
+void mgm_update(MGM_CONTEXT* context, const unsigned char* in, unsigned char* out, size_t length)
+{
+    MGMP_STREAM* stream = (MGMP_STREAM*)context->context;
+    BCLIB_ALIGN16 __m128i blocks[2];
+    BCLIB_ALIGN16 unsigned char keystream[MGMP_BLOCK_SIZE];
+
+    size_t whole_length;
+    unsigned char data;
+
+    mgmp_finish_aad(stream);
+
+    stream->length += length;
+
+    if (stream->buffered)
+    {
+        _mm_store_si128((__m128i*)keystream, stream->keystream);
+
+        for (; length && stream->buffered < MGMP_BLOCK_SIZE; --length)
+        {
+            data   = *in++;
+            *out++ = data ^ keystream[stream->buffered];
+
+            stream->block[stream->buffered] = stream->decrypt ? data : data ^ keystream[stream->buffered];
+            ++stream->buffered;
+        }
+
+        if (stream->buffered < MGMP_BLOCK_SIZE)
+        {
+            memset(keystream, 0, sizeof(keystream));
+            return;
+        }
+
+        mgmp_multiply_accumulate(&stream->state, MGMP_BSWAP(stream->h),
+                                 MGMP_BSWAP(_mm_load_si128((const __m128i*)stream->block)));
+        stream->buffered = 0;
+    }
+
+    whole_length = length - length % MGMP_BLOCK_SIZE;
+
+    if (whole_length)
+    {
+        mgmp_process(&stream->state, stream->decrypt, in, out, whole_length);
+
+        in += whole_length;
+        out += whole_length;
+        length -= whole_length;
+    }
+
+    if (length)
+    {
+        //
+        // Keystream and H_i of an incomplete block are kept for the next chunk
+        //
+
+        mgmp_next_y(&stream->state, blocks, 1);
+        mgmp_next_z(&stream->state, blocks + 1, 1);
+
+        stream->state.cipher->encrypt_blocks(blocks, stream->state.key, blocks, 2);
+
+        stream->keystream = blocks[0];
+        stream->h         = blocks[1];
+
+        _mm_store_si128((__m128i*)keystream, stream->keystream);
+
+        for (; stream->buffered < length; ++stream->buffered)
+        {
+            data                  = in[stream->buffered];
+            out[stream->buffered] = data ^ keystream[stream->buffered];
+
+            stream->block[stream->buffered] = stream->decrypt ? data : data ^ keystream[stream->buffered];
+        }
+
+        memset(blocks, 0, sizeof(blocks));
+    }
+
+    memset(keystream, 0, sizeof(keystream));
+}
+
+
+int mgm_encrypt_final(MGM_CONTEXT* context, unsigned char* tag, size_t tag_size)
+{
+    const int valid = MGMP_VALID_TAG_SIZE(tag_size);
+
+    if (valid)
+    {
+        mgmp_stream_finalize((MGMP_STREAM*)context->context, tag, tag_size);
+    }
+
+    memset(context, 0, sizeof(MGM_CONTEXT));
+
+    return valid;
+}
+
+
+int mgm_decrypt_final(MGM_CONTEXT* context, const unsigned char* tag, size_t tag_size)
+{
+    unsigned char expected_tag[MGM_MAX_TAG_SIZE];
+    int valid = 0;
+
+    if (MGMP_VALID_TAG_SIZE(tag_size))
+    {
+        mgmp_stream_finalize((MGMP_STREAM*)context->context, expected_tag, tag_size);
+        valid = mgmp_compare_tags(expected_tag, tag, tag_size);
+    }
+
+    memset(context, 0, sizeof(MGM_CONTEXT));
+    memset(expected_tag, 0, sizeof(expected_tag));
+
+    return valid;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file xts.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief XTS mode of operation (IEEE 1619) for sector encryption
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "modes/xts/xts.h"
+#include "common/utils.h"
+
+#include "iov_internal.h"
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define XTSP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Maximal number of blocks in a sector.
+ */
+#define XTSP_MAX_SECTOR_BLOCKS (XTS_MAX_SECTOR_SIZE / XTSP_BLOCK_SIZE)
+
+
+/**
+ * @brief Checks that a sector consists of whole blocks and fits tweaks buffer.
+ */
+#define XTSP_VALID_SECTOR_SIZE(sector_size) \
+    ((sector_size) && !((sector_size) % XTSP_BLOCK_SIZE) && (sector_size) <= XTS_MAX_SECTOR_SIZE)
+
+
+/**
+ * @brief Number of initial tweaks encrypted at once.
+ */
+#define XTSP_TWEAKS_BATCH 16
+
+
+/**
+ * @brief Blocks processing procedure (encrypt_blocks or decrypt_blocks of a cipher).
+ */
+typedef void (*XTSP_PROCESS_BLOCKS)(const __m128i* in, const KEY* round_keys, __m128i* out, size_t blocks_count);
+
+
+/**
+ * @brief Context for scatter-gather processing.
+ */
+typedef struct tagXTSP_CONTEXT
+{
+    const BLOCK_CIPHER* cipher;         /**< Cipher interface */
+    XTSP_PROCESS_BLOCKS process_blocks; /**< Blocks processing procedure */
+    const KEY* data_key;                /**< Key schedule for data */
+    const KEY* tweak_key;               /**< Key schedule for tweaks */
+    unsigned long long sector_number;   /**< Number of the next sector */
+    size_t sector_size;                 /**< Sector size in bytes */
+} XTSP_CONTEXT;
+
+
+/**
+ * @brief Multiplication of a tweak by primitive element in GF(2^128) modulo
+ *        x^128 + x^7 + x^2 + x + 1. Both 64-bit halves are shifted at once,
+ *        carry from the low half and reduction of the high bit are obtained
+ *        from sign bits of 32-bit lanes.
+ */
+#define XTSP_MULTIPLY_ALPHA(t, mask)                                                        \
+    t = _mm_xor_si128(_mm_add_epi64(t, t),                                                 \
+                      _mm_and_si128(_mm_shuffle_epi32(_mm_srai_epi32(t, 31), 0x13), mask))
+
+
+/**
+ * @brief Computes all tweaks of a sector from the encrypted initial one.
+ */
+BCLIB_FORCEINLINE static void xtsp_compute_tweaks(__m128i tweak, __m128i* tweaks, size_t blocks_count)
+{
+    const __m128i mask = _mm_set_epi32(0, 1, 0, 0x87);
+    size_t idx;
+
+    tweaks[0] = tweak;
+
+    for (idx = 1; idx < blocks_count; ++idx)
+    {
+        XTSP_MULTIPLY_ALPHA(tweak, mask);
+        tweaks[idx] = tweak;
+    }
+}
+
+
+/**
+ * @brief Processes sectors. Initial tweaks are either sector numbers (plain64)
+ *        or IVs supplied by caller (if `ivs` is not NULL).
+ */
+static void xtsp_process_sectors(const BLOCK_CIPHER* cipher, XTSP_PROCESS_BLOCKS process_blocks,
+                                 const KEY* data_key, const KEY* tweak_key,
+                                 unsigned long long sector_number, const unsigned char* ivs,
+                                 size_t sector_size, size_t sectors_count,
+                                 const unsigned char* in, unsigned char* out)
+{
+    BCLIB_ALIGN16 __m128i initial_tweaks[XTSP_TWEAKS_BATCH];
+    BCLIB_ALIGN16 __m128i tweaks[XTSP_MAX_SECTOR_BLOCKS];
+
+    const size_t sector_blocks = sector_size / XTSP_BLOCK_SIZE;
+    const __m128i* in_blocks   = (const __m128i*)in;
+    __m128i* out_blocks        = (__m128i*)out;
+
+    size_t batch;
+    size_t idx;
+    size_t block;
+
+    while (sectors_count)
+    {
+        batch = sectors_count < XTSP_TWEAKS_BATCH ? sectors_count : XTSP_TWEAKS_BATCH;
+
+        //
+        // Encrypt initial tweaks of several sectors at once
+        //
+
+        for (idx = 0; idx < batch; ++idx)
+        {
+            initial_tweaks[idx] = ivs ? _mm_loadu_si128((const __m128i*)ivs + idx)
+                                      : _mm_set_epi64x(0, (long long)(sector_number + idx));
+        }
+
+        cipher->encrypt_blocks(initial_tweaks, tweak_key, initial_tweaks, batch);
+
+        for (idx = 0; idx < batch; ++idx)
+        {
+            //
+            // C = E(P ^ T) ^ T, all tweaks are computed ahead and 
+            // all blocks of a sector are processed with a single call
+            //
+
+            xtsp_compute_tweaks(initial_tweaks[idx], tweaks, sector_blocks);
+
+            for (block = 0; block < sector_blocks; ++block)
+            {
+                _mm_storeu_si128(out_blocks + block, _mm_xor_si128(_mm_loadu_si128(in_blocks + block), tweaks[block]));
+            }
+
+            process_blocks(out_blocks, data_key, out_blocks, sector_blocks);
+
+            for (block = 0; block < sector_blocks; ++block)
+            {
+                _mm_storeu_si128(out_blocks + block, _mm_xor_si128(_mm_loadu_si128(out_blocks + block), tweaks[block]));
+            }
+
+            in_blocks += sector_blocks;
+            out_blocks += sector_blocks;
+        }
+
+        sector_number += batch;
+        sectors_count -= batch;
+
+        if (ivs)
+        {
+            ivs += batch * XTSP_BLOCK_SIZE;
+        }
+    }
+}
+
+
+int xts_encrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                        unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                        const unsigned char* in, unsigned char* out)
+{
+    if (!XTSP_VALID_SECTOR_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    xtsp_process_sectors(cipher, cipher->encrypt_blocks, data_key, tweak_key,
+                         sector_number, NULL, sector_size, sectors_count, in, out);
+
+    return 1;
+}
+
+
+int xts_decrypt_sectors(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                        unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                        const unsigned char* in, unsigned char* out)
+{
+    if (!XTSP_VALID_SECTOR_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    xtsp_process_sectors(cipher, cipher->decrypt_blocks, data_key, tweak_key,
+                         sector_number, NULL, sector_size, sectors_count, in, out);
+
+    return 1;
+}
+
+
+int xts_encrypt_sectors_ivs(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            const unsigned char* ivs, size_t sector_size, size_t sectors_count,
+                            const unsigned char* in, unsigned char* out)
+{
+    if (!XTSP_VALID_SECTOR_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    xtsp_process_sectors(cipher, cipher->encrypt_blocks, data_key, tweak_key,
+                         0, ivs, sector_size, sectors_count, in, out);
+
+    return 1;
+}
+
+
+int xts_decrypt_sectors_ivs(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            const unsigned char* ivs, size_t sector_size, size_t sectors_count,
+                            const unsigned char* in, unsigned char* out)
+{
+    if (!XTSP_VALID_SECTOR_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    xtsp_process_sectors(cipher, cipher->decrypt_blocks, data_key, tweak_key,
+                         0, ivs, sector_size, sectors_count, in, out);
+
+    return 1;
+}
+
+
+/**
+ * @brief Processes a contiguous run of whole sectors (callback of iov_process).
+ */
+static void xtsp_process_contiguous(void* context, const unsigned char* in, unsigned char* out, size_t length)
+{
+    XTSP_CONTEXT* xts_context = (XTSP_CONTEXT*)context;
+    const size_t sectors_count = length / xts_context->sector_size;
+
+    xtsp_process_sectors(xts_context->cipher, xts_context->process_blocks, xts_context->data_key, xts_context->tweak_key,
+                         xts_context->sector_number, NULL, xts_context->sector_size, sectors_count, in, out);
+
+    xts_context->sector_number += sectors_count;
+}
+
+
+int xts_encrypt_sectors_iov(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                            const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count)
+{
+    XTSP_CONTEXT context = { cipher, cipher->encrypt_blocks, data_key, tweak_key, sector_number, sector_size };
+
+    if (!XTSP_VALID_SECTOR_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    return iov_process(in, in_count, out, out_count, sector_size, sector_size * sectors_count, xtsp_process_contiguous, &context);
+}
+
+
+int xts_decrypt_sectors_iov(const BLOCK_CIPHER* cipher, const KEY* data_key, const KEY* tweak_key,
+                            unsigned long long sector_number, size_t sector_size, size_t sectors_count,
+                            const IOVEC* in, size_t in_count, const IOVEC* out, size_t out_count)
+{
+    XTSP_CONTEXT context = { cipher, cipher->decrypt_blocks, data_key, tweak_key, sector_number, sector_size };
+
+    if (!XTSP_VALID_SECTOR_SIZE(sector_size))
+    {
+        return 0;
+    }
+
+    return iov_process(in, in_count, out, out_count, sector_size, sector_size * sectors_count, xtsp_process_contiguous, &context);
+}
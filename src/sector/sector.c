@@ -0,0 +1,171 @@
+/**
+ * @file sector.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Sector-addressed encryption with dm-crypt compatible IV generators
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "sector/sector.h"
+#include "modes/xts/xts.h"
+#include "modes/cbc/cbc.h"
+#include "common/utils.h"
+
+#include <emmintrin.h>
+
+
+/**
+ * @brief Number of sectors, which IVs are generated at once.
+ */
+#define SECTORP_BATCH 64
+
+
+/**
+ * @brief Block size of underlying cipher in bytes.
+ */
+#define SECTORP_BLOCK_SIZE 16
+
+
+/**
+ * @brief Checks sector size of a context: sectors must consist of whole blocks
+ *        (of whole IV units, if IVs are numbered in units) and fit XTS tweaks buffer.
+ */
+#define SECTORP_VALID_SECTOR_SIZE(context)                                                                  \
+    ((context)->sector_size && (context)->sector_size <= XTS_MAX_SECTOR_SIZE &&                             \
+     !((context)->sector_size % ((context)->large_iv_sectors ? SECTORP_BLOCK_SIZE : SECTOR_IV_UNIT_SIZE)))
+
+
+/**
+ * @brief Converts sector number to IV sector number.
+ */
+BCLIB_FORCEINLINE static unsigned long long sectorp_iv_sector(const SECTOR_CONTEXT* context, unsigned long long sector)
+{
+    return context->large_iv_sectors ? sector : sector * (context->sector_size / SECTOR_IV_UNIT_SIZE);
+}
+
+
+void sector_generate_ivs(const SECTOR_CONTEXT* context, unsigned long long sector, size_t sectors_count, unsigned char* ivs)
+{
+    __m128i* iv_blocks = (__m128i*)ivs;
+
+    //
+    // As in dm-crypt, benbi converts IV sector number to a number of 
+    // block by multiplying it by 512 / block size
+    //
+
+    const unsigned long long iv_step          = context->large_iv_sectors ? 1 : context->sector_size / SECTOR_IV_UNIT_SIZE;
+    const unsigned long long benbi_multiplier = SECTOR_IV_UNIT_SIZE / SECTORP_BLOCK_SIZE;
+
+    unsigned long long iv_sector = sectorp_iv_sector(context, sector);
+    size_t idx;
+
+    switch (context->iv)
+    {
+    case SECTOR_IV_PLAIN64BE:
+        for (idx = 0; idx < sectors_count; ++idx, iv_sector += iv_step)
+        {
+            _mm_storeu_si128(iv_blocks + idx, _mm_set_epi64x((long long)BCLIB_BSWAP64(iv_sector), 0));
+        }
+        break;
+
+    case SECTOR_IV_BENBI:
+        for (idx = 0; idx < sectors_count; ++idx, iv_sector += iv_step)
+        {
+            _mm_storeu_si128(iv_blocks + idx, _mm_set_epi64x((long long)BCLIB_BSWAP64(iv_sector * benbi_multiplier + 1), 0));
+        }
+        break;
+
+    default:
+        for (idx = 0; idx < sectors_count; ++idx, iv_sector += iv_step)
+        {
+            _mm_storeu_si128(iv_blocks + idx, _mm_set_epi64x(0, (long long)iv_sector));
+        }
+        break;
+    }
+
+    if (context->iv == SECTOR_IV_ESSIV)
+    {
+        context->cipher->encrypt_blocks(iv_blocks, context->essiv_key, iv_blocks, sectors_count);
+    }
+}
+
+
+static void sectorp_process(const SECTOR_CONTEXT* context, int decrypt, unsigned long long sector, size_t sectors_count,
+                            const unsigned char* in, unsigned char* out)
+{
+    BCLIB_ALIGN16 unsigned char ivs[SECTORP_BATCH * SECTOR_IV_SIZE];
+
+    const size_t sector_size = context->sector_size;
+    size_t batch;
+
+    while (sectors_count)
+    {
+        batch = sectors_count < SECTORP_BATCH ? sectors_count : SECTORP_BATCH;
+
+        //
+        // IVs of a whole batch are generated ahead, then the batch
+        // is processed with a single mode call
+        //
+
+        if (context->mode == SECTOR_MODE_XTS && context->iv == SECTOR_IV_PLAIN64 &&
+            sectorp_iv_sector(context, 1) == 1)
+        {
+            //
+            // XTS computes plain64 tweaks itself, if IVs are numbered in sectors
+            //
+
+            decrypt ? xts_decrypt_sectors(context->cipher, context->decrypt_key, context->tweak_key, sector, sector_size, batch, in, out)
+                    : xts_encrypt_sectors(context->cipher, context->encrypt_key, context->tweak_key, sector, sector_size, batch, in, out);
+        }
+        else
+        {
+            sector_generate_ivs(context, sector, batch, ivs);
+
+            if (context->mode == SECTOR_MODE_XTS)
+            {
+                decrypt ? xts_decrypt_sectors_ivs(context->cipher, context->decrypt_key, context->tweak_key, ivs, sector_size, batch, in, out)
+                        : xts_encrypt_sectors_ivs(context->cipher, context->encrypt_key, context->tweak_key, ivs, sector_size, batch, in, out);
+            }
+            else
+            {
+                decrypt ? cbc_decrypt_sectors(context->cipher, context->decrypt_key, ivs, sector_size, batch, in, out)
+                        : cbc_encrypt_sectors(context->cipher, context->encrypt_key, ivs, sector_size, batch, in, out);
+            }
+        }
+
+        sector += batch;
+        sectors_count -= batch;
+        in += batch * sector_size;
+        out += batch * sector_size;
+    }
+}
+
+
+int sector_encrypt(const SECTOR_CONTEXT* context, unsigned long long sector, size_t sectors_count,
+                   const unsigned char* in, unsigned char* out)
+{
+    if (!SECTORP_VALID_SECTOR_SIZE(context))
+    {
+        return 0;
+    }
+
+    sectorp_process(context, 0, sector, sectors_count, in, out);
+
+    return 1;
+}
+
+
+int sector_decrypt(const SECTOR_CONTEXT* context, unsigned long long sector, size_t sectors_count,
+                   const unsigned char* in, unsigned char* out)
+{
+    if (!SECTORP_VALID_SECTOR_SIZE(context))
+    {
+        return 0;
+    }
+
+    sectorp_process(context, 1, sector, sectors_count, in, out);
+
+    return 1;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file aes.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for AES cipher
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <cstring>
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix C of FIPS 197
+//
+
+constexpr unsigned char raw_key[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+BCLIB_ALIGN16 constexpr unsigned char plaintext[] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+BCLIB_ALIGN16 constexpr unsigned char ciphertext128[] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+BCLIB_ALIGN16 constexpr unsigned char ciphertext256[] = {
+    0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf,
+    0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+};
+
+
+/**
+ * @brief Checks single block procedures against test vector.
+ */
+void CheckVector(size_t key_size, const unsigned char* expected)
+{
+    BLOCK_CIPHER cipher = {};
+    ASSERT_TRUE(aes_initialize_interface(&cipher, key_size));
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+
+    BCLIB_ALIGN16 unsigned char block[AES_BLOCK_SIZE] = {};
+
+    cipher.encrypt_block(*reinterpret_cast<const __m128i*>(plaintext), &encrypt_key, reinterpret_cast<__m128i*>(block));
+    EXPECT_PRED3(test::details::EqualBlocks, expected, block, AES_BLOCK_SIZE);
+
+    cipher.decrypt_block(*reinterpret_cast<const __m128i*>(block), &decrypt_key, reinterpret_cast<__m128i*>(block));
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, block, AES_BLOCK_SIZE);
+
+    //
+    // Separately initialized keys MUST be the same
+    //
+
+    KEY separate_key = {};
+
+    cipher.initialize_encrypt_key(raw_key, &separate_key);
+    EXPECT_PRED3(test::details::EqualBlocks, encrypt_key.key, separate_key.key, MAX_KEY_SIZE);
+
+    cipher.initialize_decrypt_key(raw_key, &separate_key);
+    EXPECT_PRED3(test::details::EqualBlocks, decrypt_key.key, separate_key.key, MAX_KEY_SIZE);
+}
+
+
+/**
+ * @brief Checks that multi-block procedures of an engine match single 
+ *        block procedures.
+ */
+void CheckEngine(size_t key_size, AES_ENGINE engine)
+{
+    BLOCK_CIPHER cipher = {};
+    ASSERT_TRUE(aes_initialize_interface_ex(&cipher, key_size, engine));
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+
+    //
+    // Every number of blocks up to several full batches is checked
+    // to cover both wide and tail paths
+    //
+
+    for (std::size_t blocks_count = 1; blocks_count <= 40; ++blocks_count)
+    {
+        std::vector<unsigned char> message(blocks_count * AES_BLOCK_SIZE);
+        std::vector<unsigned char> expected(blocks_count * AES_BLOCK_SIZE);
+        std::vector<unsigned char> buffer(blocks_count * AES_BLOCK_SIZE);
+
+        auto* message_blocks  = reinterpret_cast<__m128i*>(message.data());
+        auto* expected_blocks = reinterpret_cast<__m128i*>(expected.data());
+        auto* buffer_blocks   = reinterpret_cast<__m128i*>(buffer.data());
+
+        for (std::size_t idx = 0; idx < message.size(); ++idx)
+        {
+            message[idx] = static_cast<unsigned char>(idx * 7 + blocks_count);
+        }
+
+        for (std::size_t idx = 0; idx < blocks_count; ++idx)
+        {
+            cipher.encrypt_block(_mm_loadu_si128(message_blocks + idx), &encrypt_key, expected_blocks + idx);
+        }
+
+        cipher.encrypt_blocks(message_blocks, &encrypt_key, buffer_blocks, blocks_count);
+        EXPECT_EQ(expected, buffer);
+
+        cipher.decrypt_blocks(buffer_blocks, &decrypt_key, buffer_blocks, blocks_count);
+        EXPECT_EQ(message, buffer);
+    }
+}
+
+}  // namespace
+
+
+TEST(Aes, Initialize)
+{
+    //
+    // MUST NOT throw any exception
+    // MUST initialize all required fields of BLOCK_CIPHER structure.
+    //
+
+    if (!test::details::CpuSupportsAesni())
+    {
+        GTEST_SKIP() << "AES-NI is not supported by CPU";
+    }
+
+    BLOCK_CIPHER cipher = {};
+    ASSERT_TRUE(aes_initialize_interface(&cipher, AES256_KEY_SIZE));
+
+    EXPECT_EQ(cipher.block_size, AES_BLOCK_SIZE);
+    EXPECT_EQ(cipher.key_size, AES256_KEY_SIZE);
+    EXPECT_NE(cipher.encrypt_block, nullptr);
+    EXPECT_NE(cipher.decrypt_block, nullptr);
+    EXPECT_NE(cipher.encrypt_blocks, nullptr);
+    EXPECT_NE(cipher.decrypt_blocks, nullptr);
+    EXPECT_NE(cipher.initialize_encrypt_key, nullptr);
+    EXPECT_NE(cipher.initialize_decrypt_key, nullptr);
+    EXPECT_NE(cipher.initialize_keys, nullptr);
+    EXPECT_NE(cipher.initialize_keys_batch, nullptr);
+}
+
+
+TEST(Aes, InitializeFailure)
+{
+    //
+    // MUST NOT throw any exception
+    // MUST fail for unsupported key sizes and leave interface untouched
+    // MUST fail without AES-NI
+    //
+
+    BLOCK_CIPHER cipher = {};
+
+    EXPECT_FALSE(aes_initialize_interface_ex(&cipher, 24, AES_ENGINE_AESNI));
+    EXPECT_FALSE(aes_initialize_interface_ex(&cipher, 0, AES_ENGINE_AESNI));
+    EXPECT_FALSE(aes_initialize_interface(&cipher, 24));
+    EXPECT_EQ(cipher.encrypt_block, nullptr);
+
+    EXPECT_EQ(aes_initialize_interface(&cipher, AES128_KEY_SIZE) != 0, test::details::CpuSupportsAesni());
+}
+
+
+TEST(Aes, Aes128Vector)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted and decrypted texts MUST match an expected test vector
+    //
+
+    if (!test::details::CpuSupportsAesni())
+    {
+        GTEST_SKIP() << "AES-NI is not supported by CPU";
+    }
+
+    CheckVector(AES128_KEY_SIZE, ciphertext128);
+}
+
+
+TEST(Aes, Aes256Vector)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted and decrypted texts MUST match an expected test vector
+    //
+
+    if (!test::details::CpuSupportsAesni())
+    {
+        GTEST_SKIP() << "AES-NI is not supported by CPU";
+    }
+
+    CheckVector(AES256_KEY_SIZE, ciphertext256);
+}
+
+
+TEST(Aes, EngineAesni)
+{
+    //
+    // MUST NOT throw any exception
+    // AES-NI engine MUST produce the same results as single block procedures
+    //
+
+    if (!test::details::CpuSupportsAesni())
+    {
+        GTEST_SKIP() << "AES-NI is not supported by CPU";
+    }
+
+    CheckEngine(AES128_KEY_SIZE, AES_ENGINE_AESNI);
+    CheckEngine(AES256_KEY_SIZE, AES_ENGINE_AESNI);
+}
+
+
+TEST(Aes, EngineVaes)
+{
+    //
+    // MUST NOT throw any exception
+    // VAES engine MUST produce the same results as single block procedures
+    //
+
+    if (!test::details::CpuSupportsAvx512Vaes())
+    {
+        GTEST_SKIP() << "AVX-512 or VAES is not supported by CPU";
+    }
+
+    CheckEngine(AES128_KEY_SIZE, AES_ENGINE_VAES);
+    CheckEngine(AES256_KEY_SIZE, AES_ENGINE_VAES);
+}
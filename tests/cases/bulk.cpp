@@ -0,0 +1,288 @@
+/**
+ * @file bulk.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for multi-threaded bulk engine
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char raw_tweak_key[] = {
+    0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01,
+    0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+    0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00,
+    0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88
+};
+
+constexpr unsigned char iv[] = {
+    0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0
+};
+
+
+/**
+ * @brief Generates a buffer with some data.
+ */
+std::vector<unsigned char> MakeData(std::size_t length)
+{
+    std::vector<unsigned char> data(length);
+    for (std::size_t idx = 0; idx < length; ++idx)
+    {
+        data[idx] = static_cast<unsigned char>(idx * 31 + (idx >> 8));
+    }
+
+    return data;
+}
+
+
+/**
+ * @brief Test fixture with initialized cipher, keys and bulk engine.
+ */
+class Bulk : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        kuznyechik_initialize_interface(&cipher);
+        cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+        cipher.initialize_encrypt_key(raw_tweak_key, &tweak_key);
+
+        engine = bulk_create(4);
+        ASSERT_NE(engine, nullptr);
+    }
+
+    void TearDown() override
+    {
+        bulk_destroy(engine);
+    }
+
+    BULK_REQUEST MakeRequest(BULK_MODE mode, const std::vector<unsigned char>& in, std::vector<unsigned char>& out) const
+    {
+        BULK_REQUEST request = {};
+        request.mode         = mode;
+        request.cipher       = &cipher;
+        request.in           = in.data();
+        request.out          = out.data();
+        request.length       = in.size();
+
+        return request;
+    }
+
+    BLOCK_CIPHER cipher = {};
+    KEY encrypt_key     = {};
+    KEY decrypt_key     = {};
+    KEY tweak_key       = {};
+    BULK_ENGINE* engine = nullptr;
+};
+
+}  // namespace
+
+
+TEST_F(Bulk, Ecb)
+{
+    //
+    // MUST NOT throw any exception
+    // Results MUST match serial multi-block procedures
+    //
+
+    const auto plaintext = MakeData(37 * BULK_CHUNK_SIZE / 4 + 3 * KUZNYECHIK_BLOCK_SIZE);
+    const auto blocks    = plaintext.size() / KUZNYECHIK_BLOCK_SIZE;
+
+    std::vector<unsigned char> expected(plaintext.size());
+    cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &encrypt_key,
+                          reinterpret_cast<__m128i*>(expected.data()), blocks);
+
+    std::vector<unsigned char> ciphertext(plaintext.size());
+    auto request = MakeRequest(BULK_MODE_ECB_ENCRYPT, plaintext, ciphertext);
+    request.key  = &encrypt_key;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), ciphertext.data(), ciphertext.size());
+
+    std::vector<unsigned char> decrypted(plaintext.size());
+    request     = MakeRequest(BULK_MODE_ECB_DECRYPT, ciphertext, decrypted);
+    request.key = &decrypt_key;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), decrypted.data(), decrypted.size());
+}
+
+
+TEST_F(Bulk, Ctr)
+{
+    //
+    // MUST NOT throw any exception
+    // Results MUST match serial CTR for a non-block-aligned length and offset
+    //
+
+    const auto plaintext = MakeData(5 * BULK_CHUNK_SIZE + 7);
+
+    std::vector<unsigned char> expected(plaintext.size());
+    ctr_encrypt(&cipher, &encrypt_key, iv, 1000, plaintext.data(), expected.data(), plaintext.size());
+
+    std::vector<unsigned char> ciphertext(plaintext.size());
+    auto request   = MakeRequest(BULK_MODE_CTR, plaintext, ciphertext);
+    request.key    = &encrypt_key;
+    request.iv     = iv;
+    request.offset = 1000;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), ciphertext.data(), ciphertext.size());
+}
+
+
+TEST_F(Bulk, Xts)
+{
+    //
+    // MUST NOT throw any exception
+    // Results MUST match serial XTS (sector size doesn't divide chunk size)
+    // Decryption MUST be done in-place
+    //
+
+    constexpr std::size_t sector_size = 48 * KUZNYECHIK_BLOCK_SIZE;
+
+    const auto plaintext = MakeData(301 * sector_size);
+
+    std::vector<unsigned char> expected(plaintext.size());
+    xts_encrypt_sectors(&cipher, &encrypt_key, &tweak_key, 77, sector_size, 301,
+                        plaintext.data(), expected.data());
+
+    std::vector<unsigned char> buffer(plaintext.size());
+    auto request        = MakeRequest(BULK_MODE_XTS_ENCRYPT, plaintext, buffer);
+    request.key         = &encrypt_key;
+    request.tweak_key   = &tweak_key;
+    request.offset      = 77;
+    request.sector_size = sector_size;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), buffer.size());
+
+    request             = MakeRequest(BULK_MODE_XTS_DECRYPT, buffer, buffer);
+    request.key         = &decrypt_key;
+    request.tweak_key   = &tweak_key;
+    request.offset      = 77;
+    request.sector_size = sector_size;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), buffer.data(), buffer.size());
+}
+
+
+TEST_F(Bulk, CbcDecrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Results MUST match serial CBC decryption
+    // Decryption MUST be done in-place (IVs of chunks are overwritten by other threads)
+    //
+
+    const auto plaintext = MakeData(7 * BULK_CHUNK_SIZE + 5 * KUZNYECHIK_BLOCK_SIZE);
+
+    unsigned char cbc_iv[CBC_SECTOR_IV_SIZE];
+    std::copy(std::begin(raw_tweak_key), std::begin(raw_tweak_key) + sizeof(cbc_iv), cbc_iv);
+
+    std::vector<unsigned char> ciphertext(plaintext.size());
+    cbc_encrypt(&cipher, &encrypt_key, cbc_iv, sizeof(cbc_iv), plaintext.data(), ciphertext.data(), plaintext.size());
+
+    std::vector<unsigned char> buffer = ciphertext;
+    auto request = MakeRequest(BULK_MODE_CBC_DECRYPT, buffer, buffer);
+    request.key  = &decrypt_key;
+    request.iv   = cbc_iv;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), buffer.data(), buffer.size());
+
+    //
+    // Single thread engine MUST give the same results
+    //
+
+    BULK_ENGINE* serial = bulk_create(1);
+    ASSERT_NE(serial, nullptr);
+
+    buffer = ciphertext;
+    EXPECT_TRUE(bulk_process(serial, &request));
+    bulk_destroy(serial);
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), buffer.data(), buffer.size());
+}
+
+
+TEST_F(Bulk, CbcDecryptSectors)
+{
+    //
+    // MUST NOT throw any exception
+    // Results MUST match serial per-sector CBC (sector size doesn't divide chunk size)
+    //
+
+    constexpr std::size_t sector_size   = 48 * KUZNYECHIK_BLOCK_SIZE;
+    constexpr std::size_t sectors_count = 301;
+
+    const auto plaintext = MakeData(sectors_count * sector_size);
+    const auto ivs       = MakeData(sectors_count * CBC_SECTOR_IV_SIZE);
+
+    std::vector<unsigned char> ciphertext(plaintext.size());
+    cbc_encrypt_sectors(&cipher, &encrypt_key, ivs.data(), sector_size, sectors_count, plaintext.data(), ciphertext.data());
+
+    std::vector<unsigned char> decrypted(plaintext.size());
+    auto request        = MakeRequest(BULK_MODE_CBC_DECRYPT_SECTORS, ciphertext, decrypted);
+    request.key         = &decrypt_key;
+    request.iv          = ivs.data();
+    request.sector_size = sector_size;
+    EXPECT_TRUE(bulk_process(engine, &request));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), decrypted.data(), decrypted.size());
+}
+
+
+TEST_F(Bulk, InvalidRequest)
+{
+    //
+    // MUST NOT throw any exception
+    // Requests with invalid sector size or partial blocks (sectors)
+    // MUST be rejected without touching output
+    //
+
+    const auto plaintext = MakeData(8 * XTS_MAX_SECTOR_SIZE);
+
+    std::vector<unsigned char> buffer(plaintext.size());
+    auto request        = MakeRequest(BULK_MODE_XTS_ENCRYPT, plaintext, buffer);
+    request.key         = &encrypt_key;
+    request.tweak_key   = &tweak_key;
+    request.iv          = plaintext.data();
+
+    for (const std::size_t sector_size : { std::size_t(0), std::size_t(24), std::size_t(2 * XTS_MAX_SECTOR_SIZE) })
+    {
+        request.sector_size = sector_size;
+        EXPECT_FALSE(bulk_process(engine, &request));
+    }
+
+    request.sector_size = 512;
+    request.length      = plaintext.size() - KUZNYECHIK_BLOCK_SIZE;
+    EXPECT_FALSE(bulk_process(engine, &request));
+
+    request.mode        = BULK_MODE_CBC_DECRYPT_SECTORS;
+    request.sector_size = 0;
+    request.length      = plaintext.size();
+    EXPECT_FALSE(bulk_process(engine, &request));
+
+    request.mode   = BULK_MODE_ECB_ENCRYPT;
+    request.length = plaintext.size() - 1;
+    EXPECT_FALSE(bulk_process(engine, &request));
+
+    EXPECT_EQ(std::vector<unsigned char>(plaintext.size()), buffer);
+}
@@ -0,0 +1,204 @@
+/**
+ * @file cbc.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for CBC mode of operation
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A.1.4 of GOST 34.13-2018
+//
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char iv[] = {
+    0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0, 0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf0, 0x01, 0x12,
+    0x23, 0x34, 0x45, 0x56, 0x67, 0x78, 0x89, 0x90, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19
+};
+
+constexpr unsigned char plaintext[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a,
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00,
+    0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00, 0x11
+};
+
+constexpr unsigned char ciphertext[] = {
+    0x68, 0x99, 0x72, 0xd4, 0xa0, 0x85, 0xfa, 0x4d, 0x90, 0xe5, 0x2e, 0x3d, 0x6d, 0x7d, 0xcc, 0x27,
+    0x28, 0x26, 0xe6, 0x61, 0xb4, 0x78, 0xec, 0xa6, 0xaf, 0x1e, 0x8e, 0x44, 0x8d, 0x5e, 0xa5, 0xac,
+    0xfe, 0x7b, 0xab, 0xf1, 0xe9, 0x19, 0x99, 0xe8, 0x56, 0x40, 0xe8, 0xb0, 0xf4, 0x9d, 0x90, 0xd0,
+    0x16, 0x76, 0x88, 0x06, 0x5a, 0x89, 0x5c, 0x63, 0x1a, 0x2d, 0x9a, 0x15, 0x60, 0xb6, 0x39, 0x70
+};
+
+}  // namespace
+
+
+TEST(Cbc, Encrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted text MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(plaintext)] = {};
+    cbc_encrypt(&cipher, &key, iv, sizeof(iv), plaintext, buffer, sizeof(plaintext));
+
+    EXPECT_PRED3(test::details::EqualBlocks, ciphertext, buffer, sizeof(ciphertext));
+}
+
+
+TEST(Cbc, Decrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Decrypted text MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_decrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(ciphertext)] = {};
+    cbc_decrypt(&cipher, &key, iv, sizeof(iv), ciphertext, buffer, sizeof(ciphertext));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, sizeof(plaintext));
+}
+
+
+TEST(Cbc, LongMessageInPlace)
+{
+    //
+    // MUST NOT throw any exception
+    // In-place decryption of a long message (several batches) MUST 
+    // restore plaintext for different IV sizes
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &decrypt_key);
+
+    std::vector<unsigned char> message(75 * KUZNYECHIK_BLOCK_SIZE);
+
+    for (std::size_t idx = 0; idx < message.size(); ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    for (const std::size_t iv_size : { std::size_t(16), std::size_t(32) })
+    {
+        std::vector<unsigned char> buffer(message);
+
+        cbc_encrypt(&cipher, &encrypt_key, iv, iv_size, buffer.data(), buffer.data(), buffer.size());
+        cbc_decrypt(&cipher, &decrypt_key, iv, iv_size, buffer.data(), buffer.data(), buffer.size());
+
+        EXPECT_PRED3(test::details::EqualBlocks, message.data(), buffer.data(), message.size());
+    }
+}
+
+
+TEST(Cbc, InvalidSizes)
+{
+    //
+    // MUST NOT throw any exception
+    // IVs shorter than a block or of partial blocks, data of partial blocks 
+    // and empty sectors MUST be rejected without touching output
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+
+    std::vector<unsigned char> buffer(plaintext, plaintext + sizeof(plaintext));
+
+    for (const std::size_t iv_size : { std::size_t(0), std::size_t(8), std::size_t(24) })
+    {
+        EXPECT_FALSE(cbc_encrypt(&cipher, &encrypt_key, iv, iv_size, plaintext, buffer.data(), sizeof(plaintext)));
+        EXPECT_FALSE(cbc_decrypt(&cipher, &decrypt_key, iv, iv_size, plaintext, buffer.data(), sizeof(plaintext)));
+    }
+
+    EXPECT_FALSE(cbc_encrypt(&cipher, &encrypt_key, iv, sizeof(iv), plaintext, buffer.data(), sizeof(plaintext) - 1));
+    EXPECT_FALSE(cbc_decrypt(&cipher, &decrypt_key, iv, sizeof(iv), plaintext, buffer.data(), sizeof(plaintext) - 1));
+    EXPECT_FALSE(cbc_encrypt_sectors(&cipher, &encrypt_key, iv, 0, 1, plaintext, buffer.data()));
+    EXPECT_FALSE(cbc_decrypt_sectors(&cipher, &decrypt_key, iv, 24, 1, plaintext, buffer.data()));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer.data(), sizeof(plaintext));
+}
+
+
+TEST(Cbc, Sectors)
+{
+    //
+    // MUST NOT throw any exception
+    // Sectors encrypted in lockstep MUST match sectors encrypted one
+    // by one, in-place decryption MUST restore plaintext
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &decrypt_key);
+
+    constexpr std::size_t sector_size   = 512;
+    constexpr std::size_t sectors_count = 21;
+
+    std::vector<unsigned char> sectors(sector_size * sectors_count);
+    std::vector<unsigned char> ivs(CBC_SECTOR_IV_SIZE * sectors_count);
+    std::vector<unsigned char> expected(sectors.size());
+
+    for (std::size_t idx = 0; idx < sectors.size(); ++idx)
+    {
+        sectors[idx] = static_cast<unsigned char>(idx * 5 + 1);
+    }
+
+    for (std::size_t idx = 0; idx < ivs.size(); ++idx)
+    {
+        ivs[idx] = static_cast<unsigned char>(idx * 7 + 3);
+    }
+
+    for (std::size_t sector = 0; sector < sectors_count; ++sector)
+    {
+        cbc_encrypt(&cipher, &encrypt_key, ivs.data() + sector * CBC_SECTOR_IV_SIZE, CBC_SECTOR_IV_SIZE,
+                    sectors.data() + sector * sector_size, expected.data() + sector * sector_size, sector_size);
+    }
+
+    std::vector<unsigned char> buffer(sectors);
+    cbc_encrypt_sectors(&cipher, &encrypt_key, ivs.data(), sector_size, sectors_count, buffer.data(), buffer.data());
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), buffer.size());
+
+    cbc_decrypt_sectors(&cipher, &decrypt_key, ivs.data(), sector_size, sectors_count, buffer.data(), buffer.data());
+
+    EXPECT_PRED3(test::details::EqualBlocks, sectors.data(), buffer.data(), buffer.size());
+}
@@ -0,0 +1,228 @@
+/**
+ * @file cfb.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for CFB mode of operation
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A.1.5 of GOST 34.13-2018
+//
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char iv[] = {
+    0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0, 0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf0, 0x01, 0x12,
+    0x23, 0x34, 0x45, 0x56, 0x67, 0x78, 0x89, 0x90, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19
+};
+
+constexpr unsigned char plaintext[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a,
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00,
+    0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00, 0x11
+};
+
+constexpr unsigned char ciphertext[] = {
+    0x81, 0x80, 0x0a, 0x59, 0xb1, 0x84, 0x2b, 0x24, 0xff, 0x1f, 0x79, 0x5e, 0x89, 0x7a, 0xbd, 0x95,
+    0xed, 0x5b, 0x47, 0xa7, 0x04, 0x8c, 0xfa, 0xb4, 0x8f, 0xb5, 0x21, 0x36, 0x9d, 0x93, 0x26, 0xbf,
+    0x79, 0xf2, 0xa8, 0xeb, 0x5c, 0xc6, 0x8d, 0x38, 0x84, 0x2d, 0x26, 0x4e, 0x97, 0xa2, 0x38, 0xb5,
+    0x4f, 0xfe, 0xbe, 0xcd, 0x4e, 0x92, 0x2d, 0xe6, 0xc7, 0x5b, 0xd9, 0xdd, 0x44, 0xfb, 0xf4, 0xd1
+};
+
+}  // namespace
+
+
+TEST(Cfb, Encrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted text MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(plaintext)] = {};
+    cfb_encrypt(&cipher, &key, iv, sizeof(iv), plaintext, buffer, sizeof(plaintext));
+
+    EXPECT_PRED3(test::details::EqualBlocks, ciphertext, buffer, sizeof(ciphertext));
+}
+
+
+TEST(Cfb, Decrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Decrypted text MUST match an expected test vector, incomplete
+    // last block MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(ciphertext)] = {};
+    cfb_decrypt(&cipher, &key, iv, sizeof(iv), ciphertext, buffer, sizeof(ciphertext));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, sizeof(plaintext));
+
+    constexpr std::size_t length = sizeof(ciphertext) - 5;
+
+    unsigned char truncated[length] = {};
+    cfb_decrypt(&cipher, &key, iv, sizeof(iv), ciphertext, truncated, length);
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, truncated, length);
+}
+
+
+TEST(Cfb, LongMessageInPlace)
+{
+    //
+    // MUST NOT throw any exception
+    // In-place decryption of a long message (several batches) MUST 
+    // restore plaintext for different IV sizes
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    std::vector<unsigned char> message(75 * KUZNYECHIK_BLOCK_SIZE + 7);
+
+    for (std::size_t idx = 0; idx < message.size(); ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    for (const std::size_t iv_size : { std::size_t(16), std::size_t(32) })
+    {
+        std::vector<unsigned char> buffer(message);
+
+        cfb_encrypt(&cipher, &key, iv, iv_size, buffer.data(), buffer.data(), buffer.size());
+        cfb_decrypt(&cipher, &key, iv, iv_size, buffer.data(), buffer.data(), buffer.size());
+
+        EXPECT_PRED3(test::details::EqualBlocks, message.data(), buffer.data(), message.size());
+    }
+}
+
+
+TEST(Cfb, InvalidIvSize)
+{
+    //
+    // MUST NOT throw any exception
+    // IVs shorter than a block or of partial blocks MUST be rejected by
+    // both one-shot and streaming procedures, too long IVs MUST be rejected
+    // by streaming ones
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    std::vector<unsigned char> buffer(plaintext, plaintext + sizeof(plaintext));
+    CFB_CONTEXT context;
+
+    for (const std::size_t iv_size : { std::size_t(0), std::size_t(8), std::size_t(24) })
+    {
+        EXPECT_FALSE(cfb_encrypt(&cipher, &key, iv, iv_size, plaintext, buffer.data(), sizeof(plaintext)));
+        EXPECT_FALSE(cfb_decrypt(&cipher, &key, iv, iv_size, plaintext, buffer.data(), sizeof(plaintext)));
+        EXPECT_FALSE(cfb_encrypt_init(&context, &cipher, &key, iv, iv_size));
+        EXPECT_FALSE(cfb_decrypt_init(&context, &cipher, &key, iv, iv_size));
+    }
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer.data(), sizeof(plaintext));
+
+    const std::vector<unsigned char> long_iv(CFB_MAX_STREAM_IV_SIZE + KUZNYECHIK_BLOCK_SIZE);
+
+    EXPECT_TRUE(cfb_encrypt(&cipher, &key, long_iv.data(), long_iv.size(), plaintext, buffer.data(), sizeof(plaintext)));
+    EXPECT_FALSE(cfb_encrypt_init(&context, &cipher, &key, long_iv.data(), long_iv.size()));
+    EXPECT_FALSE(cfb_decrypt_init(&context, &cipher, &key, long_iv.data(), long_iv.size()));
+}
+
+
+TEST(Cfb, Stream)
+{
+    //
+    // MUST NOT throw any exception
+    // Processing a message by chunks of arbitrary lengths MUST match
+    // processing it at once, in-place processing MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t chunks[] = { 1, 15, 0, 16, 17, 3, 100, 31, 2 };
+
+    std::vector<unsigned char> message(53 * KUZNYECHIK_BLOCK_SIZE + 9);
+
+    for (std::size_t idx = 0; idx < message.size(); ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    for (const std::size_t iv_size : { std::size_t(16), std::size_t(32) })
+    {
+        std::vector<unsigned char> expected(message.size());
+        std::vector<unsigned char> buffer(message);
+
+        cfb_encrypt(&cipher, &key, iv, iv_size, message.data(), expected.data(), message.size());
+
+        CFB_CONTEXT context;
+        ASSERT_TRUE(cfb_encrypt_init(&context, &cipher, &key, iv, iv_size));
+
+        for (std::size_t offset = 0, chunk = 0; offset < buffer.size(); ++chunk)
+        {
+            const std::size_t length = std::min(chunks[chunk % std::size(chunks)], buffer.size() - offset);
+
+            cfb_update(&context, buffer.data() + offset, buffer.data() + offset, length);
+            offset += length;
+        }
+
+        cfb_final(&context);
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), expected.size());
+
+        ASSERT_TRUE(cfb_decrypt_init(&context, &cipher, &key, iv, iv_size));
+
+        for (std::size_t offset = 0, chunk = 4; offset < buffer.size(); ++chunk)
+        {
+            const std::size_t length = std::min(chunks[chunk % std::size(chunks)], buffer.size() - offset);
+
+            cfb_update(&context, buffer.data() + offset, buffer.data() + offset, length);
+            offset += length;
+        }
+
+        cfb_final(&context);
+
+        EXPECT_PRED3(test::details::EqualBlocks, message.data(), buffer.data(), message.size());
+    }
+}
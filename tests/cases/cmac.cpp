@@ -0,0 +1,211 @@
+/**
+ * @file cmac.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for MAC generation mode
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A.1.6 of GOST 34.13-2018
+//
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char plaintext[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a,
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00,
+    0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00, 0x11
+};
+
+constexpr unsigned char mac[] = {
+    0x33, 0x6f, 0x4d, 0x29, 0x60, 0x59, 0xfb, 0xe3
+};
+
+}  // namespace
+
+
+TEST(Cmac, Compute)
+{
+    //
+    // MUST NOT throw any exception
+    // MAC MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char tag[sizeof(mac)] = {};
+    cmac_compute(&cipher, &key, plaintext, sizeof(plaintext), tag, sizeof(tag));
+
+    EXPECT_PRED3(test::details::EqualBlocks, mac, tag, sizeof(mac));
+}
+
+
+TEST(Cmac, TagSize)
+{
+    //
+    // MUST NOT throw any exception
+    // Truncated tags MUST be prefixes of the full one, empty tags and tags
+    // longer than CMAC_MAX_TAG_SIZE MUST be rejected without writing
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char full_tag[CMAC_MAX_TAG_SIZE] = {};
+    ASSERT_TRUE(cmac_compute(&cipher, &key, plaintext, sizeof(plaintext), full_tag, sizeof(full_tag)));
+
+    const unsigned char* message = plaintext;
+    const std::size_t length     = sizeof(plaintext);
+
+    for (std::size_t tag_size = 1; tag_size <= CMAC_MAX_TAG_SIZE; ++tag_size)
+    {
+        unsigned char tag[CMAC_MAX_TAG_SIZE] = {};
+
+        EXPECT_TRUE(cmac_compute_batch(&cipher, &key, &message, &length, 1, tag, tag_size));
+        EXPECT_PRED3(test::details::EqualBlocks, full_tag, tag, tag_size);
+    }
+
+    for (const std::size_t tag_size : { std::size_t(0), std::size_t(CMAC_MAX_TAG_SIZE + 1) })
+    {
+        unsigned char tag[2 * CMAC_MAX_TAG_SIZE] = {};
+        const unsigned char untouched[2 * CMAC_MAX_TAG_SIZE] = {};
+
+        EXPECT_FALSE(cmac_compute(&cipher, &key, plaintext, sizeof(plaintext), tag, tag_size));
+        EXPECT_FALSE(cmac_compute_batch(&cipher, &key, &message, &length, 1, tag, tag_size));
+
+        CMAC_CONTEXT context;
+        cmac_init(&context, &cipher, &key);
+        cmac_update(&context, plaintext, sizeof(plaintext));
+
+        EXPECT_FALSE(cmac_final(&context, tag, tag_size));
+        EXPECT_PRED3(test::details::EqualBlocks, untouched, tag, sizeof(tag));
+    }
+}
+
+
+TEST(Cmac, Batch)
+{
+    //
+    // MUST NOT throw any exception
+    // MACs of a batch of messages of different lengths (more than 
+    // messages processed at once) MUST match MACs computed one by one
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t messages_count = 37;
+
+    std::vector<std::vector<unsigned char>> messages(messages_count);
+    std::vector<const unsigned char*> pointers(messages_count);
+    std::vector<std::size_t> lengths(messages_count);
+
+    for (std::size_t message = 0; message < messages_count; ++message)
+    {
+        messages[message].resize((message * 29) % 200);
+
+        for (std::size_t idx = 0; idx < messages[message].size(); ++idx)
+        {
+            messages[message][idx] = static_cast<unsigned char>(idx * 3 + message);
+        }
+
+        pointers[message] = messages[message].data();
+        lengths[message]  = messages[message].size();
+    }
+
+    std::vector<unsigned char> tags(messages_count * CMAC_MAX_TAG_SIZE);
+    cmac_compute_batch(&cipher, &key, pointers.data(), lengths.data(), messages_count, tags.data(), CMAC_MAX_TAG_SIZE);
+
+    for (std::size_t message = 0; message < messages_count; ++message)
+    {
+        unsigned char tag[CMAC_MAX_TAG_SIZE] = {};
+        cmac_compute(&cipher, &key, pointers[message], lengths[message], tag, sizeof(tag));
+
+        EXPECT_PRED3(test::details::EqualBlocks, tag, tags.data() + message * CMAC_MAX_TAG_SIZE, sizeof(tag));
+    }
+}
+
+
+TEST(Cmac, Stream)
+{
+    //
+    // MUST NOT throw any exception
+    // MAC of a message absorbed by chunks of arbitrary lengths MUST match
+    // MAC computed at once, including empty and block-aligned messages
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t chunks[] = { 1, 15, 0, 16, 17, 3, 32, 31, 2 };
+
+    for (const std::size_t length : { std::size_t(0), std::size_t(7), std::size_t(16), std::size_t(64), std::size_t(1000) })
+    {
+        std::vector<unsigned char> message(length);
+
+        for (std::size_t idx = 0; idx < message.size(); ++idx)
+        {
+            message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+        }
+
+        unsigned char expected_tag[CMAC_MAX_TAG_SIZE] = {};
+        unsigned char computed_tag[CMAC_MAX_TAG_SIZE] = {};
+
+        cmac_compute(&cipher, &key, message.data(), message.size(), expected_tag, sizeof(expected_tag));
+
+        CMAC_CONTEXT context;
+        cmac_init(&context, &cipher, &key);
+
+        for (std::size_t offset = 0, chunk = 0; offset < message.size(); ++chunk)
+        {
+            const std::size_t size = std::min(chunks[chunk % std::size(chunks)], message.size() - offset);
+
+            cmac_update(&context, message.data() + offset, size);
+            offset += size;
+        }
+
+        cmac_final(&context, computed_tag, sizeof(computed_tag));
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected_tag, computed_tag, sizeof(computed_tag));
+    }
+
+    CMAC_CONTEXT context;
+    unsigned char computed_tag[sizeof(mac)] = {};
+
+    cmac_init(&context, &cipher, &key);
+    cmac_update(&context, plaintext, 20);
+    cmac_update(&context, plaintext + 20, sizeof(plaintext) - 20);
+    cmac_final(&context, computed_tag, sizeof(computed_tag));
+
+    EXPECT_PRED3(test::details::EqualBlocks, mac, computed_tag, sizeof(mac));
+}
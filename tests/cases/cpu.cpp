@@ -0,0 +1,47 @@
+/**
+ * @file cpu.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for CPU features detection
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+
+TEST(Cpu, Baseline)
+{
+    //
+    // MUST NOT throw any exception
+    // SSE2 MUST be detected (it is a part of x86-64)
+    // Result MUST be stable between calls
+    //
+
+    EXPECT_TRUE(cpu_supports(CPU_FEATURE_SSE2));
+    EXPECT_EQ(cpu_features(), cpu_features());
+    EXPECT_TRUE(cpu_supports(0));
+}
+
+
+#if !defined(_MSC_VER)
+
+TEST(Cpu, MatchesCompiler)
+{
+    //
+    // MUST NOT throw any exception
+    // Detected features MUST match the ones reported by compiler runtime
+    //
+
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_SSSE3), !!__builtin_cpu_supports("ssse3"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_PCLMUL), !!__builtin_cpu_supports("pclmul"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_AESNI), !!__builtin_cpu_supports("aes"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_AVX2), !!__builtin_cpu_supports("avx2"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_AVX512F), !!__builtin_cpu_supports("avx512f"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_AVX512BW), !!__builtin_cpu_supports("avx512bw"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_AVX512VBMI), !!__builtin_cpu_supports("avx512vbmi"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_GFNI), !!__builtin_cpu_supports("gfni"));
+    EXPECT_EQ(cpu_supports(CPU_FEATURE_VAES), !!__builtin_cpu_supports("vaes"));
+}
+
+#endif  // !_MSC_VER
@@ -0,0 +1,217 @@
+/**
+ * @file ctr.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for CTR mode of operation
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A.1.2 of GOST 34.13-2018
+//
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char iv[] = {
+    0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0
+};
+
+constexpr unsigned char plaintext[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a,
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00,
+    0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00, 0x11
+};
+
+constexpr unsigned char ciphertext[] = {
+    0xf1, 0x95, 0xd8, 0xbe, 0xc1, 0x0e, 0xd1, 0xdb, 0xd5, 0x7b, 0x5f, 0xa2, 0x40, 0xbd, 0xa1, 0xb8,
+    0x85, 0xee, 0xe7, 0x33, 0xf6, 0xa1, 0x3e, 0x5d, 0xf3, 0x3c, 0xe4, 0xb3, 0x3c, 0x45, 0xde, 0xe4,
+    0xa5, 0xea, 0xe8, 0x8b, 0xe6, 0x35, 0x6e, 0xd3, 0xd5, 0xe8, 0x77, 0xf1, 0x35, 0x64, 0xa3, 0xa5,
+    0xcb, 0x91, 0xfa, 0xb1, 0xf2, 0x0c, 0xba, 0xb6, 0xd1, 0xc6, 0xd1, 0x58, 0x20, 0xbd, 0xba, 0x73
+};
+
+}  // namespace
+
+
+TEST(Ctr, Encrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted text MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(plaintext)] = {};
+    ctr_encrypt(&cipher, &key, iv, 0, plaintext, buffer, sizeof(plaintext));
+
+    EXPECT_PRED3(test::details::EqualBlocks, ciphertext, buffer, sizeof(ciphertext));
+}
+
+
+TEST(Ctr, DecryptSlice)
+{
+    //
+    // MUST NOT throw any exception
+    // A slice decrypted from a block offset MUST match the corresponding
+    // part of plaintext, incomplete last block MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t offset = 2 * KUZNYECHIK_BLOCK_SIZE;
+    constexpr std::size_t length = sizeof(ciphertext) - offset - 5;
+
+    unsigned char buffer[length] = {};
+    ctr_decrypt(&cipher, &key, iv, 2, ciphertext + offset, buffer, length);
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext + offset, buffer, length);
+}
+
+
+TEST(Ctr, LongMessageInPlace)
+{
+    //
+    // MUST NOT throw any exception
+    // Processing a long message at once MUST match processing it by parts,
+    // in-place encryption MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t blocks_count = 53;
+
+    std::vector<unsigned char> message(blocks_count * KUZNYECHIK_BLOCK_SIZE + 9);
+    std::vector<unsigned char> expected(message.size());
+
+    for (std::size_t idx = 0; idx < message.size(); ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    for (std::size_t block = 0; block <= blocks_count; ++block)
+    {
+        const std::size_t offset = block * KUZNYECHIK_BLOCK_SIZE;
+        const std::size_t length = std::min<std::size_t>(KUZNYECHIK_BLOCK_SIZE, message.size() - offset);
+
+        ctr_encrypt(&cipher, &key, iv, block, message.data() + offset, expected.data() + offset, length);
+    }
+
+    ctr_encrypt(&cipher, &key, iv, 0, message.data(), message.data(), message.size());
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), message.data(), message.size());
+}
+
+
+TEST(Ctr, Iov)
+{
+    //
+    // MUST NOT throw any exception
+    // Scatter-gather encryption MUST match contiguous one for any segmentation
+    // (including incomplete last block), in-place too
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t length = 47 * KUZNYECHIK_BLOCK_SIZE + 5;
+
+    std::vector<unsigned char> message(length);
+    std::vector<unsigned char> expected(length);
+
+    for (std::size_t idx = 0; idx < length; ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    ctr_encrypt(&cipher, &key, iv, 3, message.data(), expected.data(), length);
+
+    const std::vector<std::vector<std::size_t>> patterns = {
+        { length }, { 1 }, { 7, 0, 33 }, { 16, 5, 11 }, { 100, 3, 0, 250 }
+    };
+
+    for (const auto& pattern : patterns)
+    {
+        auto buffer   = message;
+        auto segments = test::details::SplitIntoSegments(buffer.data(), buffer.size(), pattern);
+
+        EXPECT_TRUE(ctr_encrypt_iov(&cipher, &key, iv, 3, segments.data(), segments.size(), segments.data(), segments.size(), length));
+        EXPECT_EQ(expected, buffer);
+
+        EXPECT_TRUE(ctr_decrypt_iov(&cipher, &key, iv, 3, segments.data(), segments.size(), segments.data(), segments.size(), length));
+        EXPECT_EQ(message, buffer);
+    }
+}
+
+
+TEST(Ctr, Stream)
+{
+    //
+    // MUST NOT throw any exception
+    // Processing a message by chunks of arbitrary lengths MUST match
+    // processing it at once, in-place encryption MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    constexpr std::size_t chunks[] = { 1, 15, 0, 16, 17, 3, 100, 31, 2 };
+
+    std::vector<unsigned char> message(53 * KUZNYECHIK_BLOCK_SIZE + 9);
+    std::vector<unsigned char> expected(message.size());
+
+    for (std::size_t idx = 0; idx < message.size(); ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    ctr_encrypt(&cipher, &key, iv, 5, message.data(), expected.data(), message.size());
+
+    CTR_CONTEXT context;
+    ctr_init(&context, &cipher, &key, iv, 5);
+
+    for (std::size_t offset = 0, chunk = 0; offset < message.size(); ++chunk)
+    {
+        const std::size_t length = std::min(chunks[chunk % std::size(chunks)], message.size() - offset);
+
+        ctr_update(&context, message.data() + offset, message.data() + offset, length);
+        offset += length;
+    }
+
+    ctr_final(&context);
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), message.data(), message.size());
+}
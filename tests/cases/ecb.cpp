@@ -0,0 +1,174 @@
+/**
+ * @file ecb.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for ECB mode of operation over byte buffers
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A.1.1 of GOST 34.13-2018
+//
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char plaintext[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a,
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00,
+    0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00, 0x11
+};
+
+constexpr unsigned char ciphertext[] = {
+    0x7f, 0x67, 0x9d, 0x90, 0xbe, 0xbc, 0x24, 0x30, 0x5a, 0x46, 0x8d, 0x42, 0xb9, 0xd4, 0xed, 0xcd,
+    0xb4, 0x29, 0x91, 0x2c, 0x6e, 0x00, 0x32, 0xf9, 0x28, 0x54, 0x52, 0xd7, 0x67, 0x18, 0xd0, 0x8b,
+    0xf0, 0xca, 0x33, 0x54, 0x9d, 0x24, 0x7c, 0xee, 0xf3, 0xf5, 0xa5, 0x31, 0x3b, 0xd4, 0xb1, 0x57,
+    0xd0, 0xb0, 0x9c, 0xcd, 0xe8, 0x30, 0xb9, 0xeb, 0x3a, 0x02, 0xc4, 0xc5, 0xaa, 0x8a, 0xda, 0x98
+};
+
+}  // namespace
+
+
+TEST(Ecb, EncryptUnaligned)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted text MUST match an expected test vector at any alignment,
+    // both for a single block and for several blocks
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    for (std::size_t shift = 0; shift < KUZNYECHIK_BLOCK_SIZE; ++shift)
+    {
+        std::vector<unsigned char> in(sizeof(plaintext) + shift);
+        std::vector<unsigned char> out(sizeof(ciphertext) + shift);
+        std::copy(std::begin(plaintext), std::end(plaintext), in.begin() + shift);
+
+        ecb_encrypt(&cipher, &key, in.data() + shift, out.data() + shift, KUZNYECHIK_BLOCK_SIZE);
+        EXPECT_PRED3(test::details::EqualBlocks, ciphertext, out.data() + shift, KUZNYECHIK_BLOCK_SIZE);
+
+        ecb_encrypt(&cipher, &key, in.data() + shift, out.data() + shift, sizeof(plaintext));
+        EXPECT_PRED3(test::details::EqualBlocks, ciphertext, out.data() + shift, sizeof(ciphertext));
+    }
+}
+
+
+TEST(Ecb, DecryptInPlace)
+{
+    //
+    // MUST NOT throw any exception
+    // In-place decryption of unaligned buffer MUST restore plaintext
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_decrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(ciphertext) + 3] = {};
+    std::copy(std::begin(ciphertext), std::end(ciphertext), buffer + 3);
+
+    ecb_decrypt(&cipher, &key, buffer + 3, buffer + 3, KUZNYECHIK_BLOCK_SIZE);
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer + 3, KUZNYECHIK_BLOCK_SIZE);
+
+    ecb_decrypt(&cipher, &key, buffer + 3 + KUZNYECHIK_BLOCK_SIZE, buffer + 3 + KUZNYECHIK_BLOCK_SIZE,
+                sizeof(ciphertext) - KUZNYECHIK_BLOCK_SIZE);
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer + 3, sizeof(plaintext));
+}
+
+
+TEST(Ecb, Iov)
+{
+    //
+    // MUST NOT throw any exception
+    // Scatter-gather encryption MUST match contiguous one for any segmentation
+    // (including blocks straddling segments and empty segments), in-place too
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+
+    constexpr std::size_t length = 61 * KUZNYECHIK_BLOCK_SIZE;
+
+    std::vector<unsigned char> message(length);
+    std::vector<unsigned char> expected(length);
+
+    for (std::size_t idx = 0; idx < length; ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 13 + 5);
+    }
+
+    ecb_encrypt(&cipher, &encrypt_key, message.data(), expected.data(), length);
+
+    const std::vector<std::vector<std::size_t>> patterns = {
+        { length }, { 1 }, { 7, 0, 33 }, { 16, 5, 11 }, { 100, 3, 0, 0, 250 }, { 4096 }
+    };
+
+    for (const auto& in_pattern : patterns)
+    {
+        for (const auto& out_pattern : patterns)
+        {
+            auto in      = message;
+            auto out     = std::vector<unsigned char>(length);
+            auto in_iov  = test::details::SplitIntoSegments(in.data(), in.size(), in_pattern);
+            auto out_iov = test::details::SplitIntoSegments(out.data(), out.size(), out_pattern);
+
+            EXPECT_TRUE(ecb_encrypt_iov(&cipher, &encrypt_key, in_iov.data(), in_iov.size(), out_iov.data(), out_iov.size(), length));
+            EXPECT_EQ(expected, out);
+
+            EXPECT_TRUE(ecb_decrypt_iov(&cipher, &decrypt_key, out_iov.data(), out_iov.size(), out_iov.data(), out_iov.size(), length));
+            EXPECT_EQ(message, out);
+        }
+    }
+}
+
+
+TEST(Ecb, IovShortList)
+{
+    //
+    // MUST NOT throw any exception
+    // Lists shorter than length MUST be rejected without touching output
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+
+    constexpr std::size_t length = 8 * KUZNYECHIK_BLOCK_SIZE;
+
+    std::vector<unsigned char> in(length, 0x5a);
+    std::vector<unsigned char> out(length);
+
+    auto in_iov  = test::details::SplitIntoSegments(in.data(), in.size(), { 7, 0, 33 });
+    auto out_iov = test::details::SplitIntoSegments(out.data(), out.size(), { 100 });
+
+    EXPECT_FALSE(ecb_encrypt_iov(&cipher, &encrypt_key, in_iov.data(), in_iov.size() - 1, out_iov.data(), out_iov.size(), length));
+    EXPECT_FALSE(ecb_encrypt_iov(&cipher, &encrypt_key, in_iov.data(), in_iov.size(), out_iov.data(), out_iov.size() - 1, length));
+    EXPECT_FALSE(ecb_encrypt_iov(&cipher, &encrypt_key, in_iov.data(), in_iov.size(), out_iov.data(), out_iov.size(), length + KUZNYECHIK_BLOCK_SIZE));
+    EXPECT_EQ(std::vector<unsigned char>(length), out);
+}
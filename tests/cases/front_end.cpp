@@ -0,0 +1,178 @@
+/**
+ * @file front_end.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for header-only C++ front end
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include "bclib.hpp"
+
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char raw_tweak_key[] = {
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+constexpr unsigned char iv[] = {
+    0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0
+};
+
+
+/**
+ * @brief Compares modes of the front end bound to an engine with C procedures
+ *        called through dispatch table of the same engine.
+ */
+template <KUZNYECHIK_ENGINE Engine>
+void CompareWithDispatchTable()
+{
+    using Cipher = bclib::Cipher<bclib::Kuznyechik, Engine>;
+
+    if (!Cipher::Supported())
+    {
+        return;
+    }
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface_ex(&cipher, Engine);
+
+    EXPECT_EQ(Cipher::interleave, cipher.interleave);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    KEY tweak_key   = {};
+
+    Cipher::InitializeEncryptKey(raw_key, &encrypt_key);
+    Cipher::InitializeDecryptKey(raw_key, &decrypt_key);
+    Cipher::InitializeEncryptKey(raw_tweak_key, &tweak_key);
+
+    constexpr std::size_t sector_size   = 4096;
+    constexpr std::size_t sectors_count = 37;
+
+    std::vector<unsigned char> message(sector_size * sectors_count);
+    std::vector<unsigned char> expected(message.size());
+
+    for (std::size_t idx = 0; idx < message.size(); ++idx)
+    {
+        message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+    }
+
+    //
+    // ECB
+    //
+
+    std::vector<unsigned char> buffer(message);
+
+    ecb_encrypt(&cipher, &encrypt_key, message.data(), expected.data(), message.size());
+    bclib::Mode<bclib::Ecb, Cipher>::Encrypt(encrypt_key, buffer.data(), buffer.data(), buffer.size());
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), expected.size());
+
+    bclib::Mode<bclib::Ecb, Cipher>::Decrypt(decrypt_key, buffer.data(), buffer.data(), buffer.size());
+
+    EXPECT_PRED3(test::details::EqualBlocks, message.data(), buffer.data(), message.size());
+
+    //
+    // CTR (incomplete last block and counter overflow of the right half)
+    //
+
+    constexpr std::size_t ctr_length = 1000 * KUZNYECHIK_BLOCK_SIZE + 5;
+
+    ctr_encrypt(&cipher, &encrypt_key, iv, ~0ull - 3, message.data(), expected.data(), ctr_length);
+    bclib::Mode<bclib::Ctr, Cipher>::Encrypt(encrypt_key, iv, ~0ull - 3, message.data(), buffer.data(), ctr_length);
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), ctr_length);
+
+    //
+    // XTS (several batches of sectors)
+    //
+
+    using XtsMode = bclib::Mode<bclib::Xts, Cipher>;
+
+    buffer = message;
+
+    xts_encrypt_sectors(&cipher, &encrypt_key, &tweak_key, 1000, sector_size, sectors_count, message.data(), expected.data());
+    EXPECT_TRUE(XtsMode::EncryptSectors(encrypt_key, tweak_key, 1000, sector_size, sectors_count, buffer.data(), buffer.data()));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), expected.size());
+
+    EXPECT_TRUE(XtsMode::DecryptSectors(decrypt_key, tweak_key, 1000, sector_size, sectors_count, buffer.data(), buffer.data()));
+
+    EXPECT_PRED3(test::details::EqualBlocks, message.data(), buffer.data(), message.size());
+}
+
+}  // namespace
+
+
+TEST(FrontEnd, MatchesDispatchTable)
+{
+    //
+    // MUST NOT throw any exception
+    // Results of modes bound to each supported engine at compile time
+    // MUST match results of C procedures
+    //
+
+    CompareWithDispatchTable<KUZNYECHIK_ENGINE_GENERIC>();
+    CompareWithDispatchTable<KUZNYECHIK_ENGINE_AVX2>();
+    CompareWithDispatchTable<KUZNYECHIK_ENGINE_AVX512>();
+    CompareWithDispatchTable<KUZNYECHIK_ENGINE_CONSTANT_TIME>();
+    CompareWithDispatchTable<KUZNYECHIK_ENGINE_COMPACT>();
+}
+
+
+TEST(FrontEnd, SingleBlock)
+{
+    //
+    // MUST NOT throw any exception
+    // Single block procedures of all engines MUST be inverse to each other
+    // and MUST match a multi-block call
+    //
+
+    using Generic = bclib::Cipher<bclib::Kuznyechik, KUZNYECHIK_ENGINE_GENERIC>;
+    using Compact = bclib::Cipher<bclib::Kuznyechik, KUZNYECHIK_ENGINE_COMPACT>;
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+
+    Generic::InitializeEncryptKey(raw_key, &encrypt_key);
+    Generic::InitializeDecryptKey(raw_key, &decrypt_key);
+
+    BCLIB_TESTS_ALIGN16 __m128i block     = _mm_set_epi64x(0x0123456789abcdefll, 0x0f1e2d3c4b5a6978ll);
+    BCLIB_TESTS_ALIGN16 __m128i expected  = {};
+    BCLIB_TESTS_ALIGN16 __m128i encrypted = {};
+    BCLIB_TESTS_ALIGN16 __m128i decrypted = {};
+
+    Generic::EncryptBlocks(&block, &encrypt_key, &expected, 1);
+
+    Compact::EncryptBlock(block, &encrypt_key, &encrypted);
+    Compact::DecryptBlock(encrypted, &decrypt_key, &decrypted);
+
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected),
+                 reinterpret_cast<const unsigned char*>(&encrypted), KUZNYECHIK_BLOCK_SIZE);
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&block),
+                 reinterpret_cast<const unsigned char*>(&decrypted), KUZNYECHIK_BLOCK_SIZE);
+
+    Generic::EncryptBlock(block, &encrypt_key, &encrypted);
+    Generic::DecryptBlock(encrypted, &decrypt_key, &decrypted);
+
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected),
+                 reinterpret_cast<const unsigned char*>(&encrypted), KUZNYECHIK_BLOCK_SIZE);
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&block),
+                 reinterpret_cast<const unsigned char*>(&decrypted), KUZNYECHIK_BLOCK_SIZE);
+}
@@ -0,0 +1,213 @@
+/**
+ * @file instrumentation.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for instrumentation of cipher calls
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+/**
+ * @brief Encrypts some blocks with a specific Kuznyechik engine.
+ */
+void EncryptBlocks(KUZNYECHIK_ENGINE engine, std::size_t blocks_count)
+{
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface_ex(&cipher, engine);
+
+    const std::vector<unsigned char> raw_key(KUZNYECHIK_KEY_SIZE, 0x5a);
+    std::vector<unsigned char> data(blocks_count * KUZNYECHIK_BLOCK_SIZE, 0xa5);
+
+    KEY round_keys = {};
+    cipher.initialize_encrypt_key(raw_key.data(), &round_keys);
+
+    cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(data.data()), &round_keys,
+                          reinterpret_cast<__m128i*>(data.data()), blocks_count);
+}
+
+
+/**
+ * @brief Sums latency histogram.
+ */
+unsigned long long HistogramTotal(const INSTRUMENTATION_COUNTERS& counters)
+{
+    unsigned long long total = 0;
+    for (const auto calls : counters.histogram)
+    {
+        total += calls;
+    }
+
+    return total;
+}
+
+}  // namespace
+
+
+TEST(Instrumentation, ThreadCounters)
+{
+    //
+    // MUST NOT throw any exception
+    // Without instrumentation all counters MUST be zero
+    // Otherwise exactly one call of each kind MUST be recorded,
+    // generic single block procedure (used for tails) MUST NOT
+    // be recorded, histogram MUST account every call
+    //
+
+    instrumentation_reset();
+
+    EncryptBlocks(KUZNYECHIK_ENGINE_GENERIC, 7);
+
+    INSTRUMENTATION_STATISTICS statistics = {};
+    instrumentation_query_thread(&statistics);
+
+    const auto& key_setup = statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_KEY_SETUP];
+    const auto& blocks    = statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS];
+    const auto& block     = statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCK];
+
+    const unsigned long long expected = instrumentation_enabled() ? 1 : 0;
+
+    EXPECT_EQ(key_setup.calls, expected);
+    EXPECT_EQ(key_setup.blocks, expected);
+    EXPECT_EQ(blocks.calls, expected);
+    EXPECT_EQ(blocks.blocks, expected * 7);
+    EXPECT_EQ(HistogramTotal(blocks), blocks.calls);
+    EXPECT_EQ(block.calls, 0ull);
+
+    if (!instrumentation_enabled())
+    {
+        EXPECT_EQ(blocks.cycles, 0ull);
+    }
+}
+
+
+TEST(Instrumentation, NestedEngines)
+{
+    //
+    // MUST NOT throw any exception
+    // Tail of AVX2 engine is processed by generic engine, but only
+    // the outermost call MUST be recorded
+    //
+
+    if (!test::details::CpuSupportsAvx2())
+    {
+        GTEST_SKIP() << "AVX2 is not supported by CPU";
+    }
+
+    instrumentation_reset();
+
+    EncryptBlocks(KUZNYECHIK_ENGINE_AVX2, 5);
+
+    INSTRUMENTATION_STATISTICS statistics = {};
+    instrumentation_query_thread(&statistics);
+
+    const unsigned long long expected = instrumentation_enabled() ? 1 : 0;
+
+    EXPECT_EQ(statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_AVX2][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS].calls, expected);
+    EXPECT_EQ(statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_AVX2][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS].blocks, expected * 5);
+    EXPECT_EQ(statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS].calls, 0ull);
+    EXPECT_EQ(statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCK].calls, 0ull);
+}
+
+
+TEST(Instrumentation, FinishedThreads)
+{
+    //
+    // MUST NOT throw any exception
+    // Counters of finished threads MUST be kept by global query
+    // and MUST NOT be visible in calling thread's counters
+    //
+
+    constexpr std::size_t kThreadsCount = 4;
+
+    instrumentation_reset();
+
+    std::vector<std::thread> threads;
+    for (std::size_t idx = 0; idx < kThreadsCount; ++idx)
+    {
+        threads.emplace_back(EncryptBlocks, KUZNYECHIK_ENGINE_GENERIC, 3);
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    INSTRUMENTATION_STATISTICS statistics = {};
+    instrumentation_query(&statistics);
+
+    const auto& blocks = statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS];
+
+    const unsigned long long expected = instrumentation_enabled() ? kThreadsCount : 0;
+
+    EXPECT_EQ(blocks.calls, expected);
+    EXPECT_EQ(blocks.blocks, expected * 3);
+
+    instrumentation_query_thread(&statistics);
+
+    EXPECT_EQ(statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS].calls, 0ull);
+}
+
+
+TEST(Instrumentation, ResetRunningThread)
+{
+    //
+    // MUST NOT throw any exception
+    // Reset MUST discard calls of a running thread made before it
+    // and keep calls made after it
+    //
+
+    std::atomic<int> stage{ 0 };
+
+    std::thread thread([&stage]() {
+        for (int idx = 0; idx < 10; ++idx)
+        {
+            EncryptBlocks(KUZNYECHIK_ENGINE_GENERIC, 2);
+        }
+
+        stage = 1;
+
+        while (stage != 2)
+        {
+            std::this_thread::yield();
+        }
+
+        for (int idx = 0; idx < 5; ++idx)
+        {
+            EncryptBlocks(KUZNYECHIK_ENGINE_GENERIC, 2);
+        }
+
+        INSTRUMENTATION_STATISTICS statistics = {};
+        instrumentation_query_thread(&statistics);
+
+        EXPECT_EQ(statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS].calls,
+                  instrumentation_enabled() ? 5ull : 0ull);
+    });
+
+    while (stage != 1)
+    {
+        std::this_thread::yield();
+    }
+
+    instrumentation_reset();
+    stage = 2;
+
+    thread.join();
+
+    INSTRUMENTATION_STATISTICS statistics = {};
+    instrumentation_query(&statistics);
+
+    const auto& blocks = statistics.counters[INSTRUMENTATION_ENGINE_KUZNYECHIK_GENERIC][INSTRUMENTATION_EVENT_ENCRYPT_BLOCKS];
+
+    EXPECT_EQ(blocks.calls, instrumentation_enabled() ? 5ull : 0ull);
+    EXPECT_EQ(blocks.blocks, instrumentation_enabled() ? 10ull : 0ull);
+    EXPECT_EQ(HistogramTotal(blocks), blocks.calls);
+}
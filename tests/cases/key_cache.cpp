@@ -0,0 +1,170 @@
+/**
+ * @file key_cache.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for key schedules cache
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+/**
+ * @brief Generates a distinct raw key for an identifier.
+ */
+std::vector<unsigned char> MakeKey(unsigned long long key_id)
+{
+    std::vector<unsigned char> raw_key(KUZNYECHIK_KEY_SIZE);
+    for (std::size_t idx = 0; idx < raw_key.size(); ++idx)
+    {
+        raw_key[idx] = static_cast<unsigned char>(key_id * 37 + idx);
+    }
+
+    return raw_key;
+}
+
+}  // namespace
+
+
+TEST(KeyCache, HitAndMiss)
+{
+    //
+    // MUST NOT throw any exception
+    // First access MUST miss, second one MUST hit
+    // Cached schedules MUST be equal to freshly expanded ones
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    std::vector<KEY_CACHE_SET> sets(KEY_CACHE_SETS_COUNT(64));
+
+    KEY_CACHE cache = {};
+    key_cache_initialize(&cache, &cipher, sets.data(), sets.size());
+
+    const auto raw_key = MakeKey(42);
+
+    KEY expected_encrypt_key = {};
+    KEY expected_decrypt_key = {};
+    cipher.initialize_keys(raw_key.data(), &expected_encrypt_key, &expected_decrypt_key);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+
+    EXPECT_FALSE(key_cache_lookup(&cache, 42, &encrypt_key, &decrypt_key));
+    EXPECT_FALSE(key_cache_get(&cache, 42, raw_key.data(), &encrypt_key, &decrypt_key));
+    EXPECT_TRUE(key_cache_get(&cache, 42, raw_key.data(), &encrypt_key, &decrypt_key));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_encrypt_key.key, encrypt_key.key, MAX_KEY_SIZE);
+    EXPECT_PRED3(test::details::EqualBlocks, expected_decrypt_key.key, decrypt_key.key, MAX_KEY_SIZE);
+
+    key_cache_remove(&cache, 42);
+    EXPECT_FALSE(key_cache_lookup(&cache, 42, nullptr, nullptr));
+}
+
+
+TEST(KeyCache, Eviction)
+{
+    //
+    // MUST NOT throw any exception
+    // Cache MUST never hold more keys than its capacity
+    // Recently used keys MUST survive eviction
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY_CACHE_SET set = {};
+
+    KEY_CACHE cache = {};
+    key_cache_initialize(&cache, &cipher, &set, 1);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+
+    for (unsigned long long key_id = 0; key_id < KEY_CACHE_WAYS; ++key_id)
+    {
+        key_cache_get(&cache, key_id, MakeKey(key_id).data(), &encrypt_key, &decrypt_key);
+    }
+
+    //
+    // Touch key 0, so key 1 becomes the least recently used one
+    //
+
+    EXPECT_TRUE(key_cache_lookup(&cache, 0, nullptr, nullptr));
+    EXPECT_FALSE(key_cache_get(&cache, 100, MakeKey(100).data(), &encrypt_key, &decrypt_key));
+
+    EXPECT_TRUE(key_cache_lookup(&cache, 0, nullptr, nullptr));
+    EXPECT_FALSE(key_cache_lookup(&cache, 1, nullptr, nullptr));
+    EXPECT_TRUE(key_cache_lookup(&cache, 100, nullptr, nullptr));
+
+    key_cache_clear(&cache);
+
+    for (unsigned long long key_id = 0; key_id <= 100; ++key_id)
+    {
+        EXPECT_FALSE(key_cache_lookup(&cache, key_id, nullptr, nullptr));
+    }
+}
+
+
+TEST(KeyCache, Concurrent)
+{
+    //
+    // MUST NOT throw any exception
+    // Concurrent accesses MUST always return schedules of requested key
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    std::vector<KEY_CACHE_SET> sets(KEY_CACHE_SETS_COUNT(16));
+
+    KEY_CACHE cache = {};
+    key_cache_initialize(&cache, &cipher, sets.data(), sets.size());
+
+    constexpr unsigned long long keys_count = 64;
+
+    std::vector<KEY> expected_keys(keys_count);
+    for (unsigned long long key_id = 0; key_id < keys_count; ++key_id)
+    {
+        cipher.initialize_encrypt_key(MakeKey(key_id).data(), &expected_keys[key_id]);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4);
+
+    for (std::size_t thread = 0; thread < mismatches.size(); ++thread)
+    {
+        threads.emplace_back([&, thread]() {
+            KEY encrypt_key = {};
+            KEY decrypt_key = {};
+
+            for (unsigned long long idx = 0; idx < 2000; ++idx)
+            {
+                const unsigned long long key_id = (idx * 7 + thread * 13) % keys_count;
+                key_cache_get(&cache, key_id, MakeKey(key_id).data(), &encrypt_key, &decrypt_key);
+
+                if (!test::details::EqualBlocks(expected_keys[key_id].key, encrypt_key.key, MAX_KEY_SIZE))
+                {
+                    ++mismatches[thread];
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto mismatches_count : mismatches)
+    {
+        EXPECT_EQ(mismatches_count, 0);
+    }
+}
@@ -9,6 +9,128 @@
 
 #include "tests_common.hpp"
 
+#include <vector>
+
+
+namespace {
+
+/**
+ * @brief Checks that multi-block procedures of an engine match generic ones.
+ */
+void CheckEngine(KUZNYECHIK_ENGINE engine)
+{
+    constexpr unsigned char raw_key[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+
+    BLOCK_CIPHER generic = {};
+    BLOCK_CIPHER cipher  = {};
+    kuznyechik_initialize_interface_ex(&generic, KUZNYECHIK_ENGINE_GENERIC);
+    kuznyechik_initialize_interface_ex(&cipher, engine);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &decrypt_key);
+
+    //
+    // Every number of blocks up to several full batches is checked
+    // to cover both wide and tail paths
+    //
+
+    for (std::size_t blocks_count = 1; blocks_count <= 40; ++blocks_count)
+    {
+        const std::size_t length = blocks_count * KUZNYECHIK_BLOCK_SIZE;
+
+        std::vector<unsigned char> plaintext(length);
+        std::vector<unsigned char> expected(length);
+        std::vector<unsigned char> buffer(length);
+
+        for (std::size_t idx = 0; idx < length; ++idx)
+        {
+            plaintext[idx] = static_cast<unsigned char>(idx * 29 + blocks_count);
+        }
+
+        generic.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &encrypt_key,
+                               reinterpret_cast<__m128i*>(expected.data()), blocks_count);
+
+        cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &encrypt_key,
+                              reinterpret_cast<__m128i*>(buffer.data()), blocks_count);
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), length);
+
+        cipher.decrypt_blocks(reinterpret_cast<const __m128i*>(buffer.data()), &decrypt_key,
+                              reinterpret_cast<__m128i*>(buffer.data()), blocks_count);
+
+        EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), buffer.data(), length);
+    }
+}
+
+
+/**
+ * @brief Checks that key schedules of an engine match generic ones.
+ */
+void CheckKeySetup(KUZNYECHIK_ENGINE engine)
+{
+    constexpr std::size_t keys_count      = 37;
+    constexpr std::size_t round_keys_size = 10 * KUZNYECHIK_BLOCK_SIZE;
+
+    BLOCK_CIPHER generic = {};
+    BLOCK_CIPHER cipher  = {};
+    kuznyechik_initialize_interface_ex(&generic, KUZNYECHIK_ENGINE_GENERIC);
+    kuznyechik_initialize_interface_ex(&cipher, engine);
+
+    std::vector<unsigned char> raw_keys(keys_count * KUZNYECHIK_KEY_SIZE);
+
+    for (std::size_t idx = 0; idx < raw_keys.size(); ++idx)
+    {
+        raw_keys[idx] = static_cast<unsigned char>(idx * 151 + 17);
+    }
+
+    std::vector<KEY> expected_encrypt_keys(keys_count);
+    std::vector<KEY> expected_decrypt_keys(keys_count);
+    std::vector<KEY> encrypt_keys(keys_count);
+    std::vector<KEY> decrypt_keys(keys_count);
+
+    generic.initialize_keys_batch(raw_keys.data(), expected_encrypt_keys.data(), expected_decrypt_keys.data(), keys_count);
+    cipher.initialize_keys_batch(raw_keys.data(), encrypt_keys.data(), decrypt_keys.data(), keys_count);
+
+    for (std::size_t idx = 0; idx < keys_count; ++idx)
+    {
+        EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected_encrypt_keys[idx]),
+                     reinterpret_cast<const unsigned char*>(&encrypt_keys[idx]), round_keys_size);
+        EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected_decrypt_keys[idx]),
+                     reinterpret_cast<const unsigned char*>(&decrypt_keys[idx]), round_keys_size);
+    }
+
+    //
+    // Single key procedures MUST produce the same schedules
+    //
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+
+    cipher.initialize_encrypt_key(raw_keys.data(), &encrypt_key);
+    cipher.initialize_decrypt_key(raw_keys.data(), &decrypt_key);
+
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected_encrypt_keys[0]),
+                 reinterpret_cast<const unsigned char*>(&encrypt_key), round_keys_size);
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected_decrypt_keys[0]),
+                 reinterpret_cast<const unsigned char*>(&decrypt_key), round_keys_size);
+
+    cipher.initialize_keys(raw_keys.data() + KUZNYECHIK_KEY_SIZE, &encrypt_key, &decrypt_key);
+
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected_encrypt_keys[1]),
+                 reinterpret_cast<const unsigned char*>(&encrypt_key), round_keys_size);
+    EXPECT_PRED3(test::details::EqualBlocks, reinterpret_cast<const unsigned char*>(&expected_decrypt_keys[1]),
+                 reinterpret_cast<const unsigned char*>(&decrypt_key), round_keys_size);
+}
+
+}  // namespace
+
 
 TEST(Kuznyechik, Initialize)
 {
@@ -24,8 +146,90 @@ TEST(Kuznyechik, Initialize)
     EXPECT_EQ(cipher.key_size, KUZNYECHIK_KEY_SIZE);
     EXPECT_NE(cipher.encrypt_block, nullptr);
     EXPECT_NE(cipher.decrypt_block, nullptr);
+    EXPECT_NE(cipher.encrypt_blocks, nullptr);
+    EXPECT_NE(cipher.decrypt_blocks, nullptr);
     EXPECT_NE(cipher.initialize_encrypt_key, nullptr);
     EXPECT_NE(cipher.initialize_decrypt_key, nullptr);
+    EXPECT_NE(cipher.initialize_keys, nullptr);
+    EXPECT_NE(cipher.initialize_keys_batch, nullptr);
+}
+
+
+TEST(Kuznyechik, InitializeKeys)
+{
+    //
+    // MUST NOT throw any exception
+    // Round keys MUST match an expected test vector (A.2.4 of GOST 34.12-2018)
+    // Single expansion MUST produce the same schedules as separate ones
+    //
+
+    constexpr unsigned char raw_key[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+
+    constexpr unsigned char expected_round_keys[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+        0xdb, 0x31, 0x48, 0x53, 0x15, 0x69, 0x43, 0x43, 0x22, 0x8d, 0x6a, 0xef, 0x8c, 0xc7, 0x8c, 0x44,
+        0x3d, 0x45, 0x53, 0xd8, 0xe9, 0xcf, 0xec, 0x68, 0x15, 0xeb, 0xad, 0xc4, 0x0a, 0x9f, 0xfd, 0x04,
+        0x57, 0x64, 0x64, 0x68, 0xc4, 0x4a, 0x5e, 0x28, 0xd3, 0xe5, 0x92, 0x46, 0xf4, 0x29, 0xf1, 0xac,
+        0xbd, 0x07, 0x94, 0x35, 0x16, 0x5c, 0x64, 0x32, 0xb5, 0x32, 0xe8, 0x28, 0x34, 0xda, 0x58, 0x1b,
+        0x51, 0xe6, 0x40, 0x75, 0x7e, 0x87, 0x45, 0xde, 0x70, 0x57, 0x27, 0x26, 0x5a, 0x00, 0x98, 0xb1,
+        0x5a, 0x79, 0x25, 0x01, 0x7b, 0x9f, 0xdd, 0x3e, 0xd7, 0x2a, 0x91, 0xa2, 0x22, 0x86, 0xf9, 0x84,
+        0xbb, 0x44, 0xe2, 0x53, 0x78, 0xc7, 0x31, 0x23, 0xa5, 0xf3, 0x2f, 0x73, 0xcd, 0xb6, 0xe5, 0x17,
+        0x72, 0xe9, 0xdd, 0x74, 0x16, 0xbc, 0xf4, 0x5b, 0x75, 0x5d, 0xba, 0xa8, 0x8e, 0x4a, 0x40, 0x43
+    };
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key          = {};
+    KEY decrypt_key          = {};
+    KEY expected_decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &expected_decrypt_key);
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_round_keys, encrypt_key.key, sizeof(expected_round_keys));
+    EXPECT_PRED3(test::details::EqualBlocks, expected_decrypt_key.key, decrypt_key.key, sizeof(expected_round_keys));
+}
+
+
+TEST(Kuznyechik, InitializeKeysBatch)
+{
+    //
+    // MUST NOT throw any exception
+    // Batch expansion MUST produce the same schedules as single ones
+    // (count is chosen to cover both interleaved and tail paths)
+    //
+
+    constexpr std::size_t keys_count = 11;
+
+    std::vector<unsigned char> raw_keys(keys_count * KUZNYECHIK_KEY_SIZE);
+    for (std::size_t idx = 0; idx < raw_keys.size(); ++idx)
+    {
+        raw_keys[idx] = static_cast<unsigned char>(idx * 131 + 7);
+    }
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    std::vector<KEY> encrypt_keys(keys_count);
+    std::vector<KEY> decrypt_keys(keys_count);
+    cipher.initialize_keys_batch(raw_keys.data(), encrypt_keys.data(), decrypt_keys.data(), keys_count);
+
+    for (std::size_t idx = 0; idx < keys_count; ++idx)
+    {
+        KEY expected_encrypt_key = {};
+        KEY expected_decrypt_key = {};
+        cipher.initialize_encrypt_key(raw_keys.data() + idx * KUZNYECHIK_KEY_SIZE, &expected_encrypt_key);
+        cipher.initialize_decrypt_key(raw_keys.data() + idx * KUZNYECHIK_KEY_SIZE, &expected_decrypt_key);
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected_encrypt_key.key, encrypt_keys[idx].key, 10 * KUZNYECHIK_BLOCK_SIZE);
+        EXPECT_PRED3(test::details::EqualBlocks, expected_decrypt_key.key, decrypt_keys[idx].key, 10 * KUZNYECHIK_BLOCK_SIZE);
+    }
 }
 
 
@@ -110,4 +314,302 @@ TEST(Kuznyechik, Decrypt)
                          &key, reinterpret_cast<__m128i*>(plaintext));
 
     EXPECT_PRED3(test::details::EqualBlocks, expected_plaintext, plaintext, KUZNYECHIK_BLOCK_SIZE);
-}
\ No newline at end of file
+}
+
+
+TEST(Kuznyechik, EncryptBlocks)
+{
+    //
+    // MUST NOT throw any exception
+    // Each block MUST be encrypted exactly as with single block encryption
+    // (number of blocks is not a multiple of interleaving factor intentionally)
+    //
+
+    constexpr unsigned char raw_key[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+
+    constexpr std::size_t blocks_count = 11;
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    BCLIB_TESTS_ALIGN16 unsigned char plaintext[blocks_count * KUZNYECHIK_BLOCK_SIZE];
+    BCLIB_TESTS_ALIGN16 unsigned char ciphertext[blocks_count * KUZNYECHIK_BLOCK_SIZE];
+    BCLIB_TESTS_ALIGN16 unsigned char expected_ciphertext[blocks_count * KUZNYECHIK_BLOCK_SIZE];
+
+    for (std::size_t idx = 0; idx < sizeof(plaintext); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 7 + 3);
+    }
+
+    for (std::size_t idx = 0; idx < blocks_count; ++idx)
+    {
+        cipher.encrypt_block(reinterpret_cast<const __m128i*>(plaintext)[idx],
+                             &key, reinterpret_cast<__m128i*>(expected_ciphertext) + idx);
+    }
+
+    cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext), &key,
+                          reinterpret_cast<__m128i*>(ciphertext), blocks_count);
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_ciphertext, ciphertext, sizeof(ciphertext));
+
+    //
+    // In-place encryption MUST produce the same result
+    //
+
+    cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext), &key,
+                          reinterpret_cast<__m128i*>(plaintext), blocks_count);
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_ciphertext, plaintext, sizeof(plaintext));
+}
+
+
+TEST(Kuznyechik, DecryptBlocks)
+{
+    //
+    // MUST NOT throw any exception
+    // Decrypted blocks MUST match the original ones
+    //
+
+    constexpr unsigned char raw_key[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+
+    constexpr std::size_t blocks_count = 11;
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &decrypt_key);
+
+    BCLIB_TESTS_ALIGN16 unsigned char plaintext[blocks_count * KUZNYECHIK_BLOCK_SIZE];
+    BCLIB_TESTS_ALIGN16 unsigned char buffer[blocks_count * KUZNYECHIK_BLOCK_SIZE];
+
+    for (std::size_t idx = 0; idx < sizeof(plaintext); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 13 + 1);
+    }
+
+    cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext), &encrypt_key,
+                          reinterpret_cast<__m128i*>(buffer), blocks_count);
+
+    cipher.decrypt_blocks(reinterpret_cast<const __m128i*>(buffer), &decrypt_key,
+                          reinterpret_cast<__m128i*>(buffer), blocks_count);
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, sizeof(buffer));
+}
+
+
+TEST(Kuznyechik, EngineAvx2)
+{
+    //
+    // MUST NOT throw any exception
+    // AVX2 engine MUST produce the same results as generic one
+    //
+
+    if (!test::details::CpuSupportsAvx2())
+    {
+        GTEST_SKIP() << "AVX2 is not supported by CPU";
+    }
+
+    CheckEngine(KUZNYECHIK_ENGINE_AVX2);
+}
+
+
+TEST(Kuznyechik, EngineAvx512)
+{
+    //
+    // MUST NOT throw any exception
+    // AVX-512 engine MUST produce the same results as generic one
+    //
+
+    if (!test::details::CpuSupportsAvx512Gfni())
+    {
+        GTEST_SKIP() << "AVX-512 or GFNI is not supported by CPU";
+    }
+
+    CheckEngine(KUZNYECHIK_ENGINE_AVX512);
+}
+
+
+TEST(Kuznyechik, EngineConstantTime)
+{
+    //
+    // MUST NOT throw any exception
+    // Constant-time engine MUST produce the same results as generic one
+    // (both single block and multi-block procedures)
+    //
+
+    if (!test::details::CpuSupportsAvx2())
+    {
+        GTEST_SKIP() << "AVX2 is not supported by CPU";
+    }
+
+    CheckEngine(KUZNYECHIK_ENGINE_CONSTANT_TIME);
+
+    BCLIB_TESTS_ALIGN16 constexpr unsigned char plaintext[] = {
+        0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00,
+        0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88
+    };
+
+    constexpr unsigned char raw_key[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+
+    constexpr unsigned char expected_ciphertext[] = {
+        0x7f, 0x67, 0x9d, 0x90, 0xbe, 0xbc, 0x24, 0x30,
+        0x5a, 0x46, 0x8d, 0x42, 0xb9, 0xd4, 0xed, 0xcd
+    };
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface_ex(&cipher, KUZNYECHIK_ENGINE_CONSTANT_TIME);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &decrypt_key);
+
+    BCLIB_TESTS_ALIGN16 unsigned char buffer[KUZNYECHIK_BLOCK_SIZE] = {};
+
+    cipher.encrypt_block(*reinterpret_cast<const __m128i*>(plaintext),
+                         &encrypt_key, reinterpret_cast<__m128i*>(buffer));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_ciphertext, buffer, KUZNYECHIK_BLOCK_SIZE);
+
+    cipher.decrypt_block(*reinterpret_cast<const __m128i*>(buffer),
+                         &decrypt_key, reinterpret_cast<__m128i*>(buffer));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, KUZNYECHIK_BLOCK_SIZE);
+}
+
+
+TEST(Kuznyechik, ConstantTimeKeySetup)
+{
+    //
+    // MUST NOT throw any exception
+    // Key schedules of constant-time engine MUST match generic ones
+    // (number of keys is larger than a single sliced batch intentionally)
+    //
+
+    if (!test::details::CpuSupportsAvx2())
+    {
+        GTEST_SKIP() << "AVX2 is not supported by CPU";
+    }
+
+    CheckKeySetup(KUZNYECHIK_ENGINE_CONSTANT_TIME);
+}
+
+
+TEST(Kuznyechik, EngineCompact)
+{
+    //
+    // MUST NOT throw any exception
+    // Compact engine MUST produce the same results as generic one
+    // (single block, multi-block and key setup procedures)
+    //
+
+    CheckEngine(KUZNYECHIK_ENGINE_COMPACT);
+    CheckKeySetup(KUZNYECHIK_ENGINE_COMPACT);
+
+    BCLIB_TESTS_ALIGN16 constexpr unsigned char plaintext[] = {
+        0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00,
+        0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88
+    };
+
+    constexpr unsigned char raw_key[] = {
+        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+    };
+
+    constexpr unsigned char expected_ciphertext[] = {
+        0x7f, 0x67, 0x9d, 0x90, 0xbe, 0xbc, 0x24, 0x30,
+        0x5a, 0x46, 0x8d, 0x42, 0xb9, 0xd4, 0xed, 0xcd
+    };
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface_ex(&cipher, KUZNYECHIK_ENGINE_COMPACT);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_encrypt_key(raw_key, &encrypt_key);
+    cipher.initialize_decrypt_key(raw_key, &decrypt_key);
+
+    BCLIB_TESTS_ALIGN16 unsigned char buffer[KUZNYECHIK_BLOCK_SIZE] = {};
+
+    cipher.encrypt_block(*reinterpret_cast<const __m128i*>(plaintext),
+                         &encrypt_key, reinterpret_cast<__m128i*>(buffer));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_ciphertext, buffer, KUZNYECHIK_BLOCK_SIZE);
+
+    cipher.decrypt_block(*reinterpret_cast<const __m128i*>(buffer),
+                         &decrypt_key, reinterpret_cast<__m128i*>(buffer));
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, KUZNYECHIK_BLOCK_SIZE);
+}
+
+
+TEST(Kuznyechik, SelectEngine)
+{
+    //
+    // MUST NOT throw any exception
+    // Selected engine MUST be supported by CPU and MUST NOT be slower, than AVX2 one
+    //
+
+    test::details::SetEnvironment(KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE, nullptr);
+
+    const auto engine = kuznyechik_select_engine();
+    EXPECT_TRUE(kuznyechik_engine_supported(engine));
+
+    if (kuznyechik_engine_supported(KUZNYECHIK_ENGINE_AVX512))
+    {
+        EXPECT_EQ(engine, KUZNYECHIK_ENGINE_AVX512);
+    }
+    else if (kuznyechik_engine_supported(KUZNYECHIK_ENGINE_AVX2))
+    {
+        EXPECT_EQ(engine, KUZNYECHIK_ENGINE_AVX2);
+    }
+    else
+    {
+        EXPECT_EQ(engine, KUZNYECHIK_ENGINE_GENERIC);
+    }
+}
+
+
+TEST(Kuznyechik, SelectEngineForced)
+{
+    //
+    // MUST NOT throw any exception
+    // Engine forced with environment variable MUST be selected
+    // Unknown engine names MUST be ignored
+    //
+
+    test::details::SetEnvironment(KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE, "compact");
+    EXPECT_EQ(kuznyechik_select_engine(), KUZNYECHIK_ENGINE_COMPACT);
+
+    test::details::SetEnvironment(KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE, "generic");
+    EXPECT_EQ(kuznyechik_select_engine(), KUZNYECHIK_ENGINE_GENERIC);
+
+    test::details::SetEnvironment(KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE, "unknown");
+    const auto engine = kuznyechik_select_engine();
+
+    test::details::SetEnvironment(KUZNYECHIK_ENGINE_ENVIRONMENT_VARIABLE, nullptr);
+    EXPECT_EQ(engine, kuznyechik_select_engine());
+}
@@ -0,0 +1,229 @@
+/**
+ * @file kuznyechik_numa.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for NUMA node local replicas of Kuznyechik lookup tables
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+
+/**
+ * @brief Checks that an interface bound to a node matches the default one.
+ */
+void CheckNode(KUZNYECHIK_ENGINE engine, unsigned int node)
+{
+    constexpr std::size_t kBlocksCount = 37;
+    constexpr std::size_t kLength      = kBlocksCount * KUZNYECHIK_BLOCK_SIZE;
+
+    BLOCK_CIPHER reference = {};
+    BLOCK_CIPHER cipher    = {};
+    kuznyechik_initialize_interface_ex(&reference, engine);
+    kuznyechik_numa_initialize_interface(&cipher, engine, node);
+
+    KEY reference_encrypt_key = {};
+    KEY reference_decrypt_key = {};
+    reference.initialize_keys(raw_key, &reference_encrypt_key, &reference_decrypt_key);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+
+    std::vector<unsigned char> plaintext(kLength);
+    std::vector<unsigned char> expected(kLength);
+    std::vector<unsigned char> buffer(kLength);
+
+    for (std::size_t idx = 0; idx < kLength; ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 13 + node);
+    }
+
+    reference.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &reference_encrypt_key,
+                             reinterpret_cast<__m128i*>(expected.data()), kBlocksCount);
+
+    kuznyechik_warm_up(&encrypt_key);
+
+    cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &encrypt_key,
+                          reinterpret_cast<__m128i*>(buffer.data()), kBlocksCount);
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), kLength);
+
+    cipher.decrypt_blocks(reinterpret_cast<const __m128i*>(buffer.data()), &decrypt_key,
+                          reinterpret_cast<__m128i*>(buffer.data()), kBlocksCount);
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), buffer.data(), kLength);
+
+    BCLIB_TESTS_ALIGN16 unsigned char block[KUZNYECHIK_BLOCK_SIZE] = {};
+    cipher.encrypt_block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(plaintext.data())), &encrypt_key,
+                         reinterpret_cast<__m128i*>(block));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected.data(), block, KUZNYECHIK_BLOCK_SIZE);
+}
+
+}  // namespace
+
+
+TEST(KuznyechikNuma, Replicas)
+{
+    //
+    // MUST NOT throw any exception
+    // At least one replica MUST be created, repeated creation MUST NOT change anything
+    // Interfaces bound to any node (even without replica) MUST match the default one
+    //
+
+    const unsigned int replicas_count = kuznyechik_numa_create_replicas();
+
+    EXPECT_GE(replicas_count, 1u);
+    EXPECT_EQ(kuznyechik_numa_create_replicas(), replicas_count);
+    EXPECT_LT(kuznyechik_numa_current_node(), 1024u);
+
+    for (unsigned int node = 0; node <= KUZNYECHIK_NUMA_MAX_NODES; ++node)
+    {
+        CheckNode(KUZNYECHIK_ENGINE_GENERIC, node);
+
+        if (test::details::CpuSupportsAvx2())
+        {
+            CheckNode(KUZNYECHIK_ENGINE_AVX2, node);
+        }
+    }
+}
+
+
+TEST(KuznyechikNuma, BindKeys)
+{
+    //
+    // MUST NOT throw any exception
+    // Keys rebound to a replica and batch of bound keys MUST produce 
+    // the same ciphertext as static tables
+    //
+
+    constexpr std::size_t kKeysCount = 6;
+
+    kuznyechik_numa_create_replicas();
+
+    std::vector<unsigned char> raw_keys(kKeysCount * KUZNYECHIK_KEY_SIZE);
+    for (std::size_t idx = 0; idx < raw_keys.size(); ++idx)
+    {
+        raw_keys[idx] = static_cast<unsigned char>(idx * 7 + 1);
+    }
+
+    BLOCK_CIPHER reference = {};
+    BLOCK_CIPHER cipher    = {};
+    kuznyechik_initialize_interface_ex(&reference, KUZNYECHIK_ENGINE_GENERIC);
+    kuznyechik_numa_initialize_interface(&cipher, KUZNYECHIK_ENGINE_GENERIC, kuznyechik_numa_current_node());
+
+    std::vector<KEY> reference_keys(kKeysCount);
+    std::vector<KEY> rebound_keys(kKeysCount);
+    std::vector<KEY> encrypt_keys(kKeysCount);
+    std::vector<KEY> decrypt_keys(kKeysCount);
+
+    reference.initialize_keys_batch(raw_keys.data(), reference_keys.data(), nullptr, kKeysCount);
+    reference.initialize_keys_batch(raw_keys.data(), rebound_keys.data(), nullptr, kKeysCount);
+    cipher.initialize_keys_batch(raw_keys.data(), encrypt_keys.data(), decrypt_keys.data(), kKeysCount);
+
+    kuznyechik_numa_bind_keys(rebound_keys.data(), kKeysCount, kuznyechik_numa_current_node());
+
+    for (std::size_t idx = 0; idx < kKeysCount; ++idx)
+    {
+        BCLIB_TESTS_ALIGN16 unsigned char plaintext[KUZNYECHIK_BLOCK_SIZE] = { static_cast<unsigned char>(idx) };
+        BCLIB_TESTS_ALIGN16 unsigned char expected[KUZNYECHIK_BLOCK_SIZE]  = {};
+        BCLIB_TESTS_ALIGN16 unsigned char rebound[KUZNYECHIK_BLOCK_SIZE]   = {};
+        BCLIB_TESTS_ALIGN16 unsigned char bound[KUZNYECHIK_BLOCK_SIZE]     = {};
+        BCLIB_TESTS_ALIGN16 unsigned char decrypted[KUZNYECHIK_BLOCK_SIZE] = {};
+
+        const __m128i block = *reinterpret_cast<const __m128i*>(plaintext);
+
+        reference.encrypt_block(block, &reference_keys[idx], reinterpret_cast<__m128i*>(expected));
+        cipher.encrypt_block(block, &rebound_keys[idx], reinterpret_cast<__m128i*>(rebound));
+        cipher.encrypt_block(block, &encrypt_keys[idx], reinterpret_cast<__m128i*>(bound));
+        cipher.decrypt_block(*reinterpret_cast<const __m128i*>(bound), &decrypt_keys[idx], reinterpret_cast<__m128i*>(decrypted));
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected, rebound, KUZNYECHIK_BLOCK_SIZE);
+        EXPECT_PRED3(test::details::EqualBlocks, expected, bound, KUZNYECHIK_BLOCK_SIZE);
+        EXPECT_PRED3(test::details::EqualBlocks, plaintext, decrypted, KUZNYECHIK_BLOCK_SIZE);
+    }
+}
+
+
+TEST(KuznyechikNuma, DestroyAndRecreate)
+{
+    //
+    // MUST NOT throw any exception
+    // Replicas MUST be recreated after destruction, keys bound
+    // without replicas MUST use static tables
+    //
+
+    kuznyechik_numa_destroy_replicas();
+
+    EXPECT_FALSE(kuznyechik_numa_huge_pages(0));
+
+    CheckNode(KUZNYECHIK_ENGINE_GENERIC, 0);
+
+    EXPECT_GE(kuznyechik_numa_create_replicas(), 1u);
+
+    CheckNode(KUZNYECHIK_ENGINE_GENERIC, 0);
+}
+
+
+TEST(KuznyechikNuma, ZeroedKey)
+{
+    //
+    // MUST NOT throw any exception
+    // Zeroed key schedule (without tables) MUST use static tables
+    //
+
+    constexpr std::size_t kBlocksCount = 19;
+    constexpr std::size_t kLength      = kBlocksCount * KUZNYECHIK_BLOCK_SIZE;
+
+    for (const auto engine : { KUZNYECHIK_ENGINE_GENERIC, KUZNYECHIK_ENGINE_AVX2 })
+    {
+        if (!kuznyechik_engine_supported(engine))
+        {
+            continue;
+        }
+
+        BLOCK_CIPHER cipher = {};
+        kuznyechik_initialize_interface_ex(&cipher, engine);
+
+        KEY zeroed_key = {};
+        KEY bound_key  = {};
+        kuznyechik_numa_bind_keys(&bound_key, 1, KUZNYECHIK_NUMA_MAX_NODES);
+
+        std::vector<unsigned char> plaintext(kLength);
+        std::vector<unsigned char> expected(kLength);
+        std::vector<unsigned char> buffer(kLength);
+
+        for (std::size_t idx = 0; idx < kLength; ++idx)
+        {
+            plaintext[idx] = static_cast<unsigned char>(idx * 7);
+        }
+
+        cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &bound_key,
+                              reinterpret_cast<__m128i*>(expected.data()), kBlocksCount);
+        cipher.encrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &zeroed_key,
+                              reinterpret_cast<__m128i*>(buffer.data()), kBlocksCount);
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), kLength);
+
+        cipher.decrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &bound_key,
+                              reinterpret_cast<__m128i*>(expected.data()), kBlocksCount);
+        cipher.decrypt_blocks(reinterpret_cast<const __m128i*>(plaintext.data()), &zeroed_key,
+                              reinterpret_cast<__m128i*>(buffer.data()), kBlocksCount);
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected.data(), buffer.data(), kLength);
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file magma.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for Magma cipher
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <cstring>
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A.2 of GOST 34.12-2018 and A.2 of GOST 34.13-2018
+//
+
+constexpr unsigned char raw_key[] = {
+    0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00,
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+    0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+constexpr unsigned char plaintext[] = {
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10
+};
+
+constexpr unsigned char ciphertext[] = {
+    0x4e, 0xe9, 0x01, 0xe5, 0xc2, 0xd8, 0xca, 0x3d
+};
+
+constexpr unsigned char ecb_plaintext[] = {
+    0x92, 0xde, 0xf0, 0x6b, 0x3c, 0x13, 0x0a, 0x59,
+    0xdb, 0x54, 0xc7, 0x04, 0xf8, 0x18, 0x9d, 0x20,
+    0x4a, 0x98, 0xfb, 0x2e, 0x67, 0xa8, 0x02, 0x4c,
+    0x89, 0x12, 0x40, 0x9b, 0x17, 0xb5, 0x7e, 0x41
+};
+
+constexpr unsigned char ecb_ciphertext[] = {
+    0x2b, 0x07, 0x3f, 0x04, 0x94, 0xf3, 0x72, 0xa0,
+    0xde, 0x70, 0xe7, 0x15, 0xd3, 0x55, 0x6e, 0x48,
+    0x11, 0xd8, 0xd9, 0xe9, 0xea, 0xcf, 0xbc, 0x1e,
+    0x7c, 0x68, 0x26, 0x09, 0x96, 0xc6, 0x7e, 0xfb
+};
+
+
+/**
+ * @brief Checks that multi-block procedures of an engine match test vectors
+ *        and single block procedures.
+ */
+void CheckEngine(MAGMA_ENGINE engine)
+{
+    BLOCK_CIPHER64 cipher = {};
+    magma_initialize_interface_ex(&cipher, engine);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    cipher.initialize_keys(raw_key, &encrypt_key, &decrypt_key);
+
+    unsigned long long blocks[4] = {};
+    std::memcpy(blocks, ecb_plaintext, sizeof(blocks));
+
+    cipher.encrypt_blocks(blocks, &encrypt_key, blocks, 4);
+    EXPECT_PRED3(test::details::EqualBlocks, ecb_ciphertext, reinterpret_cast<const unsigned char*>(blocks), sizeof(ecb_ciphertext));
+
+    cipher.decrypt_blocks(blocks, &decrypt_key, blocks, 4);
+    EXPECT_PRED3(test::details::EqualBlocks, ecb_plaintext, reinterpret_cast<const unsigned char*>(blocks), sizeof(ecb_plaintext));
+
+    //
+    // Every number of blocks up to several full batches is checked
+    // to cover both wide and tail paths
+    //
+
+    for (std::size_t blocks_count = 1; blocks_count <= 40; ++blocks_count)
+    {
+        std::vector<unsigned long long> message(blocks_count);
+        std::vector<unsigned long long> expected(blocks_count);
+        std::vector<unsigned long long> buffer(blocks_count);
+
+        for (std::size_t idx = 0; idx < blocks_count; ++idx)
+        {
+            message[idx] = 0x0123456789abcdefull * (idx + 1) + blocks_count;
+            cipher.encrypt_block(message[idx], &encrypt_key, &expected[idx]);
+        }
+
+        cipher.encrypt_blocks(message.data(), &encrypt_key, buffer.data(), blocks_count);
+        EXPECT_EQ(expected, buffer);
+
+        cipher.decrypt_blocks(buffer.data(), &decrypt_key, buffer.data(), blocks_count);
+        EXPECT_EQ(message, buffer);
+    }
+}
+
+}  // namespace
+
+
+TEST(Magma, Initialize)
+{
+    //
+    // MUST NOT throw any exception
+    // MUST initialize all required fields of BLOCK_CIPHER64 structure.
+    //
+
+    BLOCK_CIPHER64 cipher = {};
+    magma_initialize_interface(&cipher);
+
+    EXPECT_EQ(cipher.block_size, MAGMA_BLOCK_SIZE);
+    EXPECT_EQ(cipher.key_size, MAGMA_KEY_SIZE);
+    EXPECT_NE(cipher.encrypt_block, nullptr);
+    EXPECT_NE(cipher.decrypt_block, nullptr);
+    EXPECT_NE(cipher.encrypt_blocks, nullptr);
+    EXPECT_NE(cipher.decrypt_blocks, nullptr);
+    EXPECT_NE(cipher.initialize_encrypt_key, nullptr);
+    EXPECT_NE(cipher.initialize_decrypt_key, nullptr);
+    EXPECT_NE(cipher.initialize_keys, nullptr);
+    EXPECT_NE(cipher.initialize_keys_batch, nullptr);
+}
+
+
+TEST(Magma, Encrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted text MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER64 cipher = {};
+    magma_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned long long block = 0;
+    cipher.encrypt_block(*reinterpret_cast<const unsigned long long*>(plaintext), &key, &block);
+
+    EXPECT_PRED3(test::details::EqualBlocks, ciphertext, reinterpret_cast<const unsigned char*>(&block), MAGMA_BLOCK_SIZE);
+}
+
+
+TEST(Magma, Decrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Decrypted text MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER64 cipher = {};
+    magma_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_decrypt_key(raw_key, &key);
+
+    unsigned long long block = 0;
+    cipher.decrypt_block(*reinterpret_cast<const unsigned long long*>(ciphertext), &key, &block);
+
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, reinterpret_cast<const unsigned char*>(&block), MAGMA_BLOCK_SIZE);
+}
+
+
+TEST(Magma, EngineGeneric)
+{
+    //
+    // MUST NOT throw any exception
+    // Generic engine MUST match test vectors for multiple blocks
+    //
+
+    CheckEngine(MAGMA_ENGINE_GENERIC);
+}
+
+
+TEST(Magma, EngineAvx2)
+{
+    //
+    // MUST NOT throw any exception
+    // AVX2 engine MUST produce the same results as generic one
+    //
+
+    if (!test::details::CpuSupportsAvx2())
+    {
+        GTEST_SKIP() << "AVX2 is not supported by CPU";
+    }
+
+    CheckEngine(MAGMA_ENGINE_AVX2);
+}
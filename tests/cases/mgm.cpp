@@ -0,0 +1,421 @@
+/**
+ * @file mgm.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for MGM authenticated encryption mode
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+
+namespace {
+
+//
+// Test vectors from appendix A of RFC 9058
+//
+
+constexpr unsigned char raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char nonce[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88
+};
+
+constexpr unsigned char aad[] = {
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+    0xea, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05
+};
+
+constexpr unsigned char plaintext[] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a,
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00,
+    0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xee, 0xff, 0x0a, 0x00, 0x11,
+    0xaa, 0xbb, 0xcc
+};
+
+constexpr unsigned char ciphertext[] = {
+    0xa9, 0x75, 0x7b, 0x81, 0x47, 0x95, 0x6e, 0x90, 0x55, 0xb8, 0xa3, 0x3d, 0xe8, 0x9f, 0x42, 0xfc,
+    0x80, 0x75, 0xd2, 0x21, 0x2b, 0xf9, 0xfd, 0x5b, 0xd3, 0xf7, 0x06, 0x9a, 0xad, 0xc1, 0x6b, 0x39,
+    0x49, 0x7a, 0xb1, 0x59, 0x15, 0xa6, 0xba, 0x85, 0x93, 0x6b, 0x5d, 0x0e, 0xa9, 0xf6, 0x85, 0x1c,
+    0xc6, 0x0c, 0x14, 0xd4, 0xd3, 0xf8, 0x83, 0xd0, 0xab, 0x94, 0x42, 0x06, 0x95, 0xc7, 0x6d, 0xeb,
+    0x2c, 0x75, 0x52
+};
+
+constexpr unsigned char tag[] = {
+    0xcf, 0x5d, 0x65, 0x6f, 0x40, 0xc3, 0x4f, 0x5c, 0x46, 0xe8, 0xbb, 0x0e, 0x29, 0xfc, 0xdb, 0x4c
+};
+
+
+/**
+ * @brief Straightforward MGM (one block at a time, bitwise multiplication).
+ */
+void ReferenceMgmTag(const BLOCK_CIPHER& cipher, const KEY& key, const std::vector<unsigned char>& associated,
+                     const std::vector<unsigned char>& encrypted, unsigned char* result)
+{
+    BCLIB_TESTS_ALIGN16 unsigned char z[KUZNYECHIK_BLOCK_SIZE] = {};
+    BCLIB_TESTS_ALIGN16 unsigned char h[KUZNYECHIK_BLOCK_SIZE] = {};
+    BCLIB_TESTS_ALIGN16 unsigned char sum[KUZNYECHIK_BLOCK_SIZE] = {};
+
+    std::memcpy(z, nonce, sizeof(z));
+    z[0] |= 0x80;
+    cipher.encrypt_block(*reinterpret_cast<const __m128i*>(z), &key, reinterpret_cast<__m128i*>(z));
+
+    const auto multiply_accumulate = [&](const unsigned char* data) {
+        cipher.encrypt_block(*reinterpret_cast<const __m128i*>(z), &key, reinterpret_cast<__m128i*>(h));
+
+        //
+        // incr_l
+        //
+
+        for (int idx = KUZNYECHIK_BLOCK_SIZE / 2 - 1; idx >= 0 && !++z[idx]; --idx) { }
+
+        unsigned char product[KUZNYECHIK_BLOCK_SIZE] = {};
+        unsigned char multiplier[KUZNYECHIK_BLOCK_SIZE];
+        std::memcpy(multiplier, h, sizeof(multiplier));
+
+        for (int bit = 0; bit < 128; ++bit)
+        {
+            if (data[KUZNYECHIK_BLOCK_SIZE - 1 - bit / 8] & (1 << (bit % 8)))
+            {
+                for (int idx = 0; idx < KUZNYECHIK_BLOCK_SIZE; ++idx)
+                {
+                    product[idx] ^= multiplier[idx];
+                }
+            }
+
+            const bool carry = multiplier[0] & 0x80;
+
+            for (int idx = 0; idx < KUZNYECHIK_BLOCK_SIZE - 1; ++idx)
+            {
+                multiplier[idx] = static_cast<unsigned char>((multiplier[idx] << 1) | (multiplier[idx + 1] >> 7));
+            }
+
+            multiplier[KUZNYECHIK_BLOCK_SIZE - 1] = static_cast<unsigned char>((multiplier[KUZNYECHIK_BLOCK_SIZE - 1] << 1) ^ (carry ? 0x87 : 0));
+        }
+
+        for (int idx = 0; idx < KUZNYECHIK_BLOCK_SIZE; ++idx)
+        {
+            sum[idx] ^= product[idx];
+        }
+    };
+
+    const auto authenticate = [&](const std::vector<unsigned char>& data) {
+        for (std::size_t offset = 0; offset < data.size(); offset += KUZNYECHIK_BLOCK_SIZE)
+        {
+            unsigned char block[KUZNYECHIK_BLOCK_SIZE] = {};
+            std::memcpy(block, data.data() + offset, std::min<std::size_t>(KUZNYECHIK_BLOCK_SIZE, data.size() - offset));
+
+            multiply_accumulate(block);
+        }
+    };
+
+    authenticate(associated);
+    authenticate(encrypted);
+
+    unsigned char lengths[KUZNYECHIK_BLOCK_SIZE] = {};
+
+    for (int idx = 0; idx < 8; ++idx)
+    {
+        lengths[7 - idx]  = static_cast<unsigned char>((associated.size() * 8) >> (idx * 8));
+        lengths[15 - idx] = static_cast<unsigned char>((encrypted.size() * 8) >> (idx * 8));
+    }
+
+    multiply_accumulate(lengths);
+    cipher.encrypt_block(*reinterpret_cast<const __m128i*>(sum), &key, reinterpret_cast<__m128i*>(sum));
+
+    std::memcpy(result, sum, sizeof(sum));
+}
+
+}  // namespace
+
+
+TEST(Mgm, Encrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Ciphertext and tag MUST match an expected test vector
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(plaintext)] = {};
+    unsigned char computed_tag[MGM_MAX_TAG_SIZE] = {};
+
+    EXPECT_TRUE(mgm_encrypt(&cipher, &key, nonce, aad, sizeof(aad), plaintext, buffer, sizeof(plaintext), computed_tag, sizeof(computed_tag)));
+
+    EXPECT_PRED3(test::details::EqualBlocks, ciphertext, buffer, sizeof(ciphertext));
+    EXPECT_PRED3(test::details::EqualBlocks, tag, computed_tag, sizeof(tag));
+}
+
+
+TEST(Mgm, Decrypt)
+{
+    //
+    // MUST NOT throw any exception
+    // Valid tag MUST be accepted, plaintext MUST match an expected test vector,
+    // truncated tags MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(ciphertext)] = {};
+
+    EXPECT_TRUE(mgm_decrypt(&cipher, &key, nonce, aad, sizeof(aad), ciphertext, buffer, sizeof(ciphertext), tag, sizeof(tag)));
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, sizeof(plaintext));
+
+    EXPECT_TRUE(mgm_decrypt(&cipher, &key, nonce, aad, sizeof(aad), ciphertext, buffer, sizeof(ciphertext), tag, 8));
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext, buffer, sizeof(plaintext));
+}
+
+
+TEST(Mgm, Tampered)
+{
+    //
+    // MUST NOT throw any exception
+    // Modification of ciphertext, associated data or tag MUST be detected,
+    // output MUST be wiped in this case
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char modified_ciphertext[sizeof(ciphertext)];
+    unsigned char modified_aad[sizeof(aad)];
+    unsigned char modified_tag[sizeof(tag)];
+    unsigned char buffer[sizeof(ciphertext)];
+
+    const unsigned char zeros[sizeof(ciphertext)] = {};
+
+    std::memcpy(modified_ciphertext, ciphertext, sizeof(ciphertext));
+    modified_ciphertext[sizeof(ciphertext) - 1] ^= 1;
+
+    EXPECT_FALSE(mgm_decrypt(&cipher, &key, nonce, aad, sizeof(aad), modified_ciphertext, buffer, sizeof(buffer), tag, sizeof(tag)));
+    EXPECT_PRED3(test::details::EqualBlocks, zeros, buffer, sizeof(buffer));
+
+    std::memcpy(modified_aad, aad, sizeof(aad));
+    modified_aad[0] ^= 0x80;
+
+    EXPECT_FALSE(mgm_decrypt(&cipher, &key, nonce, modified_aad, sizeof(aad), ciphertext, buffer, sizeof(buffer), tag, sizeof(tag)));
+
+    std::memcpy(modified_tag, tag, sizeof(tag));
+    modified_tag[sizeof(tag) - 1] ^= 1;
+
+    EXPECT_FALSE(mgm_decrypt(&cipher, &key, nonce, aad, sizeof(aad), ciphertext, buffer, sizeof(buffer), modified_tag, sizeof(tag)));
+}
+
+
+TEST(Mgm, InvalidTagSize)
+{
+    //
+    // MUST NOT throw any exception
+    // Empty tags and tags longer than MGM_MAX_TAG_SIZE MUST be rejected
+    // without touching buffers
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    unsigned char buffer[sizeof(ciphertext)] = {};
+    unsigned char long_tag[MGM_MAX_TAG_SIZE + 1] = {};
+
+    const unsigned char zeros[sizeof(ciphertext)] = {};
+
+    EXPECT_FALSE(mgm_encrypt(&cipher, &key, nonce, aad, sizeof(aad), plaintext, buffer, sizeof(plaintext), long_tag, 0));
+    EXPECT_FALSE(mgm_encrypt(&cipher, &key, nonce, aad, sizeof(aad), plaintext, buffer, sizeof(plaintext), long_tag, sizeof(long_tag)));
+    EXPECT_PRED3(test::details::EqualBlocks, zeros, buffer, sizeof(buffer));
+
+    EXPECT_FALSE(mgm_decrypt(&cipher, &key, nonce, aad, sizeof(aad), ciphertext, buffer, sizeof(ciphertext), tag, 0));
+    EXPECT_FALSE(mgm_decrypt(&cipher, &key, nonce, aad, sizeof(aad), ciphertext, buffer, sizeof(ciphertext), long_tag, sizeof(long_tag)));
+    EXPECT_PRED3(test::details::EqualBlocks, zeros, buffer, sizeof(buffer));
+
+    MGM_CONTEXT context;
+
+    mgm_encrypt_init(&context, &cipher, &key, nonce);
+    mgm_update(&context, plaintext, buffer, sizeof(plaintext));
+    EXPECT_FALSE(mgm_encrypt_final(&context, long_tag, 0));
+
+    mgm_decrypt_init(&context, &cipher, &key, nonce);
+    mgm_update_aad(&context, aad, sizeof(aad));
+    mgm_update(&context, ciphertext, buffer, sizeof(ciphertext));
+    EXPECT_FALSE(mgm_decrypt_final(&context, tag, 0));
+
+    mgm_decrypt_init(&context, &cipher, &key, nonce);
+    mgm_update_aad(&context, aad, sizeof(aad));
+    mgm_update(&context, ciphertext, buffer, sizeof(ciphertext));
+    EXPECT_FALSE(mgm_decrypt_final(&context, long_tag, sizeof(long_tag)));
+}
+
+
+TEST(Mgm, LongMessageInPlace)
+{
+    //
+    // MUST NOT throw any exception
+    // Tags of long messages (several batches) MUST match a straightforward
+    // implementation, in-place processing MUST be supported
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    for (const std::size_t length : { std::size_t(0), std::size_t(16), std::size_t(1000), std::size_t(4096) })
+    {
+        std::vector<unsigned char> associated(length / 3 + 5);
+        std::vector<unsigned char> message(length);
+
+        for (std::size_t idx = 0; idx < associated.size(); ++idx)
+        {
+            associated[idx] = static_cast<unsigned char>(idx * 7 + 1);
+        }
+
+        for (std::size_t idx = 0; idx < message.size(); ++idx)
+        {
+            message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+        }
+
+        std::vector<unsigned char> buffer(message);
+
+        unsigned char computed_tag[MGM_MAX_TAG_SIZE] = {};
+        unsigned char expected_tag[MGM_MAX_TAG_SIZE] = {};
+
+        mgm_encrypt(&cipher, &key, nonce, associated.data(), associated.size(), buffer.data(), buffer.data(), buffer.size(), computed_tag, sizeof(computed_tag));
+        ReferenceMgmTag(cipher, key, associated, buffer, expected_tag);
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected_tag, computed_tag, sizeof(computed_tag));
+
+        EXPECT_TRUE(mgm_decrypt(&cipher, &key, nonce, associated.data(), associated.size(), buffer.data(), buffer.data(), buffer.size(), computed_tag, sizeof(computed_tag)));
+        EXPECT_PRED3(test::details::EqualBlocks, message.data(), buffer.data(), message.size());
+    }
+}
+
+
+TEST(Mgm, Stream)
+{
+    //
+    // MUST NOT throw any exception
+    // Processing associated data and message by chunks of arbitrary lengths
+    // MUST match the test vector and processing at once, invalid tag MUST 
+    // be detected
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY key = {};
+    cipher.initialize_encrypt_key(raw_key, &key);
+
+    MGM_CONTEXT context;
+    unsigned char buffer[sizeof(plaintext)] = {};
+    unsigned char computed_tag[MGM_MAX_TAG_SIZE] = {};
+
+    mgm_encrypt_init(&context, &cipher, &key, nonce);
+    mgm_update_aad(&context, aad, 5);
+    mgm_update_aad(&context, aad + 5, 20);
+    mgm_update_aad(&context, aad + 25, sizeof(aad) - 25);
+    mgm_update(&context, plaintext, buffer, 7);
+    mgm_update(&context, plaintext + 7, buffer + 7, 41);
+    mgm_update(&context, plaintext + 48, buffer + 48, sizeof(plaintext) - 48);
+    mgm_encrypt_final(&context, computed_tag, sizeof(computed_tag));
+
+    EXPECT_PRED3(test::details::EqualBlocks, ciphertext, buffer, sizeof(ciphertext));
+    EXPECT_PRED3(test::details::EqualBlocks, tag, computed_tag, sizeof(tag));
+
+    constexpr std::size_t chunks[] = { 1, 15, 0, 16, 17, 3, 100, 31, 2 };
+
+    for (const std::size_t length : { std::size_t(0), std::size_t(16), std::size_t(1000), std::size_t(4096) })
+    {
+        std::vector<unsigned char> associated(length / 3 + 5);
+        std::vector<unsigned char> message(length);
+
+        for (std::size_t idx = 0; idx < associated.size(); ++idx)
+        {
+            associated[idx] = static_cast<unsigned char>(idx * 7 + 1);
+        }
+
+        for (std::size_t idx = 0; idx < message.size(); ++idx)
+        {
+            message[idx] = static_cast<unsigned char>(idx * 3 + 11);
+        }
+
+        std::vector<unsigned char> expected(message.size());
+        std::vector<unsigned char> streamed(message);
+
+        unsigned char expected_tag[MGM_MAX_TAG_SIZE] = {};
+
+        mgm_encrypt(&cipher, &key, nonce, associated.data(), associated.size(), message.data(), expected.data(), message.size(), expected_tag, sizeof(expected_tag));
+
+        mgm_encrypt_init(&context, &cipher, &key, nonce);
+
+        for (std::size_t offset = 0, chunk = 0; offset < associated.size(); ++chunk)
+        {
+            const std::size_t size = std::min(chunks[chunk % std::size(chunks)], associated.size() - offset);
+
+            mgm_update_aad(&context, associated.data() + offset, size);
+            offset += size;
+        }
+
+        for (std::size_t offset = 0, chunk = 3; offset < streamed.size(); ++chunk)
+        {
+            const std::size_t size = std::min(chunks[chunk % std::size(chunks)], streamed.size() - offset);
+
+            mgm_update(&context, streamed.data() + offset, streamed.data() + offset, size);
+            offset += size;
+        }
+
+        mgm_encrypt_final(&context, computed_tag, sizeof(computed_tag));
+
+        EXPECT_PRED3(test::details::EqualBlocks, expected.data(), streamed.data(), expected.size());
+        EXPECT_PRED3(test::details::EqualBlocks, expected_tag, computed_tag, sizeof(computed_tag));
+
+        mgm_decrypt_init(&context, &cipher, &key, nonce);
+        mgm_update_aad(&context, associated.data(), associated.size());
+
+        for (std::size_t offset = 0, chunk = 5; offset < streamed.size(); ++chunk)
+        {
+            const std::size_t size = std::min(chunks[chunk % std::size(chunks)], streamed.size() - offset);
+
+            mgm_update(&context, streamed.data() + offset, streamed.data() + offset, size);
+            offset += size;
+        }
+
+        EXPECT_TRUE(mgm_decrypt_final(&context, expected_tag, sizeof(expected_tag)));
+        EXPECT_PRED3(test::details::EqualBlocks, message.data(), streamed.data(), message.size());
+
+        expected_tag[0] ^= 1;
+
+        mgm_decrypt_init(&context, &cipher, &key, nonce);
+        mgm_update_aad(&context, associated.data(), associated.size());
+        mgm_update(&context, expected.data(), streamed.data(), expected.size());
+
+        EXPECT_FALSE(mgm_decrypt_final(&context, expected_tag, sizeof(expected_tag)));
+    }
+}
@@ -0,0 +1,332 @@
+/**
+ * @file sector.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for sector-addressed encryption
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char data_raw_key[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+//
+// SHA-256 of data key (salt of essiv:sha256)
+//
+
+constexpr unsigned char essiv_raw_key[] = {
+    0x63, 0x0d, 0xcd, 0x29, 0x66, 0xc4, 0x33, 0x66,
+    0x91, 0x12, 0x54, 0x48, 0xbb, 0xb2, 0x5b, 0x4f,
+    0xf4, 0x12, 0xa4, 0x9c, 0x73, 0x2d, 0xb2, 0xc8,
+    0xab, 0xc1, 0xb8, 0x58, 0x1b, 0xd7, 0x10, 0xdd
+};
+
+//
+// aes-cbc-essiv:sha256 (as dm-crypt does), sectors 5 and 6 of 512 bytes, 
+// plaintext bytes are (7 * i + 3) mod 256: the first and the last 32 bytes
+//
+
+constexpr unsigned char essiv_ciphertext_head[] = {
+    0x98, 0xee, 0xca, 0x89, 0x0c, 0x1b, 0x7c, 0x80, 0xc8, 0x7e, 0xed, 0x06, 0x1f, 0xb3, 0xab, 0xc8,
+    0x14, 0x95, 0x15, 0x16, 0x9f, 0x86, 0x02, 0x17, 0xd6, 0xa6, 0x59, 0x43, 0x7a, 0x8c, 0x63, 0xff
+};
+
+constexpr unsigned char essiv_ciphertext_tail[] = {
+    0x3a, 0x6a, 0x9e, 0xb1, 0xb7, 0xd6, 0x7c, 0x2d, 0x9b, 0x9a, 0xd5, 0x18, 0x47, 0xe6, 0x66, 0x3d,
+    0x8a, 0x72, 0x9d, 0xc7, 0x58, 0x59, 0x09, 0x5e, 0xbe, 0xb6, 0x55, 0x56, 0x19, 0xe0, 0xed, 0x14
+};
+
+//
+// XTS-AES-128 test vector 2 from IEEE 1619-2007
+//
+
+constexpr unsigned char xts_data_raw_key[] = {
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11
+};
+
+constexpr unsigned char xts_tweak_raw_key[] = {
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22
+};
+
+constexpr unsigned char xts_ciphertext[] = {
+    0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e, 0x39, 0x33, 0x40, 0x38, 0xac, 0xef, 0x83, 0x8b,
+    0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80, 0xad, 0xc4, 0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0
+};
+
+}  // namespace
+
+
+TEST(Sector, GenerateIvs)
+{
+    //
+    // MUST NOT throw any exception
+    // IVs MUST match dm-crypt ones, IV sectors MUST be counted in 512-byte 
+    // units unless large IV sectors are requested
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    SECTOR_CONTEXT context = {};
+    context.cipher      = &cipher;
+    context.sector_size = 4096;
+
+    unsigned char ivs[2 * SECTOR_IV_SIZE] = {};
+
+    //
+    // Sector 2 of 4096 bytes is IV sector 16 (0x10)
+    //
+
+    constexpr unsigned char plain64[] = {
+        0x10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0x18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+
+    context.iv = SECTOR_IV_PLAIN64;
+    sector_generate_ivs(&context, 2, 2, ivs);
+    EXPECT_PRED3(test::details::EqualBlocks, plain64, ivs, sizeof(ivs));
+
+    constexpr unsigned char plain64be[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x18
+    };
+
+    context.iv = SECTOR_IV_PLAIN64BE;
+    sector_generate_ivs(&context, 2, 2, ivs);
+    EXPECT_PRED3(test::details::EqualBlocks, plain64be, ivs, sizeof(ivs));
+
+    //
+    // benbi: 16 * 32 + 1 = 0x201 and 24 * 32 + 1 = 0x301
+    //
+
+    constexpr unsigned char benbi[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x01,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x03, 0x01
+    };
+
+    context.iv = SECTOR_IV_BENBI;
+    sector_generate_ivs(&context, 2, 2, ivs);
+    EXPECT_PRED3(test::details::EqualBlocks, benbi, ivs, sizeof(ivs));
+
+    constexpr unsigned char plain64_large[] = {
+        0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+
+    context.iv               = SECTOR_IV_PLAIN64;
+    context.large_iv_sectors = 1;
+    sector_generate_ivs(&context, 2, 2, ivs);
+    EXPECT_PRED3(test::details::EqualBlocks, plain64_large, ivs, sizeof(ivs));
+}
+
+
+TEST(Sector, CbcEssiv)
+{
+    //
+    // MUST NOT throw any exception
+    // aes-cbc-essiv:sha256 MUST match dm-crypt compatible ciphertext,
+    // in-place decryption MUST restore plaintext
+    //
+
+    if (!test::details::CpuSupportsAesni())
+    {
+        GTEST_SKIP() << "AES-NI is not supported by CPU";
+    }
+
+    BLOCK_CIPHER cipher = {};
+    ASSERT_TRUE(aes_initialize_interface(&cipher, AES256_KEY_SIZE));
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    KEY essiv_key   = {};
+    cipher.initialize_keys(data_raw_key, &encrypt_key, &decrypt_key);
+    cipher.initialize_encrypt_key(essiv_raw_key, &essiv_key);
+
+    SECTOR_CONTEXT context = {};
+    context.cipher      = &cipher;
+    context.mode        = SECTOR_MODE_CBC;
+    context.iv          = SECTOR_IV_ESSIV;
+    context.sector_size = 512;
+    context.encrypt_key = &encrypt_key;
+    context.decrypt_key = &decrypt_key;
+    context.essiv_key   = &essiv_key;
+
+    std::vector<unsigned char> plaintext(2 * context.sector_size);
+    std::vector<unsigned char> buffer(plaintext.size());
+
+    for (std::size_t idx = 0; idx < plaintext.size(); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 7 + 3);
+    }
+
+    sector_encrypt(&context, 5, 2, plaintext.data(), buffer.data());
+
+    EXPECT_PRED3(test::details::EqualBlocks, essiv_ciphertext_head, buffer.data(), sizeof(essiv_ciphertext_head));
+    EXPECT_PRED3(test::details::EqualBlocks, essiv_ciphertext_tail, buffer.data() + buffer.size() - sizeof(essiv_ciphertext_tail),
+                 sizeof(essiv_ciphertext_tail));
+
+    sector_decrypt(&context, 5, 2, buffer.data(), buffer.data());
+    EXPECT_EQ(plaintext, buffer);
+}
+
+
+TEST(Sector, XtsPlain64)
+{
+    //
+    // MUST NOT throw any exception
+    // xts-plain64 MUST match IEEE 1619 test vector
+    //
+
+    if (!test::details::CpuSupportsAesni())
+    {
+        GTEST_SKIP() << "AES-NI is not supported by CPU";
+    }
+
+    BLOCK_CIPHER cipher = {};
+    ASSERT_TRUE(aes_initialize_interface(&cipher, AES128_KEY_SIZE));
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    KEY tweak_key   = {};
+    cipher.initialize_keys(xts_data_raw_key, &encrypt_key, &decrypt_key);
+    cipher.initialize_encrypt_key(xts_tweak_raw_key, &tweak_key);
+
+    SECTOR_CONTEXT context = {};
+    context.cipher           = &cipher;
+    context.mode             = SECTOR_MODE_XTS;
+    context.iv               = SECTOR_IV_PLAIN64;
+    context.sector_size      = sizeof(xts_ciphertext);
+    context.large_iv_sectors = 1;
+    context.encrypt_key      = &encrypt_key;
+    context.decrypt_key      = &decrypt_key;
+    context.tweak_key        = &tweak_key;
+
+    std::vector<unsigned char> buffer(sizeof(xts_ciphertext), 0x44);
+    sector_encrypt(&context, 0x3333333333ull, 1, buffer.data(), buffer.data());
+
+    EXPECT_PRED3(test::details::EqualBlocks, xts_ciphertext, buffer.data(), sizeof(xts_ciphertext));
+
+    //
+    // The same through explicit IVs
+    //
+
+    unsigned char iv[SECTOR_IV_SIZE] = {};
+    sector_generate_ivs(&context, 0x3333333333ull, 1, iv);
+
+    std::fill(buffer.begin(), buffer.end(), 0x44);
+    xts_encrypt_sectors_ivs(&cipher, &encrypt_key, &tweak_key, iv, context.sector_size, 1, buffer.data(), buffer.data());
+
+    EXPECT_PRED3(test::details::EqualBlocks, xts_ciphertext, buffer.data(), sizeof(xts_ciphertext));
+}
+
+
+TEST(Sector, AllGeneratorsRoundtrip)
+{
+    //
+    // MUST NOT throw any exception
+    // Processing many sectors at once (several IV batches) MUST match 
+    // processing them one by one for every mode and IV generator
+    //
+
+    constexpr std::size_t sector_size   = 1024;
+    constexpr std::size_t sectors_count = 150;
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    KEY tweak_key   = {};
+    KEY essiv_key   = {};
+    cipher.initialize_keys(data_raw_key, &encrypt_key, &decrypt_key);
+    cipher.initialize_encrypt_key(essiv_raw_key, &tweak_key);
+    cipher.initialize_encrypt_key(essiv_raw_key, &essiv_key);
+
+    std::vector<unsigned char> plaintext(sector_size * sectors_count);
+
+    for (std::size_t idx = 0; idx < plaintext.size(); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 29 + 1);
+    }
+
+    for (auto mode : { SECTOR_MODE_XTS, SECTOR_MODE_CBC })
+    {
+        for (auto iv : { SECTOR_IV_PLAIN64, SECTOR_IV_PLAIN64BE, SECTOR_IV_ESSIV, SECTOR_IV_BENBI })
+        {
+            SECTOR_CONTEXT context = {};
+            context.cipher      = &cipher;
+            context.mode        = mode;
+            context.iv          = iv;
+            context.sector_size = sector_size;
+            context.encrypt_key = &encrypt_key;
+            context.decrypt_key = &decrypt_key;
+            context.tweak_key   = &tweak_key;
+            context.essiv_key   = &essiv_key;
+
+            std::vector<unsigned char> expected(plaintext.size());
+            std::vector<unsigned char> buffer = plaintext;
+
+            for (std::size_t sector = 0; sector < sectors_count; ++sector)
+            {
+                sector_encrypt(&context, 1000 + sector, 1, plaintext.data() + sector * sector_size,
+                               expected.data() + sector * sector_size);
+            }
+
+            sector_encrypt(&context, 1000, sectors_count, buffer.data(), buffer.data());
+            EXPECT_EQ(expected, buffer);
+
+            sector_decrypt(&context, 1000, sectors_count, buffer.data(), buffer.data());
+            EXPECT_EQ(plaintext, buffer);
+        }
+    }
+}
+
+
+TEST(Sector, InvalidSectorSize)
+{
+    //
+    // MUST NOT throw any exception
+    // Sectors, which are not whole IV units or larger than XTS_MAX_SECTOR_SIZE,
+    // MUST be rejected without touching data
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY encrypt_key = {};
+    KEY decrypt_key = {};
+    KEY tweak_key   = {};
+    cipher.initialize_keys(data_raw_key, &encrypt_key, &decrypt_key);
+    cipher.initialize_encrypt_key(essiv_raw_key, &tweak_key);
+
+    const std::vector<unsigned char> plaintext(2 * XTS_MAX_SECTOR_SIZE, 0x5a);
+
+    for (const std::size_t sector_size : { std::size_t(0), std::size_t(528), std::size_t(2 * XTS_MAX_SECTOR_SIZE) })
+    {
+        SECTOR_CONTEXT context = {};
+        context.cipher      = &cipher;
+        context.mode        = SECTOR_MODE_XTS;
+        context.iv          = SECTOR_IV_PLAIN64;
+        context.sector_size = sector_size;
+        context.encrypt_key = &encrypt_key;
+        context.decrypt_key = &decrypt_key;
+        context.tweak_key   = &tweak_key;
+
+        auto buffer = plaintext;
+
+        EXPECT_FALSE(sector_encrypt(&context, 0, 1, buffer.data(), buffer.data()));
+        EXPECT_FALSE(sector_decrypt(&context, 0, 1, buffer.data(), buffer.data()));
+        EXPECT_EQ(plaintext, buffer);
+    }
+}
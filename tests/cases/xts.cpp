@@ -0,0 +1,260 @@
+/**
+ * @file xts.cpp
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Test cases for XTS mode of operation
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#include "tests_common.hpp"
+
+#include <cstring>
+#include <vector>
+
+
+namespace {
+
+constexpr unsigned char data_raw_key[] = {
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef
+};
+
+constexpr unsigned char tweak_raw_key[] = {
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+
+/**
+ * @brief Straightforward XTS encryption of a single sector (block by block).
+ */
+void ReferenceEncryptSector(const BLOCK_CIPHER& cipher, const KEY& data_key, const KEY& tweak_key,
+                            unsigned long long sector_number, std::size_t sector_size,
+                            const unsigned char* in, unsigned char* out)
+{
+    BCLIB_TESTS_ALIGN16 unsigned char tweak[16] = {};
+    BCLIB_TESTS_ALIGN16 unsigned char block[16];
+
+    for (std::size_t idx = 0; idx < 8; ++idx)
+    {
+        tweak[idx] = static_cast<unsigned char>(sector_number >> (8 * idx));
+    }
+
+    cipher.encrypt_block(*reinterpret_cast<const __m128i*>(tweak), &tweak_key, reinterpret_cast<__m128i*>(tweak));
+
+    for (std::size_t offset = 0; offset < sector_size; offset += 16)
+    {
+        for (std::size_t idx = 0; idx < 16; ++idx)
+        {
+            block[idx] = in[offset + idx] ^ tweak[idx];
+        }
+
+        cipher.encrypt_block(*reinterpret_cast<const __m128i*>(block), &data_key, reinterpret_cast<__m128i*>(block));
+
+        for (std::size_t idx = 0; idx < 16; ++idx)
+        {
+            out[offset + idx] = block[idx] ^ tweak[idx];
+        }
+
+        //
+        // Multiply tweak by primitive element (little-endian)
+        //
+
+        const unsigned char carry = tweak[15] >> 7;
+
+        for (std::size_t idx = 15; idx > 0; --idx)
+        {
+            tweak[idx] = static_cast<unsigned char>((tweak[idx] << 1) | (tweak[idx - 1] >> 7));
+        }
+
+        tweak[0] = static_cast<unsigned char>((tweak[0] << 1) ^ (carry ? 0x87 : 0x00));
+    }
+}
+
+
+/**
+ * @brief Checks encryption of several sectors against the reference.
+ */
+void CheckEncryptSectors(std::size_t sector_size, std::size_t sectors_count, unsigned long long sector_number)
+{
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY data_key  = {};
+    KEY tweak_key = {};
+    cipher.initialize_encrypt_key(data_raw_key, &data_key);
+    cipher.initialize_encrypt_key(tweak_raw_key, &tweak_key);
+
+    std::vector<unsigned char> plaintext(sector_size * sectors_count);
+    std::vector<unsigned char> ciphertext(plaintext.size());
+    std::vector<unsigned char> expected_ciphertext(plaintext.size());
+
+    for (std::size_t idx = 0; idx < plaintext.size(); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 31 + 7);
+    }
+
+    for (std::size_t sector = 0; sector < sectors_count; ++sector)
+    {
+        ReferenceEncryptSector(cipher, data_key, tweak_key, sector_number + sector, sector_size,
+                               plaintext.data() + sector * sector_size, expected_ciphertext.data() + sector * sector_size);
+    }
+
+    EXPECT_TRUE(xts_encrypt_sectors(&cipher, &data_key, &tweak_key, sector_number, sector_size, sectors_count,
+                                    plaintext.data(), ciphertext.data()));
+
+    EXPECT_PRED3(test::details::EqualBlocks, expected_ciphertext.data(), ciphertext.data(), ciphertext.size());
+}
+
+}  // namespace
+
+
+TEST(Xts, Encrypt512)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted sectors MUST match straightforward XTS implementation
+    //
+
+    CheckEncryptSectors(512, 37, 0x0123456789abcdefull);
+}
+
+
+TEST(Xts, Encrypt4096)
+{
+    //
+    // MUST NOT throw any exception
+    // Encrypted sectors MUST match straightforward XTS implementation
+    //
+
+    CheckEncryptSectors(4096, 3, 0xfffffffffffffffeull);
+}
+
+
+TEST(Xts, InvalidSectorSize)
+{
+    //
+    // MUST NOT throw any exception
+    // Empty sectors, sectors of partial blocks and sectors larger than 
+    // XTS_MAX_SECTOR_SIZE MUST be rejected without touching output
+    //
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY data_key  = {};
+    KEY tweak_key = {};
+    cipher.initialize_keys(data_raw_key, &data_key, &data_key);
+    cipher.initialize_encrypt_key(tweak_raw_key, &tweak_key);
+
+    const std::vector<unsigned char> plaintext(2 * XTS_MAX_SECTOR_SIZE, 0x5a);
+    const std::vector<unsigned char> ivs(XTS_SECTOR_IV_SIZE);
+
+    for (const std::size_t sector_size : { std::size_t(0), std::size_t(520), std::size_t(2 * XTS_MAX_SECTOR_SIZE) })
+    {
+        auto buffer = plaintext;
+
+        EXPECT_FALSE(xts_encrypt_sectors(&cipher, &data_key, &tweak_key, 0, sector_size, 1, buffer.data(), buffer.data()));
+        EXPECT_FALSE(xts_decrypt_sectors(&cipher, &data_key, &tweak_key, 0, sector_size, 1, buffer.data(), buffer.data()));
+        EXPECT_FALSE(xts_encrypt_sectors_ivs(&cipher, &data_key, &tweak_key, ivs.data(), sector_size, 1, buffer.data(), buffer.data()));
+        EXPECT_FALSE(xts_decrypt_sectors_ivs(&cipher, &data_key, &tweak_key, ivs.data(), sector_size, 1, buffer.data(), buffer.data()));
+        EXPECT_EQ(plaintext, buffer);
+    }
+}
+
+
+TEST(Xts, DecryptInPlace)
+{
+    //
+    // MUST NOT throw any exception
+    // In-place decryption of unaligned buffer MUST restore plaintext
+    //
+
+    constexpr std::size_t sector_size   = 512;
+    constexpr std::size_t sectors_count = 5;
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY data_encrypt_key = {};
+    KEY data_decrypt_key = {};
+    KEY tweak_key        = {};
+    cipher.initialize_encrypt_key(data_raw_key, &data_encrypt_key);
+    cipher.initialize_decrypt_key(data_raw_key, &data_decrypt_key);
+    cipher.initialize_encrypt_key(tweak_raw_key, &tweak_key);
+
+    std::vector<unsigned char> plaintext(sector_size * sectors_count);
+    std::vector<unsigned char> buffer(plaintext.size() + 1);
+
+    for (std::size_t idx = 0; idx < plaintext.size(); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 17 + 5);
+    }
+
+    unsigned char* unaligned = buffer.data() + 1;
+    std::memcpy(unaligned, plaintext.data(), plaintext.size());
+
+    xts_encrypt_sectors(&cipher, &data_encrypt_key, &tweak_key, 42, sector_size, sectors_count, unaligned, unaligned);
+    EXPECT_FALSE(test::details::EqualBlocks(plaintext.data(), unaligned, plaintext.size()));
+
+    xts_decrypt_sectors(&cipher, &data_decrypt_key, &tweak_key, 42, sector_size, sectors_count, unaligned, unaligned);
+    EXPECT_PRED3(test::details::EqualBlocks, plaintext.data(), unaligned, plaintext.size());
+}
+
+
+TEST(Xts, Iov)
+{
+    //
+    // MUST NOT throw any exception
+    // Scatter-gather encryption MUST match contiguous one, including sectors
+    // straddling segment boundaries, in-place decryption MUST restore plaintext
+    //
+
+    constexpr std::size_t sector_size   = 512;
+    constexpr std::size_t sectors_count = 7;
+
+    BLOCK_CIPHER cipher = {};
+    kuznyechik_initialize_interface(&cipher);
+
+    KEY data_encrypt_key = {};
+    KEY data_decrypt_key = {};
+    KEY tweak_key        = {};
+    cipher.initialize_keys(data_raw_key, &data_encrypt_key, &data_decrypt_key);
+    cipher.initialize_encrypt_key(tweak_raw_key, &tweak_key);
+
+    std::vector<unsigned char> plaintext(sector_size * sectors_count);
+    std::vector<unsigned char> expected(plaintext.size());
+
+    for (std::size_t idx = 0; idx < plaintext.size(); ++idx)
+    {
+        plaintext[idx] = static_cast<unsigned char>(idx * 17 + 1);
+    }
+
+    xts_encrypt_sectors(&cipher, &data_encrypt_key, &tweak_key, 100, sector_size, sectors_count,
+                        plaintext.data(), expected.data());
+
+    const std::vector<std::vector<std::size_t>> patterns = {
+        { 4096 }, { 1000, 24 }, { 1, 511, 0, 1 }, { 4, 4, 4, 300 }
+    };
+
+    for (const auto& pattern : patterns)
+    {
+        auto in      = plaintext;
+        auto out     = std::vector<unsigned char>(plaintext.size());
+        auto in_iov  = test::details::SplitIntoSegments(in.data(), in.size(), pattern);
+        auto out_iov = test::details::SplitIntoSegments(out.data(), out.size(), { 4096 });
+
+        EXPECT_TRUE(xts_encrypt_sectors_iov(&cipher, &data_encrypt_key, &tweak_key, 100, sector_size, sectors_count,
+                                            in_iov.data(), in_iov.size(), out_iov.data(), out_iov.size()));
+        EXPECT_EQ(expected, out);
+
+        EXPECT_TRUE(xts_decrypt_sectors_iov(&cipher, &data_decrypt_key, &tweak_key, 100, sector_size, sectors_count,
+                                            out_iov.data(), out_iov.size(), in_iov.data(), in_iov.size()));
+        EXPECT_EQ(plaintext, in);
+    }
+}
@@ -10,6 +10,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+#include "bclib.h"
 
 
 namespace test::details {
@@ -43,4 +48,74 @@ inline bool EqualBlocks(const unsigned char* lhs, const unsigned char* rhs, std:
     return true;
 }
 
+
+/**
+ * @brief Checks if CPU supports AVX2.
+ */
+inline bool CpuSupportsAvx2()
+{
+    return cpu_supports(CPU_FEATURE_AVX2);
+}
+
+
+/**
+ * @brief Checks if CPU supports AVX-512 (F, BW, VBMI) and GFNI.
+ */
+inline bool CpuSupportsAvx512Gfni()
+{
+    return cpu_supports(CPU_FEATURE_AVX512F | CPU_FEATURE_AVX512BW | CPU_FEATURE_AVX512VBMI | CPU_FEATURE_GFNI);
+}
+
+
+/**
+ * @brief Checks if CPU supports AES-NI.
+ */
+inline bool CpuSupportsAesni()
+{
+    return aes_engine_supported(AES_ENGINE_AESNI);
+}
+
+
+/**
+ * @brief Checks if CPU supports AVX-512 (F) and VAES.
+ */
+inline bool CpuSupportsAvx512Vaes()
+{
+    return aes_engine_supported(AES_ENGINE_VAES);
+}
+
+
+/**
+ * @brief Sets (or removes, if value is nullptr) an environment variable.
+ */
+inline void SetEnvironment(const char* name, const char* value)
+{
+#if defined(_MSC_VER)
+    _putenv_s(name, value ? value : "");
+#else
+    value ? setenv(name, value, 1) 
+          : unsetenv(name);
+#endif
+}
+
+
+/**
+ * @brief Splits a buffer into scatter-gather segments. Segment lengths are 
+ *        taken from a pattern cyclically, the last segment is truncated.
+ */
+inline std::vector<IOVEC> SplitIntoSegments(unsigned char* data, std::size_t size, const std::vector<std::size_t>& pattern)
+{
+    std::vector<IOVEC> segments;
+
+    for (std::size_t offset = 0, idx = 0; offset < size; ++idx)
+    {
+        const auto length = std::min(pattern[idx % pattern.size()], size - offset);
+
+        segments.push_back(IOVEC{ data + offset, length });
+        offset += length;
+    }
+
+    return segments;
+}
+
 }  // namespace test::details
@@ -0,0 +1,87 @@
+/**
+ * @file async_io.h
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Asynchronous I/O backends of bc-crypt (io_uring and I/O thread)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BC_CRYPT_ASYNC_IO_INCLUDED
+#define BC_CRYPT_ASYNC_IO_INCLUDED
+
+
+#include <stddef.h>
+
+
+/**
+ * @brief I/O operation.
+ */
+typedef enum tagBC_CRYPT_OPERATION
+{
+    BC_CRYPT_READ, /**< Positional read */
+    BC_CRYPT_WRITE /**< Positional write */
+} BC_CRYPT_OPERATION;
+
+
+/**
+ * @brief I/O request. Request memory is owned by caller and must stay
+ *        valid until the request is returned by `wait`.
+ */
+typedef struct tagBC_CRYPT_REQUEST
+{
+    BC_CRYPT_OPERATION operation; /**< Operation */
+    int fd;                       /**< File descriptor */
+    unsigned char* buffer;        /**< Data buffer */
+    size_t length;                /**< Number of bytes to transfer */
+    unsigned long long offset;    /**< Offset in file */
+    long long result;             /**< Number of bytes transferred or negative errno (set on completion) */
+} BC_CRYPT_REQUEST;
+
+
+/**
+ * @brief I/O backend dispatch table.
+ */
+typedef struct tagBC_CRYPT_IO
+{
+    const char* name; /**< Backend name */
+
+    /**
+     * @brief Submits a request.
+     * @return 0 on success or negative errno
+     */
+    int (*submit)(struct tagBC_CRYPT_IO* io, BC_CRYPT_REQUEST* request);
+
+    /**
+     * @brief Waits for completion of any submitted request.
+     * @return Completed request or NULL on failure (errno is set)
+     */
+    BC_CRYPT_REQUEST* (*wait)(struct tagBC_CRYPT_IO* io);
+
+    /**
+     * @brief Destroys backend (all requests must be completed).
+     */
+    void (*destroy)(struct tagBC_CRYPT_IO* io);
+} BC_CRYPT_IO;
+
+
+/**
+ * @brief Creates io_uring backend (system calls are used directly, liburing is not required).
+ * 
+ * @param depth Maximal number of requests in flight
+ * @return Backend or NULL if io_uring is not available
+ */
+BC_CRYPT_IO* bc_crypt_io_uring_create(unsigned int depth);
+
+
+/**
+ * @brief Creates fallback backend: requests are executed with pread/pwrite
+ *        by a dedicated I/O thread, so I/O still overlaps with encryption.
+ * 
+ * @param depth Maximal number of requests in flight
+ * @return Backend or NULL on failure
+ */
+BC_CRYPT_IO* bc_crypt_io_thread_create(unsigned int depth);
+
+
+#endif  // !BC_CRYPT_ASYNC_IO_INCLUDED
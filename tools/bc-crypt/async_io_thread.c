@@ -0,0 +1,247 @@
+/**
+ * @file async_io_thread.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief Fallback I/O backend of bc-crypt (dedicated I/O thread)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "async_io.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+/**
+ * @brief Fixed-size queue of requests.
+ */
+typedef struct tagBC_CRYPTP_QUEUE
+{
+    BC_CRYPT_REQUEST** requests; /**< Ring buffer */
+    size_t capacity;             /**< Capacity of ring buffer */
+    size_t head;                 /**< Index of the first request */
+    size_t count;                /**< Number of requests */
+} BC_CRYPTP_QUEUE;
+
+
+/**
+ * @brief I/O thread backend state.
+ */
+typedef struct tagBC_CRYPTP_THREAD_IO
+{
+    BC_CRYPT_IO io;              /**< Dispatch table (must be the first member) */
+    pthread_t thread;            /**< I/O thread */
+    pthread_mutex_t mutex;       /**< Protects fields below */
+    pthread_cond_t submitted;    /**< Signaled when a request is submitted or on shutdown */
+    pthread_cond_t completed;    /**< Signaled when a request is completed */
+    BC_CRYPTP_QUEUE submissions; /**< Submitted requests */
+    BC_CRYPTP_QUEUE completions; /**< Completed requests */
+    int shutdown;                /**< Non-zero if I/O thread must exit */
+} BC_CRYPTP_THREAD_IO;
+
+
+static void bc_cryptp_queue_push(BC_CRYPTP_QUEUE* queue, BC_CRYPT_REQUEST* request)
+{
+    queue->requests[(queue->head + queue->count++) % queue->capacity] = request;
+}
+
+
+static BC_CRYPT_REQUEST* bc_cryptp_queue_pop(BC_CRYPTP_QUEUE* queue)
+{
+    BC_CRYPT_REQUEST* request = queue->requests[queue->head];
+
+    queue->head = (queue->head + 1) % queue->capacity;
+    --queue->count;
+
+    return request;
+}
+
+
+/**
+ * @brief Executes a request synchronously (short transfers are continued).
+ */
+static void bc_cryptp_execute(BC_CRYPT_REQUEST* request)
+{
+    size_t done = 0;
+    ssize_t result;
+
+    while (done < request->length)
+    {
+        result = (request->operation == BC_CRYPT_READ)
+                     ? pread(request->fd, request->buffer + done, request->length - done, (off_t)(request->offset + done))
+                     : pwrite(request->fd, request->buffer + done, request->length - done, (off_t)(request->offset + done));
+
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (result < 0)
+        {
+            request->result = -errno;
+            return;
+        }
+
+        if (result == 0)
+        {
+            break;
+        }
+
+        done += (size_t)result;
+    }
+
+    request->result = (long long)done;
+}
+
+
+static void* bc_cryptp_io_thread(void* parameter)
+{
+    BC_CRYPTP_THREAD_IO* thread_io = (BC_CRYPTP_THREAD_IO*)parameter;
+    BC_CRYPT_REQUEST* request;
+
+    pthread_mutex_lock(&thread_io->mutex);
+
+    for (;;)
+    {
+        while (!thread_io->shutdown && !thread_io->submissions.count)
+        {
+            pthread_cond_wait(&thread_io->submitted, &thread_io->mutex);
+        }
+
+        if (thread_io->shutdown)
+        {
+            break;
+        }
+
+        request = bc_cryptp_queue_pop(&thread_io->submissions);
+
+        pthread_mutex_unlock(&thread_io->mutex);
+        bc_cryptp_execute(request);
+        pthread_mutex_lock(&thread_io->mutex);
+
+        bc_cryptp_queue_push(&thread_io->completions, request);
+        pthread_cond_signal(&thread_io->completed);
+    }
+
+    pthread_mutex_unlock(&thread_io->mutex);
+
+    return NULL;
+}
+
+
+static int bc_cryptp_thread_submit(BC_CRYPT_IO* io, BC_CRYPT_REQUEST* request)
+{
+    BC_CRYPTP_THREAD_IO* thread_io = (BC_CRYPTP_THREAD_IO*)io;
+    int result                     = 0;
+
+    pthread_mutex_lock(&thread_io->mutex);
+
+    if (thread_io->submissions.count + thread_io->completions.count < thread_io->submissions.capacity)
+    {
+        bc_cryptp_queue_push(&thread_io->submissions, request);
+        pthread_cond_signal(&thread_io->submitted);
+    }
+    else
+    {
+        result = -EBUSY;
+    }
+
+    pthread_mutex_unlock(&thread_io->mutex);
+
+    return result;
+}
+
+
+static BC_CRYPT_REQUEST* bc_cryptp_thread_wait(BC_CRYPT_IO* io)
+{
+    BC_CRYPTP_THREAD_IO* thread_io = (BC_CRYPTP_THREAD_IO*)io;
+    BC_CRYPT_REQUEST* request;
+
+    pthread_mutex_lock(&thread_io->mutex);
+
+    while (!thread_io->completions.count)
+    {
+        pthread_cond_wait(&thread_io->completed, &thread_io->mutex);
+    }
+
+    request = bc_cryptp_queue_pop(&thread_io->completions);
+
+    pthread_mutex_unlock(&thread_io->mutex);
+
+    return request;
+}
+
+
+static void bc_cryptp_thread_destroy(BC_CRYPT_IO* io)
+{
+    BC_CRYPTP_THREAD_IO* thread_io = (BC_CRYPTP_THREAD_IO*)io;
+
+    pthread_mutex_lock(&thread_io->mutex);
+    thread_io->shutdown = 1;
+    pthread_cond_signal(&thread_io->submitted);
+    pthread_mutex_unlock(&thread_io->mutex);
+
+    pthread_join(thread_io->thread, NULL);
+
+    pthread_cond_destroy(&thread_io->completed);
+    pthread_cond_destroy(&thread_io->submitted);
+    pthread_mutex_destroy(&thread_io->mutex);
+
+    free(thread_io->submissions.requests);
+    free(thread_io->completions.requests);
+    free(thread_io);
+}
+
+
+BC_CRYPT_IO* bc_crypt_io_thread_create(unsigned int depth)
+{
+    BC_CRYPTP_THREAD_IO* thread_io;
+
+    thread_io = (BC_CRYPTP_THREAD_IO*)calloc(1, sizeof(BC_CRYPTP_THREAD_IO));
+    if (!thread_io)
+    {
+        return NULL;
+    }
+
+    thread_io->io.name    = "thread";
+    thread_io->io.submit  = bc_cryptp_thread_submit;
+    thread_io->io.wait    = bc_cryptp_thread_wait;
+    thread_io->io.destroy = bc_cryptp_thread_destroy;
+
+    thread_io->submissions.capacity = depth;
+    thread_io->completions.capacity = depth;
+    thread_io->submissions.requests = (BC_CRYPT_REQUEST**)calloc(depth, sizeof(BC_CRYPT_REQUEST*));
+    thread_io->completions.requests = (BC_CRYPT_REQUEST**)calloc(depth, sizeof(BC_CRYPT_REQUEST*));
+
+    if (!thread_io->submissions.requests || !thread_io->completions.requests)
+    {
+        free(thread_io->submissions.requests);
+        free(thread_io->completions.requests);
+        free(thread_io);
+
+        return NULL;
+    }
+
+    pthread_mutex_init(&thread_io->mutex, NULL);
+    pthread_cond_init(&thread_io->submitted, NULL);
+    pthread_cond_init(&thread_io->completed, NULL);
+
+    if (pthread_create(&thread_io->thread, NULL, bc_cryptp_io_thread, thread_io) != 0)
+    {
+        pthread_cond_destroy(&thread_io->completed);
+        pthread_cond_destroy(&thread_io->submitted);
+        pthread_mutex_destroy(&thread_io->mutex);
+
+        free(thread_io->submissions.requests);
+        free(thread_io->completions.requests);
+        free(thread_io);
+
+        return NULL;
+    }
+
+    return &thread_io->io;
+}
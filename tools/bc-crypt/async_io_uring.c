@@ -0,0 +1,250 @@
+/**
+ * @file async_io_uring.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief io_uring backend of bc-crypt (raw system calls)
+ * @date 2023-07-07
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "async_io.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/io_uring.h>
+
+
+/**
+ * @brief io_uring backend state.
+ */
+typedef struct tagBC_CRYPTP_URING
+{
+    BC_CRYPT_IO io;                /**< Dispatch table (must be the first member) */
+    int ring_fd;                   /**< io_uring file descriptor */
+
+    unsigned int* sq_head;         /**< Submission queue head */
+    unsigned int* sq_tail;         /**< Submission queue tail */
+    unsigned int* sq_mask;         /**< Submission queue mask */
+    unsigned int* sq_array;        /**< Submission queue indices */
+    struct io_uring_sqe* sqes;     /**< Submission queue entries */
+
+    unsigned int* cq_head;         /**< Completion queue head */
+    unsigned int* cq_tail;         /**< Completion queue tail */
+    unsigned int* cq_mask;         /**< Completion queue mask */
+    struct io_uring_cqe* cqes;     /**< Completion queue entries */
+
+    void* sq_ring;                 /**< Submission ring mapping */
+    size_t sq_ring_size;           /**< Size of submission ring mapping */
+    void* cq_ring;                 /**< Completion ring mapping (may be equal to sq_ring) */
+    size_t cq_ring_size;           /**< Size of completion ring mapping */
+    size_t sqes_size;              /**< Size of submission entries mapping */
+} BC_CRYPTP_URING;
+
+
+static int bc_cryptp_io_uring_setup(unsigned int entries, struct io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+
+static int bc_cryptp_io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+
+static int bc_cryptp_uring_submit(BC_CRYPT_IO* io, BC_CRYPT_REQUEST* request)
+{
+    BC_CRYPTP_URING* uring = (BC_CRYPTP_URING*)io;
+
+    const unsigned int tail  = *uring->sq_tail;
+    const unsigned int index = tail & *uring->sq_mask;
+
+    struct io_uring_sqe* sqe = uring->sqes + index;
+    int result;
+
+    if (request->length > UINT_MAX)
+    {
+        return -EINVAL;
+    }
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode    = (request->operation == BC_CRYPT_READ) ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd        = request->fd;
+    sqe->addr      = (unsigned long long)(size_t)request->buffer;
+    sqe->len       = (unsigned int)request->length;
+    sqe->off       = request->offset;
+    sqe->user_data = (unsigned long long)(size_t)request;
+
+    uring->sq_array[index] = index;
+
+    //
+    // Entry must be visible to kernel before tail update
+    //
+
+    __atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    do
+    {
+        result = bc_cryptp_io_uring_enter(uring->ring_fd, 1, 0, 0);
+    } while (result < 0 && errno == EINTR);
+
+    return result < 0 ? -errno : 0;
+}
+
+
+static BC_CRYPT_REQUEST* bc_cryptp_uring_wait(BC_CRYPT_IO* io)
+{
+    BC_CRYPTP_URING* uring = (BC_CRYPTP_URING*)io;
+
+    unsigned int head;
+    struct io_uring_cqe* cqe;
+    BC_CRYPT_REQUEST* request;
+    int result;
+
+    for (;;)
+    {
+        head = *uring->cq_head;
+
+        if (head != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE))
+        {
+            cqe = uring->cqes + (head & *uring->cq_mask);
+
+            request         = (BC_CRYPT_REQUEST*)(size_t)cqe->user_data;
+            request->result = cqe->res;
+
+            __atomic_store_n(uring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+            return request;
+        }
+
+        result = bc_cryptp_io_uring_enter(uring->ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+        if (result < 0 && errno != EINTR)
+        {
+            return NULL;
+        }
+    }
+}
+
+
+static void bc_cryptp_uring_destroy(BC_CRYPT_IO* io)
+{
+    BC_CRYPTP_URING* uring = (BC_CRYPTP_URING*)io;
+
+    if (uring->sqes && uring->sqes != MAP_FAILED)
+    {
+        munmap(uring->sqes, uring->sqes_size);
+    }
+
+    if (uring->cq_ring && uring->cq_ring != MAP_FAILED && uring->cq_ring != uring->sq_ring)
+    {
+        munmap(uring->cq_ring, uring->cq_ring_size);
+    }
+
+    if (uring->sq_ring && uring->sq_ring != MAP_FAILED)
+    {
+        munmap(uring->sq_ring, uring->sq_ring_size);
+    }
+
+    if (uring->ring_fd >= 0)
+    {
+        close(uring->ring_fd);
+    }
+
+    free(uring);
+}
+
+
+BC_CRYPT_IO* bc_crypt_io_uring_create(unsigned int depth)
+{
+    struct io_uring_params params;
+    BC_CRYPTP_URING* uring;
+
+    unsigned char* sq_ring;
+    unsigned char* cq_ring;
+
+    uring = (BC_CRYPTP_URING*)calloc(1, sizeof(BC_CRYPTP_URING));
+    if (!uring)
+    {
+        return NULL;
+    }
+
+    uring->io.name    = "io_uring";
+    uring->io.submit  = bc_cryptp_uring_submit;
+    uring->io.wait    = bc_cryptp_uring_wait;
+    uring->io.destroy = bc_cryptp_uring_destroy;
+
+    memset(&params, 0, sizeof(params));
+
+    uring->ring_fd = bc_cryptp_io_uring_setup(depth, &params);
+    if (uring->ring_fd < 0)
+    {
+        free(uring);
+        return NULL;
+    }
+
+    //
+    // Map rings (a single mapping is used by newer kernels)
+    //
+
+    uring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    uring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        uring->sq_ring_size = uring->sq_ring_size > uring->cq_ring_size ? uring->sq_ring_size : uring->cq_ring_size;
+        uring->cq_ring_size = uring->sq_ring_size;
+    }
+
+    uring->sq_ring = mmap(NULL, uring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          uring->ring_fd, IORING_OFF_SQ_RING);
+
+    if (uring->sq_ring == MAP_FAILED)
+    {
+        bc_cryptp_uring_destroy(&uring->io);
+        return NULL;
+    }
+
+    uring->cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP)
+                         ? uring->sq_ring
+                         : mmap(NULL, uring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                uring->ring_fd, IORING_OFF_CQ_RING);
+
+    if (uring->cq_ring == MAP_FAILED)
+    {
+        bc_cryptp_uring_destroy(&uring->io);
+        return NULL;
+    }
+
+    uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes      = (struct io_uring_sqe*)mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                                  uring->ring_fd, IORING_OFF_SQES);
+
+    if (uring->sqes == MAP_FAILED)
+    {
+        bc_cryptp_uring_destroy(&uring->io);
+        return NULL;
+    }
+
+    sq_ring = (unsigned char*)uring->sq_ring;
+    cq_ring = (unsigned char*)uring->cq_ring;
+
+    uring->sq_head  = (unsigned int*)(sq_ring + params.sq_off.head);
+    uring->sq_tail  = (unsigned int*)(sq_ring + params.sq_off.tail);
+    uring->sq_mask  = (unsigned int*)(sq_ring + params.sq_off.ring_mask);
+    uring->sq_array = (unsigned int*)(sq_ring + params.sq_off.array);
+
+    uring->cq_head = (unsigned int*)(cq_ring + params.cq_off.head);
+    uring->cq_tail = (unsigned int*)(cq_ring + params.cq_off.tail);
+    uring->cq_mask = (unsigned int*)(cq_ring + params.cq_off.ring_mask);
+    uring->cqes    = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+    return &uring->io;
+}
@@ -0,0 +1,670 @@
+/**
+ * @file main.c
+ * @author Georgy Firsov (gfirsov007@gmail.com)
+ * @brief bc-crypt: streaming disk image encryption with Kuznyechik-XTS
+ * @date 2023-07-07
+ * 
+ * Image is processed in chunks. Several chunks are in flight at once:
+ * while one chunk is encrypted, others are being read or written, so
+ * I/O overlaps with encryption. Chunks are written back to the same 
+ * offsets, hence an image can be encrypted in-place.
+ * 
+ * @copyright Copyright (c) 2023
+ */
+
+
+#include "bclib.h"
+
+#include "async_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <linux/fs.h>
+
+
+/**
+ * @brief Size of XTS key in bytes: data key followed by tweak key.
+ */
+#define BC_CRYPTP_XTS_KEY_SIZE (2 * KUZNYECHIK_KEY_SIZE)
+
+
+/**
+ * @brief Alignment of chunk buffers (suitable for O_DIRECT too).
+ */
+#define BC_CRYPTP_BUFFER_ALIGNMENT 4096
+
+
+/**
+ * @brief Maximal chunk size in bytes (io_uring request length is 32-bit).
+ */
+#define BC_CRYPTP_MAX_CHUNK_SIZE (1u << 30)
+
+
+/**
+ * @brief Number of consecutive wait failures, after which requests in flight are abandoned.
+ */
+#define BC_CRYPTP_MAX_WAIT_FAILURES 16
+
+
+/**
+ * @brief Command line options.
+ */
+typedef struct tagBC_CRYPTP_OPTIONS
+{
+    int decrypt;                      /**< Non-zero to decrypt */
+    const char* input;                /**< Input image path */
+    const char* output;               /**< Output image path */
+    const char* key_file;             /**< Path to raw XTS key */
+    size_t sector_size;               /**< Sector size in bytes */
+    unsigned long long first_sector;  /**< Number of the first sector of image */
+    size_t chunk_size;                /**< Chunk size in bytes */
+    unsigned int queue_depth;         /**< Number of chunks in flight */
+    size_t threads;                   /**< Encryption threads (0 means number of CPUs) */
+    KUZNYECHIK_ENGINE engine;         /**< Kuznyechik engine */
+    int force_thread_io;              /**< Non-zero to skip io_uring */
+} BC_CRYPTP_OPTIONS;
+
+
+/**
+ * @brief A chunk in flight.
+ */
+typedef struct tagBC_CRYPTP_SLOT
+{
+    BC_CRYPT_REQUEST request;  /**< Current I/O request */
+    unsigned char* buffer;     /**< Chunk buffer */
+    unsigned long long offset; /**< Chunk offset in image */
+    size_t length;             /**< Chunk length */
+    size_t done;               /**< Bytes transferred by current operation */
+} BC_CRYPTP_SLOT;
+
+
+/**
+ * @brief Processing context.
+ */
+typedef struct tagBC_CRYPTP_CONTEXT
+{
+    const BC_CRYPTP_OPTIONS* options; /**< Options */
+    BC_CRYPT_IO* io;                  /**< I/O backend */
+    BULK_ENGINE* bulk;                /**< Bulk engine (NULL for single thread) */
+    BLOCK_CIPHER cipher;              /**< Cipher interface */
+    KEY data_key;                     /**< Data key schedule (for encryption or decryption) */
+    KEY tweak_key;                    /**< Tweak key schedule */
+    int input_fd;                     /**< Input file */
+    int output_fd;                    /**< Output file */
+    unsigned long long size;          /**< Image size in bytes */
+    unsigned int in_flight;           /**< Requests left in flight after main loop (their buffers must not be released) */
+} BC_CRYPTP_CONTEXT;
+
+
+static void bc_cryptp_usage(const char* program)
+{
+    fprintf(stderr,
+            "Usage: %s <encrypt|decrypt> -k <key file> -i <input> -o <output> [options]\n"
+            "\n"
+            "  -k, --key-file <path>      raw 64-byte XTS key: data key followed by tweak key (must differ)\n"
+            "  -i, --input <path>         input image or block device\n"
+            "  -o, --output <path>        output image or block device (may be equal to input)\n"
+            "  -s, --sector-size <bytes>  sector size, multiple of 16 up to %d (default 512)\n"
+            "  -f, --first-sector <n>     number of the first sector of the image (default 0)\n"
+            "  -c, --chunk-size <bytes>   bytes per I/O request, up to %u (default 1048576)\n"
+            "  -q, --queue-depth <n>      chunks in flight (default 8)\n"
+            "  -t, --threads <n>          encryption threads, 0 means all CPUs (default 1)\n"
+            "  -e, --engine <name>        generic, avx2, avx512, constant-time or compact\n"
+            "                             (default is the fastest one supported by CPU)\n"
+            "      --no-io-uring          use I/O thread instead of io_uring\n",
+            program, XTS_MAX_SECTOR_SIZE, BC_CRYPTP_MAX_CHUNK_SIZE);
+}
+
+
+static int bc_cryptp_parse_engine(const char* name, KUZNYECHIK_ENGINE* engine)
+{
+    static const struct
+    {
+        const char* name;
+        KUZNYECHIK_ENGINE engine;
+    } engines[] = {
+        { "generic", KUZNYECHIK_ENGINE_GENERIC },
+        { "avx2", KUZNYECHIK_ENGINE_AVX2 },
+        { "avx512", KUZNYECHIK_ENGINE_AVX512 },
+        { "constant-time", KUZNYECHIK_ENGINE_CONSTANT_TIME },
+        { "compact", KUZNYECHIK_ENGINE_COMPACT }
+    };
+
+    size_t idx;
+
+    for (idx = 0; idx < sizeof(engines) / sizeof(engines[0]); ++idx)
+    {
+        if (!strcmp(name, engines[idx].name))
+        {
+            *engine = engines[idx].engine;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static int bc_cryptp_parse_number(const char* text, unsigned long long* value)
+{
+    char* end;
+
+    errno  = 0;
+    *value = strtoull(text, &end, 0);
+
+    return !errno && *text && !*end;
+}
+
+
+static int bc_cryptp_parse_options(int argc, char** argv, BC_CRYPTP_OPTIONS* options)
+{
+    unsigned long long value;
+    const char* argument;
+    int idx;
+
+    memset(options, 0, sizeof(*options));
+    options->sector_size = 512;
+    options->chunk_size  = 1024 * 1024;
+    options->queue_depth = 8;
+    options->threads     = 1;
+    options->engine      = kuznyechik_select_engine();
+
+    if (argc < 2 || (strcmp(argv[1], "encrypt") && strcmp(argv[1], "decrypt")))
+    {
+        return 0;
+    }
+
+    options->decrypt = !strcmp(argv[1], "decrypt");
+
+    for (idx = 2; idx < argc; ++idx)
+    {
+        argument = argv[idx];
+
+        if (!strcmp(argument, "--no-io-uring"))
+        {
+            options->force_thread_io = 1;
+            continue;
+        }
+
+        if (idx + 1 >= argc)
+        {
+            return 0;
+        }
+
+        if (!strcmp(argument, "-k") || !strcmp(argument, "--key-file"))
+        {
+            options->key_file = argv[++idx];
+        }
+        else if (!strcmp(argument, "-i") || !strcmp(argument, "--input"))
+        {
+            options->input = argv[++idx];
+        }
+        else if (!strcmp(argument, "-o") || !strcmp(argument, "--output"))
+        {
+            options->output = argv[++idx];
+        }
+        else if (!strcmp(argument, "-e") || !strcmp(argument, "--engine"))
+        {
+            if (!bc_cryptp_parse_engine(argv[++idx], &options->engine))
+            {
+                return 0;
+            }
+        }
+        else if (bc_cryptp_parse_number(argv[idx + 1], &value))
+        {
+            ++idx;
+
+            if (!strcmp(argument, "-s") || !strcmp(argument, "--sector-size"))
+            {
+                options->sector_size = (size_t)value;
+            }
+            else if (!strcmp(argument, "-f") || !strcmp(argument, "--first-sector"))
+            {
+                options->first_sector = value;
+            }
+            else if (!strcmp(argument, "-c") || !strcmp(argument, "--chunk-size"))
+            {
+                options->chunk_size = (size_t)value;
+            }
+            else if (!strcmp(argument, "-q") || !strcmp(argument, "--queue-depth"))
+            {
+                options->queue_depth = (unsigned int)value;
+            }
+            else if (!strcmp(argument, "-t") || !strcmp(argument, "--threads"))
+            {
+                options->threads = (size_t)value;
+            }
+            else
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    if (!options->key_file || !options->input || !options->output)
+    {
+        return 0;
+    }
+
+    if (!options->sector_size || options->sector_size % KUZNYECHIK_BLOCK_SIZE || options->sector_size > XTS_MAX_SECTOR_SIZE)
+    {
+        fprintf(stderr, "Invalid sector size\n");
+        return 0;
+    }
+
+    if (!options->queue_depth || options->chunk_size < options->sector_size || options->chunk_size > BC_CRYPTP_MAX_CHUNK_SIZE)
+    {
+        fprintf(stderr, "Invalid queue depth or chunk size\n");
+        return 0;
+    }
+
+    if (!kuznyechik_engine_supported(options->engine))
+    {
+        fprintf(stderr, "Engine is not supported by CPU\n");
+        return 0;
+    }
+
+    //
+    // Chunks must contain whole sectors
+    //
+
+    options->chunk_size -= options->chunk_size % options->sector_size;
+
+    return 1;
+}
+
+
+static int bc_cryptp_read_key(const char* path, unsigned char* key)
+{
+    FILE* file = fopen(path, "rb");
+    size_t read;
+
+    if (!file)
+    {
+        return 0;
+    }
+
+    read = fread(key, 1, BC_CRYPTP_XTS_KEY_SIZE, file);
+    fclose(file);
+
+    return read == BC_CRYPTP_XTS_KEY_SIZE;
+}
+
+
+static int bc_cryptp_get_size(int fd, unsigned long long* size)
+{
+    struct stat status;
+
+    if (fstat(fd, &status))
+    {
+        return 0;
+    }
+
+    if (S_ISBLK(status.st_mode))
+    {
+        return !ioctl(fd, BLKGETSIZE64, size);
+    }
+
+    *size = (unsigned long long)status.st_size;
+    return 1;
+}
+
+
+static int bc_cryptp_submit(BC_CRYPTP_CONTEXT* context, BC_CRYPTP_SLOT* slot, BC_CRYPT_OPERATION operation)
+{
+    int result;
+
+    slot->request.operation = operation;
+    slot->request.fd        = (operation == BC_CRYPT_READ) ? context->input_fd : context->output_fd;
+    slot->request.buffer    = slot->buffer + slot->done;
+    slot->request.length    = slot->length - slot->done;
+    slot->request.offset    = slot->offset + slot->done;
+
+    result = context->io->submit(context->io, &slot->request);
+    if (result < 0)
+    {
+        fprintf(stderr, "Cannot submit I/O request: %s\n", strerror(-result));
+        return 0;
+    }
+
+    return 1;
+}
+
+
+static void bc_cryptp_process_chunk(BC_CRYPTP_CONTEXT* context, BC_CRYPTP_SLOT* slot)
+{
+    const BC_CRYPTP_OPTIONS* options = context->options;
+
+    const unsigned long long sector = options->first_sector + slot->offset / options->sector_size;
+    const size_t sectors_count      = slot->length / options->sector_size;
+
+    BULK_REQUEST request;
+
+    if (context->bulk)
+    {
+        memset(&request, 0, sizeof(request));
+        request.mode        = options->decrypt ? BULK_MODE_XTS_DECRYPT : BULK_MODE_XTS_ENCRYPT;
+        request.cipher      = &context->cipher;
+        request.key         = &context->data_key;
+        request.tweak_key   = &context->tweak_key;
+        request.offset      = sector;
+        request.sector_size = options->sector_size;
+        request.in          = slot->buffer;
+        request.out         = slot->buffer;
+        request.length      = slot->length;
+
+        bulk_process(context->bulk, &request);
+    }
+    else if (options->decrypt)
+    {
+        xts_decrypt_sectors(&context->cipher, &context->data_key, &context->tweak_key, sector,
+                            options->sector_size, sectors_count, slot->buffer, slot->buffer);
+    }
+    else
+    {
+        xts_encrypt_sectors(&context->cipher, &context->data_key, &context->tweak_key, sector,
+                            options->sector_size, sectors_count, slot->buffer, slot->buffer);
+    }
+}
+
+
+/**
+ * @brief Main loop: reads, processes and writes all chunks.
+ */
+static int bc_cryptp_run(BC_CRYPTP_CONTEXT* context, BC_CRYPTP_SLOT* slots)
+{
+    const BC_CRYPTP_OPTIONS* options = context->options;
+
+    unsigned long long next_offset = 0;
+    unsigned int in_flight         = 0;
+    unsigned int wait_failures     = 0;
+    unsigned int idx;
+    int success = 1;
+
+    BC_CRYPTP_SLOT* slot;
+
+    //
+    // Fill the pipeline
+    //
+
+    for (idx = 0; idx < options->queue_depth && next_offset < context->size; ++idx)
+    {
+        slots[idx].offset = next_offset;
+        slots[idx].length = (context->size - next_offset < options->chunk_size) ? (size_t)(context->size - next_offset) : options->chunk_size;
+        slots[idx].done   = 0;
+        next_offset      += slots[idx].length;
+
+        if (!bc_cryptp_submit(context, slots + idx, BC_CRYPT_READ))
+        {
+            success = 0;
+            break;
+        }
+
+        ++in_flight;
+    }
+
+    while (in_flight)
+    {
+        slot = (BC_CRYPTP_SLOT*)context->io->wait(context->io);
+        if (!slot)
+        {
+            fprintf(stderr, "I/O wait failed: %s\n", strerror(errno));
+            success = 0;
+
+            //
+            // Requests in flight still own their buffers, so the rest
+            // of them is drained, unless waiting fails persistently
+            //
+
+            if (++wait_failures < BC_CRYPTP_MAX_WAIT_FAILURES)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        wait_failures = 0;
+        --in_flight;
+
+        if (!success)
+        {
+            continue;
+        }
+
+        if (slot->request.result <= 0)
+        {
+            fprintf(stderr, "I/O error at offset %llu: %s\n", slot->request.offset,
+                    slot->request.result ? strerror((int)-slot->request.result) : "unexpected end of file");
+            success = 0;
+            continue;
+        }
+
+        //
+        // Short transfer: continue the same operation
+        //
+
+        slot->done += (size_t)slot->request.result;
+
+        if (slot->done < slot->length)
+        {
+            success = bc_cryptp_submit(context, slot, slot->request.operation);
+            in_flight += success;
+            continue;
+        }
+
+        slot->done = 0;
+
+        if (slot->request.operation == BC_CRYPT_READ)
+        {
+            bc_cryptp_process_chunk(context, slot);
+            success = bc_cryptp_submit(context, slot, BC_CRYPT_WRITE);
+            in_flight += success;
+        }
+        else if (next_offset < context->size)
+        {
+            slot->offset = next_offset;
+            slot->length = (context->size - next_offset < options->chunk_size) ? (size_t)(context->size - next_offset) : options->chunk_size;
+            next_offset += slot->length;
+
+            success = bc_cryptp_submit(context, slot, BC_CRYPT_READ);
+            in_flight += success;
+        }
+    }
+
+    context->in_flight = in_flight;
+
+    return success;
+}
+
+
+int main(int argc, char** argv)
+{
+    BC_CRYPTP_OPTIONS options;
+    BC_CRYPTP_CONTEXT context;
+    BC_CRYPTP_SLOT* slots = NULL;
+    struct stat status;
+
+    unsigned char raw_key[BC_CRYPTP_XTS_KEY_SIZE];
+    unsigned int idx;
+    int exit_code = EXIT_FAILURE;
+
+    if (!bc_cryptp_parse_options(argc, argv, &options))
+    {
+        bc_cryptp_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    memset(&context, 0, sizeof(context));
+    context.options   = &options;
+    context.input_fd  = -1;
+    context.output_fd = -1;
+
+    //
+    // Cipher and keys
+    //
+
+    if (!bc_cryptp_read_key(options.key_file, raw_key))
+    {
+        fprintf(stderr, "Cannot read %d bytes of key from '%s'\n", BC_CRYPTP_XTS_KEY_SIZE, options.key_file);
+        return EXIT_FAILURE;
+    }
+
+    //
+    // Identical halves turn XTS into a mode with a known weakness,
+    // such keys are rejected (as Linux kernel and OpenSSL do)
+    //
+
+    if (!memcmp(raw_key, raw_key + KUZNYECHIK_KEY_SIZE, KUZNYECHIK_KEY_SIZE))
+    {
+        fprintf(stderr, "XTS data key and tweak key in '%s' must differ\n", options.key_file);
+        memset(raw_key, 0, sizeof(raw_key));
+        return EXIT_FAILURE;
+    }
+
+    kuznyechik_initialize_interface_ex(&context.cipher, options.engine);
+
+    options.decrypt ? context.cipher.initialize_decrypt_key(raw_key, &context.data_key)
+                    : context.cipher.initialize_encrypt_key(raw_key, &context.data_key);
+
+    context.cipher.initialize_encrypt_key(raw_key + KUZNYECHIK_KEY_SIZE, &context.tweak_key);
+
+    memset(raw_key, 0, sizeof(raw_key));
+
+    //
+    // Files
+    //
+
+    context.input_fd = open(options.input, O_RDONLY);
+    if (context.input_fd < 0)
+    {
+        fprintf(stderr, "Cannot open '%s': %s\n", options.input, strerror(errno));
+        goto cleanup;
+    }
+
+    if (!bc_cryptp_get_size(context.input_fd, &context.size) || context.size % options.sector_size)
+    {
+        fprintf(stderr, "Size of '%s' is unknown or not a multiple of sector size\n", options.input);
+        goto cleanup;
+    }
+
+    context.output_fd = open(options.output, O_WRONLY | O_CREAT, 0600);
+    if (context.output_fd < 0)
+    {
+        fprintf(stderr, "Cannot open '%s': %s\n", options.output, strerror(errno));
+        goto cleanup;
+    }
+
+    //
+    // Output is not truncated on open, because it may be the input
+    // itself. Stale tail of a larger regular file is cut here
+    //
+
+    if (!fstat(context.output_fd, &status) && S_ISREG(status.st_mode) &&
+        ftruncate(context.output_fd, (off_t)context.size))
+    {
+        fprintf(stderr, "Cannot resize '%s': %s\n", options.output, strerror(errno));
+        goto cleanup;
+    }
+
+    //
+    // I/O backend, encryption threads and buffers
+    //
+
+    context.io = options.force_thread_io ? NULL : bc_crypt_io_uring_create(options.queue_depth);
+    if (!context.io)
+    {
+        context.io = bc_crypt_io_thread_create(options.queue_depth);
+    }
+
+    if (!context.io)
+    {
+        fprintf(stderr, "Cannot initialize I/O\n");
+        goto cleanup;
+    }
+
+    if (options.threads != 1)
+    {
+        context.bulk = bulk_create(options.threads);
+        if (!context.bulk)
+        {
+            fprintf(stderr, "Cannot create encryption threads\n");
+            goto cleanup;
+        }
+    }
+
+    slots = (BC_CRYPTP_SLOT*)calloc(options.queue_depth, sizeof(BC_CRYPTP_SLOT));
+    if (!slots)
+    {
+        fprintf(stderr, "Out of memory\n");
+        goto cleanup;
+    }
+
+    for (idx = 0; idx < options.queue_depth; ++idx)
+    {
+        if (posix_memalign((void**)&slots[idx].buffer, BC_CRYPTP_BUFFER_ALIGNMENT, options.chunk_size))
+        {
+            fprintf(stderr, "Out of memory\n");
+            goto cleanup;
+        }
+    }
+
+    if (bc_cryptp_run(&context, slots))
+    {
+        exit_code = EXIT_SUCCESS;
+    }
+
+cleanup:
+
+    //
+    // Buffers of abandoned requests may still be accessed by kernel or
+    // I/O thread, so they (and the backend) are left to process exit
+    //
+
+    if (context.io && !context.in_flight)
+    {
+        context.io->destroy(context.io);
+    }
+
+    if (slots && !context.in_flight)
+    {
+        for (idx = 0; idx < options.queue_depth; ++idx)
+        {
+            free(slots[idx].buffer);
+        }
+
+        free(slots);
+    }
+
+    if (context.bulk)
+    {
+        bulk_destroy(context.bulk);
+    }
+
+    if (context.output_fd >= 0 && close(context.output_fd))
+    {
+        fprintf(stderr, "Cannot close '%s': %s\n", options.output, strerror(errno));
+        exit_code = EXIT_FAILURE;
+    }
+
+    if (context.input_fd >= 0)
+    {
+        close(context.input_fd);
+    }
+
+    memset(&context.data_key, 0, sizeof(context.data_key));
+    memset(&context.tweak_key, 0, sizeof(context.tweak_key));
+
+    return exit_code;
+}
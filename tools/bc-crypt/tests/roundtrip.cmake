@@ -0,0 +1,73 @@
+#
+# Encrypts and decrypts an image with both I/O backends and
+# checks that ciphertexts are equal and plaintext is restored.
+#
+# Usage: cmake -DBC_CRYPT=<bc-crypt> -DWORK_DIR=<dir> -P roundtrip.cmake
+#
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+#
+# Image of 300 sectors (not a multiple of chunk size, so
+# the last chunk is partial) and 64-byte XTS key
+#
+string(RANDOM LENGTH 153600 ALPHABET 0123456789abcdefghijklmnopqrstuvwxyz IMAGE)
+file(WRITE ${WORK_DIR}/image.bin "${IMAGE}")
+
+string(RANDOM LENGTH 64 KEY)
+file(WRITE ${WORK_DIR}/key.bin "${KEY}")
+
+function(bc_crypt_run)
+    execute_process(COMMAND ${BC_CRYPT} ${ARGN} -k ${WORK_DIR}/key.bin -c 8192 -q 4 -f 1000
+                    RESULT_VARIABLE RESULT)
+
+    if (NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "bc-crypt ${ARGN} failed: ${RESULT}")
+    endif ()
+endfunction()
+
+function(bc_crypt_compare FIRST SECOND EXPECT_EQUAL)
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${WORK_DIR}/${FIRST} ${WORK_DIR}/${SECOND}
+                    RESULT_VARIABLE RESULT)
+
+    if (EXPECT_EQUAL AND NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "${FIRST} and ${SECOND} differ")
+    elseif (NOT EXPECT_EQUAL AND RESULT EQUAL 0)
+        message(FATAL_ERROR "${FIRST} and ${SECOND} are equal")
+    endif ()
+endfunction()
+
+bc_crypt_run(encrypt -i ${WORK_DIR}/image.bin -o ${WORK_DIR}/uring.enc)
+bc_crypt_run(encrypt -i ${WORK_DIR}/image.bin -o ${WORK_DIR}/thread.enc --no-io-uring -t 2)
+bc_crypt_run(decrypt -i ${WORK_DIR}/uring.enc -o ${WORK_DIR}/uring.dec)
+bc_crypt_run(decrypt -i ${WORK_DIR}/thread.enc -o ${WORK_DIR}/thread.dec --no-io-uring)
+
+bc_crypt_compare(image.bin uring.enc FALSE)
+bc_crypt_compare(uring.enc thread.enc TRUE)
+bc_crypt_compare(image.bin uring.dec TRUE)
+bc_crypt_compare(image.bin thread.dec TRUE)
+
+#
+# In-place processing
+#
+configure_file(${WORK_DIR}/image.bin ${WORK_DIR}/inplace.bin COPYONLY)
+
+bc_crypt_run(encrypt -i ${WORK_DIR}/inplace.bin -o ${WORK_DIR}/inplace.bin)
+bc_crypt_compare(inplace.bin uring.enc TRUE)
+
+bc_crypt_run(decrypt -i ${WORK_DIR}/inplace.bin -o ${WORK_DIR}/inplace.bin)
+bc_crypt_compare(inplace.bin image.bin TRUE)
+
+#
+# Key with identical data and tweak halves is rejected
+#
+string(SUBSTRING "${KEY}" 0 32 KEY_HALF)
+file(WRITE ${WORK_DIR}/weak_key.bin "${KEY_HALF}${KEY_HALF}")
+
+execute_process(COMMAND ${BC_CRYPT} encrypt -i ${WORK_DIR}/image.bin -o ${WORK_DIR}/weak.enc -k ${WORK_DIR}/weak_key.bin
+                RESULT_VARIABLE RESULT ERROR_QUIET)
+
+if (RESULT EQUAL 0)
+    message(FATAL_ERROR "bc-crypt accepted identical XTS key halves")
+endif ()